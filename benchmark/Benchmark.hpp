@@ -0,0 +1,134 @@
+#ifndef PASSPORT_BENCHMARK_HPP
+#define PASSPORT_BENCHMARK_HPP
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#   define BENCHMARK_HAS_TSC
+#   ifdef _MSC_VER
+#       include <intrin.h>
+#   else
+#       include <x86intrin.h>
+#   endif
+#endif
+
+/**
+ * Minimal benchmark helpers shared by the native benchmarks
+ */
+namespace benchmark {
+	using clock = std::chrono::steady_clock;
+
+	/**
+	 * Prevent the compiler from optimizing away a value
+	 *
+	 * @param value the value to keep
+	 */
+	template<class T>
+	inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+		__asm__ volatile("" : : "g"(&value) : "memory");
+#else
+		static const void* volatile sink;
+		sink = &value;
+#endif
+	}
+
+	/**
+	 * Run a function repeatedly for at least minSeconds
+	 *
+	 * @param fn the function to run
+	 * @param minSeconds the minimum time to run
+	 * @return the average number of seconds per call
+	 */
+	template<class Fn>
+	inline double measure(Fn&& fn, double minSeconds = 0.5) {
+		// Warm up
+		fn();
+
+		size_t iterations = 1;
+		while (true) {
+			const auto start = clock::now();
+			for (size_t i = 0; i < iterations; i++) fn();
+			const double elapsed = std::chrono::duration<double>(clock::now() - start).count();
+
+			if (elapsed >= minSeconds) return elapsed / (double)iterations;
+			iterations *= elapsed > 0.01 ? (size_t)(minSeconds / elapsed) + 1 : 10;
+		}
+	}
+
+	/**
+	 * Run a function a number of times and count the time stamp counter ticks,
+	 * which are cpu cycles at the nominal frequency
+	 *
+	 * @param fn the function to run
+	 * @param iterations the number of calls
+	 * @return the average number of ticks per call, zero if the cpu has no time stamp counter
+	 */
+	template<class Fn>
+	inline double measureCycles(Fn&& fn, size_t iterations) {
+#ifdef BENCHMARK_HAS_TSC
+		fn();
+		const uint64_t start = __rdtsc();
+		for (size_t i = 0; i < iterations; i++) fn();
+		return (double)(__rdtsc() - start) / (double)iterations;
+#else
+		(void)fn;
+		(void)iterations;
+		return 0;
+#endif
+	}
+
+	/**
+	 * Get a percentile of a set of samples
+	 *
+	 * @param samples the samples. Will be sorted.
+	 * @param p the percentile to get in [0, 1]
+	 * @return the value at the percentile
+	 */
+	inline double percentile(std::vector<double>& samples, double p) {
+		if (samples.empty()) return 0;
+		std::sort(samples.begin(), samples.end());
+		const size_t index = std::min(samples.size() - 1, (size_t)(p * (double)(samples.size() - 1) + 0.5));
+		return samples[index];
+	}
+
+	/**
+	 * Print a throughput result line
+	 *
+	 * @param name the name of the benchmark
+	 * @param bytes the number of bytes processed per call
+	 * @param seconds the seconds per call
+	 */
+	inline void printThroughput(const std::string& name, size_t bytes, double seconds) {
+		printf("%-40s %10.3f GB/s\n", name.c_str(), (double)bytes / seconds / 1e9);
+	}
+
+	/**
+	 * Print an operations per second result line
+	 *
+	 * @param name the name of the benchmark
+	 * @param seconds the seconds per operation
+	 */
+	inline void printRate(const std::string& name, double seconds) {
+		printf("%-40s %12.0f ops/s %10.3f us/op\n", name.c_str(), 1.0 / seconds, seconds * 1e6);
+	}
+
+	/**
+	 * Print an operations per second and cycles per operation result line
+	 *
+	 * @param name the name of the benchmark
+	 * @param seconds the seconds per operation
+	 * @param cycles the cycles per operation, zero if unknown
+	 */
+	inline void printCycles(const std::string& name, double seconds, double cycles) {
+		printf("%-40s %12.0f ops/s %10.3f us/op %12.0f cycles/op\n", name.c_str(), 1.0 / seconds, seconds * 1e6,
+			cycles);
+	}
+}
+
+#endif //PASSPORT_BENCHMARK_HPP
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include <string>
+#include <iostream>
+
+#include "Benchmark.hpp"
+#include "ChallengeIssuer.hpp"
+#include "HexCodec.hpp"
+#include "RsaSigner.hpp"
+
+using namespace nodeMsPassport;
+using namespace nodeMsPassport::crypto;
+
+namespace {
+	bool expect(const std::string& name, challengeIssuer::status actual, challengeIssuer::status expected) {
+		if (actual == expected) return true;
+
+		std::cerr << name << ": expected " << challengeIssuer::statusName(expected) << ", got "
+				  << challengeIssuer::statusName(actual) << std::endl;
+		return false;
+	}
+
+	/**
+	 * Check HMAC-SHA256 against the test cases 1, 2 and 6 of RFC 4231
+	 *
+	 * @return true if all tags match
+	 */
+	bool checkHmac() {
+		const secure_vector<byte> key1(20, 0x0b);
+		const std::string data1 = "Hi There";
+		const std::string key2 = "Jefe";
+		const std::string data2 = "what do ya want for nothing?";
+		const secure_vector<byte> key6(131, 0xaa);
+		const std::string data6 = "Test Using Larger Than Block-Size Key - Hash Key First";
+
+		const auto tagOf = [](const byte* key, size_t keyLength, const std::string& data) {
+			const hmacSha256::tag tag = hmacSha256::mac(key, keyLength, reinterpret_cast<const byte*>(data.data()),
+				data.size());
+			return hex::encode(secure_vector<byte>(tag.begin(), tag.end()));
+		};
+
+		return tagOf(key1.data(), key1.size(), data1) ==
+			   "B0344C61D8DB38535CA8AFCEAF0BF12B881DC200C9833DA726E9376C2E32CFF7" &&
+			   tagOf(reinterpret_cast<const byte*>(key2.data()), key2.size(), data2) ==
+			   "5BDCC146BF60754E6A042426089575C75A003F089D2739839DEC58B964EC3843" &&
+			   tagOf(key6.data(), key6.size(), data6) ==
+			   "60E431591EE0B67F0D8A26AACBF5B77F8E0BC6213728C5140546040F0EE37F54";
+	}
+
+	/**
+	 * Check that only fresh, authentic challenges bound to the account are accepted
+	 *
+	 * @return true if all checks passed
+	 */
+	bool checkChallenges() {
+		const secure_vector<byte> key(32, 0x42);
+		const challengeIssuer issuer(key.data(), key.size());
+		const uint64_t now = challengeIssuer::now();
+		const secure_buffer challenge = issuer.issue("alice", now);
+
+		bool ok = true;
+		ok &= expect("A fresh challenge", issuer.verify(challenge, "alice", now), challengeIssuer::status::valid);
+		ok &= expect("Another account", issuer.verify(challenge, "bob", now), challengeIssuer::status::wrongAccount);
+		ok &= expect("An expired challenge", issuer.verify(challenge, "alice", now + challengeIssuer::defaultMaxAge + 1),
+			challengeIssuer::status::expired);
+		ok &= expect("A challenge from the future", issuer.verify(challenge, "alice",
+			now - challengeIssuer::maxClockSkew - 1), challengeIssuer::status::notYetValid);
+
+		const secure_vector<byte> otherKey(32, 0x43);
+		const challengeIssuer other(otherKey.data(), otherKey.size());
+		ok &= expect("Another key", other.verify(challenge, "alice", now), challengeIssuer::status::badTag);
+
+		for (size_t i = 0; i < challenge.size(); i++) {
+			secure_buffer tampered = challenge;
+			tampered.data()[i] ^= 0x01;
+			const challengeIssuer::status expected = i == 0 ? challengeIssuer::status::malformed
+															: challengeIssuer::status::badTag;
+			ok &= expect("Byte " + std::to_string(i) + " modified", issuer.verify(tampered, "alice", now), expected);
+		}
+
+		ok &= expect("A short challenge", issuer.verify(secure_buffer(challenge.data(), challenge.size() - 1), "alice",
+			now), challengeIssuer::status::malformed);
+		ok &= expect("A second challenge", issuer.verify(issuer.issue("alice", now), "alice", now),
+			challengeIssuer::status::valid);
+
+		return ok && issuer.issue("alice", now) != challenge;
+	}
+}
+
+int main() {
+	if (!checkHmac()) {
+		std::cerr << "HMAC-SHA256 does not match the RFC 4231 test vectors" << std::endl;
+		return 1;
+	} else if (!checkChallenges()) {
+		return 1;
+	}
+
+	std::cout << "Challenges passed all checks" << std::endl;
+
+	const secure_vector<byte> key(32, 0x42);
+	const challengeIssuer issuer(key.data(), key.size());
+	const secure_buffer challenge = issuer.issue("alice");
+	secure_buffer forged = challenge;
+	forged.data()[1] ^= 0x01;
+
+	const rsaPrivateKey privateKey = rsaPrivateKey::generate();
+	const secure_vector<byte> publicKey = privateKey.getPublicKey();
+	const secure_buffer signature = privateKey.signPkcs1Sha256(challenge.data(), challenge.size());
+
+	benchmark::printRate("issue", benchmark::measure([&] {
+		benchmark::doNotOptimize(issuer.issue("alice"));
+	}));
+	benchmark::printRate("verify", benchmark::measure([&] {
+		benchmark::doNotOptimize(issuer.verify(challenge, "alice"));
+	}));
+	benchmark::printRate("verifySignature", benchmark::measure([&] {
+		benchmark::doNotOptimize(passport::verifySignature(challenge, signature, publicKey));
+	}));
+
+	// A forged challenge is rejected by the MAC before the RSA verification
+	benchmark::printRate("verify and verifySignature, forged", benchmark::measure([&] {
+		benchmark::doNotOptimize(issuer.verify(forged, "alice") == challengeIssuer::status::valid &&
+								 passport::verifySignature(forged, signature, publicKey));
+	}));
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include <set>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <climits>
+#include <iostream>
+
+#include "Benchmark.hpp"
+#include "ChallengePool.hpp"
+#include "Drbg.hpp"
+
+using namespace nodeMsPassport;
+using namespace nodeMsPassport::crypto;
+
+namespace {
+	constexpr size_t challengeSize = 32;
+
+	/**
+	 * Wait until the refill thread filled the pool
+	 *
+	 * @param pool the pool to wait for
+	 */
+	void waitUntilFull(const challengePool& pool) {
+		while (pool.getStatistics().available < pool.getStatistics().depth) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+
+	/**
+	 * Check that concurrent callers never get the same challenge
+	 * and that every challenge is counted exactly once
+	 *
+	 * @return true if all checks passed
+	 */
+	bool checkConcurrentTakes() {
+		constexpr size_t threads = 4;
+		constexpr size_t perThread = 5000;
+
+		// A small pool, so the callers run into the refill thread and into an empty pool
+		challengePool pool(64, 16);
+		std::vector<std::vector<std::string>> results(threads);
+		std::vector<std::thread> takers;
+		for (size_t t = 0; t < threads; t++) {
+			takers.emplace_back([&pool, &results, t] {
+				byte challenge[challengeSize];
+				for (size_t i = 0; i < perThread; i++) {
+					pool.take(challenge, challengeSize);
+					results[t].emplace_back(reinterpret_cast<const char*>(challenge), challengeSize);
+				}
+			});
+		}
+
+		for (std::thread& t : takers) t.join();
+
+		std::set<std::string> unique;
+		for (const std::vector<std::string>& r : results) unique.insert(r.begin(), r.end());
+
+		const challengePool::statistics stats = pool.getStatistics();
+		std::cout << "Concurrent takes: " << stats.taken << " from the pool, " << stats.exhausted
+				  << " generated by the caller" << std::endl;
+
+		return unique.size() == threads * perThread && stats.taken + stats.exhausted == threads * perThread;
+	}
+
+	/**
+	 * Measure the latency of every call in a burst of calls
+	 *
+	 * @param burst the number of calls
+	 * @param fn the function to call
+	 * @return the latencies in microseconds
+	 */
+	template<class Fn>
+	std::vector<double> measureBurst(size_t burst, Fn&& fn) {
+		std::vector<double> latencies;
+		latencies.reserve(burst);
+		for (size_t i = 0; i < burst; i++) {
+			const auto start = benchmark::clock::now();
+			fn();
+			latencies.push_back(std::chrono::duration<double, std::micro>(benchmark::clock::now() - start).count());
+		}
+
+		return latencies;
+	}
+
+	void print(const std::string& name, std::vector<double> latencies) {
+		const double p50 = benchmark::percentile(latencies, 0.5);
+		const double p99 = benchmark::percentile(latencies, 0.99);
+		printf("  %-38s %10.3f us p50 %10.3f us p99\n", name.c_str(), p50, p99);
+	}
+}
+
+int main() {
+	if (!checkConcurrentTakes()) {
+		std::cerr << "A challenge was handed out twice or not counted" << std::endl;
+		return 1;
+	}
+
+	// A login peak: a burst of challenges smaller than the pool depth
+	constexpr size_t burst = 512;
+	byte challenge[challengeSize];
+	std::cout << "Latency of " << burst << " challenges in a burst" << std::endl;
+
+	print("mt19937 per call", measureBurst(burst, [&] {
+		std::random_device dev;
+		std::mt19937 rng(dev());
+		std::uniform_int_distribution<> dist(0, UCHAR_MAX);
+		for (byte& b : challenge) b = (byte)dist(rng);
+		benchmark::doNotOptimize(challenge);
+	}));
+
+	print("secureRandom", measureBurst(burst, [&] {
+		secureRandom(challenge, challengeSize);
+		benchmark::doNotOptimize(challenge);
+	}));
+
+	challengePool pool(1024, 256);
+	waitUntilFull(pool);
+	print("challenge pool", measureBurst(burst, [&] {
+		pool.take(challenge, challengeSize);
+		benchmark::doNotOptimize(challenge);
+	}));
+
+	const challengePool::statistics stats = pool.getStatistics();
+	std::cout << "Pool: " << stats.taken << " taken, " << stats.exhausted << " exhausted, "
+			  << stats.generated << " generated" << std::endl;
+
+	return 0;
+}
\ No newline at end of file
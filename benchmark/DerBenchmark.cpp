@@ -0,0 +1,67 @@
+#include <new>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+
+#include "Benchmark.hpp"
+#include "TestVectors.hpp"
+#include "HexCodec.hpp"
+#include "Der.hpp"
+#include "RsaVerifier.hpp"
+
+using namespace nodeMsPassport;
+
+// Count heap allocations to check that parsing does not allocate
+static std::atomic<size_t> allocations(0);
+
+void* operator new(size_t size) {
+	allocations++;
+	if (void* p = std::malloc(size == 0 ? 1 : size)) return p;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+	std::free(p);
+}
+
+int main() {
+	std::vector<secure_vector<byte>> corpus;
+	size_t corpusSize = 0;
+	for (const char* key : testVectors::publicKeyCorpus) {
+		corpus.push_back(hex::decode(key));
+		corpusSize += corpus.back().size();
+	}
+
+	const size_t before = allocations;
+	size_t modulusBytes = 0;
+	for (const secure_vector<byte>& key : corpus) {
+		const der::subjectPublicKeyInfo info = der::parseSubjectPublicKeyInfo(der::span{key.data(), key.size()});
+		modulusBytes += der::parseRsaPublicKey(info).modulus.size;
+	}
+
+	std::cout << "Corpus: " << corpus.size() << " keys, " << corpusSize << " bytes, " << modulusBytes
+		<< " modulus bytes" << std::endl;
+	std::cout << "Heap allocations while parsing: " << allocations - before << std::endl;
+
+	const double parse = benchmark::measure([&] {
+		for (const secure_vector<byte>& key : corpus) {
+			const der::subjectPublicKeyInfo info = der::parseSubjectPublicKeyInfo(der::span{key.data(), key.size()});
+			benchmark::doNotOptimize(der::parseRsaPublicKey(info));
+		}
+	});
+	benchmark::printThroughput("der::parseRsaPublicKey", corpusSize, parse);
+	benchmark::printRate("der::parseRsaPublicKey", parse / (double)corpus.size());
+
+	const double prepare = benchmark::measure([&] {
+		for (const secure_vector<byte>& key : corpus) {
+			benchmark::doNotOptimize(crypto::rsaPublicKey::fromSubjectPublicKeyInfo(key.data(), key.size()));
+		}
+	});
+	benchmark::printRate("rsaPublicKey::fromSubjectPublicKeyInfo", prepare / (double)corpus.size());
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,186 @@
+#include <random>
+#include <climits>
+#include <iostream>
+
+#include "Benchmark.hpp"
+#include "Drbg.hpp"
+#include "HexCodec.hpp"
+#include "Random.hpp"
+
+#ifndef _WIN32
+#   include <unistd.h>
+#   include <sys/wait.h>
+#endif
+
+using namespace nodeMsPassport;
+using namespace nodeMsPassport::crypto;
+
+namespace {
+	/**
+	 * The previous generateRandom implementation
+	 */
+	void mt19937Bytes(byte* out, size_t len) {
+		std::random_device dev;
+		std::mt19937 rng(dev());
+		std::uniform_int_distribution<> dist(0, UCHAR_MAX);
+
+		for (size_t i = 0; i < len; i++) {
+			out[i] = (byte)dist(rng);
+		}
+	}
+
+	/**
+	 * Check the block function against the test vector of RFC 8439 section 2.3.2
+	 *
+	 * @return true if the output matches
+	 */
+	bool checkTestVector() {
+		uint32_t key[8];
+		for (uint32_t i = 0; i < 8; i++) {
+			key[i] = (4 * i) | ((4 * i + 1) << 8u) | ((4 * i + 2) << 16u) | ((4 * i + 3) << 24u);
+		}
+
+		const uint32_t nonce[3] = {0x09000000, 0x4a000000, 0x00000000};
+		secure_vector<byte> block(64);
+		chacha20Block(key, 1, nonce, block.data());
+
+		return block == hex::decode("10F1E7E4D13B5915500FDD1FA32071C4C7D1F4C733C068030422AA9AC3D46C4E"
+									"D2826446079FAA0914C2D705D98B02A2B5129CD1DE164EB9CBD083E8A2503C4E");
+	}
+
+	/**
+	 * Check that bulk output, which uses the vectorized block function
+	 * if supported, matches the scalar block function
+	 *
+	 * @return true if the outputs match
+	 */
+	bool checkBulkOutput() {
+		byte seed[32];
+		uint32_t key[8];
+		for (uint32_t i = 0; i < 8; i++) {
+			seed[4 * i] = seed[4 * i + 1] = seed[4 * i + 2] = seed[4 * i + 3] = (byte)i;
+			key[i] = i * 0x01010101u;
+		}
+
+		// A fresh generator writes blocks 1..n of its seed key straight into the output
+		chachaDrbg drbg(seed);
+		secure_vector<byte> out(4096 + 32), expected(out.size() + 64);
+		drbg.generate(out.data(), out.size());
+
+		const uint32_t nonce[3] = {0, 0, 0};
+		for (uint32_t i = 0; i < expected.size() / 64; i++) {
+			chacha20Block(key, i + 1, nonce, expected.data() + 64 * i);
+		}
+
+		return std::equal(out.begin(), out.end(), expected.begin());
+	}
+
+	/**
+	 * Check that generators with the same seed produce the same output
+	 * and that buffered bytes are never handed out twice
+	 *
+	 * @return true if the checks passed
+	 */
+	bool checkDeterministic() {
+		byte seed[32] = {1, 2, 3};
+		chachaDrbg a(seed), b(seed);
+
+		// Mix buffered and direct requests
+		secure_vector<byte> first(5000), second(5000);
+		for (size_t pos = 0, n = 1; pos < first.size(); pos += n, n = n * 3 + 1) {
+			a.generate(first.data() + pos, std::min(n, first.size() - pos));
+			b.generate(second.data() + pos, std::min(n, second.size() - pos));
+		}
+
+		secure_vector<byte> next(16);
+		for (size_t i = 0; i < 100; i++) {
+			a.generate(next.data(), next.size());
+			if (std::search(first.begin(), first.end(), next.begin(), next.end()) != first.end()) return false;
+		}
+
+		return first == second;
+	}
+
+	/**
+	 * Check that a forked child process does not repeat the output of its parent
+	 *
+	 * @return true if the outputs differ
+	 */
+	bool checkFork() {
+#ifndef _WIN32
+		// Fill the buffer of this thread's generator before forking
+		byte warmup[1];
+		secureRandom(warmup, sizeof(warmup));
+
+		int fds[2];
+		if (pipe(fds) != 0) return false;
+
+		const pid_t pid = fork();
+		if (pid < 0) return false;
+		if (pid == 0) {
+			byte child[32];
+			secureRandom(child, sizeof(child));
+			const bool written = write(fds[1], child, sizeof(child)) == (ssize_t)sizeof(child);
+			_exit(written ? 0 : 1);
+		}
+
+		byte parent[32], child[32];
+		secureRandom(parent, sizeof(parent));
+		const bool read = ::read(fds[0], child, sizeof(child)) == (ssize_t)sizeof(child);
+		waitpid(pid, nullptr, 0);
+		close(fds[0]);
+		close(fds[1]);
+
+		return read && !std::equal(parent, parent + sizeof(parent), child);
+#else
+		return true;
+#endif
+	}
+}
+
+int main() {
+	if (!checkTestVector()) {
+		std::cerr << "The ChaCha20 block function does not match the test vector" << std::endl;
+		return 1;
+	} else if (!checkBulkOutput()) {
+		std::cerr << "The vectorized block function does not match the scalar one" << std::endl;
+		return 1;
+	} else if (!checkDeterministic()) {
+		std::cerr << "The generator is not deterministic or repeated its output" << std::endl;
+		return 1;
+	} else if (!checkFork()) {
+		std::cerr << "A forked process repeated the output of its parent" << std::endl;
+		return 1;
+	}
+
+	std::cout << "The generator passed all checks" << std::endl;
+
+	// A challenge, a RSA-2048 blinding value and bulk output
+	for (size_t size : {32, 256, 65536}) {
+		secure_vector<byte> out(size);
+		std::cout << "Request size: " << size << " bytes" << std::endl;
+
+		const double legacy = benchmark::measure([&] {
+			mt19937Bytes(out.data(), out.size());
+			benchmark::doNotOptimize(out);
+		});
+		benchmark::printThroughput("  mt19937 per call", size, legacy);
+		benchmark::printRate("  mt19937 per call", legacy);
+
+		const double os = benchmark::measure([&] {
+			randomBytes(out.data(), out.size());
+			benchmark::doNotOptimize(out);
+		});
+		benchmark::printThroughput("  operating system", size, os);
+		benchmark::printRate("  operating system", os);
+
+		const double drbg = benchmark::measure([&] {
+			secureRandom(out.data(), out.size());
+			benchmark::doNotOptimize(out);
+		});
+		benchmark::printThroughput("  ChaCha20 DRBG", size, drbg);
+		benchmark::printRate("  ChaCha20 DRBG", drbg);
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,165 @@
+#include <string>
+#include <iostream>
+#include <stdexcept>
+
+#include "Benchmark.hpp"
+#include "TestVectors.hpp"
+#include "HexCodec.hpp"
+#include "KeyCache.hpp"
+#include "RsaVerifier.hpp"
+#include "EcdsaVerifier.hpp"
+#include "Der.hpp"
+
+using namespace nodeMsPassport;
+using namespace nodeMsPassport::crypto;
+
+namespace {
+	// The big endian order of the P-256 base point
+	const byte groupOrder[] = {
+		0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xBC, 0xE6, 0xFA, 0xAD, 0xA7, 0x17, 0x9E, 0x84, 0xF3, 0xB9, 0xCA, 0xC2, 0xFC, 0x63, 0x25, 0x51
+	};
+
+	/**
+	 * Convert a DER encoded signature to the raw r || s form
+	 */
+	secure_vector<byte> toRaw(const secure_vector<byte>& signature) {
+		const der::ecdsaSignatureView view = der::parseEcdsaSignature(der::span{signature.data(), signature.size()});
+		secure_vector<byte> res(ecPublicKey::rawSignatureSize, 0);
+		std::copy(view.r.data, view.r.data + view.r.size, res.begin() + 32 - view.r.size);
+		std::copy(view.s.data, view.s.data + view.s.size, res.end() - view.s.size);
+		return res;
+	}
+
+	/**
+	 * Convert a raw r || s signature to DER
+	 */
+	secure_vector<byte> toDer(const secure_vector<byte>& raw) {
+		secure_vector<byte> content = der::encodeInteger(secure_vector<byte>(raw.begin(), raw.begin() + 32));
+		const secure_vector<byte> s = der::encodeInteger(secure_vector<byte>(raw.begin() + 32, raw.end()));
+		content.insert(content.end(), s.begin(), s.end());
+		return der::encode(der::TAG_SEQUENCE, content);
+	}
+
+	bool verify(const ecPublicKey& key, const secure_vector<byte>& message, const secure_vector<byte>& signature) {
+		return key.verifyEcdsaSha256(message.data(), message.size(), signature.data(), signature.size());
+	}
+
+	bool expect(const std::string& name, bool actual, bool expected) {
+		if (actual == expected) return true;
+
+		std::cerr << name << ": expected " << (expected ? "valid" : "invalid") << std::endl;
+		return false;
+	}
+
+	/**
+	 * Check the verification against the openssl signatures and modified signatures
+	 *
+	 * @return true if all checks passed
+	 */
+	bool checkVectors() {
+		for (const testVectors::ecdsaVector& vector : testVectors::p256Corpus) {
+			const secure_vector<byte> spki = hex::decode(vector.publicKey);
+			const secure_vector<byte> message = hex::decode(vector.message);
+			const secure_vector<byte> signature = hex::decode(vector.signature);
+			const ecPublicKey key = ecPublicKey::fromSubjectPublicKeyInfo(spki.data(), spki.size());
+
+			secure_vector<byte> tamperedMessage = message;
+			tamperedMessage[0] ^= 1u;
+			secure_vector<byte> tamperedSignature = signature;
+			tamperedSignature.back() ^= 1u;
+
+			// (r, n - s) is a valid signature as well
+			const secure_vector<byte> raw = toRaw(signature);
+			secure_vector<byte> negated = raw;
+			unsigned borrow = 0;
+			for (size_t i = 32; i-- > 0;) {
+				const int diff = (int)groupOrder[i] - raw[32 + i] - (int)borrow;
+				negated[32 + i] = (byte)diff;
+				borrow = diff < 0 ? 1 : 0;
+			}
+
+			secure_vector<byte> zeroS = raw;
+			std::fill(zeroS.begin() + 32, zeroS.end(), 0);
+			secure_vector<byte> orderS = raw;
+			std::copy(std::begin(groupOrder), std::end(groupOrder), orderS.begin() + 32);
+
+			if (!expect("DER signature", verify(key, message, signature), true) ||
+				!expect("raw signature", verify(key, message, raw), true) ||
+				!expect("negated s", verify(key, message, toDer(negated)), true) ||
+				!expect("tampered signature", verify(key, message, tamperedSignature), false) ||
+				!expect("tampered message", verify(key, tamperedMessage, signature), false) ||
+				!expect("s = 0", verify(key, message, zeroS), false) ||
+				!expect("s = n", verify(key, message, orderS), false) ||
+				!expect("truncated signature", verify(key, message,
+					secure_vector<byte>(signature.begin(), signature.end() - 1)), false)) {
+				return false;
+			}
+		}
+
+		// A point which is not on the curve must be rejected
+		secure_vector<byte> invalidKey = hex::decode(testVectors::p256PublicKey);
+		invalidKey.back() ^= 1u;
+		try {
+			(void)ecPublicKey::fromSubjectPublicKeyInfo(invalidKey.data(), invalidKey.size());
+			std::cerr << "A point which is not on the curve was accepted" << std::endl;
+			return false;
+		} catch (const std::invalid_argument&) {}
+
+		// Both key types must be selected from the algorithm identifier
+		const secure_vector<byte> ecSpki = hex::decode(testVectors::p256PublicKey);
+		const secure_vector<byte> ecChallenge = hex::decode(testVectors::p256Challenge);
+		const secure_vector<byte> ecSignature = hex::decode(testVectors::p256Signature);
+		const secure_vector<byte> rsaSpki = hex::decode(testVectors::rsa2048PublicKey);
+		const secure_vector<byte> rsaChallenge = hex::decode(testVectors::rsa2048Challenge);
+		const secure_vector<byte> rsaSignature = hex::decode(testVectors::rsa2048Signature);
+
+		return expect("EC key from the key cache", keyCache::shared().get(ecSpki.data(), ecSpki.size())->verifySha256(
+			ecChallenge.data(), ecChallenge.size(), ecSignature.data(), ecSignature.size()), true) &&
+			expect("RSA key from the key cache", keyCache::shared().get(rsaSpki.data(), rsaSpki.size())->verifySha256(
+				rsaChallenge.data(), rsaChallenge.size(), rsaSignature.data(), rsaSignature.size()), true) &&
+			expect("RSA signature with an EC key", passport::verifySignature(rsaChallenge, rsaSignature, ecSpki),
+				false);
+	}
+}
+
+int main() {
+	if (!checkVectors()) return 1;
+
+	const passport::signatureData ec = {
+		hex::decode(testVectors::p256Challenge),
+		hex::decode(testVectors::p256Signature),
+		hex::decode(testVectors::p256PublicKey),
+		{}
+	};
+	const passport::signatureData rsa = {
+		hex::decode(testVectors::rsa2048Challenge),
+		hex::decode(testVectors::rsa2048Signature),
+		hex::decode(testVectors::rsa2048PublicKey),
+		{}
+	};
+
+	if (!passport::verifySignature(ec.challenge, ec.signature, ec.publicKey)) {
+		std::cerr << "The P-256 test signature did not verify" << std::endl;
+		return 1;
+	}
+
+	benchmark::printRate("verifySignature, ECDSA P-256", benchmark::measure([&] {
+		benchmark::doNotOptimize(passport::verifySignature(ec.challenge, ec.signature, ec.publicKey));
+	}));
+	benchmark::printRate("verifySignature, RSA-2048", benchmark::measure([&] {
+		benchmark::doNotOptimize(passport::verifySignature(rsa.challenge, rsa.signature, rsa.publicKey));
+	}));
+	benchmark::printRate("verifySignature, P-256 key not cached", benchmark::measure([&] {
+		const ecPublicKey key = ecPublicKey::fromSubjectPublicKeyInfo(ec.publicKey.data(), ec.publicKey.size());
+		benchmark::doNotOptimize(key.verifyEcdsaSha256(ec.challenge.data(), ec.challenge.size(),
+			ec.signature.data(), ec.signature.size()));
+	}));
+	benchmark::printRate("verifySignature, RSA-2048 key not cached", benchmark::measure([&] {
+		const rsaPublicKey key = rsaPublicKey::fromSubjectPublicKeyInfo(rsa.publicKey.data(), rsa.publicKey.size());
+		benchmark::doNotOptimize(key.verifyPkcs1Sha256(rsa.challenge.data(), rsa.challenge.size(),
+			rsa.signature.data(), rsa.signature.size()));
+	}));
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,223 @@
+#include <string>
+#include <vector>
+#include <utility>
+#include <iostream>
+#include <functional>
+
+#include "Benchmark.hpp"
+#include "TestVectors.hpp"
+#include "HexCodec.hpp"
+#include "RsaSigner.hpp"
+#include "RsaVerifier.hpp"
+#include "Der.hpp"
+#include "VerificationEngine.hpp"
+
+using namespace nodeMsPassport;
+using namespace nodeMsPassport::crypto;
+
+namespace {
+	/**
+	 * A signature verified by every engine
+	 */
+	struct testCase {
+		std::string name;
+		passport::signatureData data;
+	};
+
+	bool expect(const std::string& engine, const std::string& name, bool actual, bool expected) {
+		if (actual == expected) return true;
+
+		std::cerr << engine << ": " << name << ": expected " << (expected ? "valid" : "invalid") << std::endl;
+		return false;
+	}
+
+	/**
+	 * Check the active engine against the openssl signatures,
+	 * with tampered messages and signatures and with invalid arguments
+	 *
+	 * @return true if all checks passed
+	 */
+	bool checkEngine(const std::string& engine) {
+		const auto verify = [](const secure_vector<byte>& message, const secure_vector<byte>& signature,
+			const secure_vector<byte>& key, const passport::signatureOptions& options) {
+			return passport::verifySignature(message, signature, key, options);
+		};
+
+		bool ok = true;
+		for (const testVectors::rsaVector& vector : testVectors::rsaCorpus) {
+			const secure_vector<byte> key = hex::decode(vector.publicKey);
+			const secure_vector<byte> message = hex::decode(vector.message);
+			const secure_vector<byte> signature = hex::decode(vector.signature);
+			passport::signatureOptions options;
+			options.padding = vector.padding;
+			options.hash = vector.hash;
+			options.saltLength = vector.saltLength;
+
+			secure_vector<byte> tamperedMessage = message;
+			tamperedMessage[0] ^= 1u;
+			secure_vector<byte> tamperedSignature = signature;
+			tamperedSignature[signature.size() / 2] ^= 1u;
+			passport::signatureOptions otherSalt = options;
+			otherSalt.saltLength = options.saltLength + 1;
+
+			ok &= expect(engine, "RSA signature", verify(message, signature, key, options), true) &&
+				expect(engine, "Tampered message", verify(tamperedMessage, signature, key, options), false) &&
+				expect(engine, "Tampered signature", verify(message, tamperedSignature, key, options), false);
+
+			if (vector.padding == passport::signaturePadding::pss) {
+				ok &= expect(engine, "Wrong salt length", verify(message, signature, key, otherSalt), false);
+			}
+		}
+
+		for (const testVectors::ecdsaVector& vector : testVectors::p256Corpus) {
+			const secure_vector<byte> key = hex::decode(vector.publicKey);
+			const secure_vector<byte> message = hex::decode(vector.message);
+			const secure_vector<byte> signature = hex::decode(vector.signature);
+
+			secure_vector<byte> tamperedMessage = message;
+			tamperedMessage.push_back(0);
+			secure_vector<byte> tamperedSignature = signature;
+			tamperedSignature[signature.size() - 1] ^= 1u;
+
+			ok &= expect(engine, "ECDSA signature", verify(message, signature, key, {}), true) &&
+				expect(engine, "Tampered message", verify(tamperedMessage, signature, key, {}), false) &&
+				expect(engine, "Tampered signature", verify(message, tamperedSignature, key, {}), false);
+		}
+
+		// Invalid keys and unsupported options must throw with every engine
+		secure_vector<byte> truncatedKey = hex::decode(testVectors::rsa2048PublicKey);
+		truncatedKey.pop_back();
+		passport::signatureOptions pss;
+		pss.padding = passport::signaturePadding::pss;
+
+		// With e = 1 the encoded message is a valid signature, anyone could create it
+		const secure_vector<byte> spki = hex::decode(testVectors::rsa2048PublicKey);
+		const der::span modulus = der::parseRsaPublicKey(der::parseSubjectPublicKeyInfo(der::span{
+			spki.data(), spki.size()})).modulus;
+		const secure_vector<byte> n(modulus.data, modulus.data + modulus.size);
+		const secure_vector<byte> exponentOne = der::encodeRsaPublicKey(n, {0x01});
+		const secure_vector<byte> evenExponent = der::encodeRsaPublicKey(n, {0x01, 0x00, 0x00});
+		const secure_vector<byte> largeExponent = der::encodeRsaPublicKey(n, {0x01, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x01});
+
+		const secure_vector<byte> challenge = hex::decode(testVectors::rsa2048Challenge);
+		secure_vector<byte> encoded(n.size());
+		encodePkcs1Sha256(sha256::hash(challenge.data(), challenge.size()), encoded.data(), encoded.size());
+
+		const std::pair<const char*, std::function<void()>> invalid[] = {
+			{"Truncated key", [&] {
+				(void)verify(hex::decode(testVectors::rsa2048Challenge), hex::decode(testVectors::rsa2048Signature),
+					truncatedKey, {});
+			}},
+			{"PSS with an EC key", [&] {
+				(void)verify(hex::decode(testVectors::p256Challenge), hex::decode(testVectors::p256Signature),
+					hex::decode(testVectors::p256PublicKey), pss);
+			}},
+			{"Public exponent 1", [&] {
+				(void)verify(challenge, encoded, exponentOne, {});
+			}},
+			{"Even public exponent", [&] {
+				(void)verify(challenge, hex::decode(testVectors::rsa2048Signature), evenExponent, {});
+			}},
+			{"Public exponent larger than 64 bits", [&] {
+				(void)verify(challenge, hex::decode(testVectors::rsa2048Signature), largeExponent, {});
+			}}
+		};
+
+		for (const auto& test : invalid) {
+			try {
+				test.second();
+				std::cerr << engine << ": " << test.first << " did not throw" << std::endl;
+				ok = false;
+			} catch (const passport::passportException&) {}
+		}
+
+		return ok;
+	}
+
+	/**
+	 * Create a PKCS1 SHA-256 signature with a generated key
+	 */
+	testCase generated(size_t bits) {
+		const rsaPrivateKey key = rsaPrivateKey::generate(bits);
+		const secure_vector<byte> challenge = hex::decode(testVectors::rsa2048Challenge);
+
+		return {"RSA-" + std::to_string(bits) + " PKCS1", {
+			challenge, key.signPkcs1Sha256(challenge.data(), challenge.size()), key.getPublicKey(), {}
+		}};
+	}
+
+	/**
+	 * Print the batch throughput and the latency of single calls
+	 */
+	void measure(const std::string& engine, const testCase& test) {
+		constexpr size_t batchSize = 256;
+		constexpr size_t samples = 1000;
+
+		const std::vector<passport::signatureData> batch(batchSize, test.data);
+		const double batchSeconds = benchmark::measure([&] {
+			benchmark::doNotOptimize(passport::verifySignatures(batch));
+		});
+
+		std::vector<double> latencies;
+		latencies.reserve(samples);
+		for (size_t i = 0; i < samples; i++) {
+			const auto start = benchmark::clock::now();
+			benchmark::doNotOptimize(passport::verifySignature(test.data.challenge, test.data.signature,
+				test.data.publicKey, test.data.options));
+			latencies.push_back(std::chrono::duration<double, std::micro>(benchmark::clock::now() - start).count());
+		}
+
+		printf("  %-8s %-22s %12.0f ops/s %10.3f us p50 %10.3f us p99\n", engine.c_str(), test.name.c_str(),
+			(double)batchSize / batchSeconds, benchmark::percentile(latencies, 0.5),
+			benchmark::percentile(latencies, 0.99));
+	}
+}
+
+int main() {
+	const std::vector<std::string> engines = verificationEngine::available();
+	std::cout << "Default engine: " << verificationEngine::active().name() << std::endl;
+	if (engines.size() == 1) {
+		std::cout << "Build with -DPASSPORT_WITH_OPENSSL=ON to compare against OpenSSL" << std::endl;
+	}
+
+	for (const std::string& engine : engines) {
+		if (!verificationEngine::setActive(engine) || !checkEngine(engine)) return 1;
+	}
+
+	std::vector<testCase> tests;
+	for (size_t bits : {2048, 3072, 4096}) {
+		tests.push_back(generated(bits));
+	}
+
+	passport::signatureOptions pss;
+	pss.padding = passport::signaturePadding::pss;
+	for (const testVectors::rsaVector& vector : testVectors::rsaCorpus) {
+		if (vector.publicKey != testVectors::rsaCorpusKey2048 || vector.padding != pss.padding ||
+			vector.hash != passport::hashAlgorithm::sha256) {
+			continue;
+		}
+
+		tests.push_back({"RSA-2048 PSS", {
+			hex::decode(vector.message), hex::decode(vector.signature), hex::decode(vector.publicKey), pss
+		}});
+		break;
+	}
+
+	tests.push_back({"P-256 ECDSA", {
+		hex::decode(testVectors::p256Challenge),
+		hex::decode(testVectors::p256Signature),
+		hex::decode(testVectors::p256PublicKey),
+		{}
+	}});
+
+	// Throughput of batches of one key and latency of single verifySignature calls
+	for (const testCase& test : tests) {
+		for (const std::string& engine : engines) {
+			(void)verificationEngine::setActive(engine);
+			measure(engine, test);
+		}
+	}
+
+	return 0;
+}
\ No newline at end of file
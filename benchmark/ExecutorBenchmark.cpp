@@ -0,0 +1,123 @@
+#include <mutex>
+#include <thread>
+#include <iostream>
+#include <condition_variable>
+
+#include "Benchmark.hpp"
+#include "TestVectors.hpp"
+#include "HexCodec.hpp"
+#include "ThreadPool.hpp"
+
+using namespace nodeMsPassport;
+
+namespace {
+	/**
+	 * Stands in for the thread-safe function: completed calls are queued
+	 * and picked up by a single thread, like the javascript thread would
+	 */
+	class completionQueue {
+	public:
+		void push(benchmark::clock::time_point start) {
+			std::unique_lock<std::mutex> lock(mtx);
+			completed.push_back(start);
+			lock.unlock();
+			cv.notify_one();
+		}
+
+		std::vector<benchmark::clock::time_point> wait() {
+			std::unique_lock<std::mutex> lock(mtx);
+			cv.wait(lock, [this] {
+				return !completed.empty();
+			});
+
+			return std::move(completed);
+		}
+
+	private:
+		std::mutex mtx;
+		std::condition_variable cv;
+		std::vector<benchmark::clock::time_point> completed;
+	};
+
+	struct result {
+		double opsPerSecond;
+		double p99Micros;
+	};
+
+	/**
+	 * Keep a number of calls in flight until total calls completed
+	 *
+	 * @param inFlight the number of concurrent calls
+	 * @param total the number of calls to run
+	 * @param submit starts a call, which must push its start time to the queue when it finished
+	 * @return the throughput and the 99th percentile of the latency
+	 */
+	template<class Submit>
+	result run(size_t inFlight, size_t total, Submit&& submit) {
+		completionQueue queue;
+		std::vector<double> latencies;
+		latencies.reserve(total);
+
+		const auto start = benchmark::clock::now();
+		size_t submitted = 0;
+		for (; submitted < std::min(inFlight, total); submitted++) {
+			submit(queue, benchmark::clock::now());
+		}
+
+		while (latencies.size() < total) {
+			for (const benchmark::clock::time_point& callStart : queue.wait()) {
+				const auto now = benchmark::clock::now();
+				latencies.push_back(std::chrono::duration<double, std::micro>(now - callStart).count());
+				if (submitted < total) {
+					submit(queue, now);
+					submitted++;
+				}
+			}
+		}
+
+		const double elapsed = std::chrono::duration<double>(benchmark::clock::now() - start).count();
+		return {(double)total / elapsed, benchmark::percentile(latencies, 0.99)};
+	}
+
+	void print(const std::string& name, const result& res) {
+		printf("  %-38s %12.0f ops/s %12.1f us p99\n", name.c_str(), res.opsPerSecond, res.p99Micros);
+	}
+}
+
+int main() {
+	const passport::signatureData data = {
+		hex::decode(testVectors::rsa2048Challenge),
+		hex::decode(testVectors::rsa2048Signature),
+		hex::decode(testVectors::rsa2048PublicKey),
+		{}
+	};
+
+	// The work of a single asynchronous call
+	const auto call = [&data] {
+		benchmark::doNotOptimize(passport::verifySignature(data.challenge, data.signature, data.publicKey));
+	};
+	call();
+
+	std::cout << "Thread pool size: " << util::threadPool::shared().size() << std::endl;
+	for (size_t inFlight : {1, 100, 10000}) {
+		const size_t total = std::max<size_t>(2000, inFlight * 2);
+		std::cout << "In-flight calls: " << inFlight << std::endl;
+
+		// One thread per call, like the napi_tools promises
+		print("thread per call", run(inFlight, total, [&call](completionQueue& queue, benchmark::clock::time_point start) {
+			std::thread([&call, &queue, start] {
+				call();
+				queue.push(start);
+			}).detach();
+		}));
+
+		print("shared thread pool", run(inFlight, total, [&call](completionQueue& queue, benchmark::clock::time_point start) {
+			util::threadPool::shared().submit([&call, &queue, start] {
+				call();
+				queue.push(start);
+			});
+		}));
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+#include <sstream>
+#include <random>
+#include <cctype>
+#include <iostream>
+
+#include "Benchmark.hpp"
+#include "HexCodec.hpp"
+
+using namespace nodeMsPassport;
+
+/**
+ * The string_to_binary implementation previously used by msPassport.cpp
+ */
+secure_vector<byte> legacy_string_to_binary(const std::string& source) {
+	static unsigned int nibbles[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 0, 0, 0, 0, 0, 0, 0, 10, 11, 12, 13, 14, 15 };
+	secure_vector<byte> retval;
+	for (std::string::const_iterator it = source.begin(); it < source.end(); it += 2) {
+		unsigned char v;
+		if (isxdigit(*it))
+			v = nibbles[toupper(*it) - '0'] << (unsigned)4;
+		else
+			throw std::runtime_error("Invalid character");
+		if (it + 1 < source.end() && isxdigit(*(it + 1)))
+			v += nibbles[toupper(*(it + 1)) - '0'];
+		retval.push_back(v);
+	}
+	return retval;
+}
+
+/**
+ * The binary_to_string implementation previously used by msPassport.cpp
+ */
+std::string legacy_binary_to_string(const secure_vector<byte>& source) {
+	static char syms[] = "0123456789ABCDEF";
+	std::stringstream ss;
+	for (byte it : source)
+		ss << syms[(((unsigned)it >> (unsigned)4) & (unsigned)0xf)] << syms[(unsigned)it & (unsigned)0xf];
+
+	return ss.str();
+}
+
+int main() {
+	std::mt19937 rng(42);
+	std::uniform_int_distribution<> dist(0, 255);
+
+	// Challenge, signature, public key and a large buffer
+	for (size_t size : {32, 256, 294, 65536}) {
+		secure_vector<byte> data(size);
+		for (byte& b : data) b = (byte)dist(rng);
+		const std::string encoded = hex::encode(data);
+
+		std::cout << "Payload size: " << size << " bytes" << std::endl;
+		benchmark::printThroughput("  legacy binary_to_string", size, benchmark::measure([&] {
+			benchmark::doNotOptimize(legacy_binary_to_string(data));
+		}));
+		benchmark::printThroughput("  legacy string_to_binary", size, benchmark::measure([&] {
+			benchmark::doNotOptimize(legacy_string_to_binary(encoded));
+		}));
+
+		for (hex::implementation impl : {hex::implementation::scalar, hex::implementation::sse2,
+										 hex::implementation::avx2}) {
+			if (!hex::setImplementation(impl)) continue;
+			const std::string name = hex::implementationName(impl);
+
+			if (hex::encode(data) != encoded || hex::decode(encoded) != data) {
+				std::cerr << "The " << name << " implementation produced a wrong result" << std::endl;
+				return 1;
+			}
+
+			// Into presized buffers
+			std::string encodeOut(encoded.size(), '\0');
+			secure_vector<byte> decodeOut(size);
+			benchmark::printThroughput("  " + name + " encode", size, benchmark::measure([&] {
+				hex::encode(data.data(), data.size(), &encodeOut[0]);
+				benchmark::doNotOptimize(encodeOut);
+			}));
+			benchmark::printThroughput("  " + name + " decode", size, benchmark::measure([&] {
+				hex::decode(encoded.data(), encoded.size(), decodeOut.data());
+				benchmark::doNotOptimize(decodeOut);
+			}));
+
+			// Including the allocation of the result
+			benchmark::printThroughput("  " + name + " encode (allocating)", size, benchmark::measure([&] {
+				benchmark::doNotOptimize(hex::encode(data));
+			}));
+			benchmark::printThroughput("  " + name + " decode (allocating)", size, benchmark::measure([&] {
+				benchmark::doNotOptimize(hex::decode(encoded));
+			}));
+		}
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include <random>
+#include <string>
+#include <vector>
+#include <iostream>
+
+#include "Benchmark.hpp"
+#include "BigInt.hpp"
+#include "RsaPublicOperation.hpp"
+
+using namespace nodeMsPassport;
+using namespace nodeMsPassport::crypto;
+
+namespace {
+	using implementation = rsaPublicOperation::implementation;
+
+	std::vector<byte> randomBytes(std::mt19937_64& rng, size_t len) {
+		std::vector<byte> res(len);
+		for (byte& b : res) b = (byte)rng();
+		return res;
+	}
+
+	/**
+	 * Get the kernels supported by this cpu
+	 */
+	std::vector<implementation> supportedImplementations() {
+		std::vector<implementation> res;
+		for (implementation impl : {implementation::portable, implementation::bmi2Adx}) {
+			if (rsaPublicOperation::setImplementation(impl)) res.push_back(impl);
+		}
+
+		return res;
+	}
+
+	/**
+	 * Check every fixed size kernel against montgomeryContext::modExp
+	 *
+	 * @return true if all results match
+	 */
+	bool checkFixedSize(std::mt19937_64& rng, size_t bits, const std::vector<implementation>& impls) {
+		const size_t len = bits / 8;
+		std::vector<byte> modulus = randomBytes(rng, len);
+		modulus.front() |= 0x80u;
+		modulus.back() |= 1u;
+		const montgomeryContext context(modulus.data(), modulus.size());
+
+		std::vector<byte> longExponent = randomBytes(rng, 4);
+		longExponent.front() |= 0x80u;
+		longExponent.back() |= 1u;
+		const std::vector<std::vector<byte>> exponents = {{0x01, 0x00, 0x01}, {0x03}, longExponent};
+
+		for (const std::vector<byte>& exponent : exponents) {
+			const auto op = rsaPublicOperation::create(modulus.data(), modulus.size(), exponent.data(), exponent.size());
+			if (!op->isFixedSize() || op->bits() != bits) {
+				std::cerr << bits << " bit modulus: the fixed size implementation was not used" << std::endl;
+				return false;
+			}
+
+			std::vector<byte> expected(len), actual(len);
+			for (int i = 0; i < 8; i++) {
+				std::vector<byte> base = randomBytes(rng, len);
+				base.front() &= 0x7fu;
+				bigintToBytes(context.modExp(bigintFromBytes(base.data(), len, context.limbs()), exponent.data(),
+					exponent.size()), expected.data(), len);
+
+				for (implementation impl : impls) {
+					rsaPublicOperation::setImplementation(impl);
+					if (!op->apply(base.data(), actual.data()) || actual != expected) {
+						std::cerr << bits << " bit modulus: wrong result of the "
+								  << rsaPublicOperation::implementationName(impl) << " kernel" << std::endl;
+						return false;
+					}
+				}
+			}
+
+			if (op->apply(modulus.data(), actual.data())) {
+				std::cerr << bits << " bit modulus: an input equal to the modulus was accepted" << std::endl;
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/**
+	 * Measure e = 65537 with the generic implementation and every fixed size kernel
+	 */
+	void measureSize(std::mt19937_64& rng, size_t bits, const std::vector<implementation>& impls) {
+		const size_t len = bits / 8;
+		std::vector<byte> modulus = randomBytes(rng, len);
+		modulus.front() |= 0x80u;
+		modulus.back() |= 1u;
+		std::vector<byte> base = randomBytes(rng, len);
+		base.front() &= 0x7fu;
+		const byte exponent[] = {0x01, 0x00, 0x01};
+
+		const std::string prefix = "RSA-" + std::to_string(bits) + " e=65537 ";
+		const montgomeryContext context(modulus.data(), modulus.size());
+		const bigint s = bigintFromBytes(base.data(), len, context.limbs());
+		const auto generic = [&] {
+			benchmark::doNotOptimize(context.modExp(s, exponent, sizeof(exponent)));
+		};
+		double seconds = benchmark::measure(generic);
+		benchmark::printCycles(prefix + "generic", seconds,
+			benchmark::measureCycles(generic, (size_t)(0.2 / seconds) + 1));
+
+		const auto op = rsaPublicOperation::create(modulus.data(), modulus.size(), exponent, sizeof(exponent));
+		std::vector<byte> out(len);
+		const auto fixed = [&] {
+			benchmark::doNotOptimize(op->apply(base.data(), out.data()));
+		};
+		for (implementation impl : impls) {
+			rsaPublicOperation::setImplementation(impl);
+			seconds = benchmark::measure(fixed);
+			benchmark::printCycles(prefix + rsaPublicOperation::implementationName(impl), seconds,
+				benchmark::measureCycles(fixed, (size_t)(0.2 / seconds) + 1));
+		}
+	}
+}
+
+int main() {
+	std::mt19937_64 rng(0x5eed);
+	const std::vector<implementation> impls = supportedImplementations();
+
+	for (size_t bits : {2048, 3072, 4096}) {
+		if (!checkFixedSize(rng, bits, impls)) return 1;
+	}
+
+	// Other sizes must use the generic implementation
+	std::vector<byte> modulus = randomBytes(rng, 257);
+	modulus.front() |= 0x80u;
+	modulus.back() |= 1u;
+	const byte exponent[] = {0x01, 0x00, 0x01};
+	if (rsaPublicOperation::create(modulus.data(), modulus.size(), exponent, sizeof(exponent))->isFixedSize()) {
+		std::cerr << "A 2056 bit modulus used a fixed size implementation" << std::endl;
+		return 1;
+	}
+
+	for (size_t bits : {2048, 3072, 4096}) {
+		measureSize(rng, bits, impls);
+	}
+
+	return 0;
+}
\ No newline at end of file
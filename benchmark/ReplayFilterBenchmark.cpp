@@ -0,0 +1,141 @@
+#include <atomic>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <iostream>
+
+#include "Benchmark.hpp"
+#include "ReplayFilter.hpp"
+
+using namespace nodeMsPassport;
+using namespace nodeMsPassport::crypto;
+
+namespace {
+	using result = replayFilter::result;
+
+	bool expect(const std::string& name, result actual, result expected) {
+		if (actual == expected) return true;
+
+		std::cerr << name << " returned " << (int)actual << ", expected " << (int)expected << std::endl;
+		return false;
+	}
+
+	/**
+	 * Check duplicate detection, expiry and the size bound
+	 *
+	 * @return true if all checks passed
+	 */
+	bool checkFilter() {
+		bool ok = true;
+		const uint64_t start = 1000000;
+
+		replayFilter filter(7000, 1000, 4);
+		ok &= expect("A new challenge", filter.insertFingerprint(1, start), result::inserted);
+		ok &= expect("A replayed challenge", filter.insertFingerprint(1, start), result::duplicate);
+		ok &= expect("A replay before the ttl", filter.insertFingerprint(1, start + filter.ttl() - 1),
+			result::duplicate);
+
+		// At most one bucket width after the ttl the challenge is forgotten
+		const uint64_t expired = start + filter.ttl() + filter.ttl() / 7 + 1;
+		ok &= expect("A replay after the ttl", filter.insertFingerprint(1, expired), result::inserted);
+
+		const byte challenge[] = {1, 2, 3, 4};
+		ok &= expect("A challenge", filter.insert(challenge, sizeof(challenge), expired), result::inserted);
+		ok &= expect("The same challenge", filter.insert(challenge, sizeof(challenge), expired), result::duplicate);
+
+		// Fill one shard, the shard is selected by the upper 32 bits
+		replayFilter small(7000, 4, 1);
+		for (uint64_t i = 0; i < 4; i++) {
+			ok &= expect("Filling the filter", small.insertFingerprint(i + 1, start), result::inserted);
+		}
+		ok &= expect("A full filter", small.insertFingerprint(5, start), result::full);
+		ok &= expect("A replay into a full filter", small.insertFingerprint(1, start), result::duplicate);
+		ok &= expect("A full filter after the ttl", small.insertFingerprint(5, expired), result::inserted);
+
+		const replayFilter::statistics stats = small.getStatistics();
+		if (stats.size != 1 || stats.rejected != 1 || stats.duplicates != 1 || stats.memory > 16 * sizeof(uint64_t)) {
+			std::cerr << "The expired entries were not released" << std::endl;
+			ok = false;
+		}
+
+		return ok;
+	}
+
+	/**
+	 * Check that concurrent inserts of the same challenges succeed exactly once
+	 *
+	 * @return true if every challenge was inserted once
+	 */
+	bool checkConcurrentInserts() {
+		constexpr size_t threads = 4;
+		constexpr uint64_t count = 100000;
+
+		replayFilter filter;
+		std::atomic<uint64_t> inserted(0);
+		std::vector<std::thread> inserters;
+		for (size_t t = 0; t < threads; t++) {
+			inserters.emplace_back([&filter, &inserted] {
+				const uint64_t now = replayFilter::now();
+				for (uint64_t i = 1; i <= count; i++) {
+					if (filter.insertFingerprint(i * 0x9E3779B97F4A7C15ull, now) == result::inserted) inserted++;
+				}
+			});
+		}
+
+		for (std::thread& t : inserters) t.join();
+		return inserted == count && filter.getStatistics().duplicates == count * (threads - 1);
+	}
+
+	void print(const std::string& name, std::vector<double> latencies) {
+		printf("  %-30s %8.3f us p50 %8.3f us p99 %8.3f us p99.9\n", name.c_str(),
+			benchmark::percentile(latencies, 0.5), benchmark::percentile(latencies, 0.99),
+			benchmark::percentile(latencies, 0.999));
+	}
+}
+
+int main() {
+	if (!checkFilter()) {
+		return 1;
+	} else if (!checkConcurrentInserts()) {
+		std::cerr << "A challenge was consumed more than once" << std::endl;
+		return 1;
+	}
+
+	std::cout << "The replay filter passed all checks" << std::endl;
+
+	std::mt19937_64 rng(42);
+	for (size_t entries : {1000000, 4000000}) {
+		replayFilter filter(replayFilter::defaultTtl, entries * 2);
+		std::vector<uint64_t> fingerprints(entries);
+		for (uint64_t& fp : fingerprints) fp = rng();
+
+		std::vector<double> inserts, replays;
+		inserts.reserve(entries);
+		replays.reserve(entries);
+
+		const uint64_t now = replayFilter::now();
+		for (uint64_t fp : fingerprints) {
+			const auto start = benchmark::clock::now();
+			benchmark::doNotOptimize(filter.insertFingerprint(fp, now));
+			inserts.push_back(std::chrono::duration<double, std::micro>(benchmark::clock::now() - start).count());
+		}
+
+		for (uint64_t fp : fingerprints) {
+			const auto start = benchmark::clock::now();
+			benchmark::doNotOptimize(filter.insertFingerprint(fp, now));
+			replays.push_back(std::chrono::duration<double, std::micro>(benchmark::clock::now() - start).count());
+		}
+
+		const replayFilter::statistics stats = filter.getStatistics();
+		std::cout << entries << " challenges, " << stats.memory / (1024 * 1024) << " MiB" << std::endl;
+		print("insert", inserts);
+		print("replay", replays);
+		if (stats.size != entries || stats.duplicates != entries) {
+			std::cerr << "Challenges were lost or rejected" << std::endl;
+			return 1;
+		}
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,170 @@
+#include <string>
+#include <vector>
+#include <iostream>
+
+#include "Benchmark.hpp"
+#include "TestVectors.hpp"
+#include "HexCodec.hpp"
+#include "RsaVerifier.hpp"
+#include "Digest.hpp"
+
+using namespace nodeMsPassport;
+using namespace nodeMsPassport::crypto;
+
+namespace {
+	bool expect(const std::string& name, bool actual, bool expected) {
+		if (actual == expected) return true;
+
+		std::cerr << name << ": expected " << (expected ? "valid" : "invalid") << std::endl;
+		return false;
+	}
+
+	/**
+	 * Check SHA-384 and SHA-512 against the openssl hashes,
+	 * in one call and fed byte by byte
+	 *
+	 * @return true if all checks passed
+	 */
+	bool checkHashes() {
+		for (const testVectors::hashVector& vector : testVectors::sha512Corpus) {
+			const std::string message = vector.message;
+			const byte* data = reinterpret_cast<const byte*>(message.data());
+
+			const sha384::digest h384 = sha384::hash(data, message.size());
+			const sha512::digest h512 = sha512::hash(data, message.size());
+			sha512 chunked;
+			for (size_t i = 0; i < message.size(); i++) chunked.update(data + i, 1);
+
+			if (secure_vector<byte>(h384.begin(), h384.end()) != hex::decode(vector.sha384) ||
+				secure_vector<byte>(h512.begin(), h512.end()) != hex::decode(vector.sha512) ||
+				chunked.finish() != h512) {
+				std::cerr << "Wrong hash of \"" << message << '"' << std::endl;
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/**
+	 * Check the verification against the openssl signatures and with mismatching options
+	 *
+	 * @return true if all checks passed
+	 */
+	bool checkVectors() {
+		bool ok = true;
+		for (const testVectors::rsaVector& vector : testVectors::rsaCorpus) {
+			const secure_vector<byte> spki = hex::decode(vector.publicKey);
+			const secure_vector<byte> message = hex::decode(vector.message);
+			const secure_vector<byte> signature = hex::decode(vector.signature);
+			const rsaPublicKey key = rsaPublicKey::fromSubjectPublicKeyInfo(spki.data(), spki.size());
+
+			const auto verify = [&](const secure_vector<byte>& m, const secure_vector<byte>& s,
+				const passport::signatureOptions& options) {
+				return key.verify(m.data(), m.size(), s.data(), s.size(), options);
+			};
+
+			passport::signatureOptions options;
+			options.padding = vector.padding;
+			options.hash = vector.hash;
+			options.saltLength = vector.saltLength;
+
+			secure_vector<byte> tamperedMessage = message;
+			tamperedMessage[0] ^= 1u;
+			secure_vector<byte> tamperedSignature = signature;
+			tamperedSignature[signature.size() / 2] ^= 1u;
+
+			passport::signatureOptions otherHash = options;
+			otherHash.hash = options.hash == hashAlgorithm::sha256 ? hashAlgorithm::sha512 : hashAlgorithm::sha256;
+			passport::signatureOptions otherPadding = options;
+			otherPadding.padding = options.padding == passport::signaturePadding::pss ?
+				passport::signaturePadding::pkcs1 : passport::signaturePadding::pss;
+
+			ok &= expect("Valid signature", verify(message, signature, options), true) &&
+				expect("Tampered message", verify(tamperedMessage, signature, options), false) &&
+				expect("Tampered signature", verify(message, tamperedSignature, options), false) &&
+				expect("Wrong hash", verify(message, signature, otherHash), false) &&
+				expect("Wrong padding", verify(message, signature, otherPadding), false);
+
+			if (vector.padding == passport::signaturePadding::pss) {
+				passport::signatureOptions anySalt = options;
+				anySalt.saltLength = passport::signatureOptions::saltLengthAuto;
+				passport::signatureOptions otherSalt = options;
+				otherSalt.saltLength = options.saltLength + 1;
+
+				ok &= expect("Automatic salt length", verify(message, signature, anySalt), true) &&
+					expect("Wrong salt length", verify(message, signature, otherSalt), false);
+			}
+		}
+
+		return ok;
+	}
+
+	/**
+	 * Check PSS options through the public api, in a mixed batch and with an EC key
+	 *
+	 * @return true if all checks passed
+	 */
+	bool checkPassportApi() {
+		std::vector<passport::signatureData> batch;
+		for (const testVectors::rsaVector& vector : testVectors::rsaCorpus) {
+			passport::signatureOptions options;
+			options.padding = vector.padding;
+			options.hash = vector.hash;
+			batch.push_back({hex::decode(vector.message), hex::decode(vector.signature),
+				hex::decode(vector.publicKey), options});
+		}
+
+		const std::vector<bool> results = passport::verifySignatures(batch);
+		for (bool result : results) {
+			if (!expect("Batch entry", result, true)) return false;
+		}
+
+		passport::signatureOptions pss;
+		pss.padding = passport::signaturePadding::pss;
+		try {
+			(void)passport::verifySignature(hex::decode(testVectors::p256Challenge),
+				hex::decode(testVectors::p256Signature), hex::decode(testVectors::p256PublicKey), pss);
+			std::cerr << "PSS options with an EC key did not throw" << std::endl;
+			return false;
+		} catch (const passport::passportException&) {
+			return true;
+		}
+	}
+}
+
+int main() {
+	if (!checkHashes() || !checkVectors() || !checkPassportApi()) return 1;
+
+	const passport::signatureData reference = {
+		hex::decode(testVectors::rsa2048Challenge),
+		hex::decode(testVectors::rsa2048Signature),
+		hex::decode(testVectors::rsa2048PublicKey),
+		{}
+	};
+	benchmark::printRate("verifySignature, PKCS1 SHA-256", benchmark::measure([&] {
+		benchmark::doNotOptimize(passport::verifySignature(reference.challenge, reference.signature,
+			reference.publicKey));
+	}));
+
+	const secure_vector<byte> publicKey = hex::decode(testVectors::rsaCorpusKey2048);
+	for (const testVectors::rsaVector& vector : testVectors::rsaCorpus) {
+		if (vector.publicKey != testVectors::rsaCorpusKey2048) continue;
+
+		const secure_buffer message = hex::decode(vector.message);
+		const secure_buffer signature = hex::decode(vector.signature);
+		passport::signatureOptions options;
+		options.padding = vector.padding;
+		options.hash = vector.hash;
+
+		const std::string name = std::string("verifySignature, ") +
+			(vector.padding == passport::signaturePadding::pss ? "PSS " : "PKCS1 ") +
+			(vector.hash == hashAlgorithm::sha256 ? "SHA-256" : vector.hash == hashAlgorithm::sha384 ? "SHA-384" :
+				"SHA-512");
+		benchmark::printRate(name, benchmark::measure([&] {
+			benchmark::doNotOptimize(passport::verifySignature(message, signature, publicKey, options));
+		}));
+	}
+
+	return 0;
+}
\ No newline at end of file
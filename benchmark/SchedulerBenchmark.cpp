@@ -0,0 +1,134 @@
+#include <atomic>
+#include <iostream>
+
+#include "Benchmark.hpp"
+#include "TestVectors.hpp"
+#include "HexCodec.hpp"
+#include "Scheduler.hpp"
+#include "Backend.hpp"
+
+using namespace nodeMsPassport;
+
+namespace {
+	constexpr auto promptTime = std::chrono::milliseconds(500);
+	constexpr size_t prompts = 4;
+
+	/**
+	 * A stand-in for windows hello, every sign
+	 * call waits for the user to answer a prompt
+	 */
+	class promptBackend : public passport::backend {
+	public:
+		const char* name() const noexcept override {
+			return "prompt";
+		}
+
+		bool interactive() const noexcept override {
+			return true;
+		}
+
+		bool available() override {
+			return true;
+		}
+
+		void create(const std::string&) override {}
+
+		bool open(const std::string&) override {
+			return true;
+		}
+
+		secure_buffer sign(const std::string&, const secure_buffer& challenge) override {
+			std::this_thread::sleep_for(promptTime);
+			return challenge;
+		}
+
+		secure_vector<byte> getPublicKey(const std::string&) override {
+			return secure_vector<byte>();
+		}
+
+		void remove(const std::string&) override {}
+	};
+
+	/**
+	 * Measure the verification throughput while prompts are pending
+	 *
+	 * @param pool the pool running the verifications
+	 * @param submitPrompt starts a prompt, which must decrement the counter when it finished
+	 * @param numPrompts the number of prompts to start
+	 * @return the number of verifications per second
+	 */
+	template<class Submit>
+	double verifyRate(util::threadPool& pool, Submit&& submitPrompt, size_t numPrompts) {
+		const passport::signatureData data = {
+			hex::decode(testVectors::rsa2048Challenge),
+			hex::decode(testVectors::rsa2048Signature),
+			hex::decode(testVectors::rsa2048PublicKey),
+			{}
+		};
+
+		std::atomic<size_t> promptsLeft(numPrompts);
+		for (size_t i = 0; i < numPrompts; i++) {
+			submitPrompt(promptsLeft);
+		}
+
+		// Keep a few verifications in flight for one prompt time
+		std::atomic<size_t> completed(0), inFlight(0);
+		const auto end = benchmark::clock::now() + promptTime;
+		while (benchmark::clock::now() < end) {
+			if (inFlight.load() >= 16) {
+				std::this_thread::yield();
+				continue;
+			}
+
+			inFlight++;
+			pool.submit([&] {
+				benchmark::doNotOptimize(passport::verifySignature(data.challenge, data.signature, data.publicKey));
+				completed++;
+				inFlight--;
+			});
+		}
+
+		const size_t res = completed.load();
+		while (inFlight.load() > 0 || promptsLeft.load() > 0) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		return (double)res / std::chrono::duration<double>(promptTime).count();
+	}
+}
+
+int main() {
+	passport::setBackend(std::make_shared<promptBackend>());
+	const secure_buffer challenge(32, 0);
+	const auto prompt = [&challenge](std::atomic<size_t>& left) {
+		return [&challenge, &left] {
+			benchmark::doNotOptimize(passport::passportSign("user", challenge));
+			left--;
+		};
+	};
+
+	util::threadPool pool;
+	util::scheduler lanes(pool);
+	std::cout << "Thread pool size: " << pool.size() << ", " << prompts << " prompts of "
+	          << promptTime.count() << "ms" << std::endl;
+
+	const double idle = verifyRate(pool, [](std::atomic<size_t>&) {}, 0);
+	const double shared = verifyRate(pool, [&](std::atomic<size_t>& left) {
+		pool.submit(prompt(left));
+	}, prompts);
+	const double separate = verifyRate(pool, [&](std::atomic<size_t>& left) {
+		lanes.submit(util::lane::interactive, prompt(left));
+	}, prompts);
+
+	printf("%-40s %12.0f ops/s\n", "verifySignature, no prompts", idle);
+	printf("%-40s %12.0f ops/s\n", "verifySignature, prompts on the pool", shared);
+	printf("%-40s %12.0f ops/s\n", "verifySignature, interactive lane", separate);
+
+	// The interactive lane must not take threads away from the verification
+	if (separate < idle / 2) {
+		std::cerr << "Pending prompts starved the compute lane" << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,187 @@
+#include <iostream>
+#include <optional>
+
+#include "Benchmark.hpp"
+#include "NodeMsPassport.hpp"
+
+using namespace nodeMsPassport;
+
+namespace {
+	// Long enough to never fit into the small string buffer
+	const char16_t* password = u"correct horse battery staple, but a lot longer than that";
+
+	/**
+	 * Count the secure allocations made by a function
+	 *
+	 * @param fn the function to run
+	 * @return the number of secure allocations
+	 */
+	template<class Fn>
+	size_t countAllocations(Fn&& fn) {
+		const size_t before = util::secureAllocationCount();
+		fn();
+		return util::secureAllocationCount() - before;
+	}
+
+	/**
+	 * Stands in for the promise task, which stores the function and its result
+	 */
+	template<class T, class Fn>
+	std::optional<T> runTask(Fn&& fn) {
+		std::decay_t<Fn> stored(std::forward<Fn>(fn));
+		std::optional<T> result;
+		result = stored();
+
+		return result;
+	}
+
+	/**
+	 * Stands in for an in-place transformation like protectCredential,
+	 * which replaces the secret with a new buffer holding the result
+	 */
+	void transform(secure_u16string& data) {
+		secure_u16string out(data.size() + 8, u'\0');
+		std::copy(data.begin(), data.end(), out.begin());
+		data = std::move(out);
+	}
+
+	/**
+	 * The path a password took through writeCredential before
+	 * secrets were owned: every step made its own copy
+	 */
+	size_t copyingPipeline(const secure_u16string& input) {
+		const secure_u16string captured = input;
+		auto task = [captured] {
+			secure_u16string pass = captured;
+			secure_vector<char16_t> toProtect(pass.begin(), pass.end());
+			toProtect = secure_vector<char16_t>(pass.begin(), pass.end());
+			transform(pass);
+			secure_vector<byte> blob(pass.size() * sizeof(char16_t));
+			std::copy_n(reinterpret_cast<const byte*>(pass.data()), blob.size(), blob.begin());
+			return blob.size() + toProtect.size();
+		};
+
+		return *runTask<size_t>(task);
+	}
+
+	/**
+	 * The same path with an owned secret, which is moved
+	 * through every step and transformed in place
+	 */
+	size_t owningPipeline(secret_u16string input) {
+		auto task = [captured = std::move(input)]() mutable {
+			secret_u16string pass = std::move(captured);
+			transform(*pass);
+			return pass->size() * sizeof(char16_t);
+		};
+
+		return *runTask<size_t>(std::move(task));
+	}
+
+	/**
+	 * Check a number of allocations
+	 *
+	 * @param what the operation that was counted
+	 * @param count the number of allocations made
+	 * @param expected the expected number of allocations
+	 * @return true if the count matches
+	 */
+	bool expect(const char* what, size_t count, size_t expected) {
+		if (count == expected) return true;
+
+		std::cerr << what << " made " << count << " secure allocations, expected " << expected << std::endl;
+		return false;
+	}
+
+	/**
+	 * Check how often secrets are copied
+	 *
+	 * @return true if all checks passed
+	 */
+	bool checkCopies() {
+		bool ok = true;
+
+		secret_u16string secret;
+		ok &= expect("Creating a secret", countAllocations([&] {
+			secret = secret_u16string(secure_u16string(password));
+		}), 1);
+
+		ok &= expect("Moving a secret through a task", countAllocations([&] {
+			auto res = runTask<secret_u16string>([captured = std::move(secret)]() mutable {
+				return std::move(captured);
+			});
+			secret = std::move(*res);
+		}), 0);
+
+		ok &= expect("Cloning a secret", countAllocations([&] {
+			const secret_u16string copy = secret.clone();
+			benchmark::doNotOptimize(copy);
+		}), 1);
+
+		// Only the result of the transformation is allocated
+		ok &= expect("The owning pipeline", countAllocations([&] {
+			benchmark::doNotOptimize(owningPipeline(std::move(secret)));
+		}), 1);
+
+		ok &= expect("Passing a signature", countAllocations([&] {
+			const secure_buffer signature(256, 0xAA);
+			auto res = runTask<secure_buffer>([signature] {
+				return signature;
+			});
+			benchmark::doNotOptimize(res);
+		}), 0);
+
+#ifdef _WIN32
+		const std::wstring target = L"node-ms-passport-copy-test";
+		for (bool encrypt : {false, true}) {
+			// Protecting the password allocates the encrypted password
+			secret = secret_u16string(secure_u16string(password));
+			ok &= expect(encrypt ? "An encrypted credentials::write" : "credentials::write", countAllocations([&] {
+				if (!credentials::write(target, L"user", std::move(secret), encrypt)) {
+					std::cerr << "Could not write the credential" << std::endl;
+				}
+			}), encrypt ? 1 : 0);
+
+			// The password is copied out of the storage, decrypting it allocates the decrypted password
+			std::wstring user;
+			ok &= expect(encrypt ? "An encrypted credentials::read" : "credentials::read", countAllocations([&] {
+				if (!credentials::read(target, user, secret, encrypt)) {
+					std::cerr << "Could not read the credential" << std::endl;
+				}
+			}), encrypt ? 2 : 1);
+
+			if (*secret != password) {
+				std::cerr << "The read password does not match" << std::endl;
+				ok = false;
+			}
+		}
+
+		credentials::remove(target);
+#endif
+
+		return ok;
+	}
+}
+
+int main() {
+	if (!checkCopies()) return 1;
+	std::cout << "Secrets are not copied" << std::endl;
+
+	const secure_u16string input(password);
+	std::cout << "Secure allocations per password" << std::endl;
+	std::cout << "  copying pipeline: " << countAllocations([&] {
+		copyingPipeline(input);
+	}) << std::endl;
+	std::cout << "  owning pipeline: " << countAllocations([&] {
+		owningPipeline(secret_u16string(secure_u16string(input)));
+	}) << std::endl;
+
+	benchmark::printRate("  copying pipeline", benchmark::measure([&] {
+		benchmark::doNotOptimize(copyingPipeline(input));
+	}));
+	benchmark::printRate("  owning pipeline", benchmark::measure([&] {
+		benchmark::doNotOptimize(owningPipeline(secret_u16string(secure_u16string(input))));
+	}));
+
+	return 0;
+}
\ No newline at end of file
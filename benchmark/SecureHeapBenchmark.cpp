@@ -0,0 +1,81 @@
+#include <iostream>
+
+#include "Benchmark.hpp"
+#include "NodeMsPassport.hpp"
+
+using namespace nodeMsPassport;
+
+/**
+ * The allocation previously used by zallocator
+ */
+void* legacyAllocate(size_t size) {
+	return ::operator new(size);
+}
+
+/**
+ * The deallocation previously used by zallocator
+ */
+void legacyDeallocate(void* ptr, size_t size) {
+	std::fill_n((volatile char*)ptr, size, 0);
+	::operator delete(ptr);
+}
+
+/**
+ * Allocate and free a dozen short-lived blocks,
+ * like a single passportSign call does
+ */
+template<class Allocate, class Deallocate>
+void signPattern(Allocate&& allocate, Deallocate&& deallocate) {
+	static const size_t sizes[] = {32, 32, 256, 256, 256, 294, 512, 1191, 64, 128, 256, 32};
+	void* blocks[sizeof(sizes) / sizeof(size_t)];
+
+	for (size_t i = 0; i < sizeof(sizes) / sizeof(size_t); i++) {
+		blocks[i] = allocate(sizes[i]);
+		static_cast<byte*>(blocks[i])[0] = 1;
+	}
+
+	for (size_t i = sizeof(sizes) / sizeof(size_t); i-- > 0;) {
+		deallocate(blocks[i], sizes[i]);
+	}
+}
+
+int main() {
+	for (size_t size : {32, 256, 1024, 4096, 16384, 65536}) {
+		std::cout << "Block size: " << size << std::endl;
+		benchmark::printRate("  operator new + volatile wipe", benchmark::measure([size] {
+			void* ptr = legacyAllocate(size);
+			benchmark::doNotOptimize(ptr);
+			legacyDeallocate(ptr, size);
+		}));
+		benchmark::printRate("  secure heap", benchmark::measure([size] {
+			void* ptr = util::secureAllocate(size);
+			benchmark::doNotOptimize(ptr);
+			util::secureDeallocate(ptr, size);
+		}));
+	}
+
+	std::cout << "passportSign allocation pattern" << std::endl;
+	benchmark::printRate("  operator new + volatile wipe", benchmark::measure([] {
+		signPattern(legacyAllocate, legacyDeallocate);
+	}));
+	benchmark::printRate("  secure heap", benchmark::measure([] {
+		signPattern(util::secureAllocate, util::secureDeallocate);
+	}));
+
+	// A challenge and a signature passed through the sign path: decoded,
+	// captured by the promise lambda and returned by the backend
+	const secure_vector<byte> challenge(32, 1), signature(256, 2);
+	std::cout << "Challenge and signature copies" << std::endl;
+	benchmark::printRate("  secure_vector", benchmark::measure([&] {
+		secure_vector<byte> c(challenge), copy(c), s(signature), result(s);
+		benchmark::doNotOptimize(copy);
+		benchmark::doNotOptimize(result);
+	}));
+	benchmark::printRate("  secure_buffer", benchmark::measure([&] {
+		secure_buffer c(challenge), copy(c), s(signature), result(s);
+		benchmark::doNotOptimize(copy);
+		benchmark::doNotOptimize(result);
+	}));
+
+	return 0;
+}
\ No newline at end of file
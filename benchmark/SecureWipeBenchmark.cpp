@@ -0,0 +1,96 @@
+#include <iostream>
+
+#include "Benchmark.hpp"
+#include "NodeMsPassport.hpp"
+
+using namespace nodeMsPassport;
+
+/**
+ * The wipe previously used by zallocator
+ */
+void legacyWipe(void* ptr, size_t size) {
+	std::fill_n((volatile char*)ptr, size, 0);
+}
+
+/**
+ * Check that freed secure memory was zeroed. The blocks of the secure heap stay mapped
+ * after they were freed, so the memory can still be read. The first word of a free
+ * block links it to the next free block and is not checked.
+ *
+ * @param data the freed memory
+ * @param size the size of the memory
+ * @return true if the memory was zeroed
+ */
+bool isWiped(const byte* data, size_t size) {
+	const volatile byte* ptr = data;
+	for (size_t i = sizeof(void*); i < size; i++) {
+		if (ptr[i] != 0) return false;
+	}
+
+	return true;
+}
+
+/**
+ * Check that secure memory is zeroed when it is freed,
+ * even though it is never read after the last write
+ *
+ * @return true if all checks passed
+ */
+bool checkWipe() {
+	constexpr size_t size = 256;
+
+	const byte* vectorData;
+	{
+		secure_vector<byte> secret(size, 0xAA);
+		vectorData = secret.data();
+	}
+
+	const byte* stringData;
+	{
+		secure_wstring secret(size / sizeof(wchar_t), L'x');
+		stringData = reinterpret_cast<const byte*>(secret.data());
+	}
+
+	auto* raw = static_cast<byte*>(util::secureAllocate(size));
+	std::fill_n(raw, size, 0xAA);
+	util::secureDeallocate(raw, size);
+
+	bool ok = true;
+	if (!isWiped(vectorData, size)) {
+		std::cerr << "A freed secure_vector was not zeroed" << std::endl;
+		ok = false;
+	}
+
+	if (!isWiped(stringData, size - sizeof(wchar_t))) {
+		std::cerr << "A freed secure_wstring was not zeroed" << std::endl;
+		ok = false;
+	}
+
+	if (!isWiped(raw, size)) {
+		std::cerr << "Freed secure memory was not zeroed" << std::endl;
+		ok = false;
+	}
+
+	return ok;
+}
+
+int main() {
+	if (!checkWipe()) return 1;
+	std::cout << "Freed secure memory is zeroed" << std::endl;
+
+	for (size_t size : {32, 256, 1024, 4096, 65536}) {
+		std::vector<byte> buffer(size, 0xAA);
+		std::cout << "Buffer size: " << size << std::endl;
+
+		benchmark::printThroughput("  volatile byte loop", size, benchmark::measure([&buffer] {
+			legacyWipe(buffer.data(), buffer.size());
+			benchmark::doNotOptimize(buffer.data());
+		}));
+		benchmark::printThroughput("  secureWipe", size, benchmark::measure([&buffer] {
+			util::secureWipe(buffer.data(), buffer.size());
+			benchmark::doNotOptimize(buffer.data());
+		}));
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,127 @@
+#include <random>
+#include <vector>
+#include <iostream>
+
+#include "Benchmark.hpp"
+#include "Sha256.hpp"
+
+using namespace nodeMsPassport;
+using namespace nodeMsPassport::crypto;
+
+namespace {
+	const sha256::implementation implementations[] = {
+		sha256::implementation::scalar, sha256::implementation::shaNi
+	};
+
+	const sha256::batchImplementation batchImplementations[] = {
+		sha256::batchImplementation::sequential, sha256::batchImplementation::avx2
+	};
+
+	/**
+	 * Check that every batch implementation hashes groups of
+	 * messages with different lengths like the single message hash
+	 *
+	 * @return true if all hashes matched
+	 */
+	bool checkBatches(std::mt19937& rng) {
+		for (sha256::implementation impl : implementations) {
+			if (!sha256::setImplementation(impl)) continue;
+
+			for (sha256::batchImplementation batch : batchImplementations) {
+				if (!sha256::setBatchImplementation(batch)) continue;
+
+				for (size_t count = 1; count <= 20; count++) {
+					std::vector<secure_vector<byte>> messages(count);
+					std::vector<const byte*> data;
+					std::vector<size_t> lengths;
+					for (secure_vector<byte>& message : messages) {
+						message.resize(rng() % 300);
+						for (byte& b : message) b = (byte)rng();
+						data.push_back(message.data());
+						lengths.push_back(message.size());
+					}
+
+					std::vector<sha256::digest> hashes(count);
+					sha256::hashBatch(data.data(), lengths.data(), count, hashes.data());
+					for (size_t i = 0; i < count; i++) {
+						if (hashes[i] != sha256::hash(messages[i])) {
+							std::cerr << "Wrong hash of a " << lengths[i] << " byte message using "
+								<< sha256::implementationName(impl) << '/' << sha256::batchImplementationName(batch)
+								<< std::endl;
+							return false;
+						}
+					}
+				}
+			}
+		}
+
+		return true;
+	}
+}
+
+int main() {
+	std::mt19937 rng(42);
+	std::uniform_int_distribution<> dist(0, 255);
+
+	if (!checkBatches(rng)) return 1;
+
+	// Challenge, RSA-2048 public key and large buffers
+	for (size_t size : {32, 294, 4096, 65536}) {
+		secure_vector<byte> data(size);
+		for (byte& b : data) b = (byte)dist(rng);
+
+		std::cout << "Message size: " << size << " bytes" << std::endl;
+		for (sha256::implementation impl : implementations) {
+			if (!sha256::setImplementation(impl)) {
+				std::cout << "  " << sha256::implementationName(impl) << " is not supported by this cpu" << std::endl;
+				continue;
+			}
+
+			const double seconds = benchmark::measure([&] {
+				benchmark::doNotOptimize(sha256::hash(data));
+			});
+
+			const std::string name = std::string("  ") + sha256::implementationName(impl);
+			benchmark::printThroughput(name, size, seconds);
+			benchmark::printRate(name, seconds);
+		}
+	}
+
+	// Batches of challenges, as hashed by verifySignatures
+	constexpr size_t batchSize = 256;
+	for (size_t size : {32, 64, 1024}) {
+		std::vector<secure_vector<byte>> messages(batchSize, secure_vector<byte>(size));
+		std::vector<const byte*> data;
+		std::vector<size_t> lengths;
+		for (secure_vector<byte>& message : messages) {
+			for (byte& b : message) b = (byte)dist(rng);
+			data.push_back(message.data());
+			lengths.push_back(size);
+		}
+
+		std::vector<sha256::digest> hashes(batchSize);
+		std::cout << "Batch of " << batchSize << " messages, " << size << " bytes each" << std::endl;
+		for (sha256::implementation impl : implementations) {
+			if (!sha256::setImplementation(impl)) continue;
+
+			for (sha256::batchImplementation batch : batchImplementations) {
+				if (!sha256::setBatchImplementation(batch)) {
+					std::cout << "  " << sha256::batchImplementationName(batch) << " is not supported by this cpu"
+						<< std::endl;
+					continue;
+				}
+
+				const double seconds = benchmark::measure([&] {
+					sha256::hashBatch(data.data(), lengths.data(), batchSize, hashes.data());
+					benchmark::doNotOptimize(hashes[0]);
+				});
+
+				const std::string name = std::string("  ") + sha256::implementationName(impl) + '/' +
+					sha256::batchImplementationName(batch) + ", per message";
+				benchmark::printRate(name, seconds / (double)batchSize);
+			}
+		}
+	}
+
+	return 0;
+}
\ No newline at end of file
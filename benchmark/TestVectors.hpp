@@ -0,0 +1,347 @@
+#ifndef PASSPORT_TESTVECTORS_HPP
+#define PASSPORT_TESTVECTORS_HPP
+
+#include "NodeMsPassport.hpp"
+
+/**
+ * Known good signatures used by the native benchmarks, generated with openssl
+ * (RSASSA-PKCS1-v1_5, RSASSA-PSS and ECDSA P-256, SHA-256, SHA-384 and SHA-512)
+ */
+namespace testVectors {
+	using nodeMsPassport::passport::signaturePadding;
+	using nodeMsPassport::passport::hashAlgorithm;
+
+	/**
+	 * A RSA-2048 SubjectPublicKeyInfo, as returned by getPublicKey
+	 */
+	constexpr const char* rsa2048PublicKey =
+		"30820122300D06092A864886F70D01010105000382010F003082010A028201010090B786902601A7C35978A717A2BF845514"
+		"B4E078286ECFF6DE3DBC8FBE05E4D986B683612B64F9943EB9751DC9CE3A683C3197BB67777D6C13931E41ABD5CC5B1C4BB8"
+		"5AB1B4535EAD215966CFF08A57858937D3D9EED73402D7013E80AC47A579C90F08D282E9915058A3F142190CFE3FBA871134"
+		"8F5A0869234580BDA437898F213F2FB88100FA529B02B98CE0C331C6816B8F80FB2A60690E93DE2727D2BB9F87E369191E3A"
+		"30093699A21D92618585939E0CFED7138705164B59CA8B6F72AD8C1ED25C0B22BD2BFDE4117A9B4CCB29BCF5D6F1A5F1214F"
+		"492CB34A6A55C1D7A1D2F8685DC905D386CDB53455887A28AF4CBF8FF45370FB77EDEA5AC7C6110203010001";
+
+	/**
+	 * The signed challenge
+	 */
+	constexpr const char* rsa2048Challenge =
+		"C514EF6EA7420671D0E9A86D9E838271976FC83B93C61BEC5A0EECD705E390B4";
+
+	/**
+	 * The signature of rsa2048Challenge
+	 */
+	constexpr const char* rsa2048Signature =
+		"026DED01445615FEC50DB068EB617C2DB84CF937F3C62871123DCCECAC675CE8F771E68C111481A80769AA9CC0AA38F67566"
+		"FC6F7D9EF806DE39F88EB35588925D338AC501D3903627291DFBCAF905EECE9A6765BF42132920DF1BA514C8BBB2C94AE3FB"
+		"E1687B2FA46485C42F09370F75226B6582D993905DEB8ADDF5533AF804ECC33C2E5FA6B1EF2D0002DDD0BF971AB5F15B6235"
+		"9D68218DA2DADF1358726A59FEE2819DF1F3035B50C37E90ABF4B2FAC267E8EF41ECE16AFB9C30D21279E53AB1FD525B3D13"
+		"67A566352EBBD7C3759812E5DDEAE0DCE481B669C5D699B59399FF3E5701510FFE4F00242C524D0E78506A34FA84855BD025"
+		"C54C14146489";
+
+	/**
+	 * RSA-2048 SubjectPublicKeyInfos with the public exponent 65537,
+	 * the format of the keys created by windows hello
+	 */
+	constexpr const char* publicKeyCorpus[] = {
+		"30820122300D06092A864886F70D01010105000382010F003082010A0282010100AF39D91ED50BD700930394F9AB6FA68F29"
+		"F2214DC369218043A1E1DCB422CABC978ED3C388C565ACBFEBAB5BDAEDA35CBAC1A96CD9D8F5252B40BA12E93EF6BFD93BAD"
+		"D6AA8E21332FF3B870D12141045A99BF24DB8DDCA0F5C5A0F91431570ED226459162C43DD218C7B05F370B656DDAA0D51197"
+		"13DCD495FF19B0D4A1D15A81B1B211F92F26D5F6F960F2FF03311CE0808459CA9B3C16CF7F42DA6EC3FE77775D23933E3A9B"
+		"B05FD13211F6253A72AF506BE45681625BC9D4F1450C0854DFE9B014B46A3BDB66AB85E1AA565EBC4DD77AF0A0D8C4B000E3"
+		"C65F8401EB8B15241F443626F3972F51F91C5B96F03EA32E230B3FF00BD7AEC4DCF199D9E540950203010001",
+
+		"30820122300D06092A864886F70D01010105000382010F003082010A0282010100C6F34703BF1A379BA912A03BD167A7D156"
+		"2792BDCD6FB0CD65FFC01B9DBAFA305A073E5B4BB63A746955BE04EE4135688857660C44C238581D3EF5652E1C55FA3F2413"
+		"9975541BDE626F3ACE14342A22323299CBE1C4730728E06208F5A70578649A18E3BBE38ACF0E1D6993450192904B641E16B4"
+		"52D356F3C372714A7DEA4BBA1B7D873CFB0758586E1E041AFF906E395F98B11776C320A568E8E3A76DDDF603A7B3794073D9"
+		"D79031B25788A4D954DF89353B5DC84AD32C9DAE7199EDEC4FD41CFC70BD30032F346F4CBF040917490705BDF6456FBA22AB"
+		"157DD3FBCA834B6AA1E65F849A168B300E25519F0AC5161DBF834D83FAB86B831680951D962D670203010001",
+
+		"30820122300D06092A864886F70D01010105000382010F003082010A0282010100E215C2931935710895C4DCF412BF80CABE"
+		"44258EB19364C2F01B8D38FEF135AA135A740B8472D92FA91524FAF98890E6DAB881D89C3CF3BBC97D8822CA9319912306FF"
+		"95FCE282D1067F663F628951E5C23020B2AC4B8CB145B3ECEE08BF2760FA15CE9F938EFE0E4A76D579A940D22CD968E9A2CE"
+		"E5CA5C1041F402FD0BB17B61B5FAE775B92DD4ED86C853EEC92EE1D2DDBE37E573ABF4FBE0D7AF801252472EA6A247AD7E86"
+		"DBA701E72B8EFBE70202D102BC58B67C60AF6D3EE147C7F8AB8DAE7CDAA19835013A9A5F0712A54179E5107AFCE967CB8733"
+		"97A3ACECC3F060615407B1129A7FA185912B2037D463B4918701417D5FDBEF2114BEABC85280FB0203010001",
+
+		"30820122300D06092A864886F70D01010105000382010F003082010A0282010100A648790909AE6B8C28CE18C8F67DC4E70F"
+		"14F48C37FD2DCC58D39BE31455BE850F33DD0FE81DD36D4A8EB4E5079E4892686C15F64DCC465892A5BF26BFF4CE7EB0A33E"
+		"4A8EE08800B14251A7E224AFA7DA0CE5739BDAA67E8F95B66257E6CD9FBC865BB82F5CD0092E120749A02CC6B000430EDE91"
+		"3664DF8E71A8B8CA348521586250D76BE0680AFBD4CB6CE665BA03E53777D62B19240046DA32DA1B93C150BB5B6BAE116990"
+		"66FE14C242569490E31D196912B7B2320D6E32E1511FEE72162A509043712AC3492F5E05939A954C0C3E7560584332C95D03"
+		"E583344A554EB80FECE8B694852756DB5E56DB2D88FB3D464F5BC04DA3D4F167863B93C1CAC3770203010001",
+
+		"30820122300D06092A864886F70D01010105000382010F003082010A0282010100CC6402561F01BF47BDFF291FBD3165F7A9"
+		"065AE0555FCAE568DF9810A20F8545E5709D5F1CFA1F9B624A96B1618D00BB47A6F1ED249BD6F0106745BA0714C4590DF33A"
+		"5A298F03DAC6ED127E58FA77CD70C406130F03583969F13DC7346D52F4584BE96DCD48443054E01CF84BABDCAFD6DF47C078"
+		"030DDC88E66264146762051D3D8FA0B3AD9F09D239289EFA869B196883D1B21FE757DB81B47D3360CBD16D536534F84FA2A6"
+		"CB0084D8DB92D92A776F97A714E9DB537F44E614619A270449604D49F919DDAC5876141C40BADF642C9C061D89F570D5EED3"
+		"2D6FAC5D9A6D7986C9AB28B31BB971095B47FB2A0A4A5E84AEA1F46573A0DA270AB150A01B1A7B0203010001",
+
+		"30820122300D06092A864886F70D01010105000382010F003082010A0282010100DF8800502CB3D18CAEC99F1C07A5FAB50E"
+		"D5A36FA3AB08A245EF3245063C550775B24A2E85D26B9AA5DCA445209A64208B5007A924B57F6506293DF05566C41D8B49CD"
+		"342914A1A9FE36D22BE03B7E9882CA7500FBA87FC125F9CB08C1A3699C739FBA30C9251E508AC29CBE807D93B45A37E1BF80"
+		"E86FD817A81F892AC08CD926EB64C9CD14E8FA7E05F6A61B259466E0897A299154F6ECB11D1B45F0969F6A24104B27FC6A27"
+		"C3C23ED6AB73C5E0E6CEF3DDC3DDC25BCF1DD13B8E4E52DB0BD61070A572DB210FCA2F79B356EA09953FDDD5259F1618B74F"
+		"9786BA125E41D2EE8D9A1830A38586FD21506C902A648F156A80018206212AEE416FA16C591A6F0203010001",
+
+		"30820122300D06092A864886F70D01010105000382010F003082010A0282010100BA7A88D7111437D1875B3FF8CEBB06CE0C"
+		"AB5EB2EF0EF3EBD85E28D599C3C3995187134688D47005AB77EA839879E862E3AC106E2623E2C9BDBA1DAFA82CD9C9701E38"
+		"0CD2F1C8E4AD93EBD4C817ECC0C79317590C304DD84C2EA836C599DA8F87F1B143E847780430A1F89DEDC027A97A533F5841"
+		"E86AE7F25AAA81B45FC4FA16DB6E7B6024FFEC95D043CA5E1390481FB4B69B81A63A80EFE3C79CCB75BBF9ADAC15EDE78D68"
+		"EEF8EBC633F2F6BE44FE4FFABD7EF80C3C7D66580BDD77896A4BC7C654B658BA1781DB6883E1AB3B7FE645542FDD7C455214"
+		"E9C62110130034BB45C26E2782CC60A36D18186CBC126E04DB448BDCC5135627DB39F02EA0D2DB0203010001",
+
+		"30820122300D06092A864886F70D01010105000382010F003082010A0282010100BEF73E01BA3D4A6094B4BFAB24DD28F426"
+		"C4AC011EB76545BC48353A235CDC5DAAFD9581AE71B391450EB402E659000B2522CA85763CCE2E1217F865736FF78C8DF2B3"
+		"0DEC8D24A44EF14FCE559E92286FEE68BF0979CEB75B03C88BE7B753BFAD08E25768AE78DFC072704B1FD805D1D66D1260BE"
+		"E2CEDA8AA6A0CC5884042E448B8899A1145F834846D40D4CC4DB1B9C618F1A2510942B5362132CA529FB80DD91422AE2919A"
+		"07DAB7D92D4B701495F3E410BB13759200798E1A412AB75EA7CB751E63FD85FBEC782F58B9DE3F354EB7020935B34DF0BFDD"
+		"BC9046302A9B6045FCF5F3B0620F1E3C27EEEC7F0C90F6FBB6529F8CC9FDA0CE6970B9F54AE7D70203010001"
+	};
+
+	/**
+	 * A P-256 SubjectPublicKeyInfo
+	 */
+	constexpr const char* p256PublicKey =
+		"3059301306072A8648CE3D020106082A8648CE3D03010703420004FBF72C774F59CDE95D9D7CBD1B8D902ABD139BD518F1F6"
+		"6D2CBC70BF13F311FC43A964A1DC978BDDE9F4B9A499307E699B9660F997C0560D60D57353A27175F1";
+
+	/**
+	 * The challenge signed with the P-256 key
+	 */
+	constexpr const char* p256Challenge =
+		"052AD72FB04724C9CA45C428001322BE66C6010813ABAFB343911D055FB8E930";
+
+	/**
+	 * The DER encoded ECDSA signature of p256Challenge
+	 */
+	constexpr const char* p256Signature =
+		"3045022100CFCA62FFB438B99B6FCD361AD302365186EC43A6F98DB18881F4D60991725B90022050DF982FE046063AC984DA"
+		"AFD4FDBB8CEF74240D70F95C2292937A0A6014B4C8";
+
+	/**
+	 * An ECDSA P-256 signature with its key and message
+	 */
+	struct ecdsaVector {
+		const char* publicKey;
+		const char* message;
+		const char* signature;
+	};
+
+	/**
+	 * Signatures of messages of different lengths, each with its own key
+	 */
+	constexpr ecdsaVector p256Corpus[] = {
+		{
+			"3059301306072A8648CE3D020106082A8648CE3D0301070342000467E36EA6CF33C933B3E893B05C178D98E81AA977A4"
+			"458B23B3DCBF9BFD891B0BF100ED9248412C50DC74E0601BA7090E4B92C8842F8F237C8358F189FF652CE8",
+			"FCB6EBC8B787D7C22C8DE0",
+			"30440220719256B4408E1EED1533B2B7891DB805DDDFF32EC309CC6E5810C16E0833E36F0220099C9C385AACF3EBE0D1"
+			"1E4B9D0817DD8FA4DCE08EEB6FAD2C96C10A9825FD64"
+		},
+
+		{
+			"3059301306072A8648CE3D020106082A8648CE3D030107034200047D89542DB6D0B526F412DDD5BA0030F5E9239B05AB"
+			"0745F15B854AA6C98DC25DB8FE457E5AC8C28E011536589D79977FC58A638687FEC7F4C7FDAD389C17FD16",
+			"8A80667FCE076989BD66AA1A46134C29E29349458BC0",
+			"304502207899D234E2C789905EB3931114FC59F7E3B6471625B7D1150C39A6E61C7BA33A022100A18B9C5DA1634A3C07"
+			"EA2A8BEA200A7749F5168CA7A9858D712A41F02BCC260E"
+		},
+
+		{
+			"3059301306072A8648CE3D020106082A8648CE3D0301070342000479C4C8188FF4218A707BD5ED0834679F3689546DDD"
+			"4BB974BAD657892943B4F4FFB873B39A6A955F9EF19BA8A7F71F934F47123C0F4FF1D25FDA8F24CFB21088",
+			"5EE4947C3FA0437371A57C552C2A511026ACDEC39D6164CFF96A7DFC9B006F9BD0",
+			"304602210085FD3920367029A355DE73ADB0C5AE9B244FA6289D2FB22A075850B7F364C3C3022100914402E052C17F07"
+			"06A51EEBEC809D8410D686D6F184DFF4D502279193FA6FE3"
+		},
+
+		{
+			"3059301306072A8648CE3D020106082A8648CE3D03010703420004514EA6CB59EAD301CAAECD8131097D9399A5844BE3"
+			"82F6D6E28156FDDD6BE2D29A7BD1E7FA84E9619E0ED2B1DB16A4179F93BC39A7F42D78FB590EAE0A8F10B4",
+			"421D316BDA1254A6CA7F6F7DDADB35EDEF2BC8C521988EC4FA8B8149DD7B7C4E4CA12A91CA48A5380AC24D05",
+			"3045022030EFD5B713AA95659762B6AEDD036E461C1D1D777F6135F54C4B9B166C80988C022100BDB588CB1A05A45469"
+			"D5656E18CA138463CA5185A6A01EB6952A888F81FF612A"
+		},
+
+		{
+			"3059301306072A8648CE3D020106082A8648CE3D03010703420004492DC98C5A9F128C75D0B3656F7D67B0CC2FEB6F3B"
+			"B92B2F6C20F21C2EC441CDC12A4EEB5AD305A58C2E8874B6D86B26455EE270F914DEB207A1236A5670D579",
+			"D04931C4B5E26A4E056B85F9E618FD615AA7759D2F0E24C42E01C9BB8F1D3F3E59E7E42C778C37DB6FC6B7BA2DB59B3D"
+			"CCBCEFED1BBE2B",
+			"3044022042BEA2CB1B68D274D41872ADFDC2CC89A7DFF05C05B50B29409D05A1E1929F3F022071B6C30652EC29288C0F"
+			"B19B3A7CBEEA704C73818924A5FC5740ED290F16161D"
+		},
+
+		{
+			"3059301306072A8648CE3D020106082A8648CE3D030107034200043C5574B123DE5278606BBE4E58AFC9A4A28D8C2B1C"
+			"D49C37487D633EB55FAF088C901D1BFE3797FF2E484A9829D76507EBF76866AB3A4FE98D659396DDF20403",
+			"B037A18258DA1DBA36F2F997CBBF1141073645EF0DFFF2915EB6381E71D401F2140C711D8FF7F030A27E0C8B6A044D96"
+			"E5BBB43A04B75984AE56989B634D764404D4",
+			"3044022055CC8DB1C7ED790455240BA5E3D4A3CC713B6E815E33ED4FA47D73210BC8090602202B3A76B3B818E95AED18"
+			"AA6B91259F4434DA4681FA89E92FCA32DBA69AEFEEF8"
+		}
+	};
+
+	/**
+	 * A RSA-2048 and a RSA-1537 SubjectPublicKeyInfo. The encoded message of the
+	 * 1537 bit key is one byte shorter than the modulus (RFC 8017 section 9.1.2).
+	 */
+	constexpr const char* rsaCorpusKey2048 =
+		"30820122300D06092A864886F70D01010105000382010F003082010A0282010100A2BFE780E47C2C687FE9959DFDA434"
+		"7F48281F26BE0BBF306C2D0309624E1E88468236DED127E1C5EC47D737C3D081483CF8C9F1B0C2F1725BD6A76439C6E7"
+		"95B7B243B45738951A0DB66679B46EAD6771505834A448A490D7B0D44F7E271E1186773A46045410951E96113670AD42"
+		"DF52E68B27284CD16ABA69E642A943CB0D30472A70ED5564D09D5327A2AF235F44B007B3EB4994AACFCA9C22F1DFDFCD"
+		"14DBE1B7A1BB18917CA09728F74B32F5483C596B29F8E9D20CA48370D3E1A81C4AF6B31665366096372D6F1472A8F27E"
+		"1D03ADBFB0927101D24A3D2665230BADE8DEE7C34624DF66516727064A8E8567E864FDC56D4DF2D3939A376AF4DD49EE"
+		"910203010001";
+
+	constexpr const char* rsaCorpusKey1537 =
+		"3081DF300D06092A864886F70D01010105000381CD003081C90281C101C3A3A101C81C5BB1BC5987A1CF2B4072550626"
+		"87A7B4DD7277E7BAC7FF6372F64C2B4EDF71BFB04A47C19DE12B476A8BED45BBC59754ECB9FA4C4298B347D017126A32"
+		"42C7CAB3375073A5296EE474900F1A5C04CD408F204C639D5064BA181B72736ECB98B1AB35B6EC08078F90AF33FD91B0"
+		"531D4FAB9042614C0E3CB2AE42EE62DFE5E1AE3D71E1BBCE62BD07BB0B9A8F080B373A01C58CB40581F3B9F48C1539D3"
+		"9DB0BBD7EAAF131C65E5C4DA3412A259CAA1037E4CA4018A9EFBE9B8470203010001";
+
+	/**
+	 * A RSA signature with its key, message and options
+	 */
+	struct rsaVector {
+		const char* publicKey;
+		signaturePadding padding;
+		hashAlgorithm hash;
+		// The length of the PSS salt
+		size_t saltLength;
+		const char* message;
+		const char* signature;
+	};
+
+	/**
+	 * RSASSA-PSS and RSASSA-PKCS1-v1_5 signatures using SHA-256, SHA-384 and SHA-512
+	 */
+	constexpr rsaVector rsaCorpus[] = {
+		{
+			rsaCorpusKey2048, signaturePadding::pss, hashAlgorithm::sha256, 32,
+			"58BB7F8F842E10885BE2B786886C1DFF873CDA470589C60FCB0B84361035BB2F26F41EF6BE49",
+			"592E799F7D7A2338D972FDC15D134C8E95B518845A166CD9A4DAA2DCDD346AEBE3A5D4EBD0A0DB6295124741E3EECB14"
+			"78E5BF7921C00AE4194294A46F1ECCD822C735D6A8DBC7E4F7FBBC5FE1083387885F7E8AAA4D9628E986B69339716002"
+			"AA70CE55EECF1BFE4B6E975E725A1820F858F1442D9023E99FBF21323A65E6DFA6CE3A8AAA0A7882C39F4E421825E000"
+			"AC15A54FEA0A1E7B2286A2CD79D391DFFCE9F5545BA77298FC150F6137C5CC29963141C12DD1FD76DBC76ED59042004A"
+			"2C98EF8ACF8C69F6D4B3D2E637A435714684120CDA6F62A5B8866025E094503152B19D1DF52FE94A81CA5AE1849A8CE9"
+			"662BC88B6745F3AE0861BC7E7F4189B7"
+		},
+
+		{
+			rsaCorpusKey2048, signaturePadding::pss, hashAlgorithm::sha384, 206,
+			"04C8B77831D49DE289",
+			"18EE2D46D7537052C730A9E9E4710F688DF3C72800B6A0991581AAE33CD99902C794614443645CAA02D6BC156DFCAA23"
+			"793EBFF503D8ED2F1F7D029EB32FCDB7F6D1FFD68F030BB68FB311DF1DB1A1F119BBDA5B19395D3CA17756C52E9681F0"
+			"AAA5B66CE34E8F1EE8DC7FE8136D1A5E277821F4C3BA41294969C82B0A096AEB32800E2F58BF867B30EA52C556AF323B"
+			"42ECD43D141BF21F7D99355C8D47A6648FC947A363229FA96C1E8D55BBEE3866FFC839BFAF64FB2E9DD5B0652CF6D235"
+			"0F24D8F6EC5B498E7DD6A563B77E87795715D55980FDB11EA4AC75B375C421FDB4DA399FA48DBA7942DE4F6AB5359B37"
+			"A233FA03C89455F8FFEDECD5D39BCBE7"
+		},
+
+		{
+			rsaCorpusKey2048, signaturePadding::pss, hashAlgorithm::sha512, 0,
+			"80B7F764F7FA55FBBFAD38D08EA4753FC4816986FBB31DC9",
+			"6D8B568A465685C4A17DF754FCB00B79D02C5493C6137B61F2CDF94FF67D7887A8C594D1CF6F40DF4DA86FE419BE0EF9"
+			"50AAC6048ED1A19BB7E72BA935BE52388CB3950ED10314B5094887D71794A2764894A80E53F2F50A60D709C08DE5EDD4"
+			"7604E8B270B4F89AC919CBF2CFAF0C018B5B8C4520EDED501C2E504A046C7F133357D3EA5BC49197DB039DCB1DF1A2CF"
+			"0F8E67DC9BCED157B9CAEB05707ECCA21ACA302EB3E120704D60618E1B9198A4376AAC0AA9EE571AEDAEC3CFEA227124"
+			"FBA131532618D622E2871E3CA73C1A18C7A5AC439271043AB21AEBC6F48DB887667D6DD363D9C50E6BF2FBFA2B202AF0"
+			"746E0DE99DB7E63587CF5A78A484DDD2"
+		},
+
+		{
+			rsaCorpusKey2048, signaturePadding::pkcs1, hashAlgorithm::sha384, 0,
+			"0E62E6CC37EBF90C3E1A9D304342F3247035F4FDBCD27FE2D0BE0586413592",
+			"0668F11D28B575C2968005D888A66380748D1B77C832084B66986F2DC0B289A85765C8F1ED4A3A1B55A7C2325FBEA39A"
+			"5B17D1EEFCA80C5891E3B0B3ADFECDC9D2C63309636D1F2BEA65F9113D11C84B9B56B39D3B7EEFF766E6E5FFD51C6B54"
+			"F9D4967324C194E61B12169988CC0B35A84656E1A3EDF01C3DB14EFC1D1470347466A5B6A39F6189652E425E85BFA5E5"
+			"D7E36FF3E76C796C90C8C8AA48F552F42A3BA22A1C5CDABDE47E4049C60F897CAF7D7650ACDF407AA25549163BE3469C"
+			"E3584D153C7FCCD1562810E7F05CF337451ABC74284A1288CBDF0E35C3368271EB005B81D66DA86526222A269FFD3F15"
+			"AD88D3B984B84E754465752BE64A0737"
+		},
+
+		{
+			rsaCorpusKey2048, signaturePadding::pkcs1, hashAlgorithm::sha512, 0,
+			"688EE45EF3B13C8B0463B227E57FA3C6F015048253DE1766D453E7884876C694A37869607D9CD096",
+			"389186A5478BA19FFDE3AADB94B36C43F51F184BAB48CB1AED0BF52259867215FE73F2938523110FFC2A02FCB70AA65E"
+			"750CEEA43FB9A2235BFBF0AB3DB7D96485155D6062605148A9443FE7E378049A56453189E8989898369DF1FAE81A75C5"
+			"C911329BA1A74BFA4256BC7E0BC13F9BD80DB2C8D766212C1F7596BE1A13A22E506F5E473F3CF817B6A6B4F5BEAC4482"
+			"B5198C2BD62DA76264BA0C39406ACA4A4B5526B3C652F8ADC96C1C734C32179E1F2470F7C5F5B0DC82E83A9F4BF06E3C"
+			"1D8F261B611353880B3F425D13267C53ACB3593706A84D774CCC5A4B720CEE41A0653FF268F63FC07ABAC51E5D1EB011"
+			"6254D10FC637D9D2DDD9996B2001FDDA"
+		},
+
+		{
+			rsaCorpusKey1537, signaturePadding::pss, hashAlgorithm::sha256, 32,
+			"5E5A71AA88F0EFF7A10B79D9524FA5422DAA384657964394555F6926690C7A145D151635F51A94",
+			"01A2DEFC34D39787FBD110FEDC81F1AF548E854A1A673902DB66D8C880A39B1E70F0AC155806E454600D6E5091EF629A"
+			"E81B64DCB5B124630FE0462D70CC4103675520D69F5BE94AC0917E9F8BE21A039711CC77DDE3A336B24A4CF7960DC8D2"
+			"B58EBF8503B1DF1054B7F7E9B9B53C8B3DA2132119B6DCDCF4F50993F33A31BB70222E34E34C9DF4BCF4D5E5FCE12C7D"
+			"9AAE9A00070CCDA555019134275ED15195068B5B71C6F0F2D3B78AD7D9C8C1D1A14C1FEE92DAFD380F61BEF26E78400D"
+			"A6"
+		},
+
+		{
+			rsaCorpusKey1537, signaturePadding::pss, hashAlgorithm::sha512, 126,
+			"F8515A2A766AF82F021222D3EAF014B8",
+			"012AD51B64C1EBF9B1B37803AC839A277FA0814909F5D3EBCA8ECEC8DFCB4D57371EB1F58AA0576D91AAA87E996DBB7D"
+			"A70ECE67760BDB864E721F25B9F104C6257016967C690F281F9E70739DDBF9F01FB8B891CDCBA298209EF76BAB7BEAC7"
+			"39440E45D2497457984E13DE11B87A710DAC7084E1E940116B7200CEF71359CD5032048548BD8F19301294A26394FE80"
+			"D0336A9395BFAED80039854D67A128E66D5E115B6DCF6D1B10C1597F523E15E7D8EDA4FA3CB1EC79801A1E7EBC6BC004"
+			"78"
+		},
+
+		{
+			rsaCorpusKey1537, signaturePadding::pkcs1, hashAlgorithm::sha256, 0,
+			"98A99F87B842A0284113B9476110B00267035E9403FF194DE3",
+			"00A24680225009A65F1443A3F562A81DD0FAC83371B3F6D865A82DFE66C3376732D9D76F35C04DA4AC36B3BA83A19AB7"
+			"858FABC72A31AABD2A9C1BFA4C524EF8621D19466C253175C20623F4C8B5280B62A6D7297A51DE43861D220E819E2EB5"
+			"B855131DE7E021082DDE4E2D80D02591ED2CEFA88133F1B68B11EC6EC8692376BC1C29A7009926DA87D484829E783570"
+			"88330FB99AF279A1AB0CF9A451E789D694A93FB20EC253C4EFFD2DB19DB140499C07F2E4AF0E858ECE3AA53C2EADF337"
+			"B9"
+		}
+	};
+
+	/**
+	 * A message with its SHA-384 and SHA-512 hash
+	 */
+	struct hashVector {
+		const char* message;
+		const char* sha384;
+		const char* sha512;
+	};
+
+	/**
+	 * Messages filling zero, one and two blocks, hashed with openssl
+	 */
+	constexpr hashVector sha512Corpus[] = {
+		{
+			"",
+			"38B060A751AC96384CD9327EB1B1E36A21FDB71114BE07434C0CC7BF63F6E1DA274EDEBFE76F65FBD51AD2F14898B95B",
+			"CF83E1357EEFB8BDF1542850D66D8007D620E4050B5715DC83F4A921D36CE9CE47D0D13C5D85F2B0FF8318D2877EEC2F"
+			"63B931BD47417A81A538327AF927DA3E"
+		},
+
+		{
+			"abc",
+			"CB00753F45A35E8BB5A03D699AC65007272C32AB0EDED1631A8B605A43FF5BED8086072BA1E7CC2358BAECA134C825A7",
+			"DDAF35A193617ABACC417349AE20413112E6FA4E89A97EA20A9EEEE64B55D39A2192992A274FC1A836BA3C23A3FEEBBD"
+			"454D4423643CE80E2A9AC94FA54CA49F"
+		},
+
+		{
+			"abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu",
+			"09330C33F71147E83D192FC782CD1B4753111B173B3B05D22FA08086E3B0F712FCC7C71A557E2DB966C3E9FA91746039",
+			"8E959B75DAE313DA8CF4F72814FC143F8F7779C6EB9F7FA17299AEADB6889018501D289E4900F7E4331B99DEC4B5433A"
+			"C7D329EEB6DD26545E96E55B874BE909"
+		}
+	};
+}
+
+#endif //PASSPORT_TESTVECTORS_HPP
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include <clocale>
+#include <cstdlib>
+#include <iostream>
+
+#include "Benchmark.hpp"
+#include "UtfCodec.hpp"
+
+using namespace nodeMsPassport;
+
+/**
+ * The conversion previously used by secure_wstring(const std::string&)
+ */
+std::wstring legacyToWide(const std::string& str) {
+	std::wstring out(str.size() + 1, L' ');
+	size_t outSize = mbstowcs(&out[0], str.c_str(), out.size());
+	if (outSize == (size_t)-1) outSize = 0;
+	out.resize(outSize);
+
+	return out;
+}
+
+/**
+ * The conversion previously used by CLITools::string_to_std_string,
+ * a character by character copy followed by wcstombs
+ */
+std::string legacyToUtf8(const std::u16string& str) {
+	std::wstring wide(str.size(), L'\0');
+	for (size_t i = 0; i < str.size(); i++) {
+		wide[i] = str[i];
+	}
+
+	std::string out(wide.size() * 4 + 1, '\0');
+	size_t outSize = wcstombs(&out[0], wide.c_str(), out.size());
+	if (outSize == (size_t)-1) outSize = 0;
+	out.resize(outSize);
+
+	return out;
+}
+
+/**
+ * Repeat a string until it is at least len bytes long
+ */
+std::string repeat(const std::string& str, size_t len) {
+	std::string out;
+	while (out.size() < len) out += str;
+
+	return out;
+}
+
+int main() {
+	// The legacy conversions depend on the locale
+	if (!setlocale(LC_ALL, "C.UTF-8") && !setlocale(LC_ALL, "en_US.UTF-8") && !setlocale(LC_ALL, ".UTF8")) {
+		std::cerr << "No UTF-8 locale available, the legacy conversions will fail on non-ASCII input" << std::endl;
+	}
+
+	const std::pair<const char*, std::string> inputs[] = {
+		{"ASCII account id", "jane.doe@example.com"},
+		{"ASCII account id (1 KiB)", repeat("jane.doe@example.com;", 1024)},
+		{"mixed-script account id", u8"Jürgen Müller Женя 山田"},
+		{"mixed-script account id (1 KiB)", repeat(u8"Jürgen Женя 山田 \U0001F600 ", 1024)}
+	};
+
+	for (const auto& input : inputs) {
+		const std::string& utf8 = input.second;
+		const std::u16string utf16 = utf::toUtf16(utf8);
+		std::cout << input.first << ": " << utf8.size() << " bytes" << std::endl;
+
+		// The legacy conversions fail on some inputs, which makes them return early
+		const char* toWideResult = legacyToWide(utf8) == utf::toWide(utf8) ? "" : " (wrong result)";
+		const char* toUtf8Result = legacyToUtf8(utf16) == utf8 ? "" : " (wrong result)";
+		benchmark::printThroughput(std::string("  legacy mbstowcs") + toWideResult, utf8.size(),
+			benchmark::measure([&] {
+				benchmark::doNotOptimize(legacyToWide(utf8));
+			}));
+		benchmark::printThroughput(std::string("  legacy copy + wcstombs") + toUtf8Result, utf8.size(),
+			benchmark::measure([&] {
+				benchmark::doNotOptimize(legacyToUtf8(utf16));
+			}));
+
+		for (utf::implementation impl : {utf::implementation::scalar, utf::implementation::sse2,
+										 utf::implementation::avx2}) {
+			if (!utf::setImplementation(impl)) continue;
+			const std::string name = utf::implementationName(impl);
+
+			if (utf::toUtf16(utf8) != utf16 || utf::toUtf8(utf16) != utf8) {
+				std::cerr << "The " << name << " implementation produced a wrong result" << std::endl;
+				return 1;
+			}
+
+			// Into presized buffers
+			std::u16string utf16Out(utf8.size(), u'\0');
+			std::string utf8Out(utf16.size() * 3, '\0');
+			benchmark::printThroughput("  " + name + " UTF-8 to UTF-16", utf8.size(), benchmark::measure([&] {
+				utf::utf8ToUtf16(utf8.data(), utf8.size(), &utf16Out[0]);
+				benchmark::doNotOptimize(utf16Out);
+			}));
+			benchmark::printThroughput("  " + name + " UTF-16 to UTF-8", utf8.size(), benchmark::measure([&] {
+				utf::utf16ToUtf8(utf16.data(), utf16.size(), &utf8Out[0]);
+				benchmark::doNotOptimize(utf8Out);
+			}));
+		}
+	}
+
+	return 0;
+}
\ No newline at end of file
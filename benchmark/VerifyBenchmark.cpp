@@ -0,0 +1,64 @@
+#include <iostream>
+
+#include "Benchmark.hpp"
+#include "TestVectors.hpp"
+#include "HexCodec.hpp"
+#include "ThreadPool.hpp"
+#include "KeyCache.hpp"
+#include "RsaVerifier.hpp"
+#include "RsaSigner.hpp"
+
+using namespace nodeMsPassport;
+
+int main() {
+	passport::signatureData data = {
+		hex::decode(testVectors::rsa2048Challenge),
+		hex::decode(testVectors::rsa2048Signature),
+		hex::decode(testVectors::rsa2048PublicKey),
+		{}
+	};
+
+	if (!passport::verifySignature(data.challenge, data.signature, data.publicKey)) {
+		std::cerr << "The test signature did not verify" << std::endl;
+		return 1;
+	}
+
+	std::cout << "Thread pool size: " << util::threadPool::shared().size() << std::endl;
+	benchmark::printRate("verifySignature", benchmark::measure([&] {
+		benchmark::doNotOptimize(passport::verifySignature(data.challenge, data.signature, data.publicKey));
+	}));
+	benchmark::printRate("verifySignature, key not cached", benchmark::measure([&] {
+		const crypto::rsaPublicKey key = crypto::rsaPublicKey::fromSubjectPublicKeyInfo(data.publicKey.data(),
+			data.publicKey.size());
+		benchmark::doNotOptimize(key.verifyPkcs1Sha256(data.challenge.data(), data.challenge.size(),
+			data.signature.data(), data.signature.size()));
+	}));
+	benchmark::printRate("key cache lookup", benchmark::measure([&] {
+		benchmark::doNotOptimize(crypto::keyCache::shared().get(data.publicKey.data(), data.publicKey.size()));
+	}));
+
+	// The signing side of the software authenticator
+	const crypto::rsaPrivateKey privateKey = crypto::rsaPrivateKey::generate();
+	benchmark::printRate("software signPkcs1Sha256", benchmark::measure([&] {
+		benchmark::doNotOptimize(privateKey.signPkcs1Sha256(data.challenge.data(), data.challenge.size()));
+	}));
+
+	for (size_t batchSize : {1, 16, 256}) {
+		const std::vector<passport::signatureData> batch(batchSize, data);
+
+		const double sequential = benchmark::measure([&] {
+			for (const passport::signatureData& d : batch) {
+				benchmark::doNotOptimize(passport::verifySignature(d.challenge, d.signature, d.publicKey));
+			}
+		});
+		const double parallel = benchmark::measure([&] {
+			benchmark::doNotOptimize(passport::verifySignatures(batch));
+		});
+
+		std::cout << "Batch size: " << batchSize << std::endl;
+		benchmark::printRate("  sequential verifySignature", sequential / (double)batchSize);
+		benchmark::printRate("  verifySignatures", parallel / (double)batchSize);
+	}
+
+	return 0;
+}
\ No newline at end of file
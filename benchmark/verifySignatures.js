@@ -0,0 +1,55 @@
+/**
+ * Compare passport.verifySignatures with Promise.all over passport.verifySignature.
+ * Run with: node benchmark/verifySignatures.js
+ */
+const crypto = require('crypto');
+const {passport} = require('../index');
+
+const {publicKey, privateKey} = crypto.generateKeyPairSync('rsa', {modulusLength: 2048});
+const publicKeyDer = publicKey.export({type: 'spki', format: 'der'});
+
+function createSignatures(count) {
+    const res = [];
+    for (let i = 0; i < count; i++) {
+        const challenge = crypto.randomBytes(32);
+        const signature = crypto.sign('sha256', challenge, privateKey);
+        res.push({challenge: challenge, signature: signature, publicKey: publicKeyDer});
+    }
+
+    return res;
+}
+
+async function measure(fn, minMillis = 1000) {
+    // Warm up
+    await fn();
+
+    let runs = 0;
+    const start = process.hrtime.bigint();
+    let elapsed = 0;
+    while (elapsed < minMillis) {
+        await fn();
+        runs++;
+        elapsed = Number(process.hrtime.bigint() - start) / 1e6;
+    }
+
+    return elapsed / runs;
+}
+
+async function run() {
+    for (const count of [1, 16, 256, 1024]) {
+        const signatures = createSignatures(count);
+
+        const single = await measure(() => Promise.all(signatures.map(s =>
+            passport.verifySignature(s.challenge, s.signature, s.publicKey))));
+        const batch = await measure(() => passport.verifySignatures(signatures));
+
+        console.log(`Batch size: ${count}`);
+        console.log(`  Promise.all(verifySignature) ${(count / single * 1000).toFixed(0).padStart(10)} verifies/s`);
+        console.log(`  verifySignatures             ${(count / batch * 1000).toFixed(0).padStart(10)} verifies/s`);
+    }
+}
+
+run().catch(e => {
+    console.error(e);
+    process.exit(1);
+});
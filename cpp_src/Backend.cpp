@@ -0,0 +1,53 @@
+#include <mutex>
+#include <stdexcept>
+
+#include "Backend.hpp"
+
+using namespace nodeMsPassport;
+
+namespace {
+	std::mutex backendMtx;
+	std::shared_ptr<passport::backend> activeBackend;
+}
+
+void passport::setBackend(std::shared_ptr<backend> value) {
+	if (!value) throw std::invalid_argument("The backend must not be null");
+
+	std::unique_lock<std::mutex> lock(backendMtx);
+	activeBackend = std::move(value);
+}
+
+std::shared_ptr<passport::backend> passport::getBackend() {
+	std::unique_lock<std::mutex> lock(backendMtx);
+	if (!activeBackend) activeBackend = createDefaultBackend();
+
+	return activeBackend;
+}
+
+bool passport::passportAvailable() {
+	return getBackend()->available();
+}
+
+bool passport::passportAccountExists(const std::string& accountId) {
+	return getBackend()->open(accountId);
+}
+
+void passport::createPassportKey(const std::string& accountId) {
+	getBackend()->create(accountId);
+}
+
+secure_buffer passport::passportSign(const std::string& accountId, const secure_buffer& challenge) {
+	return getBackend()->sign(accountId, challenge);
+}
+
+secure_vector<byte> passport::getPublicKey(const std::string& accountId) {
+	return getBackend()->getPublicKey(accountId);
+}
+
+secure_buffer passport::getPublicKeyHash(const std::string& accountId) {
+	return fingerprint(getBackend()->getPublicKey(accountId));
+}
+
+void passport::deletePassportAccount(const std::string& accountId) {
+	getBackend()->remove(accountId);
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#ifndef PASSPORT_BACKEND_HPP
+#define PASSPORT_BACKEND_HPP
+
+#include <memory>
+
+#include "NodeMsPassport.hpp"
+
+namespace nodeMsPassport::passport {
+	/**
+	 * A backend creating and using the passport keys.
+	 * All passport operations are forwarded to the active backend.
+	 * Failures are reported by throwing a passportException.
+	 */
+	class backend {
+	public:
+		/**
+		 * Get the name of this backend
+		 *
+		 * @return the name
+		 */
+		NODEMSPASSPORT_NODISCARD virtual const char* name() const noexcept = 0;
+
+		/**
+		 * Check if creating keys and signing waits for the user,
+		 * e.g. for a windows hello prompt. These operations are
+		 * run one at a time, apart from the computational work.
+		 *
+		 * @return true if create and sign require user interaction
+		 */
+		NODEMSPASSPORT_NODISCARD virtual bool interactive() const noexcept = 0;
+
+		/**
+		 * Check if this backend can be used on this system
+		 *
+		 * @return true if the backend is available
+		 */
+		virtual bool available() = 0;
+
+		/**
+		 * Create a new key for an account
+		 *
+		 * @param accountId the id of the account
+		 */
+		virtual void create(const std::string& accountId) = 0;
+
+		/**
+		 * Open the key of an account
+		 *
+		 * @param accountId the id of the account
+		 * @return true if the account exists
+		 */
+		virtual bool open(const std::string& accountId) = 0;
+
+		/**
+		 * Sign a challenge with the private key of an account
+		 *
+		 * @param accountId the id of the account
+		 * @param challenge the challenge to sign
+		 * @return the RSASSA-PKCS1-v1_5 SHA-256 signature
+		 */
+		virtual secure_buffer sign(const std::string& accountId, const secure_buffer& challenge) = 0;
+
+		/**
+		 * Get the public key of an account
+		 *
+		 * @param accountId the id of the account
+		 * @return the DER encoded SubjectPublicKeyInfo
+		 */
+		virtual secure_vector<byte> getPublicKey(const std::string& accountId) = 0;
+
+		/**
+		 * Delete the key of an account
+		 *
+		 * @param accountId the id of the account
+		 */
+		virtual void remove(const std::string& accountId) = 0;
+
+		virtual ~backend() = default;
+	};
+
+	/**
+	 * Set the backend to use for all passport operations
+	 *
+	 * @param value the backend to use
+	 */
+	void setBackend(std::shared_ptr<backend> value);
+
+	/**
+	 * Get the backend used for all passport operations.
+	 * Creates the default backend if no backend was set.
+	 *
+	 * @return the active backend
+	 */
+	std::shared_ptr<backend> getBackend();
+
+	/**
+	 * Create the default backend of this platform. This is the windows hello
+	 * backend on windows and the software authenticator on any other system.
+	 *
+	 * @return the default backend
+	 */
+	std::shared_ptr<backend> createDefaultBackend();
+}
+
+#endif //PASSPORT_BACKEND_HPP
\ No newline at end of file
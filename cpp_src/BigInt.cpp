@@ -0,0 +1,353 @@
+#include <stdexcept>
+#include <algorithm>
+
+#include "BigInt.hpp"
+
+using namespace nodeMsPassport;
+using namespace nodeMsPassport::crypto;
+
+namespace {
+	constexpr unsigned limbBits = sizeof(limb) * 8;
+	// The maximum supported modulus size is 16384 bits
+	constexpr size_t maxLimbs = 16384 / limbBits;
+
+	/**
+	 * Subtract b from a in place
+	 *
+	 * @return the borrow
+	 */
+	limb subtractInPlace(limb* a, const limb* b, size_t limbs) {
+		uint64_t borrow = 0;
+		for (size_t i = 0; i < limbs; i++) {
+			const uint64_t diff = (uint64_t)a[i] - b[i] - borrow;
+			a[i] = (limb)diff;
+			borrow = (diff >> limbBits) & 1u;
+		}
+
+		return (limb)borrow;
+	}
+
+	/**
+	 * Check if a >= b
+	 */
+	bool greaterOrEqual(const limb* a, const limb* b, size_t limbs) {
+		for (size_t i = limbs; i-- > 0;) {
+			if (a[i] != b[i]) return a[i] > b[i];
+		}
+
+		return true;
+	}
+}
+
+bigint crypto::bigintFromBytes(const byte* data, size_t len, size_t limbs) {
+	bigint res(limbs, 0);
+	for (size_t i = 0; i < len; i++) {
+		const size_t bytePos = len - 1 - i;
+		if (i / sizeof(limb) >= limbs) {
+			if (data[bytePos] != 0) throw std::invalid_argument("The value does not fit into the big integer");
+			continue;
+		}
+
+		res[i / sizeof(limb)] |= (limb)data[bytePos] << (8u * (i % sizeof(limb)));
+	}
+
+	return res;
+}
+
+void crypto::bigintToBytes(const bigint& in, byte* out, size_t len) {
+	for (size_t i = 0; i < len; i++) {
+		const size_t limbIndex = i / sizeof(limb);
+		out[len - 1 - i] = limbIndex < in.size() ? (byte)(in[limbIndex] >> (8u * (i % sizeof(limb)))) : 0;
+	}
+}
+
+int crypto::bigintCompare(const bigint& a, const bigint& b) {
+	for (size_t i = a.size(); i-- > 0;) {
+		if (a[i] != b[i]) return a[i] > b[i] ? 1 : -1;
+	}
+
+	return 0;
+}
+
+secure_vector<byte> crypto::bigintToBytes(const bigint& in) {
+	const size_t len = std::max<size_t>(1, (bigintBits(in) + 7) / 8);
+	secure_vector<byte> res(len);
+	bigintToBytes(in, res.data(), len);
+
+	return res;
+}
+
+size_t crypto::bigintBits(const bigint& a) {
+	for (size_t i = a.size(); i-- > 0;) {
+		if (a[i] != 0) {
+			size_t bits = (i + 1) * limbBits;
+			for (limb top = a[i]; (top >> (limbBits - 1)) == 0; top <<= 1u) bits--;
+			return bits;
+		}
+	}
+
+	return 0;
+}
+
+limb crypto::bigintAdd(bigint& a, const bigint& b) {
+	uint64_t carry = 0;
+	for (size_t i = 0; i < a.size(); i++) {
+		const uint64_t sum = (uint64_t)a[i] + (i < b.size() ? b[i] : 0) + carry;
+		a[i] = (limb)sum;
+		carry = sum >> limbBits;
+	}
+
+	return (limb)carry;
+}
+
+limb crypto::bigintSubtract(bigint& a, const bigint& b) {
+	uint64_t borrow = 0;
+	for (size_t i = 0; i < a.size(); i++) {
+		const uint64_t diff = (uint64_t)a[i] - (i < b.size() ? b[i] : 0) - borrow;
+		a[i] = (limb)diff;
+		borrow = (diff >> limbBits) & 1u;
+	}
+
+	return (limb)borrow;
+}
+
+limb crypto::bigintMultiplyAddLimb(bigint& a, limb m, limb add) {
+	uint64_t carry = add;
+	for (limb& l : a) {
+		const uint64_t product = (uint64_t)l * m + carry;
+		l = (limb)product;
+		carry = product >> limbBits;
+	}
+
+	return (limb)carry;
+}
+
+limb crypto::bigintDivideLimb(bigint& a, limb d) {
+	uint64_t remainder = 0;
+	for (size_t i = a.size(); i-- > 0;) {
+		const uint64_t current = (remainder << limbBits) | a[i];
+		a[i] = (limb)(current / d);
+		remainder = current % d;
+	}
+
+	return (limb)remainder;
+}
+
+limb crypto::bigintModLimb(const bigint& a, limb m) {
+	uint64_t remainder = 0;
+	for (size_t i = a.size(); i-- > 0;) {
+		remainder = ((remainder << limbBits) | a[i]) % m;
+	}
+
+	return (limb)remainder;
+}
+
+bigint crypto::bigintMultiply(const bigint& a, const bigint& b) {
+	bigint res(a.size() + b.size(), 0);
+	for (size_t i = 0; i < a.size(); i++) {
+		uint64_t carry = 0;
+		for (size_t j = 0; j < b.size(); j++) {
+			const uint64_t sum = (uint64_t)res[i + j] + (uint64_t)a[i] * b[j] + carry;
+			res[i + j] = (limb)sum;
+			carry = sum >> limbBits;
+		}
+		res[i + b.size()] = (limb)carry;
+	}
+
+	return res;
+}
+
+bigint crypto::bigintMod(const bigint& a, const bigint& m) {
+	if (bigintBits(m) == 0) throw std::invalid_argument("The modulus must not be zero");
+
+	// Binary long division, the remainder has an additional
+	// limb to hold the shifted value before the subtraction
+	const size_t s = m.size();
+	bigint r(s + 1, 0);
+	for (size_t bit = bigintBits(a); bit-- > 0;) {
+		for (size_t j = s; j > 0; j--) {
+			r[j] = (r[j] << 1u) | (r[j - 1] >> (limbBits - 1));
+		}
+		r[0] = (r[0] << 1u) | ((a[bit / limbBits] >> (bit % limbBits)) & 1u);
+
+		if (r[s] != 0 || greaterOrEqual(r.data(), m.data(), s)) {
+			r[s] -= subtractInPlace(r.data(), m.data(), s);
+		}
+	}
+
+	r.resize(s);
+	return r;
+}
+
+montgomeryContext::montgomeryContext(const byte* modulus, size_t len) {
+	// Skip leading zeros
+	while (len > 0 && *modulus == 0) {
+		modulus++;
+		len--;
+	}
+
+	if (len == 0 || (modulus[len - 1] & 1u) == 0 || (len == 1 && modulus[0] == 1)) {
+		throw std::invalid_argument("The modulus must be odd and greater than one");
+	}
+
+	const size_t limbs = (len + sizeof(limb) - 1) / sizeof(limb);
+	if (limbs > maxLimbs) {
+		throw std::invalid_argument("The modulus is too large");
+	}
+
+	n = bigintFromBytes(modulus, len, limbs);
+
+	// Newton iteration for n[0]^-1 mod 2^32, each step doubles the number of correct bits
+	limb inv = n[0];
+	for (int i = 0; i < 5; i++) {
+		inv *= 2 - n[0] * inv;
+	}
+	n0inv = (limb)0 - inv;
+
+	size_t bits = limbs * limbBits;
+	for (limb top = n[limbs - 1]; (top >> (limbBits - 1)) == 0; top <<= 1u) bits--;
+
+	// Start with 2^(bits - 1), which is smaller than n and double it until it is
+	// R * 2^limbs mod n, with R = 2^(32 * limbs). Then square it five times in
+	// montgomery form, which results in R * 2^(32 * limbs) = R^2 mod n.
+	bigint r(limbs, 0);
+	r[(bits - 1) / limbBits] = (limb)1 << ((bits - 1) % limbBits);
+	for (size_t i = bits - 1; i < limbs * limbBits + limbs; i++) {
+		const limb carry = r[limbs - 1] >> (limbBits - 1);
+		for (size_t j = limbs - 1; j > 0; j--) {
+			r[j] = (r[j] << 1u) | (r[j - 1] >> (limbBits - 1));
+		}
+		r[0] <<= 1u;
+
+		if (carry || greaterOrEqual(r.data(), n.data(), limbs)) {
+			subtractInPlace(r.data(), n.data(), limbs);
+		}
+	}
+
+	for (int i = 0; i < 5; i++) {
+		multiply(r.data(), r.data(), r.data());
+	}
+
+	r2 = std::move(r);
+}
+
+const bigint& montgomeryContext::modulus() const noexcept {
+	return n;
+}
+
+size_t montgomeryContext::limbs() const noexcept {
+	return n.size();
+}
+
+void montgomeryContext::multiply(const limb* a, const limb* b, limb* out) const {
+	// Coarsely integrated operand scanning (CIOS)
+	const size_t s = n.size();
+	limb t[maxLimbs + 2];
+	std::fill_n(t, s + 2, 0);
+
+	for (size_t i = 0; i < s; i++) {
+		uint64_t carry = 0;
+		for (size_t j = 0; j < s; j++) {
+			const uint64_t sum = (uint64_t)t[j] + (uint64_t)a[j] * b[i] + carry;
+			t[j] = (limb)sum;
+			carry = sum >> limbBits;
+		}
+
+		uint64_t sum = (uint64_t)t[s] + carry;
+		t[s] = (limb)sum;
+		t[s + 1] = (limb)(sum >> limbBits);
+
+		const limb m = t[0] * n0inv;
+		sum = (uint64_t)t[0] + (uint64_t)m * n[0];
+		carry = sum >> limbBits;
+		for (size_t j = 1; j < s; j++) {
+			sum = (uint64_t)t[j] + (uint64_t)m * n[j] + carry;
+			t[j - 1] = (limb)sum;
+			carry = sum >> limbBits;
+		}
+
+		sum = (uint64_t)t[s] + carry;
+		t[s - 1] = (limb)sum;
+		t[s] = t[s + 1] + (limb)(sum >> limbBits);
+	}
+
+	if (t[s] != 0 || greaterOrEqual(t, n.data(), s)) {
+		subtractInPlace(t, n.data(), s);
+	}
+
+	std::copy(t, t + s, out);
+}
+
+void montgomeryContext::toMontgomery(const limb* a, limb* out) const {
+	multiply(a, r2.data(), out);
+}
+
+bigint montgomeryContext::modExp(const bigint& base, const byte* exponent, size_t exponentLength) const {
+	const size_t s = n.size();
+
+	// Skip leading zeros
+	while (exponentLength > 0 && *exponent == 0) {
+		exponent++;
+		exponentLength--;
+	}
+
+	bigint one(s, 0);
+	one[0] = 1;
+	if (exponentLength == 0) return one;
+
+	// Convert the base into montgomery form
+	bigint x(s);
+	multiply(base.data(), r2.data(), x.data());
+
+	// Left to right square and multiply, starting below the most significant bit
+	bigint acc = x;
+	int bit = 7;
+	while (((exponent[0] >> bit) & 1u) == 0) bit--;
+	bit--;
+
+	for (size_t i = 0; i < exponentLength; i++) {
+		for (; bit >= 0; bit--) {
+			multiply(acc.data(), acc.data(), acc.data());
+			if ((exponent[i] >> bit) & 1u) {
+				multiply(acc.data(), x.data(), acc.data());
+			}
+		}
+
+		bit = 7;
+	}
+
+	// Convert the result back out of montgomery form
+	multiply(acc.data(), one.data(), acc.data());
+	return acc;
+}
+
+bigint montgomeryContext::modExpSecret(const bigint& base, const bigint& exponent) const {
+	const size_t s = n.size();
+
+	bigint one(s, 0);
+	one[0] = 1;
+
+	bigint x(s);
+	toMontgomery(base.data(), x.data());
+
+	// Start with one in montgomery form and always multiply,
+	// keeping the product only if the exponent bit is set
+	bigint acc(s);
+	toMontgomery(one.data(), acc.data());
+	bigint product(s);
+
+	for (size_t i = exponent.size(); i-- > 0;) {
+		for (unsigned bit = limbBits; bit-- > 0;) {
+			multiply(acc.data(), acc.data(), acc.data());
+			multiply(acc.data(), x.data(), product.data());
+
+			const limb mask = (limb)0 - ((exponent[i] >> bit) & 1u);
+			for (size_t j = 0; j < s; j++) {
+				acc[j] ^= (acc[j] ^ product[j]) & mask;
+			}
+		}
+	}
+
+	multiply(acc.data(), one.data(), acc.data());
+	return acc;
+}
\ No newline at end of file
@@ -0,0 +1,206 @@
+#ifndef PASSPORT_BIGINT_HPP
+#define PASSPORT_BIGINT_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "NodeMsPassport.hpp"
+
+namespace nodeMsPassport::crypto {
+	/**
+	 * A single big integer word
+	 */
+	using limb = uint32_t;
+
+	/**
+	 * A big integer, stored as little endian limbs.
+	 * Private key components are stored in big integers,
+	 * so the memory is zeroed when it is released.
+	 */
+	using bigint = secure_vector<limb>;
+
+	/**
+	 * Convert a big endian byte array to a big integer
+	 *
+	 * @param data the bytes to convert
+	 * @param len the number of bytes
+	 * @param limbs the number of limbs of the result. Must be large enough to hold the value.
+	 * @return the big integer
+	 */
+	bigint bigintFromBytes(const byte* data, size_t len, size_t limbs);
+
+	/**
+	 * Convert a big integer to a big endian byte array
+	 *
+	 * @param in the big integer to convert
+	 * @param out the output buffer
+	 * @param len the size of the output buffer. Excess high bytes are dropped.
+	 */
+	void bigintToBytes(const bigint& in, byte* out, size_t len);
+
+	/**
+	 * Convert a big integer to a big endian byte array without leading zeros
+	 *
+	 * @param in the big integer to convert
+	 * @return the bytes, at least one byte long
+	 */
+	secure_vector<byte> bigintToBytes(const bigint& in);
+
+	/**
+	 * Get the number of significant bits of a big integer
+	 *
+	 * @param a the value
+	 * @return the position of the highest set bit plus one, zero if a is zero
+	 */
+	size_t bigintBits(const bigint& a);
+
+	/**
+	 * Compare two big integers of the same size
+	 *
+	 * @param a the first value
+	 * @param b the second value
+	 * @return -1 if a < b, 0 if a == b, 1 if a > b
+	 */
+	int bigintCompare(const bigint& a, const bigint& b);
+
+	/**
+	 * Add b to a in place. b must not have more limbs than a.
+	 *
+	 * @param a the value to add to
+	 * @param b the value to add
+	 * @return the carry out of the highest limb of a
+	 */
+	limb bigintAdd(bigint& a, const bigint& b);
+
+	/**
+	 * Subtract b from a in place. b must not have more limbs than a.
+	 *
+	 * @param a the value to subtract from
+	 * @param b the value to subtract
+	 * @return the borrow out of the highest limb of a
+	 */
+	limb bigintSubtract(bigint& a, const bigint& b);
+
+	/**
+	 * Calculate a = a * m + add in place
+	 *
+	 * @param a the value to multiply
+	 * @param m the factor
+	 * @param add the value to add
+	 * @return the carry out of the highest limb of a
+	 */
+	limb bigintMultiplyAddLimb(bigint& a, limb m, limb add);
+
+	/**
+	 * Divide a by d in place
+	 *
+	 * @param a the dividend, replaced by the quotient
+	 * @param d the divisor, must not be zero
+	 * @return the remainder
+	 */
+	limb bigintDivideLimb(bigint& a, limb d);
+
+	/**
+	 * Calculate a mod m for a single limb m
+	 *
+	 * @param a the value to reduce
+	 * @param m the modulus, must not be zero
+	 * @return the remainder
+	 */
+	limb bigintModLimb(const bigint& a, limb m);
+
+	/**
+	 * Multiply two big integers
+	 *
+	 * @param a the first factor
+	 * @param b the second factor
+	 * @return the product, with a.size() + b.size() limbs
+	 */
+	bigint bigintMultiply(const bigint& a, const bigint& b);
+
+	/**
+	 * Calculate a mod m, for any non-zero m
+	 *
+	 * @param a the value to reduce
+	 * @param m the modulus
+	 * @return the remainder, with m.size() limbs
+	 */
+	bigint bigintMod(const bigint& a, const bigint& m);
+
+	/**
+	 * Precomputed values for montgomery arithmetic modulo an odd number
+	 */
+	class montgomeryContext {
+	public:
+		/**
+		 * Create a montgomery context
+		 *
+		 * @param modulus the big endian modulus. Must be odd.
+		 * @param len the length of the modulus in bytes
+		 */
+		montgomeryContext(const byte* modulus, size_t len);
+
+		/**
+		 * Get the modulus
+		 *
+		 * @return the modulus
+		 */
+		NODEMSPASSPORT_NODISCARD const bigint& modulus() const noexcept;
+
+		/**
+		 * Get the number of limbs used by every value in this context
+		 *
+		 * @return the number of limbs
+		 */
+		NODEMSPASSPORT_NODISCARD size_t limbs() const noexcept;
+
+		/**
+		 * Montgomery multiplication: out = a * b / R mod n.
+		 * out may alias a or b.
+		 *
+		 * @param a the first factor, must be smaller than the modulus
+		 * @param b the second factor, must be smaller than the modulus
+		 * @param out the result
+		 */
+		void multiply(const limb* a, const limb* b, limb* out) const;
+
+		/**
+		 * Convert a value into montgomery form: out = a * R mod n.
+		 * out may alias a.
+		 *
+		 * @param a the value to convert, must be smaller than the modulus
+		 * @param out the result
+		 */
+		void toMontgomery(const limb* a, limb* out) const;
+
+		/**
+		 * Calculate base ^ exponent mod n
+		 *
+		 * @param base the base, must be smaller than the modulus
+		 * @param exponent the big endian exponent
+		 * @param exponentLength the length of the exponent in bytes
+		 * @return the result
+		 */
+		NODEMSPASSPORT_NODISCARD bigint modExp(const bigint& base, const byte* exponent, size_t exponentLength) const;
+
+		/**
+		 * Calculate base ^ exponent mod n for a secret exponent.
+		 * The sequence of operations only depends on the number
+		 * of limbs of the exponent, not on its value.
+		 *
+		 * @param base the base, must be smaller than the modulus
+		 * @param exponent the exponent
+		 * @return the result
+		 */
+		NODEMSPASSPORT_NODISCARD bigint modExpSecret(const bigint& base, const bigint& exponent) const;
+
+	private:
+		bigint n;
+		// R^2 mod n, used to convert values into montgomery form
+		bigint r2;
+		// -n^-1 mod 2^32
+		limb n0inv;
+	};
+}
+
+#endif //PASSPORT_BIGINT_HPP
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include <Windows.h>
+#include <vcclr.h>
 
 #include "CLITools.hpp"
 
@@ -25,33 +26,23 @@ void CLITools::callVoidPassportFunction(String^ name, array<Object^>^ data) {
 }
 
 std::string CLITools::wstring_to_string(const std::wstring& in) {
-	std::string out(in.size() + 1, '\0');
-	size_t outSize;
-
-	errno_t err = wcstombs_s(&outSize, (char*)out.data(), out.size(), in.c_str(), in.size());
-	if (err) {
-		perror("Error creating string");
-		return std::string();
-	}
-
-	out.resize(outSize);
-	return out;
+	return utf::toUtf8(in);
 }
 
 std::string CLITools::string_to_std_string(String^ s) {
-	array<wchar_t>^ arr = s->ToCharArray();
-	int size = arr->Length;
-	std::wstring out(size, '\0');
-	for (int i = 0; i < size; i++) {
-		out[i] = arr[i];
-	}
+	if (String::IsNullOrEmpty(s)) return std::string();
 
-	return wstring_to_string(out);
+	// Transcode the characters of the managed string in place, without copying them first
+	pin_ptr<const wchar_t> chars = PtrToStringChars(s);
+	std::string out((size_t)s->Length * 3, '\0');
+	out.resize(utf::utf16ToUtf8(reinterpret_cast<const char16_t*>(chars), s->Length, &out[0]));
+
+	return out;
 }
 
 String^ CLITools::std_string_to_string(const std::string& in) {
-	std::wstring w_str = std::wstring(in.begin(), in.end());
-	return gcnew String(w_str.c_str());
+	const std::u16string chars = utf::toUtf16(in);
+	return gcnew String(reinterpret_cast<const wchar_t*>(chars.data()), 0, (int)chars.size());
 }
 
 secure_vector<byte> CLITools::byteArrayToVector(array<byte>^ data) {
@@ -63,6 +54,23 @@ secure_vector<byte> CLITools::byteArrayToVector(array<byte>^ data) {
 	return out;
 }
 
+secure_buffer CLITools::byteArrayToBuffer(array<byte>^ data) {
+	if (data->Length == 0) return secure_buffer();
+
+	pin_ptr<byte> ptr = &data[0];
+	return secure_buffer(ptr, data->Length);
+}
+
+array<unsigned char>^ CLITools::byteBufferToArray(const secure_buffer& in) {
+	array<byte>^ out = gcnew array<byte>((int)in.size());
+	if (!in.empty()) {
+		pin_ptr<byte> ptr = &out[0];
+		memcpy(ptr, in.data(), in.size());
+	}
+
+	return out;
+}
+
 array<unsigned char>^ CLITools::byteVectorToArray(const secure_vector<byte>& in) {
 	array<byte>^ out = gcnew array<byte>(in.size());
 	for (int i = 0; i < in.size(); i++) {
@@ -77,7 +85,8 @@ bool CLITools::convertBoolean(Boolean val) {
 }
 
 void CLITools::clearArray(array<byte>^ arr) {
-	for (int i = 0; i < arr->Length; i++) {
-		arr[i] = 0;
-	}
+	if (arr == nullptr || arr->Length == 0) return;
+
+	pin_ptr<byte> data = &arr[0];
+	util::secureWipe(data, arr->Length);
 }
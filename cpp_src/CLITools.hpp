@@ -22,7 +22,7 @@ namespace CLITools {
 	String^ getDllLocation();
 
 	/**
-	 * Convert a std::wstring to a std::string
+	 * Convert a std::wstring to an UTF-8 std::string
 	 *
 	 * @param in the string to convert
 	 * @return the converted string
@@ -30,7 +30,7 @@ namespace CLITools {
 	std::string wstring_to_string(const std::wstring& in);
 
 	/**
-	 * Convert a managed System::String to a std::string
+	 * Convert a managed System::String to an UTF-8 std::string
 	 *
 	 * @param s the string to convert
 	 * @return the converted C++ std::string
@@ -38,11 +38,9 @@ namespace CLITools {
 	std::string string_to_std_string(String^ s);
 
 	/**
-	 * Convert a unmanaged character array to a managed string.
-	 * Does not delete the character array.
-	 * Source: https://stackoverflow.com/a/39249779
+	 * Convert an UTF-8 std::string to a managed string
 	 *
-	 * @param char_array the char array to convert
+	 * @param in the string to convert
 	 * @return the System::String
 	 */
 	String^ std_string_to_string(const std::string& in);
@@ -55,6 +53,14 @@ namespace CLITools {
 	*/
 	secure_vector<byte> byteArrayToVector(array<byte>^ data);
 
+	/**
+	* Convert a managed byte array to a secure buffer.
+	*
+	* @param data the array to convert
+	* @return the converted buffer
+	*/
+	secure_buffer byteArrayToBuffer(array<byte>^ data);
+
 	/**
 	* Convert a char array to a managed byte array.
 	* Does not delete the input array
@@ -65,6 +71,14 @@ namespace CLITools {
 	*/
 	array<unsigned char>^ byteVectorToArray(const secure_vector<byte>& in);
 
+	/**
+	* Convert a secure buffer to a managed byte array
+	*
+	* @param in the buffer to convert
+	* @return the managed byte array
+	*/
+	array<unsigned char>^ byteBufferToArray(const secure_buffer& in);
+
 	/**
 	 * Convert a managed boolean to an unmanaged boolean
 	 *
@@ -107,11 +121,14 @@ namespace CLITools {
 	 */
 	template<class T>
 	inline Object^ anyToObject(const T& val) {
-		static_assert(std::is_same_v<T, std::string> || std::is_same_v<T, secure_vector<byte>>);
+		static_assert(std::is_same_v<T, std::string> || std::is_same_v<T, secure_vector<byte>> ||
+			std::is_same_v<T, secure_buffer>);
 		if constexpr (std::is_same_v<T, std::string>) {
 			return std_string_to_string(val);
 		} else if constexpr (std::is_same_v<T, secure_vector<byte>>) {
 			return byteVectorToArray(val);
+		} else if constexpr (std::is_same_v<T, secure_buffer>) {
+			return byteBufferToArray(val);
 		}
 	}
 
@@ -153,7 +170,8 @@ namespace CLITools {
 	 */
 	template<class T, class...Args>
 	inline T callFunc(String^ name, Args...args) {
-		static_assert(std::is_same_v<bool, T> || std::is_same_v<secure_vector<byte>, T> || std::is_same_v<void, T>);
+		static_assert(std::is_same_v<bool, T> || std::is_same_v<secure_vector<byte>, T> ||
+			std::is_same_v<secure_buffer, T> || std::is_same_v<void, T>);
 		if constexpr (std::is_same_v<bool, T>) {
 			Boolean ret = callPassportFunction<Boolean>(name, convertArgs(args...));
 			return convertBoolean(ret);
@@ -162,6 +180,12 @@ namespace CLITools {
 			secure_vector<byte> out = byteArrayToVector(ret);
 			clearArray(ret);
 
+			return out;
+		} else if constexpr (std::is_same_v<secure_buffer, T>) {
+			array<byte>^ ret = callPassportFunction<array<byte>^>(name, convertArgs(args...));
+			secure_buffer out = byteArrayToBuffer(ret);
+			clearArray(ret);
+
 			return out;
 		} else if constexpr (std::is_same_v<void, T>) {
 			callVoidPassportFunction(name, convertArgs(args...));
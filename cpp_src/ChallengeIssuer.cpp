@@ -0,0 +1,133 @@
+#include <mutex>
+#include <chrono>
+#include <stdexcept>
+#include <algorithm>
+
+#include "ChallengeIssuer.hpp"
+#include "ChallengePool.hpp"
+#include "Drbg.hpp"
+
+using namespace nodeMsPassport;
+using namespace nodeMsPassport::crypto;
+
+namespace {
+	constexpr size_t timestampOffset = 1 + challengeIssuer::nonceSize;
+	constexpr size_t bindingOffset = timestampOffset + challengeIssuer::timestampSize;
+	constexpr size_t tagOffset = bindingOffset + challengeIssuer::bindingSize;
+
+	std::mutex sharedMtx;
+	std::shared_ptr<const challengeIssuer> sharedIssuer;
+}
+
+challengeIssuer::challengeIssuer(const byte* key, size_t len, uint64_t maxAge) noexcept : hmac(key, len),
+	maxAge(maxAge) {}
+
+secure_buffer challengeIssuer::issue(const std::string& accountId) const {
+	return issue(accountId, now());
+}
+
+secure_buffer challengeIssuer::issue(const std::string& accountId, uint64_t timestamp) const {
+	secure_buffer res(challengeSize);
+	byte* data = res.data();
+
+	data[0] = version;
+	challengePool::shared().take(data + 1, nonceSize);
+	for (size_t i = 0; i < timestampSize; i++) {
+		data[timestampOffset + i] = (byte)(timestamp >> (8u * (timestampSize - 1 - i)));
+	}
+	bind(accountId, data + bindingOffset);
+
+	hmacSha256 mac = hmac;
+	mac.update(data, tagOffset);
+	const hmacSha256::tag tag = mac.finish();
+	std::copy(tag.begin(), tag.end(), data + tagOffset);
+
+	return res;
+}
+
+challengeIssuer::status challengeIssuer::verify(const secure_buffer& challenge, const std::string& accountId) const {
+	return verify(challenge, accountId, now());
+}
+
+challengeIssuer::status challengeIssuer::verify(const secure_buffer& challenge, const std::string& accountId,
+	uint64_t now) const {
+	if (challenge.size() != challengeSize || challenge.data()[0] != version) return status::malformed;
+
+	// Nothing but the tag is looked at before the tag is verified
+	hmacSha256 mac = hmac;
+	mac.update(challenge.data(), tagOffset);
+	const hmacSha256::tag tag = mac.finish();
+	if (!constantTimeEqual(tag.data(), challenge.data() + tagOffset, tag.size())) return status::badTag;
+
+	byte binding[bindingSize];
+	bind(accountId, binding);
+	if (!constantTimeEqual(binding, challenge.data() + bindingOffset, bindingSize)) return status::wrongAccount;
+
+	const uint64_t issued = timestamp(challenge);
+	if (issued > now + maxClockSkew) return status::notYetValid;
+	if (issued + maxAge < now) return status::expired;
+
+	return status::valid;
+}
+
+uint64_t challengeIssuer::getMaxAge() const noexcept {
+	return maxAge;
+}
+
+uint64_t challengeIssuer::timestamp(const secure_buffer& challenge) noexcept {
+	uint64_t res = 0;
+	for (size_t i = 0; i < timestampSize; i++) {
+		res = (res << 8u) | challenge.data()[timestampOffset + i];
+	}
+
+	return res;
+}
+
+const char* challengeIssuer::statusName(status s) noexcept {
+	switch (s) {
+		case status::valid:
+			return "valid";
+		case status::malformed:
+			return "malformed";
+		case status::badTag:
+			return "bad tag";
+		case status::wrongAccount:
+			return "wrong account";
+		case status::expired:
+			return "expired";
+		case status::notYetValid:
+			return "not yet valid";
+		default:
+			return "unknown";
+	}
+}
+
+uint64_t challengeIssuer::now() noexcept {
+	using namespace std::chrono;
+	return (uint64_t)duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+void challengeIssuer::setShared(const secure_vector<byte>& key, uint64_t maxAge) {
+	if (key.size() < 16) throw std::invalid_argument("The challenge key must be at least 16 bytes long");
+
+	auto issuer = std::make_shared<const challengeIssuer>(key.data(), key.size(), maxAge);
+	std::unique_lock<std::mutex> lock(sharedMtx);
+	sharedIssuer = std::move(issuer);
+}
+
+std::shared_ptr<const challengeIssuer> challengeIssuer::shared() {
+	std::unique_lock<std::mutex> lock(sharedMtx);
+	if (!sharedIssuer) {
+		byte key[32];
+		secureRandom(key, sizeof(key));
+		sharedIssuer = std::make_shared<const challengeIssuer>(key, sizeof(key));
+		util::secureWipe(key, sizeof(key));
+	}
+
+	return sharedIssuer;
+}
+
+void challengeIssuer::bind(const std::string& accountId, byte* out) noexcept {
+	const sha256::digest hash = sha256::hash(reinterpret_cast<const byte*>(accountId.data()), accountId.size());
+	std::copy_n(hash.begin(), bindingSize, out);
+}
\ No newline at end of file
@@ -0,0 +1,149 @@
+#ifndef PASSPORT_CHALLENGEISSUER_HPP
+#define PASSPORT_CHALLENGEISSUER_HPP
+
+#include <memory>
+#include <string>
+#include <cstdint>
+
+#include "Hmac.hpp"
+
+namespace nodeMsPassport::crypto {
+	/**
+	 * Issues and verifies stateless challenges. A challenge is
+	 * version || nonce || timestamp || account binding || HMAC-SHA256 tag,
+	 * the tag covers all previous fields. Every server holding the key can
+	 * verify a challenge issued by any other server without storing it.
+	 */
+	class challengeIssuer {
+	public:
+		static constexpr byte version = 1;
+		static constexpr size_t nonceSize = 16;
+		static constexpr size_t timestampSize = 8;
+		// The first bytes of the SHA-256 hash of the account id
+		static constexpr size_t bindingSize = 16;
+		static constexpr size_t challengeSize = 1 + nonceSize + timestampSize + bindingSize + hmacSha256::tagSize;
+
+		/**
+		 * The default maximum age of a challenge in milliseconds
+		 */
+		static constexpr uint64_t defaultMaxAge = 5 * 60 * 1000;
+
+		/**
+		 * The clock skew between servers tolerated for challenges issued in the future
+		 */
+		static constexpr uint64_t maxClockSkew = 30 * 1000;
+
+		/**
+		 * The result of a challenge verification
+		 */
+		enum class status {
+			valid,
+			malformed,
+			badTag,
+			wrongAccount,
+			expired,
+			notYetValid
+		};
+
+		/**
+		 * Create a challenge issuer
+		 *
+		 * @param key the key used to authenticate the challenges, should be at least 32 bytes
+		 * @param len the length of the key
+		 * @param maxAge the maximum age of a challenge in milliseconds
+		 */
+		challengeIssuer(const byte* key, size_t len, uint64_t maxAge = defaultMaxAge) noexcept;
+
+		/**
+		 * Issue a challenge for an account
+		 *
+		 * @param accountId the account the challenge is bound to
+		 * @return the challenge
+		 */
+		NODEMSPASSPORT_NODISCARD secure_buffer issue(const std::string& accountId) const;
+
+		/**
+		 * Issue a challenge for an account with a fixed time
+		 *
+		 * @param accountId the account the challenge is bound to
+		 * @param timestamp the time of issue in milliseconds since the unix epoch
+		 * @return the challenge
+		 */
+		NODEMSPASSPORT_NODISCARD secure_buffer issue(const std::string& accountId, uint64_t timestamp) const;
+
+		/**
+		 * Verify a challenge. The tag is checked before any other field.
+		 *
+		 * @param challenge the challenge to verify
+		 * @param accountId the account the challenge must be bound to
+		 * @return the verification result
+		 */
+		NODEMSPASSPORT_NODISCARD status verify(const secure_buffer& challenge, const std::string& accountId) const;
+
+		/**
+		 * Verify a challenge at a fixed time
+		 *
+		 * @param challenge the challenge to verify
+		 * @param accountId the account the challenge must be bound to
+		 * @param now the current time in milliseconds since the unix epoch
+		 * @return the verification result
+		 */
+		NODEMSPASSPORT_NODISCARD status verify(const secure_buffer& challenge, const std::string& accountId,
+			uint64_t now) const;
+
+		/**
+		 * Get the maximum age of a challenge
+		 *
+		 * @return the maximum age in milliseconds
+		 */
+		NODEMSPASSPORT_NODISCARD uint64_t getMaxAge() const noexcept;
+
+		/**
+		 * Get the time a challenge was issued at. The challenge must have been verified.
+		 *
+		 * @param challenge the challenge
+		 * @return the time of issue in milliseconds since the unix epoch
+		 */
+		static uint64_t timestamp(const secure_buffer& challenge) noexcept;
+
+		/**
+		 * Get the name of a verification result
+		 *
+		 * @param s the result
+		 * @return the name of the result
+		 */
+		static const char* statusName(status s) noexcept;
+
+		/**
+		 * Get the current time in milliseconds since the unix epoch
+		 *
+		 * @return the current time
+		 */
+		static uint64_t now() noexcept;
+
+		/**
+		 * Set the key used by the shared issuer. All servers verifying
+		 * each other's challenges must use the same key.
+		 *
+		 * @param key the key
+		 * @param maxAge the maximum age of a challenge in milliseconds
+		 */
+		static void setShared(const secure_vector<byte>& key, uint64_t maxAge = defaultMaxAge);
+
+		/**
+		 * Get the process wide issuer. Uses a random key if no key was set,
+		 * challenges can then only be verified by this process.
+		 *
+		 * @return the shared issuer
+		 */
+		static std::shared_ptr<const challengeIssuer> shared();
+
+	private:
+		static void bind(const std::string& accountId, byte* out) noexcept;
+
+		hmacSha256 hmac;
+		uint64_t maxAge;
+	};
+}
+
+#endif //PASSPORT_CHALLENGEISSUER_HPP
\ No newline at end of file
@@ -0,0 +1,168 @@
+#include <chrono>
+#include <stdexcept>
+#include <algorithm>
+
+#include "ChallengePool.hpp"
+#include "Drbg.hpp"
+
+using namespace nodeMsPassport;
+using namespace nodeMsPassport::crypto;
+
+namespace {
+	std::mutex sharedMtx;
+	size_t sharedDepth = 1024;
+	size_t sharedLowWater = 256;
+	bool sharedStarted = false;
+
+	// Check the fill level regularly, in case a refill request was missed
+	constexpr std::chrono::milliseconds refillPollInterval(50);
+
+	size_t roundUpToPowerOfTwo(size_t value) {
+		size_t res = 1;
+		while (res < value) res <<= 1u;
+		return res;
+	}
+}
+
+challengePool::challengePool(size_t depth, size_t lowWater) : mask(roundUpToPowerOfTwo(std::max<size_t>(depth, 2)) - 1),
+	lowWater(std::min(lowWater, mask)), forkGeneration(crypto::forkGeneration()), head(0), tail(0), taken(0),
+	exhausted(0), generated(0), refillRequested(false), stopping(false) {
+	slots = std::make_unique<slot[]>(mask + 1);
+	for (size_t i = 0; i <= mask; i++) {
+		slots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	refillThread = std::thread(&challengePool::refillLoop, this);
+}
+
+bool challengePool::take(byte* out, size_t len) {
+	if (len > maxChallengeSize) throw std::invalid_argument("The challenge is too large");
+
+	// A forked child never uses the pool, its refill thread did not survive the fork
+	if (forkGeneration == crypto::forkGeneration() && tryPop(out, len)) {
+		taken.fetch_add(1, std::memory_order_relaxed);
+
+		if (available() <= lowWater && !refillRequested.exchange(true, std::memory_order_relaxed)) {
+			refillCv.notify_one();
+		}
+
+		return true;
+	}
+
+	secureRandom(out, len);
+	exhausted.fetch_add(1, std::memory_order_relaxed);
+	if (!refillRequested.exchange(true, std::memory_order_relaxed)) refillCv.notify_one();
+
+	return false;
+}
+
+challengePool::statistics challengePool::getStatistics() const noexcept {
+	statistics res;
+	res.taken = taken.load(std::memory_order_relaxed);
+	res.exhausted = exhausted.load(std::memory_order_relaxed);
+	res.generated = generated.load(std::memory_order_relaxed);
+	res.available = available();
+	res.depth = mask + 1;
+
+	return res;
+}
+
+void challengePool::setSharedConfiguration(size_t depth, size_t lowWater) {
+	if (lowWater >= depth) throw std::invalid_argument("The low-water mark must be smaller than the depth");
+
+	std::unique_lock<std::mutex> lock(sharedMtx);
+	if (sharedStarted) throw std::logic_error("The shared challenge pool is already running");
+	sharedDepth = depth;
+	sharedLowWater = lowWater;
+}
+
+challengePool& challengePool::shared() {
+	static challengePool pool = [] {
+		std::unique_lock<std::mutex> lock(sharedMtx);
+		sharedStarted = true;
+		return challengePool(sharedDepth, sharedLowWater);
+	}();
+
+	return pool;
+}
+
+challengePool::~challengePool() {
+	std::unique_lock<std::mutex> lock(refillMtx);
+	stopping = true;
+	lock.unlock();
+	refillCv.notify_all();
+
+	if (refillThread.joinable()) refillThread.join();
+	for (size_t i = 0; i <= mask; i++) {
+		util::secureWipe(slots[i].data.data(), maxChallengeSize);
+	}
+}
+
+bool challengePool::tryPush() {
+	// Bounded MPMC queue, every slot stores the position it may be used at next
+	size_t pos = tail.load(std::memory_order_relaxed);
+	while (true) {
+		slot& s = slots[pos & mask];
+		const size_t sequence = s.sequence.load(std::memory_order_acquire);
+		const auto diff = (intptr_t)sequence - (intptr_t)pos;
+
+		if (diff == 0) {
+			if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+				secureRandom(s.data.data(), maxChallengeSize);
+				s.sequence.store(pos + 1, std::memory_order_release);
+				return true;
+			}
+		} else if (diff < 0) {
+			// The pool is full
+			return false;
+		} else {
+			pos = tail.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+bool challengePool::tryPop(byte* out, size_t len) {
+	size_t pos = head.load(std::memory_order_relaxed);
+	while (true) {
+		slot& s = slots[pos & mask];
+		const size_t sequence = s.sequence.load(std::memory_order_acquire);
+		const auto diff = (intptr_t)sequence - (intptr_t)(pos + 1);
+
+		if (diff == 0) {
+			if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+				std::copy_n(s.data.data(), len, out);
+				util::secureWipe(s.data.data(), maxChallengeSize);
+				s.sequence.store(pos + mask + 1, std::memory_order_release);
+				return true;
+			}
+		} else if (diff < 0) {
+			// The pool is empty
+			return false;
+		} else {
+			pos = head.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+size_t challengePool::available() const noexcept {
+	const size_t h = head.load(std::memory_order_relaxed);
+	const size_t t = tail.load(std::memory_order_relaxed);
+	return t > h ? t - h : 0;
+}
+
+void challengePool::refillLoop() {
+	while (true) {
+		std::unique_lock<std::mutex> lock(refillMtx);
+		refillCv.wait_for(lock, refillPollInterval, [this] {
+			return stopping || refillRequested.load(std::memory_order_relaxed) || available() <= lowWater;
+		});
+
+		if (stopping) return;
+		lock.unlock();
+
+		refillRequested.store(false, std::memory_order_relaxed);
+		while (tryPush()) {
+			generated.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+}
\ No newline at end of file
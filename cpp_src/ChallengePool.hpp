@@ -0,0 +1,128 @@
+#ifndef PASSPORT_CHALLENGEPOOL_HPP
+#define PASSPORT_CHALLENGEPOOL_HPP
+
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <cstdint>
+#include <condition_variable>
+
+#include "NodeMsPassport.hpp"
+
+namespace nodeMsPassport::crypto {
+	/**
+	 * A pool of pre-generated random challenges. The challenges are stored in a
+	 * lock-free bounded ring buffer and taken in constant time. A background thread
+	 * refills the pool from secureRandom once it drops to the low-water mark.
+	 * If the pool is empty, the challenge is generated by the calling thread.
+	 */
+	class challengePool {
+	public:
+		/**
+		 * The maximum size of a challenge in bytes
+		 */
+		static constexpr size_t maxChallengeSize = 64;
+
+		/**
+		 * The pool statistics
+		 */
+		struct statistics {
+			// The number of challenges taken from the pool
+			uint64_t taken = 0;
+			// The number of challenges generated by the caller because the pool was empty
+			uint64_t exhausted = 0;
+			// The number of challenges generated by the background thread
+			uint64_t generated = 0;
+			// The number of challenges currently stored
+			size_t available = 0;
+			// The maximum number of challenges stored
+			size_t depth = 0;
+		};
+
+		/**
+		 * Create a challenge pool and start its refill thread
+		 *
+		 * @param depth the number of challenges to keep. Rounded up to a power of two.
+		 * @param lowWater refill the pool once it holds this many challenges or less
+		 */
+		explicit challengePool(size_t depth = 1024, size_t lowWater = 256);
+
+		challengePool(const challengePool&) = delete;
+
+		challengePool& operator=(const challengePool&) = delete;
+
+		/**
+		 * Take a challenge from the pool. Thread safe.
+		 * Throws std::invalid_argument if len is larger than maxChallengeSize.
+		 *
+		 * @param out the buffer to write the challenge to
+		 * @param len the size of the challenge in bytes
+		 * @return false if the pool was empty and the challenge was generated by the caller
+		 */
+		bool take(byte* out, size_t len);
+
+		/**
+		 * Get the current statistics
+		 *
+		 * @return the pool statistics
+		 */
+		NODEMSPASSPORT_NODISCARD statistics getStatistics() const noexcept;
+
+		/**
+		 * Set the depth and low-water mark of the shared pool.
+		 * Throws std::logic_error if the shared pool is already running.
+		 *
+		 * @param depth the number of challenges to keep
+		 * @param lowWater refill the pool once it holds this many challenges or less
+		 */
+		static void setSharedConfiguration(size_t depth, size_t lowWater);
+
+		/**
+		 * Get the process wide challenge pool
+		 *
+		 * @return the shared challenge pool
+		 */
+		static challengePool& shared();
+
+		~challengePool();
+
+	private:
+		struct slot {
+			// The position in the ring this slot may next be written (== position)
+			// or read (== position + 1) at
+			std::atomic<size_t> sequence;
+			std::array<byte, maxChallengeSize> data;
+		};
+
+		bool tryPush();
+
+		bool tryPop(byte* out, size_t len);
+
+		NODEMSPASSPORT_NODISCARD size_t available() const noexcept;
+
+		void refillLoop();
+
+		std::unique_ptr<slot[]> slots;
+		size_t mask;
+		size_t lowWater;
+		// The challenges stored before a fork are shared with the parent process
+		uint64_t forkGeneration;
+
+		alignas(64) std::atomic<size_t> head;
+		alignas(64) std::atomic<size_t> tail;
+
+		std::atomic<uint64_t> taken;
+		std::atomic<uint64_t> exhausted;
+		std::atomic<uint64_t> generated;
+
+		std::atomic<bool> refillRequested;
+		std::mutex refillMtx;
+		std::condition_variable refillCv;
+		bool stopping;
+		std::thread refillThread;
+	};
+}
+
+#endif //PASSPORT_CHALLENGEPOOL_HPP
\ No newline at end of file
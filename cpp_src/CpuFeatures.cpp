@@ -0,0 +1,84 @@
+#include "CpuFeatures.hpp"
+
+#ifdef NODEMSPASSPORT_X86
+#   ifdef _MSC_VER
+#       include <intrin.h>
+#   else
+#       include <cpuid.h>
+#   endif
+#endif
+
+using namespace nodeMsPassport;
+
+#ifdef NODEMSPASSPORT_X86
+/**
+ * Execute the cpuid instruction
+ *
+ * @param leaf the leaf to query
+ * @param subLeaf the sub leaf to query
+ * @param regs the output registers eax, ebx, ecx, edx
+ */
+static void cpuid(unsigned leaf, unsigned subLeaf, unsigned regs[4]) {
+#ifdef _MSC_VER
+	int tmp[4];
+	__cpuidex(tmp, (int)leaf, (int)subLeaf);
+	for (int i = 0; i < 4; i++) regs[i] = (unsigned)tmp[i];
+#else
+	__cpuid_count(leaf, subLeaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+/**
+ * Read the XCR0 register to check which register
+ * states are saved by the operating system
+ *
+ * @return the value of XCR0
+ */
+static unsigned long long xgetbv0() {
+#ifdef _MSC_VER
+	return _xgetbv(0);
+#else
+	unsigned eax, edx;
+	__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+	return ((unsigned long long)edx << 32u) | eax;
+#endif
+}
+
+static cpu::features queryFeatures() {
+	cpu::features res;
+	unsigned regs[4];
+
+	cpuid(0, 0, regs);
+	const unsigned maxLeaf = regs[0];
+	if (maxLeaf < 1) return res;
+
+	cpuid(1, 0, regs);
+	res.sse2 = (regs[3] & (1u << 26u)) != 0;
+	res.ssse3 = (regs[2] & (1u << 9u)) != 0;
+	res.sse41 = (regs[2] & (1u << 19u)) != 0;
+
+	// AVX requires the os to save the ymm registers
+	const bool osxsave = (regs[2] & (1u << 27u)) != 0;
+	const bool avx = (regs[2] & (1u << 28u)) != 0;
+	const bool ymmSaved = osxsave && (xgetbv0() & 0x6u) == 0x6u;
+
+	if (maxLeaf >= 7) {
+		cpuid(7, 0, regs);
+		res.avx2 = avx && ymmSaved && (regs[1] & (1u << 5u)) != 0;
+		res.bmi2 = (regs[1] & (1u << 8u)) != 0;
+		res.adx = (regs[1] & (1u << 19u)) != 0;
+		res.sha = (regs[1] & (1u << 29u)) != 0;
+	}
+
+	return res;
+}
+#else
+static cpu::features queryFeatures() {
+	return cpu::features();
+}
+#endif
+
+const cpu::features& cpu::getFeatures() {
+	static const features f = queryFeatures();
+	return f;
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#ifndef PASSPORT_CPUFEATURES_HPP
+#define PASSPORT_CPUFEATURES_HPP
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#   define NODEMSPASSPORT_X86
+#endif
+
+// Functions using intrinsics of an instruction set that may not be
+// enabled globally must be marked with the instruction set on gcc and clang.
+// MSVC allows the use of any intrinsic without any additional flags.
+#if defined(NODEMSPASSPORT_X86) && (defined(__GNUC__) || defined(__clang__))
+#   define NODEMSPASSPORT_TARGET(isa) __attribute__((target(isa)))
+#else
+#   define NODEMSPASSPORT_TARGET(isa)
+#endif
+
+namespace nodeMsPassport::cpu {
+	/**
+	 * The instruction set extensions supported by the cpu
+	 * and enabled by the operating system
+	 */
+	struct features {
+		bool sse2 = false;
+		bool ssse3 = false;
+		bool sse41 = false;
+		bool avx2 = false;
+		bool bmi2 = false;
+		bool adx = false;
+		bool sha = false;
+	};
+
+	/**
+	 * Get the features supported by this cpu.
+	 * The cpu is only queried once, any
+	 * subsequent calls return the cached result.
+	 *
+	 * @return the supported cpu features
+	 */
+	const features& getFeatures();
+}
+
+#endif //PASSPORT_CPUFEATURES_HPP
\ No newline at end of file
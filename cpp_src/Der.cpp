@@ -0,0 +1,263 @@
+#include <string>
+#include <stdexcept>
+#include <algorithm>
+#include <initializer_list>
+
+#include "Der.hpp"
+
+using namespace nodeMsPassport;
+using namespace nodeMsPassport::der;
+
+namespace {
+	// 1.2.840.113549.1.1.1
+	const byte rsaEncryptionOid[] = {0x2A, 0x86, 0x48, 0x86, 0xF7, 0x0D, 0x01, 0x01, 0x01};
+	// 1.2.840.10045.2.1
+	const byte ecPublicKeyOid[] = {0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x02, 0x01};
+	// 1.2.840.10045.3.1.7
+	const byte prime256v1Oid[] = {0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x03, 0x01, 0x07};
+
+	/**
+	 * Append the values of multiple encoded values
+	 */
+	secure_vector<byte> concat(std::initializer_list<const secure_vector<byte>*> values) {
+		secure_vector<byte> res;
+		for (const secure_vector<byte>* value : values) {
+			res.insert(res.end(), value->begin(), value->end());
+		}
+
+		return res;
+	}
+}
+
+reader::reader(span data, const char* subject) noexcept : pos(data.data), end(data.data + data.size),
+	subject(subject) {}
+
+span reader::read(byte tag) {
+	if (pos >= end || *pos++ != tag) fail("unexpected tag");
+	if (pos >= end) fail("missing length");
+
+	size_t len = *pos++;
+	if (len & 0x80u) {
+		// Long form. The indefinite form (zero length bytes) is not allowed in DER.
+		const size_t lengthBytes = len & 0x7fu;
+		if (lengthBytes == 0 || lengthBytes > sizeof(size_t) || (size_t)(end - pos) < lengthBytes) {
+			fail("invalid length");
+		}
+
+		// The length must be encoded with as few bytes as possible
+		if (*pos == 0) fail("non-minimal length");
+
+		len = 0;
+		for (size_t i = 0; i < lengthBytes; i++) {
+			len = (len << 8u) | *pos++;
+		}
+
+		if (len < 0x80u) fail("non-minimal length");
+	}
+
+	if ((size_t)(end - pos) < len) fail("truncated value");
+
+	const span content{pos, len};
+	pos += len;
+	return content;
+}
+
+span reader::readPositiveInteger() {
+	span value = read(TAG_INTEGER);
+	if (value.empty()) fail("empty integer");
+	if (value.data[0] & 0x80u) fail("negative integer");
+
+	// A leading zero is only allowed if the next byte would make the value negative
+	if (value.data[0] == 0 && value.size > 1) {
+		if ((value.data[1] & 0x80u) == 0) fail("non-minimal integer");
+		value.data++;
+		value.size--;
+	}
+
+	return value;
+}
+
+bool reader::peek(byte tag) const noexcept {
+	return pos < end && *pos == tag;
+}
+
+bool reader::empty() const noexcept {
+	return pos == end;
+}
+
+void reader::expectEnd() const {
+	if (!empty()) fail("trailing data");
+}
+
+void reader::fail(const char* reason) const {
+	throw std::invalid_argument(std::string("Invalid ") + subject + ": " + reason);
+}
+
+subjectPublicKeyInfo der::parseSubjectPublicKeyInfo(span data) {
+	if (data.data == nullptr || data.empty()) throw std::invalid_argument("The public key must not be empty");
+
+	// SubjectPublicKeyInfo ::= SEQUENCE { algorithm AlgorithmIdentifier, subjectPublicKey BIT STRING }
+	reader outer(data);
+	reader spki(outer.read(TAG_SEQUENCE));
+	outer.expectEnd();
+
+	// AlgorithmIdentifier ::= SEQUENCE { algorithm OBJECT IDENTIFIER, parameters ANY DEFINED BY algorithm OPTIONAL }
+	const span algorithmIdentifier = spki.read(TAG_SEQUENCE);
+	reader algorithm(algorithmIdentifier);
+
+	subjectPublicKeyInfo res;
+	res.algorithm = algorithm.read(TAG_OID);
+	if (res.algorithm.empty()) throw std::invalid_argument("Invalid public key: empty algorithm identifier");
+
+	const byte* parametersEnd = algorithmIdentifier.data + algorithmIdentifier.size;
+	res.parameters.data = res.algorithm.data + res.algorithm.size;
+	res.parameters.size = parametersEnd - res.parameters.data;
+
+	const span bitString = spki.read(TAG_BIT_STRING);
+	if (bitString.empty() || bitString.data[0] != 0) throw std::invalid_argument("Invalid public key: invalid bit string");
+	spki.expectEnd();
+
+	res.publicKey = span{bitString.data + 1, bitString.size - 1};
+	return res;
+}
+
+bool der::isRsaKey(const subjectPublicKeyInfo& info) noexcept {
+	return info.algorithm.equals(rsaEncryptionOid, sizeof(rsaEncryptionOid));
+}
+
+rsaPublicKeyView der::parseRsaPublicKey(const subjectPublicKeyInfo& info) {
+	if (!isRsaKey(info)) throw std::invalid_argument("Invalid public key: not an RSA key");
+
+	// The parameters must be NULL, some encoders leave them out
+	if (!info.parameters.empty()) {
+		reader parameters(info.parameters);
+		if (!parameters.read(TAG_NULL).empty()) {
+			throw std::invalid_argument("Invalid public key: invalid algorithm parameters");
+		}
+		if (!parameters.empty()) throw std::invalid_argument("Invalid public key: invalid algorithm parameters");
+	}
+
+	// RSAPublicKey ::= SEQUENCE { modulus INTEGER, publicExponent INTEGER }
+	reader outer(info.publicKey);
+	reader key(outer.read(TAG_SEQUENCE));
+	outer.expectEnd();
+
+	rsaPublicKeyView res;
+	res.modulus = key.readPositiveInteger();
+	res.exponent = key.readPositiveInteger();
+	key.expectEnd();
+
+	return res;
+}
+
+bool der::isEcKey(const subjectPublicKeyInfo& info) noexcept {
+	return info.algorithm.equals(ecPublicKeyOid, sizeof(ecPublicKeyOid));
+}
+
+ecPublicKeyView der::parseEcPublicKey(const subjectPublicKeyInfo& info) {
+	if (!isEcKey(info)) throw std::invalid_argument("Invalid public key: not an EC key");
+
+	// ECParameters ::= CHOICE { namedCurve OBJECT IDENTIFIER, ... }, only named curves are allowed
+	reader parameters(info.parameters);
+	if (!parameters.peek(TAG_OID)) throw std::invalid_argument("Invalid public key: missing named curve");
+	if (!parameters.read(TAG_OID).equals(prime256v1Oid, sizeof(prime256v1Oid))) {
+		throw std::invalid_argument("Invalid public key: unsupported curve");
+	}
+	parameters.expectEnd();
+
+	// The point is stored directly in the bit string
+	return ecPublicKeyView{info.publicKey};
+}
+
+ecdsaSignatureView der::parseEcdsaSignature(span data) {
+	if (data.data == nullptr || data.empty()) throw std::invalid_argument("The signature must not be empty");
+
+	// ECDSA-Sig-Value ::= SEQUENCE { r INTEGER, s INTEGER }
+	reader outer(data, "signature");
+	reader signature(outer.read(TAG_SEQUENCE), "signature");
+	outer.expectEnd();
+
+	ecdsaSignatureView res;
+	res.r = signature.readPositiveInteger();
+	res.s = signature.readPositiveInteger();
+	signature.expectEnd();
+
+	return res;
+}
+
+rsaPrivateKeyView der::parseRsaPrivateKey(span data) {
+	if (data.data == nullptr || data.empty()) throw std::invalid_argument("The private key must not be empty");
+
+	// RSAPrivateKey ::= SEQUENCE { version Version, modulus INTEGER, publicExponent INTEGER,
+	//     privateExponent INTEGER, prime1 INTEGER, prime2 INTEGER, exponent1 INTEGER,
+	//     exponent2 INTEGER, coefficient INTEGER }
+	reader outer(data, "private key");
+	reader key(outer.read(TAG_SEQUENCE), "private key");
+	outer.expectEnd();
+
+	// Only version 0, two-prime keys are supported
+	const span version = key.read(TAG_INTEGER);
+	if (version.size != 1 || version.data[0] != 0) throw std::invalid_argument("Invalid private key: unsupported version");
+
+	rsaPrivateKeyView res;
+	res.modulus = key.readPositiveInteger();
+	res.publicExponent = key.readPositiveInteger();
+	res.privateExponent = key.readPositiveInteger();
+	res.prime1 = key.readPositiveInteger();
+	res.prime2 = key.readPositiveInteger();
+	res.exponent1 = key.readPositiveInteger();
+	res.exponent2 = key.readPositiveInteger();
+	res.coefficient = key.readPositiveInteger();
+	key.expectEnd();
+
+	return res;
+}
+
+secure_vector<byte> der::encode(byte tag, const secure_vector<byte>& content) {
+	byte lengthBytes = 0;
+	if (content.size() >= 0x80u) {
+		for (size_t len = content.size(); len > 0; len >>= 8u) lengthBytes++;
+	}
+
+	secure_vector<byte> res(2 + lengthBytes + content.size());
+	res[0] = tag;
+	if (lengthBytes == 0) {
+		res[1] = (byte)content.size();
+	} else {
+		res[1] = 0x80u | lengthBytes;
+		for (byte i = 0; i < lengthBytes; i++) {
+			res[2 + i] = (byte)(content.size() >> (8u * (lengthBytes - 1 - i)));
+		}
+	}
+
+	std::copy(content.begin(), content.end(), res.begin() + 2 + lengthBytes);
+	return res;
+}
+
+secure_vector<byte> der::encodeInteger(const secure_vector<byte>& value) {
+	size_t start = 0;
+	while (start + 1 < value.size() && value[start] == 0) start++;
+
+	secure_vector<byte> content;
+	if (value.empty() || (value[start] & 0x80u)) content.push_back(0);
+	content.insert(content.end(), value.begin() + start, value.end());
+
+	return encode(TAG_INTEGER, content);
+}
+
+secure_vector<byte> der::encodeRsaPublicKey(const secure_vector<byte>& modulus, const secure_vector<byte>& exponent) {
+	const secure_vector<byte> n = encodeInteger(modulus);
+	const secure_vector<byte> e = encodeInteger(exponent);
+	const secure_vector<byte> key = encode(TAG_SEQUENCE, concat({&n, &e}));
+
+	secure_vector<byte> bitString{0};
+	bitString.insert(bitString.end(), key.begin(), key.end());
+
+	const secure_vector<byte> oid = encode(TAG_OID, secure_vector<byte>(std::begin(rsaEncryptionOid),
+		std::end(rsaEncryptionOid)));
+	const secure_vector<byte> null = encode(TAG_NULL, {});
+	const secure_vector<byte> algorithm = encode(TAG_SEQUENCE, concat({&oid, &null}));
+	const secure_vector<byte> publicKey = encode(TAG_BIT_STRING, bitString);
+
+	return encode(TAG_SEQUENCE, concat({&algorithm, &publicKey}));
+}
\ No newline at end of file
@@ -0,0 +1,239 @@
+#ifndef PASSPORT_DER_HPP
+#define PASSPORT_DER_HPP
+
+#include "NodeMsPassport.hpp"
+
+/**
+ * A DER decoder for the public keys returned by passport.
+ * The decoder works on views into the encoded data and
+ * never allocates memory, unless an error is thrown.
+ * The encoder is only used to store the keys of the software authenticator.
+ */
+namespace nodeMsPassport::der {
+	constexpr byte TAG_INTEGER = 0x02;
+	constexpr byte TAG_BIT_STRING = 0x03;
+	constexpr byte TAG_NULL = 0x05;
+	constexpr byte TAG_OID = 0x06;
+	constexpr byte TAG_SEQUENCE = 0x30;
+
+	/**
+	 * A non-owning view of a range of bytes
+	 */
+	struct span {
+		const byte* data = nullptr;
+		size_t size = 0;
+
+		NODEMSPASSPORT_NODISCARD bool empty() const noexcept {
+			return size == 0;
+		}
+
+		NODEMSPASSPORT_NODISCARD bool equals(const byte* other, size_t otherSize) const noexcept {
+			return size == otherSize && (size == 0 || std::memcmp(data, other, size) == 0);
+		}
+	};
+
+	/**
+	 * A reader for DER encoded values
+	 */
+	class reader {
+	public:
+		/**
+		 * Create a reader
+		 *
+		 * @param data the encoded values to read
+		 * @param subject what is being parsed, used in the error messages
+		 */
+		explicit reader(span data, const char* subject = "public key") noexcept;
+
+		/**
+		 * Read the next value, which must have the given tag.
+		 * Throws std::invalid_argument if the value is not encoded
+		 * correctly or its length is not in the shortest form.
+		 *
+		 * @param tag the expected tag
+		 * @return the content of the value
+		 */
+		span read(byte tag);
+
+		/**
+		 * Read an INTEGER which must be positive and minimally encoded
+		 *
+		 * @return the big endian value without a leading zero byte
+		 */
+		span readPositiveInteger();
+
+		/**
+		 * Check if the next value has a tag
+		 *
+		 * @param tag the tag to check
+		 * @return true if the next value has the tag
+		 */
+		NODEMSPASSPORT_NODISCARD bool peek(byte tag) const noexcept;
+
+		/**
+		 * Check if all values were read
+		 *
+		 * @return true if there is no data left
+		 */
+		NODEMSPASSPORT_NODISCARD bool empty() const noexcept;
+
+		/**
+		 * Throw if there is data left
+		 */
+		void expectEnd() const;
+
+	private:
+		/**
+		 * Throw a std::invalid_argument naming the subject and the reason
+		 */
+		[[noreturn]] void fail(const char* reason) const;
+
+		const byte* pos;
+		const byte* end;
+		const char* subject;
+	};
+
+	/**
+	 * The parts of a X.509 SubjectPublicKeyInfo
+	 */
+	struct subjectPublicKeyInfo {
+		// The encoded algorithm object identifier, without tag and length
+		span algorithm;
+		// The complete encoded algorithm parameters, including tag and length. May be empty.
+		span parameters;
+		// The content of the public key bit string, without the unused bits byte
+		span publicKey;
+	};
+
+	/**
+	 * The components of a RSA public key
+	 */
+	struct rsaPublicKeyView {
+		// The big endian modulus
+		span modulus;
+		// The big endian public exponent
+		span exponent;
+	};
+
+	/**
+	 * The components of an EC public key
+	 */
+	struct ecPublicKeyView {
+		// The encoded curve point, see SEC 1 section 2.3.3
+		span point;
+	};
+
+	/**
+	 * The components of an ECDSA signature
+	 */
+	struct ecdsaSignatureView {
+		// The big endian r value
+		span r;
+		// The big endian s value
+		span s;
+	};
+
+	/**
+	 * The components of a PKCS#1 RSAPrivateKey
+	 */
+	struct rsaPrivateKeyView {
+		span modulus;
+		span publicExponent;
+		span privateExponent;
+		span prime1;
+		span prime2;
+		span exponent1;
+		span exponent2;
+		span coefficient;
+	};
+
+	/**
+	 * Parse a DER encoded PKCS#1 RSAPrivateKey with two primes.
+	 * Throws std::invalid_argument if the key could not be parsed.
+	 *
+	 * @param data the encoded key
+	 * @return the components of the key, pointing into data
+	 */
+	rsaPrivateKeyView parseRsaPrivateKey(span data);
+
+	/**
+	 * Encode a value
+	 *
+	 * @param tag the tag of the value
+	 * @param content the encoded content
+	 * @return the encoded value
+	 */
+	secure_vector<byte> encode(byte tag, const secure_vector<byte>& content);
+
+	/**
+	 * Encode a non-negative INTEGER
+	 *
+	 * @param value the big endian value
+	 * @return the encoded value
+	 */
+	secure_vector<byte> encodeInteger(const secure_vector<byte>& value);
+
+	/**
+	 * Encode a RSA public key as a SubjectPublicKeyInfo
+	 *
+	 * @param modulus the big endian modulus
+	 * @param exponent the big endian public exponent
+	 * @return the encoded key
+	 */
+	secure_vector<byte> encodeRsaPublicKey(const secure_vector<byte>& modulus, const secure_vector<byte>& exponent);
+
+	/**
+	 * Parse a DER encoded SubjectPublicKeyInfo.
+	 * Throws std::invalid_argument if the key could not be parsed.
+	 *
+	 * @param data the encoded key
+	 * @return the parts of the key, pointing into data
+	 */
+	subjectPublicKeyInfo parseSubjectPublicKeyInfo(span data);
+
+	/**
+	 * Check if a SubjectPublicKeyInfo holds a RSA key
+	 *
+	 * @param info the parsed key
+	 * @return true if the algorithm is rsaEncryption
+	 */
+	NODEMSPASSPORT_NODISCARD bool isRsaKey(const subjectPublicKeyInfo& info) noexcept;
+
+	/**
+	 * Get the components of a RSA SubjectPublicKeyInfo.
+	 * Throws std::invalid_argument if the key is not a valid RSA key.
+	 *
+	 * @param info the parsed key
+	 * @return the modulus and exponent, pointing into the encoded key
+	 */
+	rsaPublicKeyView parseRsaPublicKey(const subjectPublicKeyInfo& info);
+
+	/**
+	 * Check if a SubjectPublicKeyInfo holds an EC key
+	 *
+	 * @param info the parsed key
+	 * @return true if the algorithm is id-ecPublicKey
+	 */
+	NODEMSPASSPORT_NODISCARD bool isEcKey(const subjectPublicKeyInfo& info) noexcept;
+
+	/**
+	 * Get the point of an EC SubjectPublicKeyInfo.
+	 * Throws std::invalid_argument if the key is not an EC key
+	 * or the curve is not P-256 (prime256v1).
+	 *
+	 * @param info the parsed key
+	 * @return the encoded point, pointing into the encoded key
+	 */
+	ecPublicKeyView parseEcPublicKey(const subjectPublicKeyInfo& info);
+
+	/**
+	 * Parse a DER encoded ECDSA-Sig-Value, see RFC 3279 section 2.2.3.
+	 * Throws std::invalid_argument if the signature could not be parsed.
+	 *
+	 * @param data the encoded signature
+	 * @return r and s without leading zero bytes, pointing into data
+	 */
+	ecdsaSignatureView parseEcdsaSignature(span data);
+}
+
+#endif //PASSPORT_DER_HPP
\ No newline at end of file
@@ -0,0 +1,37 @@
+#include <algorithm>
+
+#include "Digest.hpp"
+
+using namespace nodeMsPassport;
+using namespace nodeMsPassport::crypto;
+
+size_t crypto::digestSize(hashAlgorithm alg) noexcept {
+	switch (alg) {
+		case hashAlgorithm::sha384:
+			return sha384::digestSize;
+		case hashAlgorithm::sha512:
+			return sha512::digestSize;
+		default:
+			return sha256::digestSize;
+	}
+}
+
+size_t crypto::digest(hashAlgorithm alg, const byte* data, size_t len, byte* out) noexcept {
+	switch (alg) {
+		case hashAlgorithm::sha384: {
+			const sha384::digest hash = sha384::hash(data, len);
+			std::copy(hash.begin(), hash.end(), out);
+			return hash.size();
+		}
+		case hashAlgorithm::sha512: {
+			const sha512::digest hash = sha512::hash(data, len);
+			std::copy(hash.begin(), hash.end(), out);
+			return hash.size();
+		}
+		default: {
+			const sha256::digest hash = sha256::hash(data, len);
+			std::copy(hash.begin(), hash.end(), out);
+			return hash.size();
+		}
+	}
+}
\ No newline at end of file
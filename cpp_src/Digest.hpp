@@ -0,0 +1,33 @@
+#ifndef PASSPORT_DIGEST_HPP
+#define PASSPORT_DIGEST_HPP
+
+#include "Sha256.hpp"
+#include "Sha512.hpp"
+
+namespace nodeMsPassport::crypto {
+	using passport::hashAlgorithm;
+
+	// The size of the largest digest of all hash algorithms
+	constexpr size_t maxDigestSize = sha512::digestSize;
+
+	/**
+	 * Get the digest size of a hash algorithm
+	 *
+	 * @param alg the hash algorithm
+	 * @return the size of the digest in bytes
+	 */
+	size_t digestSize(hashAlgorithm alg) noexcept;
+
+	/**
+	 * Hash data in one call using the selected algorithm
+	 *
+	 * @param alg the hash algorithm to use
+	 * @param data the data to hash
+	 * @param len the number of bytes to hash
+	 * @param out the output buffer, must hold digestSize(alg) bytes
+	 * @return the size of the digest in bytes
+	 */
+	size_t digest(hashAlgorithm alg, const byte* data, size_t len, byte* out) noexcept;
+}
+
+#endif //PASSPORT_DIGEST_HPP
\ No newline at end of file
@@ -0,0 +1,276 @@
+#include <atomic>
+#include <mutex>
+#include <algorithm>
+
+#include "Drbg.hpp"
+#include "Random.hpp"
+#include "CpuFeatures.hpp"
+
+#ifndef _WIN32
+#   include <pthread.h>
+#endif
+
+#ifdef NODEMSPASSPORT_X86
+#   include <immintrin.h>
+#endif
+
+using namespace nodeMsPassport;
+using namespace nodeMsPassport::crypto;
+
+namespace {
+	// Incremented in the child process after every fork
+	std::atomic<uint64_t> forkCounter(0);
+
+	inline uint32_t rotl(uint32_t x, unsigned n) {
+		return (x << n) | (x >> (32u - n));
+	}
+
+	inline void quarterRound(uint32_t& a, uint32_t& b, uint32_t& c, uint32_t& d) {
+		a += b;
+		d = rotl(d ^ a, 16);
+		c += d;
+		b = rotl(b ^ c, 12);
+		a += b;
+		d = rotl(d ^ a, 8);
+		c += d;
+		b = rotl(b ^ c, 7);
+	}
+
+	inline uint32_t load32(const byte* in) {
+		return (uint32_t)in[0] | ((uint32_t)in[1] << 8u) | ((uint32_t)in[2] << 16u) | ((uint32_t)in[3] << 24u);
+	}
+
+	inline void store32(byte* out, uint32_t value) {
+		out[0] = (byte)value;
+		out[1] = (byte)(value >> 8u);
+		out[2] = (byte)(value >> 16u);
+		out[3] = (byte)(value >> 24u);
+	}
+
+	// The generator always uses a zero nonce, the key is never reused
+	const uint32_t zeroNonce[3] = {0, 0, 0};
+
+#ifdef NODEMSPASSPORT_X86
+	NODEMSPASSPORT_TARGET("sse2")
+	inline __m128i rotl128(__m128i x, int n) {
+		return _mm_or_si128(_mm_slli_epi32(x, n), _mm_srli_epi32(x, 32 - n));
+	}
+
+	NODEMSPASSPORT_TARGET("sse2")
+	inline void quarterRound128(__m128i& a, __m128i& b, __m128i& c, __m128i& d) {
+		a = _mm_add_epi32(a, b);
+		d = rotl128(_mm_xor_si128(d, a), 16);
+		c = _mm_add_epi32(c, d);
+		b = rotl128(_mm_xor_si128(b, c), 12);
+		a = _mm_add_epi32(a, b);
+		d = rotl128(_mm_xor_si128(d, a), 8);
+		c = _mm_add_epi32(c, d);
+		b = rotl128(_mm_xor_si128(b, c), 7);
+	}
+
+	/**
+	 * Generate four consecutive blocks with a zero nonce. Every vector
+	 * holds the same word of all four blocks, so the rounds run in parallel.
+	 */
+	NODEMSPASSPORT_TARGET("sse2")
+	void chacha20Blocks4Sse2(const uint32_t key[8], uint32_t counter, byte out[256]) {
+		__m128i input[16] = {
+			_mm_set1_epi32(0x61707865), _mm_set1_epi32(0x3320646e),
+			_mm_set1_epi32(0x79622d32), _mm_set1_epi32(0x6b206574)
+		};
+		for (int i = 0; i < 8; i++) {
+			input[4 + i] = _mm_set1_epi32((int)key[i]);
+		}
+		input[12] = _mm_add_epi32(_mm_set1_epi32((int)counter), _mm_set_epi32(3, 2, 1, 0));
+		input[13] = input[14] = input[15] = _mm_setzero_si128();
+
+		__m128i x[16];
+		std::copy(input, input + 16, x);
+		for (int i = 0; i < 10; i++) {
+			quarterRound128(x[0], x[4], x[8], x[12]);
+			quarterRound128(x[1], x[5], x[9], x[13]);
+			quarterRound128(x[2], x[6], x[10], x[14]);
+			quarterRound128(x[3], x[7], x[11], x[15]);
+			quarterRound128(x[0], x[5], x[10], x[15]);
+			quarterRound128(x[1], x[6], x[11], x[12]);
+			quarterRound128(x[2], x[7], x[8], x[13]);
+			quarterRound128(x[3], x[4], x[9], x[14]);
+		}
+
+		// Transpose every group of four words back into the four blocks
+		for (int group = 0; group < 4; group++) {
+			const __m128i a = _mm_add_epi32(x[4 * group], input[4 * group]);
+			const __m128i b = _mm_add_epi32(x[4 * group + 1], input[4 * group + 1]);
+			const __m128i c = _mm_add_epi32(x[4 * group + 2], input[4 * group + 2]);
+			const __m128i d = _mm_add_epi32(x[4 * group + 3], input[4 * group + 3]);
+
+			const __m128i ab0 = _mm_unpacklo_epi32(a, b), ab1 = _mm_unpackhi_epi32(a, b);
+			const __m128i cd0 = _mm_unpacklo_epi32(c, d), cd1 = _mm_unpackhi_epi32(c, d);
+
+			byte* base = out + 16 * group;
+			_mm_storeu_si128((__m128i*)base, _mm_unpacklo_epi64(ab0, cd0));
+			_mm_storeu_si128((__m128i*)(base + 64), _mm_unpackhi_epi64(ab0, cd0));
+			_mm_storeu_si128((__m128i*)(base + 128), _mm_unpacklo_epi64(ab1, cd1));
+			_mm_storeu_si128((__m128i*)(base + 192), _mm_unpackhi_epi64(ab1, cd1));
+		}
+
+		util::secureWipe(x, sizeof(x));
+	}
+#endif
+}
+
+uint64_t crypto::forkGeneration() {
+#ifndef _WIN32
+	static std::once_flag registered;
+	std::call_once(registered, [] {
+		pthread_atfork(nullptr, nullptr, [] {
+			forkCounter.fetch_add(1, std::memory_order_relaxed);
+		});
+	});
+#endif
+	return forkCounter.load(std::memory_order_relaxed);
+}
+
+void crypto::chacha20Block(const uint32_t key[8], uint32_t counter, const uint32_t nonce[3], byte out[64]) noexcept {
+	// "expand 32-byte k"
+	const uint32_t input[16] = {
+		0x61707865, 0x3320646e, 0x79622d32, 0x6b206574,
+		key[0], key[1], key[2], key[3], key[4], key[5], key[6], key[7],
+		counter, nonce[0], nonce[1], nonce[2]
+	};
+
+	uint32_t x[16];
+	std::copy(input, input + 16, x);
+	for (int i = 0; i < 10; i++) {
+		quarterRound(x[0], x[4], x[8], x[12]);
+		quarterRound(x[1], x[5], x[9], x[13]);
+		quarterRound(x[2], x[6], x[10], x[14]);
+		quarterRound(x[3], x[7], x[11], x[15]);
+		quarterRound(x[0], x[5], x[10], x[15]);
+		quarterRound(x[1], x[6], x[11], x[12]);
+		quarterRound(x[2], x[7], x[8], x[13]);
+		quarterRound(x[3], x[4], x[9], x[14]);
+	}
+
+	for (int i = 0; i < 16; i++) {
+		store32(out + 4 * i, x[i] + input[i]);
+	}
+
+	util::secureWipe(x, sizeof(x));
+}
+
+chachaDrbg::chachaDrbg() : key(), buffer(), available(0), sinceReseed(0), forkGeneration(crypto::forkGeneration()) {
+	byte seed[keySize];
+	randomBytes(seed, keySize);
+	setKey(seed);
+	util::secureWipe(seed, keySize);
+}
+
+chachaDrbg::chachaDrbg(const byte seed[32]) noexcept : key(), buffer(), available(0), sinceReseed(0),
+	forkGeneration(crypto::forkGeneration()) {
+	setKey(seed);
+}
+
+void chachaDrbg::generate(byte* out, size_t len) {
+	if (forkGeneration != crypto::forkGeneration()) reseed();
+
+	while (len > 0) {
+		if (sinceReseed >= reseedInterval) reseed();
+
+		if (available == 0) {
+			// Large requests are written straight into the output
+			if (len >= buffer.size()) {
+				const size_t n = std::min(len, reseedInterval);
+				keyStream(out, n);
+				sinceReseed += n;
+				out += n;
+				len -= n;
+				continue;
+			}
+
+			refill();
+		}
+
+		const size_t n = std::min(len, available);
+		byte* start = buffer.data() + buffer.size() - available;
+		std::copy_n(start, n, out);
+		util::secureWipe(start, n);
+
+		available -= n;
+		out += n;
+		len -= n;
+	}
+}
+
+void chachaDrbg::reseed() {
+	byte seed[keySize];
+	randomBytes(seed, keySize);
+
+	// Keep the entropy of the current key in case the os is compromised
+	byte mixed[keySize];
+	keyStream(mixed, keySize);
+	for (size_t i = 0; i < keySize; i++) {
+		mixed[i] ^= seed[i];
+	}
+
+	setKey(mixed);
+	util::secureWipe(seed, keySize);
+	util::secureWipe(mixed, keySize);
+
+	// Buffered bytes may also have been handed out by the parent process
+	util::secureWipe(buffer.data(), buffer.size());
+	available = 0;
+	sinceReseed = 0;
+	forkGeneration = crypto::forkGeneration();
+}
+
+void chachaDrbg::keyStream(byte* out, size_t len) noexcept {
+	// The first block becomes the next key, the output starts at the second block
+	byte block[blockSize];
+	chacha20Block(key, 0, zeroNonce, block);
+
+	uint32_t counter = 1;
+#ifdef NODEMSPASSPORT_X86
+	if (cpu::getFeatures().sse2) {
+		for (; len >= 4 * blockSize; len -= 4 * blockSize, out += 4 * blockSize, counter += 4) {
+			chacha20Blocks4Sse2(key, counter, out);
+		}
+	}
+#endif
+
+	for (; len >= blockSize; len -= blockSize, out += blockSize) {
+		chacha20Block(key, counter++, zeroNonce, out);
+	}
+
+	if (len > 0) {
+		byte last[blockSize];
+		chacha20Block(key, counter, zeroNonce, last);
+		std::copy_n(last, len, out);
+		util::secureWipe(last, blockSize);
+	}
+
+	setKey(block);
+	util::secureWipe(block, blockSize);
+}
+
+void chachaDrbg::refill() noexcept {
+	keyStream(buffer.data(), buffer.size());
+	available = buffer.size();
+	sinceReseed += buffer.size();
+}
+
+void chachaDrbg::setKey(const byte* newKey) noexcept {
+	for (int i = 0; i < 8; i++) {
+		key[i] = load32(newKey + 4 * i);
+	}
+}
+
+chachaDrbg::~chachaDrbg() {
+	util::secureWipe(key, sizeof(key));
+	util::secureWipe(buffer.data(), buffer.size());
+}
+
+void crypto::secureRandom(byte* out, size_t len) {
+	thread_local chachaDrbg drbg;
+	drbg.generate(out, len);
+}
\ No newline at end of file
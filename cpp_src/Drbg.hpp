@@ -0,0 +1,112 @@
+#ifndef PASSPORT_DRBG_HPP
+#define PASSPORT_DRBG_HPP
+
+#include <array>
+#include <cstdint>
+
+#include "NodeMsPassport.hpp"
+
+namespace nodeMsPassport::crypto {
+	/**
+	 * The ChaCha20 block function, see RFC 8439 section 2.3
+	 *
+	 * @param key the 256 bit key
+	 * @param counter the block counter
+	 * @param nonce the 96 bit nonce
+	 * @param out the 64 byte output block
+	 */
+	void chacha20Block(const uint32_t key[8], uint32_t counter, const uint32_t nonce[3], byte out[64]) noexcept;
+
+	/**
+	 * Get the number of times this process was created by a fork.
+	 * Random state created before a fork must not be used in both processes.
+	 *
+	 * @return the number of forks, always zero on windows
+	 */
+	uint64_t forkGeneration();
+
+	/**
+	 * A deterministic random bit generator based on ChaCha20.
+	 * Seeded from the operating system and reseeded after reseedInterval bytes
+	 * or if the process forked. Uses fast key erasure: the key is replaced after
+	 * every refill and every output byte is wiped from the buffer once handed out,
+	 * so a later compromise of the state does not reveal previous outputs.
+	 * Not thread safe, use secureRandom for a per-thread instance.
+	 */
+	class chachaDrbg {
+	public:
+		/**
+		 * The number of bytes generated before mixing fresh entropy into the key
+		 */
+		static constexpr size_t reseedInterval = 1u << 20u;
+
+		/**
+		 * Create a generator seeded from the operating system.
+		 * Throws std::runtime_error if no seed could be read.
+		 */
+		chachaDrbg();
+
+		/**
+		 * Create a generator from a fixed seed. Only useful for tests,
+		 * as the output is predictable until the first reseed.
+		 *
+		 * @param seed the 32 byte seed
+		 */
+		explicit chachaDrbg(const byte seed[32]) noexcept;
+
+		chachaDrbg(const chachaDrbg&) = delete;
+
+		chachaDrbg& operator=(const chachaDrbg&) = delete;
+
+		/**
+		 * Fill a buffer with random bytes.
+		 * Throws std::runtime_error if reseeding failed.
+		 *
+		 * @param out the buffer to fill
+		 * @param len the number of bytes to generate
+		 */
+		void generate(byte* out, size_t len);
+
+		/**
+		 * Mix fresh entropy from the operating system into the key.
+		 * Throws std::runtime_error if no entropy could be read.
+		 */
+		void reseed();
+
+		~chachaDrbg();
+
+	private:
+		static constexpr size_t keySize = 32;
+		static constexpr size_t blockSize = 64;
+		// Large enough to serve many challenges from a single refill
+		static constexpr size_t bufferBlocks = 16;
+
+		/**
+		 * Generate len bytes of key stream into out and replace the key
+		 */
+		void keyStream(byte* out, size_t len) noexcept;
+
+		void refill() noexcept;
+
+		void setKey(const byte* key) noexcept;
+
+		uint32_t key[8];
+		std::array<byte, bufferBlocks * blockSize> buffer;
+		// The number of unused bytes at the end of the buffer
+		size_t available;
+		size_t sinceReseed;
+		uint64_t forkGeneration;
+	};
+
+	/**
+	 * Fill a buffer with cryptographically secure random bytes from a
+	 * per-thread ChaCha20 DRBG. Much faster than randomBytes for small requests.
+	 * Throws std::runtime_error if the generator could not be seeded.
+	 *
+	 * @param out the buffer to fill
+	 * @param len the number of bytes to generate
+	 */
+	void secureRandom(byte* out, size_t len);
+}
+
+#endif //PASSPORT_DRBG_HPP
\ No newline at end of file
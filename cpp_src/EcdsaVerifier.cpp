@@ -0,0 +1,586 @@
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+#include <algorithm>
+
+#include "EcdsaVerifier.hpp"
+#include "Digest.hpp"
+#include "Der.hpp"
+
+using namespace nodeMsPassport;
+using namespace nodeMsPassport::crypto;
+
+namespace {
+	using word = word64;
+	// A 256 bit value as little endian words
+	using element = std::array<word, 4>;
+
+	// The field prime p = 2^256 - 2^224 + 2^192 + 2^96 - 1
+	constexpr element fieldPrime = {0xFFFFFFFFFFFFFFFFull, 0x00000000FFFFFFFFull, 0x0000000000000000ull,
+		0xFFFFFFFF00000001ull};
+	// The order n of the base point
+	constexpr element groupOrder = {0xF3B9CAC2FC632551ull, 0xBCE6FAADA7179E84ull, 0xFFFFFFFFFFFFFFFFull,
+		0xFFFFFFFF00000000ull};
+	// The coefficient b of the curve y^2 = x^3 - 3x + b
+	constexpr element curveB = {0x3BCE3C3E27D2604Bull, 0x651D06B0CC53B0F6ull, 0xB3EBBD55769886BCull,
+		0x5AC635D8AA3A93E7ull};
+	// The base point G
+	constexpr element baseX = {0xF4A13945D898C296ull, 0x77037D812DEB33A0ull, 0xF8BCE6E563A440F2ull,
+		0x6B17D1F2E12C4247ull};
+	constexpr element baseY = {0xCBB6406837BF51F5ull, 0x2BCE33576B315ECEull, 0x8EE7EB4A7C0F9E16ull,
+		0x4FE342E2FE1A7F9Bull};
+
+	// The window width of the NAF of u1 and the number of precomputed odd multiples of G
+	constexpr unsigned baseWindow = 8;
+	constexpr size_t baseTableSize = (size_t)1 << (baseWindow - 2);
+	// The maximum number of digits of the NAF of a 256 bit scalar
+	constexpr size_t maxNafLength = 257;
+
+	bool isZero(const element& a) noexcept {
+		return (a[0] | a[1] | a[2] | a[3]) == 0;
+	}
+
+	bool less(const element& a, const element& b) noexcept {
+		for (size_t i = a.size(); i-- > 0;) {
+			if (a[i] != b[i]) return a[i] < b[i];
+		}
+
+		return false;
+	}
+
+	/**
+	 * Add b to a in place
+	 *
+	 * @return the carry
+	 */
+	word addWords(element& a, const element& b) noexcept {
+		word carry = 0;
+		for (size_t i = 0; i < a.size(); i++) {
+			a[i] = addWithCarry(a[i], b[i], carry);
+		}
+
+		return carry;
+	}
+
+	/**
+	 * Subtract b from a in place
+	 *
+	 * @return the borrow
+	 */
+	word subtractWords(element& a, const element& b) noexcept {
+		word borrow = 0;
+		for (size_t i = 0; i < a.size(); i++) {
+			a[i] = subtractWithBorrow(a[i], b[i], borrow);
+		}
+
+		return borrow;
+	}
+
+	/**
+	 * Convert a big endian value of up to 32 bytes
+	 *
+	 * @return false if the value is too large
+	 */
+	bool fromBytes(const byte* data, size_t len, element& out) noexcept {
+		if (len > 32) return false;
+
+		out = element();
+		for (size_t i = 0; i < len; i++) {
+			out[i / 8] |= (word)data[len - 1 - i] << (8u * (i % 8));
+		}
+
+		return true;
+	}
+
+	constexpr word negativeInverse(word x) {
+		// Newton iteration for x^-1 mod 2^64, each step doubles the number of correct bits
+		word inv = x;
+		for (int i = 0; i < 6; i++) {
+			inv *= 2 - x * inv;
+		}
+
+		return (word)0 - inv;
+	}
+
+	/**
+	 * Montgomery arithmetic modulo a 256 bit prime with the highest bit set, used for
+	 * both the field prime and the group order. The modulus is a template parameter,
+	 * so the multiplications by its words are specialized at compile time.
+	 */
+	template<const element& m>
+	class montgomery {
+	public:
+		montgomery() : rr(), r() {
+			// R mod m = 2^256 - m, as the highest bit of m is set
+			for (size_t i = 0; i < r.size(); i++) {
+				r[i] = ~m[i];
+			}
+			r[0] += 1;
+
+			// Doubling it 256 times results in R^2 mod m
+			rr = r;
+			for (int bit = 0; bit < 256; bit++) {
+				const word carry = rr[3] >> 63u;
+				for (size_t i = rr.size() - 1; i > 0; i--) {
+					rr[i] = (rr[i] << 1u) | (rr[i - 1] >> 63u);
+				}
+				rr[0] <<= 1u;
+
+				if (carry || !less(rr, m)) subtractWords(rr, m);
+			}
+		}
+
+		/**
+		 * out = a * b / R mod m, out may alias a or b
+		 */
+		void multiply(const element& a, const element& b, element& out) const noexcept {
+			// CIOS, moving a window up a twice as large accumulator instead of shifting it
+			word t[10] = {};
+			for (size_t i = 0; i < 4; i++) {
+				word* window = t + i;
+				addRow(window, a, b[i]);
+				addRow(window, m, window[0] * n0inv);
+			}
+
+			element res = {t[4], t[5], t[6], t[7]};
+			if (t[8] != 0 || !less(res, m)) subtractWords(res, m);
+			out = res;
+		}
+
+		void square(const element& a, element& out) const noexcept {
+			multiply(a, a, out);
+		}
+
+		void add(const element& a, const element& b, element& out) const noexcept {
+			element res = a;
+			if (addWords(res, b) || !less(res, m)) subtractWords(res, m);
+			out = res;
+		}
+
+		void subtract(const element& a, const element& b, element& out) const noexcept {
+			element res = a;
+			if (subtractWords(res, b)) addWords(res, m);
+			out = res;
+		}
+
+		void toMontgomery(const element& a, element& out) const noexcept {
+			multiply(a, rr, out);
+		}
+
+		/**
+		 * Get one in montgomery form
+		 */
+		NODEMSPASSPORT_NODISCARD const element& one() const noexcept {
+			return r;
+		}
+
+		/**
+		 * out = a^-1 mod m = a^(m - 2) mod m, in montgomery form
+		 */
+		void invert(const element& a, element& out) const noexcept {
+			element exponent = m;
+			exponent[0] -= 2;
+
+			element acc = r;
+			for (size_t bit = 256; bit-- > 0;) {
+				multiply(acc, acc, acc);
+				if ((exponent[bit / 64] >> (bit % 64)) & 1u) {
+					multiply(acc, a, acc);
+				}
+			}
+
+			out = acc;
+		}
+
+	private:
+		/**
+		 * Add x * y to t[0, 6)
+		 */
+		static void addRow(word* t, const element& x, word y) noexcept {
+			word carry = 0;
+			for (size_t j = 0; j < 4; j++) {
+				t[j] = multiplyAdd(x[j], y, t[j], carry, carry);
+			}
+
+			t[4] += carry;
+			t[5] += t[4] < carry;
+		}
+
+		static constexpr word n0inv = negativeInverse(m[0]);
+		// R^2 mod m and R mod m
+		element rr, r;
+	};
+
+	using fieldArithmetic = montgomery<fieldPrime>;
+	using scalarArithmetic = montgomery<groupOrder>;
+
+	const fieldArithmetic& field() {
+		static const fieldArithmetic f;
+		return f;
+	}
+
+	const scalarArithmetic& scalars() {
+		static const scalarArithmetic n;
+		return n;
+	}
+
+	/**
+	 * A point in jacobian coordinates (X / Z^2, Y / Z^3) in montgomery form.
+	 * Z is zero for the point at infinity.
+	 */
+	struct jacobianPoint {
+		element x, y, z;
+	};
+
+	/**
+	 * out = 2p, out may alias p. Uses a = -3 (dbl-2001-b).
+	 */
+	void pointDouble(const fieldArithmetic& f, const jacobianPoint& p, jacobianPoint& out) noexcept {
+		element delta, gamma, beta, alpha, t1, t2;
+		f.square(p.z, delta);
+		f.square(p.y, gamma);
+		f.multiply(p.x, gamma, beta);
+
+		// alpha = 3 * (x - delta) * (x + delta)
+		f.subtract(p.x, delta, t1);
+		f.add(p.x, delta, t2);
+		f.multiply(t1, t2, alpha);
+		f.add(alpha, alpha, t1);
+		f.add(t1, alpha, alpha);
+
+		// z3 = (y + z)^2 - gamma - delta
+		f.add(p.y, p.z, t1);
+		f.square(t1, t1);
+		f.subtract(t1, gamma, t1);
+		f.subtract(t1, delta, out.z);
+
+		// x3 = alpha^2 - 8 * beta
+		f.add(beta, beta, t2);
+		f.add(t2, t2, t2);
+		f.square(alpha, t1);
+		f.subtract(t1, t2, t1);
+		f.subtract(t1, t2, out.x);
+
+		// y3 = alpha * (4 * beta - x3) - 8 * gamma^2
+		f.subtract(t2, out.x, t2);
+		f.multiply(alpha, t2, t2);
+		f.square(gamma, t1);
+		f.add(t1, t1, t1);
+		f.add(t1, t1, t1);
+		f.add(t1, t1, t1);
+		f.subtract(t2, t1, out.y);
+	}
+
+	/**
+	 * out = p + (qx, qy), out may alias p (madd-2007-bl)
+	 */
+	void pointAddAffine(const fieldArithmetic& f, const jacobianPoint& p, const element& qx, const element& qy,
+		jacobianPoint& out) noexcept {
+		if (isZero(p.z)) {
+			out = jacobianPoint{qx, qy, f.one()};
+			return;
+		}
+
+		element z1z1, u2, s2, h, r;
+		f.square(p.z, z1z1);
+		f.multiply(qx, z1z1, u2);
+		f.multiply(qy, p.z, s2);
+		f.multiply(s2, z1z1, s2);
+		f.subtract(u2, p.x, h);
+		f.subtract(s2, p.y, r);
+
+		if (isZero(h)) {
+			if (isZero(r)) {
+				pointDouble(f, p, out);
+			} else {
+				out = jacobianPoint{f.one(), f.one(), element()};
+			}
+			return;
+		}
+
+		element hh, i, j, v, y1j;
+		f.square(h, hh);
+		f.add(hh, hh, i);
+		f.add(i, i, i);
+		f.multiply(h, i, j);
+		f.add(r, r, r);
+		f.multiply(p.x, i, v);
+		f.multiply(p.y, j, y1j);
+
+		// z3 = (z1 + h)^2 - z1z1 - hh
+		element z3;
+		f.add(p.z, h, z3);
+		f.square(z3, z3);
+		f.subtract(z3, z1z1, z3);
+		f.subtract(z3, hh, z3);
+
+		// x3 = r^2 - j - 2 * v
+		element x3;
+		f.square(r, x3);
+		f.subtract(x3, j, x3);
+		f.subtract(x3, v, x3);
+		f.subtract(x3, v, x3);
+
+		// y3 = r * (v - x3) - 2 * y1 * j
+		element y3;
+		f.subtract(v, x3, y3);
+		f.multiply(r, y3, y3);
+		f.subtract(y3, y1j, y3);
+		f.subtract(y3, y1j, y3);
+
+		out = jacobianPoint{x3, y3, z3};
+	}
+
+	/**
+	 * Convert points to affine coordinates with a single inversion
+	 * (Montgomery's trick). None of the points may be the point at infinity.
+	 */
+	void toAffine(const fieldArithmetic& f, const jacobianPoint* in, p256Point* out, size_t count) {
+		std::vector<element> products(count);
+		products[0] = in[0].z;
+		for (size_t i = 1; i < count; i++) {
+			f.multiply(products[i - 1], in[i].z, products[i]);
+		}
+
+		element inv;
+		f.invert(products[count - 1], inv);
+		for (size_t i = count; i-- > 0;) {
+			element zInv = inv;
+			if (i > 0) {
+				f.multiply(inv, products[i - 1], zInv);
+				f.multiply(inv, in[i].z, inv);
+			}
+
+			element zInv2, zInv3;
+			f.square(zInv, zInv2);
+			f.multiply(zInv2, zInv, zInv3);
+			f.multiply(in[i].x, zInv2, out[i].x);
+			f.multiply(in[i].y, zInv3, out[i].y);
+		}
+	}
+
+	/**
+	 * Compute p, 3p, 5p, ..., (2 * count - 1)p
+	 */
+	void oddMultiples(const fieldArithmetic& f, const p256Point& p, p256Point* out, size_t count) {
+		std::vector<jacobianPoint> multiples(count);
+		multiples[0] = jacobianPoint{p.x, p.y, f.one()};
+
+		jacobianPoint twice;
+		p256Point twiceAffine;
+		pointDouble(f, multiples[0], twice);
+		toAffine(f, &twice, &twiceAffine, 1);
+
+		for (size_t i = 1; i < count; i++) {
+			pointAddAffine(f, multiples[i - 1], twiceAffine.x, twiceAffine.y, multiples[i]);
+		}
+
+		toAffine(f, multiples.data(), out, count);
+	}
+
+	/**
+	 * Get the odd multiples of the base point, computed on the first call
+	 */
+	const std::array<p256Point, baseTableSize>& baseTable() {
+		static const std::array<p256Point, baseTableSize> table = [] {
+			const fieldArithmetic& f = field();
+			p256Point g;
+			f.toMontgomery(baseX, g.x);
+			f.toMontgomery(baseY, g.y);
+
+			std::array<p256Point, baseTableSize> res;
+			oddMultiples(f, g, res.data(), res.size());
+			return res;
+		}();
+
+		return table;
+	}
+
+	/**
+	 * Compute the width-w non-adjacent form of a scalar, least significant digit first.
+	 * Every non-zero digit is odd and in (-2^(w-1), 2^(w-1)), followed by at least w - 1 zeros.
+	 *
+	 * @return the number of digits
+	 */
+	size_t computeNaf(const element& scalar, unsigned width, int8_t* out) noexcept {
+		word k[5] = {scalar[0], scalar[1], scalar[2], scalar[3], 0};
+		const word mask = ((word)1 << width) - 1;
+		const int half = 1 << (width - 1);
+
+		size_t len = 0;
+		while ((k[0] | k[1] | k[2] | k[3] | k[4]) != 0) {
+			int digit = 0;
+			if (k[0] & 1u) {
+				digit = (int)(k[0] & mask);
+				if (digit >= half) digit -= (int)(mask + 1);
+
+				// k -= digit, which clears the lowest w bits
+				if (digit > 0) {
+					word borrow = (word)digit;
+					for (size_t i = 0; i < 5 && borrow; i++) {
+						const word old = k[i];
+						k[i] = old - borrow;
+						borrow = old < borrow;
+					}
+				} else {
+					word carry = (word)-digit;
+					for (size_t i = 0; i < 5 && carry; i++) {
+						k[i] += carry;
+						carry = k[i] < carry;
+					}
+				}
+			}
+
+			out[len++] = (int8_t)digit;
+			for (size_t i = 0; i < 4; i++) {
+				k[i] = (k[i] >> 1u) | (k[i + 1] << 63u);
+			}
+			k[4] >>= 1u;
+		}
+
+		return len;
+	}
+
+	/**
+	 * Add the odd multiple of a NAF digit to acc, subtracting it for negative digits
+	 */
+	void addDigit(const fieldArithmetic& f, jacobianPoint& acc, const p256Point* table, int digit) noexcept {
+		if (digit > 0) {
+			const p256Point& p = table[digit >> 1];
+			pointAddAffine(f, acc, p.x, p.y, acc);
+		} else if (digit < 0) {
+			const p256Point& p = table[(-digit) >> 1];
+			element negativeY;
+			f.subtract(element(), p.y, negativeY);
+			pointAddAffine(f, acc, p.x, negativeY, acc);
+		}
+	}
+
+	/**
+	 * Parse a DER encoded or raw (r || s) signature
+	 *
+	 * @return false if the signature could not be parsed
+	 */
+	bool parseSignature(const byte* data, size_t len, element& r, element& s) {
+		// A raw signature may start like a DER sequence of the same length
+		const bool mayBeDer = len >= 2 && data[0] == der::TAG_SEQUENCE && data[1] == len - 2;
+		if (mayBeDer || len != ecPublicKey::rawSignatureSize) {
+			try {
+				const der::ecdsaSignatureView signature = der::parseEcdsaSignature(der::span{data, len});
+				return fromBytes(signature.r.data, signature.r.size, r) &&
+					fromBytes(signature.s.data, signature.s.size, s);
+			} catch (const std::invalid_argument&) {
+				if (len != ecPublicKey::rawSignatureSize) return false;
+			}
+		}
+
+		const size_t half = ecPublicKey::rawSignatureSize / 2;
+		return fromBytes(data, half, r) && fromBytes(data + half, half, s);
+	}
+}
+
+ecPublicKey ecPublicKey::fromSubjectPublicKeyInfo(const byte* data, size_t len) {
+	const der::ecPublicKeyView key = der::parseEcPublicKey(der::parseSubjectPublicKeyInfo(der::span{data, len}));
+	return ecPublicKey(key.point.data, key.point.size);
+}
+
+ecPublicKey::ecPublicKey(const byte* point, size_t len) : table() {
+	// Compressed points are not used by windows hello or FIDO authenticators
+	if (len != pointSize || point[0] != 0x04) {
+		throw std::invalid_argument("Invalid public key: only uncompressed points are supported");
+	}
+
+	element x, y;
+	fromBytes(point + 1, 32, x);
+	fromBytes(point + 33, 32, y);
+	if (!less(x, fieldPrime) || !less(y, fieldPrime)) {
+		throw std::invalid_argument("Invalid public key: the point is not on the curve");
+	}
+
+	const fieldArithmetic& f = field();
+	p256Point q;
+	f.toMontgomery(x, q.x);
+	f.toMontgomery(y, q.y);
+
+	// y^2 = x^3 - 3x + b
+	element lhs, rhs, t, b;
+	f.square(q.y, lhs);
+	f.square(q.x, rhs);
+	f.multiply(rhs, q.x, rhs);
+	f.add(q.x, q.x, t);
+	f.add(t, q.x, t);
+	f.subtract(rhs, t, rhs);
+	f.toMontgomery(curveB, b);
+	f.add(rhs, b, rhs);
+	if (lhs != rhs) throw std::invalid_argument("Invalid public key: the point is not on the curve");
+
+	oddMultiples(f, q, table.data(), table.size());
+}
+
+bool ecPublicKey::verifyEcdsaSha256(const byte* message, size_t messageLength, const byte* signature,
+	size_t signatureLength) const {
+	return verifyHash(sha256::hash(message, messageLength).data(), signature, signatureLength);
+}
+
+bool ecPublicKey::verifyDigest(const byte* hash, size_t hashLength, const byte* signature,
+	size_t signatureLength, const passport::signatureOptions& options) const {
+	if (options.padding != passport::signaturePadding::pkcs1) {
+		throw std::invalid_argument("PSS signatures require an RSA key");
+	}
+
+	if (hashLength != digestSize(options.hash)) {
+		throw std::invalid_argument("The length of the hash does not match the hash algorithm");
+	}
+
+	return verifyHash(hash, signature, signatureLength);
+}
+
+bool ecPublicKey::verifyHash(const byte* hash, const byte* signature, size_t signatureLength) const {
+	element r, s;
+	if (!parseSignature(signature, signatureLength, r, s)) return false;
+	if (isZero(r) || isZero(s) || !less(r, groupOrder) || !less(s, groupOrder)) return false;
+
+	// The leftmost 256 bits of the hash, see SEC 1 section 4.1.4
+	element e;
+	fromBytes(hash, 32, e);
+	if (!less(e, groupOrder)) subtractWords(e, groupOrder);
+
+	// w = s^-1 in montgomery form, so multiplying it by the plain
+	// values results in the plain u1 = e * w and u2 = r * w
+	const scalarArithmetic& n = scalars();
+	element w, u1, u2;
+	n.toMontgomery(s, w);
+	n.invert(w, w);
+	n.multiply(e, w, u1);
+	n.multiply(r, w, u2);
+
+	// u1 * G + u2 * Q, sharing the doublings (Shamir's trick)
+	int8_t naf1[maxNafLength] = {}, naf2[maxNafLength] = {};
+	const size_t length = std::max(computeNaf(u1, baseWindow, naf1), computeNaf(u2, window, naf2));
+	const p256Point* base = baseTable().data();
+
+	const fieldArithmetic& f = field();
+	jacobianPoint acc{f.one(), f.one(), element()};
+	for (size_t i = length; i-- > 0;) {
+		if (!isZero(acc.z)) pointDouble(f, acc, acc);
+		addDigit(f, acc, base, naf1[i]);
+		addDigit(f, acc, table.data(), naf2[i]);
+	}
+
+	if (isZero(acc.z)) return false;
+
+	// Check x mod n == r without an inversion: X == r * Z^2 mod p.
+	// x may also be r + n, if that is still smaller than p.
+	element z2, rm, candidate;
+	f.square(acc.z, z2);
+	f.toMontgomery(r, rm);
+	f.multiply(rm, z2, candidate);
+	if (candidate == acc.x) return true;
+
+	element rn = r;
+	if (addWords(rn, groupOrder) != 0 || !less(rn, fieldPrime)) return false;
+
+	f.toMontgomery(rn, rm);
+	f.multiply(rm, z2, candidate);
+	return candidate == acc.x;
+}
\ No newline at end of file
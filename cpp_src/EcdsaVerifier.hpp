@@ -0,0 +1,93 @@
+#ifndef PASSPORT_ECDSAVERIFIER_HPP
+#define PASSPORT_ECDSAVERIFIER_HPP
+
+#include <array>
+
+#include "PublicKey.hpp"
+#include "Word64.hpp"
+
+namespace nodeMsPassport::crypto {
+	/**
+	 * A point on the P-256 curve in affine coordinates. The coordinates
+	 * are stored in montgomery form, as little endian 64 bit words.
+	 */
+	struct p256Point {
+		std::array<word64, 4> x;
+		std::array<word64, 4> y;
+	};
+
+	/**
+	 * An EC P-256 public key used to verify ECDSA signatures.
+	 * The verification computes u1 * G + u2 * Q with a single chain of doublings,
+	 * using width-w NAFs of both scalars. The odd multiples of the base point are
+	 * computed once per process, the odd multiples of the key once per key.
+	 * Only public values are processed, the verification is not constant time.
+	 */
+	class ecPublicKey : public publicKey {
+	public:
+		// The size of the encoded uncompressed point
+		static constexpr size_t pointSize = 65;
+		// The size of a raw (r || s) signature
+		static constexpr size_t rawSignatureSize = 64;
+
+		/**
+		 * Parse a DER encoded X.509 SubjectPublicKeyInfo holding a P-256 key.
+		 * Throws std::invalid_argument if the key could not be parsed.
+		 *
+		 * @param data the encoded key
+		 * @param len the length of the encoded key
+		 * @return the parsed key
+		 */
+		static ecPublicKey fromSubjectPublicKeyInfo(const byte* data, size_t len);
+
+		/**
+		 * Create a public key from an uncompressed point (0x04 || x || y).
+		 * Throws std::invalid_argument if the point is not on the curve.
+		 *
+		 * @param point the encoded point
+		 * @param len the length of the encoded point
+		 */
+		ecPublicKey(const byte* point, size_t len);
+
+		/**
+		 * Verify an ECDSA signature using SHA-256
+		 *
+		 * @param message the signed message
+		 * @param messageLength the length of the message
+		 * @param signature the DER encoded ECDSA-Sig-Value or the raw 64 byte r || s
+		 * @param signatureLength the length of the signature
+		 * @return true if the signature is valid
+		 */
+		NODEMSPASSPORT_NODISCARD bool verifyEcdsaSha256(const byte* message, size_t messageLength,
+			const byte* signature, size_t signatureLength) const;
+
+		/**
+		 * Verify an ECDSA signature. Hashes longer than 256 bits are truncated.
+		 * Throws std::invalid_argument if the options select the PSS padding.
+		 */
+		NODEMSPASSPORT_NODISCARD bool verifyDigest(const byte* hash, size_t hashLength, const byte* signature,
+			size_t signatureLength, const passport::signatureOptions& options) const override;
+
+		// The window width of the NAF of u2
+		static constexpr unsigned window = 6;
+		// The number of precomputed odd multiples of the key
+		static constexpr size_t tableSize = (size_t)1 << (window - 2);
+
+	private:
+		/**
+		 * Verify an ECDSA signature of a hash
+		 *
+		 * @param hash the hash of the message, at least 32 bytes
+		 * @param signature the DER encoded ECDSA-Sig-Value or the raw 64 byte r || s
+		 * @param signatureLength the length of the signature
+		 * @return true if the signature is valid
+		 */
+		NODEMSPASSPORT_NODISCARD bool verifyHash(const byte* hash, const byte* signature,
+			size_t signatureLength) const;
+
+		// Q, 3Q, 5Q, ..., (2 * tableSize - 1)Q
+		std::array<p256Point, tableSize> table;
+	};
+}
+
+#endif //PASSPORT_ECDSAVERIFIER_HPP
\ No newline at end of file
@@ -0,0 +1,331 @@
+#include <atomic>
+
+#include "HexCodec.hpp"
+#include "CpuFeatures.hpp"
+
+#ifdef NODEMSPASSPORT_X86
+#   include <immintrin.h>
+#endif
+
+using namespace nodeMsPassport;
+
+namespace {
+	using encodeFunc = void (*)(const byte*, size_t, char*);
+	// A decode kernel returns the number of characters
+	// it consumed. It stops before the first invalid block.
+	using decodeFunc = size_t(*)(const char*, size_t, byte*);
+
+	/**
+	 * A table mapping every character to its
+	 * nibble value or to -1 if it is not a hex digit
+	 */
+	struct decodeTable {
+		signed char values[256];
+
+		constexpr decodeTable() : values() {
+			for (int i = 0; i < 256; i++) values[i] = -1;
+			for (int i = 0; i < 10; i++) values['0' + i] = (signed char)i;
+			for (int i = 0; i < 6; i++) {
+				values['a' + i] = (signed char)(10 + i);
+				values['A' + i] = (signed char)(10 + i);
+			}
+		}
+	};
+
+	constexpr decodeTable nibbles;
+
+	/**
+	 * A table mapping every byte to its two hex characters
+	 */
+	struct encodeTable {
+		char chars[512];
+
+		constexpr encodeTable() : chars() {
+			for (int i = 0; i < 256; i++) {
+				chars[i * 2] = "0123456789ABCDEF"[i >> 4];
+				chars[i * 2 + 1] = "0123456789ABCDEF"[i & 0xf];
+			}
+		}
+	};
+
+	constexpr encodeTable pairs;
+
+	void encodeScalar(const byte* in, size_t len, char* out) {
+		for (size_t i = 0; i < len; i++) {
+			out[i * 2] = pairs.chars[in[i] * 2];
+			out[i * 2 + 1] = pairs.chars[in[i] * 2 + 1];
+		}
+	}
+
+	size_t decodeScalar(const char* in, size_t len, byte* out) {
+		for (size_t i = 0; i < len; i += 2) {
+			const signed char hi = nibbles.values[(unsigned char)in[i]];
+			const signed char lo = nibbles.values[(unsigned char)in[i + 1]];
+			if ((hi | lo) < 0) return i;
+
+			out[i / 2] = (byte)((hi << 4) | lo);
+		}
+
+		return len;
+	}
+
+#ifdef NODEMSPASSPORT_X86
+	/**
+	 * Convert 16 nibbles to their upper case hex characters
+	 */
+	NODEMSPASSPORT_TARGET("sse2")
+	inline __m128i nibblesToHex128(__m128i n) {
+		const __m128i letterOffset = _mm_and_si128(_mm_cmpgt_epi8(n, _mm_set1_epi8(9)), _mm_set1_epi8('A' - '0' - 10));
+		return _mm_add_epi8(_mm_add_epi8(n, _mm_set1_epi8('0')), letterOffset);
+	}
+
+	/**
+	 * Convert 16 hex characters to nibbles. Sets
+	 * all bytes of invalid to 0xff for invalid characters.
+	 */
+	NODEMSPASSPORT_TARGET("sse2")
+	inline __m128i hexToNibbles128(__m128i c, __m128i& invalid) {
+		const __m128i digit = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+		const __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+
+		const __m128i letter = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+		const __m128i isLetter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+
+		invalid = _mm_andnot_si128(_mm_or_si128(isDigit, isLetter), _mm_set1_epi8(-1));
+		return _mm_or_si128(_mm_and_si128(isDigit, digit),
+			_mm_and_si128(isLetter, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+	}
+
+	/**
+	 * Combine pairs of nibbles (high first) into eight 16 bit values
+	 */
+	NODEMSPASSPORT_TARGET("sse2")
+	inline __m128i combineNibbles128(__m128i n) {
+		const __m128i hi = _mm_and_si128(n, _mm_set1_epi16(0x00ff));
+		const __m128i lo = _mm_srli_epi16(n, 8);
+		return _mm_or_si128(_mm_slli_epi16(hi, 4), lo);
+	}
+
+	NODEMSPASSPORT_TARGET("sse2")
+	void encodeSse2(const byte* in, size_t len, char* out) {
+		const __m128i mask = _mm_set1_epi8(0x0f);
+		size_t i = 0;
+		for (; i + 16 <= len; i += 16) {
+			const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+			const __m128i hi = nibblesToHex128(_mm_and_si128(_mm_srli_epi16(v, 4), mask));
+			const __m128i lo = nibblesToHex128(_mm_and_si128(v, mask));
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 2), _mm_unpacklo_epi8(hi, lo));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 2 + 16), _mm_unpackhi_epi8(hi, lo));
+		}
+
+		encodeScalar(in + i, len - i, out + i * 2);
+	}
+
+	NODEMSPASSPORT_TARGET("sse2")
+	size_t decodeSse2(const char* in, size_t len, byte* out) {
+		size_t i = 0;
+		for (; i + 32 <= len; i += 32) {
+			__m128i invalidA, invalidB;
+			const __m128i a = hexToNibbles128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)), invalidA);
+			const __m128i b = hexToNibbles128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 16)), invalidB);
+			if (_mm_movemask_epi8(_mm_or_si128(invalidA, invalidB)) != 0) return i;
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i / 2),
+				_mm_packus_epi16(combineNibbles128(a), combineNibbles128(b)));
+		}
+
+		return i + decodeScalar(in + i, len - i, out + i / 2);
+	}
+
+	NODEMSPASSPORT_TARGET("avx2")
+	inline __m256i nibblesToHex256(__m256i n) {
+		const __m256i letterOffset = _mm256_and_si256(_mm256_cmpgt_epi8(n, _mm256_set1_epi8(9)),
+			_mm256_set1_epi8('A' - '0' - 10));
+		return _mm256_add_epi8(_mm256_add_epi8(n, _mm256_set1_epi8('0')), letterOffset);
+	}
+
+	NODEMSPASSPORT_TARGET("avx2")
+	inline __m256i hexToNibbles256(__m256i c, __m256i& invalid) {
+		const __m256i digit = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+		const __m256i isDigit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+
+		const __m256i letter = _mm256_sub_epi8(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+		const __m256i isLetter = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter);
+
+		invalid = _mm256_andnot_si256(_mm256_or_si256(isDigit, isLetter), _mm256_set1_epi8(-1));
+		return _mm256_or_si256(_mm256_and_si256(isDigit, digit),
+			_mm256_and_si256(isLetter, _mm256_add_epi8(letter, _mm256_set1_epi8(10))));
+	}
+
+	NODEMSPASSPORT_TARGET("avx2")
+	inline __m256i combineNibbles256(__m256i n) {
+		const __m256i hi = _mm256_and_si256(n, _mm256_set1_epi16(0x00ff));
+		const __m256i lo = _mm256_srli_epi16(n, 8);
+		return _mm256_or_si256(_mm256_slli_epi16(hi, 4), lo);
+	}
+
+	NODEMSPASSPORT_TARGET("avx2")
+	void encodeAvx2(const byte* in, size_t len, char* out) {
+		const __m256i mask = _mm256_set1_epi8(0x0f);
+		size_t i = 0;
+		for (; i + 32 <= len; i += 32) {
+			const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+			const __m256i hi = nibblesToHex256(_mm256_and_si256(_mm256_srli_epi16(v, 4), mask));
+			const __m256i lo = nibblesToHex256(_mm256_and_si256(v, mask));
+
+			// The unpack instructions operate on each 128 bit lane separately
+			const __m256i first = _mm256_unpacklo_epi8(hi, lo);
+			const __m256i second = _mm256_unpackhi_epi8(hi, lo);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i * 2), _mm256_permute2x128_si256(first, second, 0x20));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i * 2 + 32),
+				_mm256_permute2x128_si256(first, second, 0x31));
+		}
+
+		// Avoid the penalty of mixing avx and legacy sse instructions
+		_mm256_zeroupper();
+		encodeSse2(in + i, len - i, out + i * 2);
+	}
+
+	NODEMSPASSPORT_TARGET("avx2")
+	size_t decodeAvx2(const char* in, size_t len, byte* out) {
+		size_t i = 0;
+		for (; i + 64 <= len; i += 64) {
+			__m256i invalidA, invalidB;
+			const __m256i a = hexToNibbles256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i)), invalidA);
+			const __m256i b = hexToNibbles256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i + 32)),
+				invalidB);
+			if (_mm256_movemask_epi8(_mm256_or_si256(invalidA, invalidB)) != 0) return i;
+
+			// packus also operates on each lane separately, restore the order afterwards
+			const __m256i packed = _mm256_packus_epi16(combineNibbles256(a), combineNibbles256(b));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i / 2), _mm256_permute4x64_epi64(packed, 0xD8));
+		}
+
+		_mm256_zeroupper();
+		return i + decodeSse2(in + i, len - i, out + i / 2);
+	}
+#endif
+
+	struct kernels {
+		hex::implementation impl;
+		encodeFunc encode;
+		decodeFunc decode;
+	};
+
+	const kernels scalarKernels{hex::implementation::scalar, encodeScalar, decodeScalar};
+#ifdef NODEMSPASSPORT_X86
+	const kernels sse2Kernels{hex::implementation::sse2, encodeSse2, decodeSse2};
+	const kernels avx2Kernels{hex::implementation::avx2, encodeAvx2, decodeAvx2};
+#endif
+
+	const kernels* selectKernels(hex::implementation impl) {
+		const cpu::features& features = cpu::getFeatures();
+		switch (impl) {
+#ifdef NODEMSPASSPORT_X86
+			case hex::implementation::avx2:
+				return features.avx2 ? &avx2Kernels : nullptr;
+			case hex::implementation::sse2:
+				return features.sse2 ? &sse2Kernels : nullptr;
+#endif
+			case hex::implementation::scalar:
+				return &scalarKernels;
+			default:
+				return nullptr;
+		}
+	}
+
+	const kernels* bestKernels() {
+		for (hex::implementation impl : {hex::implementation::avx2, hex::implementation::sse2}) {
+			const kernels* k = selectKernels(impl);
+			if (k) return k;
+		}
+
+		return &scalarKernels;
+	}
+
+	std::atomic<const kernels*> active(bestKernels());
+}
+
+hex::hexDecodeException::hexDecodeException(const std::string& err, size_t position)
+	: std::invalid_argument(err), pos(position) {}
+
+size_t hex::hexDecodeException::position() const noexcept {
+	return pos;
+}
+
+hex::implementation hex::getImplementation() noexcept {
+	return active.load(std::memory_order_relaxed)->impl;
+}
+
+bool hex::setImplementation(implementation impl) noexcept {
+	const kernels* k = selectKernels(impl);
+	if (!k) return false;
+
+	active.store(k, std::memory_order_relaxed);
+	return true;
+}
+
+const char* hex::implementationName(implementation impl) noexcept {
+	switch (impl) {
+		case implementation::avx2:
+			return "avx2";
+		case implementation::sse2:
+			return "sse2";
+		default:
+			return "scalar";
+	}
+}
+
+void hex::encode(const byte* in, size_t len, char* out) noexcept {
+	active.load(std::memory_order_relaxed)->encode(in, len, out);
+}
+
+void hex::decode(const char* in, size_t len, byte* out) {
+	if (len % 2 != 0) {
+		throw hexDecodeException("Invalid hex string: the length must be a multiple of two", len);
+	}
+
+	const size_t consumed = active.load(std::memory_order_relaxed)->decode(in, len, out);
+	if (consumed == len) return;
+
+	// A kernel stops at the first block containing an invalid
+	// character, find the exact position of the character
+	for (size_t i = consumed; i < len; i++) {
+		if (nibbles.values[(unsigned char)in[i]] < 0) {
+			std::string err = "Invalid character at position ";
+			err.append(std::to_string(i)).append(": '");
+			err += in[i];
+			err.append("' is not a valid hex digit");
+			throw hexDecodeException(err, i);
+		}
+	}
+}
+
+std::string hex::encode(const secure_vector<byte>& data) {
+	std::string out(data.size() * 2, '\0');
+	encode(data.data(), data.size(), &out[0]);
+
+	return out;
+}
+
+secure_vector<byte> hex::decode(const std::string& data) {
+	secure_vector<byte> out(data.size() / 2);
+	decode(data.data(), data.size(), out.data());
+
+	return out;
+}
+
+std::string hex::encode(const secure_buffer& data) {
+	std::string out(data.size() * 2, '\0');
+	encode(data.data(), data.size(), &out[0]);
+
+	return out;
+}
+
+secure_buffer hex::decodeBuffer(const std::string& data) {
+	secure_buffer out(data.size() / 2);
+	decode(data.data(), data.size(), out.data());
+
+	return out;
+}
\ No newline at end of file
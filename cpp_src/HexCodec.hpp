@@ -0,0 +1,125 @@
+#ifndef PASSPORT_HEXCODEC_HPP
+#define PASSPORT_HEXCODEC_HPP
+
+#include <string>
+#include <stdexcept>
+
+#include "NodeMsPassport.hpp"
+
+/**
+ * Hex encoding and decoding. Uses SSE2 or AVX2
+ * if supported by the cpu, a scalar implementation otherwise.
+ */
+namespace nodeMsPassport::hex {
+	/**
+	 * The available codec implementations
+	 */
+	enum class implementation {
+		scalar,
+		sse2,
+		avx2
+	};
+
+	/**
+	 * An exception thrown if a hex string could not be decoded
+	 */
+	class hexDecodeException : public std::invalid_argument {
+	public:
+		/**
+		 * Create a hexDecodeException
+		 *
+		 * @param err the error message
+		 * @param position the offset of the offending character in the input
+		 */
+		hexDecodeException(const std::string& err, size_t position);
+
+		/**
+		 * Get the offset of the offending character
+		 *
+		 * @return the position of the invalid character
+		 */
+		NODEMSPASSPORT_NODISCARD size_t position() const noexcept;
+
+	private:
+		size_t pos;
+	};
+
+	/**
+	 * Get the implementation currently in use
+	 *
+	 * @return the active implementation
+	 */
+	implementation getImplementation() noexcept;
+
+	/**
+	 * Set the implementation to use. Mainly used by benchmarks.
+	 *
+	 * @param impl the implementation to use
+	 * @return false if the implementation is not supported by this cpu
+	 */
+	bool setImplementation(implementation impl) noexcept;
+
+	/**
+	 * Get the name of an implementation
+	 *
+	 * @param impl the implementation
+	 * @return the name of the implementation
+	 */
+	const char* implementationName(implementation impl) noexcept;
+
+	/**
+	 * Encode bytes to an upper case hex string.
+	 * The output buffer must hold at least len * 2 characters.
+	 *
+	 * @param in the bytes to encode
+	 * @param len the number of bytes to encode
+	 * @param out the output buffer
+	 */
+	void encode(const byte* in, size_t len, char* out) noexcept;
+
+	/**
+	 * Decode a hex string. Accepts upper and lower case digits.
+	 * The output buffer must hold at least len / 2 bytes.
+	 * Throws a hexDecodeException if the input is not a valid hex string.
+	 *
+	 * @param in the characters to decode
+	 * @param len the number of characters to decode. Must be even.
+	 * @param out the output buffer
+	 */
+	void decode(const char* in, size_t len, byte* out);
+
+	/**
+	 * Encode bytes to an upper case hex string
+	 *
+	 * @param data the bytes to encode
+	 * @return the hex string
+	 */
+	std::string encode(const secure_vector<byte>& data);
+
+	/**
+	 * Decode a hex string
+	 *
+	 * @param data the hex string to decode
+	 * @return the decoded bytes
+	 */
+	secure_vector<byte> decode(const std::string& data);
+
+	/**
+	 * Encode bytes to an upper case hex string
+	 *
+	 * @param data the bytes to encode
+	 * @return the hex string
+	 */
+	std::string encode(const secure_buffer& data);
+
+	/**
+	 * Decode a hex string into a secure buffer.
+	 * Decoded values of up to 512 bytes are stored inline.
+	 *
+	 * @param data the hex string to decode
+	 * @return the decoded bytes
+	 */
+	secure_buffer decodeBuffer(const std::string& data);
+}
+
+#endif //PASSPORT_HEXCODEC_HPP
\ No newline at end of file
@@ -0,0 +1,55 @@
+#include <algorithm>
+
+#include "Hmac.hpp"
+
+using namespace nodeMsPassport;
+using namespace nodeMsPassport::crypto;
+
+hmacSha256::hmacSha256(const byte* key, size_t len) noexcept {
+	// Keys longer than a block are hashed first
+	byte pad[sha256::blockSize] = {};
+	if (len > sha256::blockSize) {
+		const sha256::digest hashed = sha256::hash(key, len);
+		std::copy(hashed.begin(), hashed.end(), pad);
+	} else {
+		std::copy_n(key, len, pad);
+	}
+
+	for (byte& b : pad) b ^= 0x36;
+	innerKeyed.update(pad, sha256::blockSize);
+
+	// 0x36 ^ 0x5c
+	for (byte& b : pad) b ^= 0x6a;
+	outerKeyed.update(pad, sha256::blockSize);
+
+	util::secureWipe(pad, sizeof(pad));
+	inner = innerKeyed;
+}
+
+void hmacSha256::update(const byte* data, size_t len) noexcept {
+	inner.update(data, len);
+}
+
+hmacSha256::tag hmacSha256::finish() noexcept {
+	const sha256::digest innerHash = inner.finish();
+	sha256 outer = outerKeyed;
+	outer.update(innerHash.data(), innerHash.size());
+
+	inner = innerKeyed;
+	return outer.finish();
+}
+
+hmacSha256::tag hmacSha256::mac(const byte* key, size_t keyLength, const byte* data, size_t len) noexcept {
+	hmacSha256 hmac(key, keyLength);
+	hmac.update(data, len);
+	return hmac.finish();
+}
+
+bool crypto::constantTimeEqual(const byte* a, const byte* b, size_t len) noexcept {
+	byte diff = 0;
+	for (size_t i = 0; i < len; i++) {
+		diff |= a[i] ^ b[i];
+	}
+
+	return diff == 0;
+}
\ No newline at end of file
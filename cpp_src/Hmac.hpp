@@ -0,0 +1,68 @@
+#ifndef PASSPORT_HMAC_HPP
+#define PASSPORT_HMAC_HPP
+
+#include "Sha256.hpp"
+
+namespace nodeMsPassport::crypto {
+	/**
+	 * HMAC-SHA256, see RFC 2104. The padded key is absorbed once on creation,
+	 * so copying a keyed instance saves two block compressions per message.
+	 */
+	class hmacSha256 {
+	public:
+		static constexpr size_t tagSize = sha256::digestSize;
+
+		using tag = sha256::digest;
+
+		/**
+		 * Create a keyed HMAC instance
+		 *
+		 * @param key the key
+		 * @param len the length of the key in bytes
+		 */
+		hmacSha256(const byte* key, size_t len) noexcept;
+
+		/**
+		 * Add data to the message
+		 *
+		 * @param data the data to add
+		 * @param len the number of bytes to add
+		 */
+		void update(const byte* data, size_t len) noexcept;
+
+		/**
+		 * Finish the message and reset this instance to its keyed state
+		 *
+		 * @return the tag of all data passed to update
+		 */
+		tag finish() noexcept;
+
+		/**
+		 * Calculate a tag in one call
+		 *
+		 * @param key the key
+		 * @param keyLength the length of the key in bytes
+		 * @param data the message
+		 * @param len the length of the message in bytes
+		 * @return the tag of the message
+		 */
+		static tag mac(const byte* key, size_t keyLength, const byte* data, size_t len) noexcept;
+
+	private:
+		sha256 innerKeyed;
+		sha256 outerKeyed;
+		sha256 inner;
+	};
+
+	/**
+	 * Compare two buffers in constant time
+	 *
+	 * @param a the first buffer
+	 * @param b the second buffer
+	 * @param len the number of bytes to compare
+	 * @return true if the buffers are equal
+	 */
+	NODEMSPASSPORT_NODISCARD bool constantTimeEqual(const byte* a, const byte* b, size_t len) noexcept;
+}
+
+#endif //PASSPORT_HMAC_HPP
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include <cstring>
+#include <stdexcept>
+
+#include "KeyCache.hpp"
+
+using namespace nodeMsPassport;
+using namespace nodeMsPassport::crypto;
+
+keyCache::keyCache(size_t capacity, size_t shards, parser parse)
+	: parse(parse), shardCapacity(0), numShards(shards == 0 ? 1 : shards) {
+	if (capacity > 0) {
+		shardCapacity = (capacity + numShards - 1) / numShards;
+	}
+
+	this->shards = std::make_unique<shard[]>(numShards);
+}
+
+std::shared_ptr<const publicKey> keyCache::get(const byte* spki, size_t len) {
+	if (shardCapacity == 0) {
+		return parse(spki, len);
+	}
+
+	return get(sha256::hash(spki, len), spki, len);
+}
+
+std::shared_ptr<const publicKey> keyCache::get(const sha256::digest& fingerprint, const byte* spki, size_t len) {
+	if (shardCapacity == 0) {
+		return parse(spki, len);
+	}
+
+	shard& s = shards[fingerprint[0] % numShards];
+
+	{
+		std::unique_lock<std::mutex> lock(s.mtx);
+		const auto it = s.index.find(fingerprint);
+		if (it != s.index.end()) {
+			s.hits++;
+			s.lru.splice(s.lru.begin(), s.lru, it->second);
+			return it->second->second;
+		}
+
+		s.misses++;
+	}
+
+	// Parse the key without holding the lock
+	std::shared_ptr<const publicKey> key = parse(spki, len);
+
+	std::unique_lock<std::mutex> lock(s.mtx);
+	const auto it = s.index.find(fingerprint);
+	if (it != s.index.end()) {
+		// Another thread inserted the key in the meantime
+		s.lru.splice(s.lru.begin(), s.lru, it->second);
+		return it->second->second;
+	}
+
+	s.lru.emplace_front(fingerprint, key);
+	s.index.emplace(fingerprint, s.lru.begin());
+
+	if (s.lru.size() > shardCapacity) {
+		s.index.erase(s.lru.back().first);
+		s.lru.pop_back();
+		s.evictions++;
+	}
+
+	return key;
+}
+
+void keyCache::clear() {
+	for (size_t i = 0; i < numShards; i++) {
+		std::unique_lock<std::mutex> lock(shards[i].mtx);
+		shards[i].index.clear();
+		shards[i].lru.clear();
+	}
+}
+
+keyCache::statistics keyCache::getStatistics() const {
+	statistics res;
+	for (size_t i = 0; i < numShards; i++) {
+		std::unique_lock<std::mutex> lock(shards[i].mtx);
+		res.hits += shards[i].hits;
+		res.misses += shards[i].misses;
+		res.evictions += shards[i].evictions;
+		res.size += shards[i].lru.size();
+	}
+
+	return res;
+}
+
+keyCache& keyCache::shared() {
+	static keyCache cache(1024);
+	return cache;
+}
+
+size_t keyCache::digestHash::operator()(const sha256::digest& d) const noexcept {
+	// The digest is uniformly distributed. The first byte selects the shard, use the following ones.
+	size_t res;
+	std::memcpy(&res, d.data() + 1, sizeof(res));
+	return res;
+}
\ No newline at end of file
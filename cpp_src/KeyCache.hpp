@@ -0,0 +1,116 @@
+#ifndef PASSPORT_KEYCACHE_HPP
+#define PASSPORT_KEYCACHE_HPP
+
+#include <list>
+#include <mutex>
+#include <memory>
+#include <cstdint>
+#include <unordered_map>
+
+#include "PublicKey.hpp"
+#include "Sha256.hpp"
+
+namespace nodeMsPassport::crypto {
+	/**
+	 * A bounded cache of parsed public keys. The keys are indexed by the
+	 * SHA-256 hash of their SubjectPublicKeyInfo, which is the value returned
+	 * by getPublicKeyHash. The cache is split into shards, each with its own
+	 * lock and least recently used eviction.
+	 */
+	class keyCache {
+	public:
+		/**
+		 * The cache statistics
+		 */
+		struct statistics {
+			uint64_t hits = 0;
+			uint64_t misses = 0;
+			uint64_t evictions = 0;
+			// The number of keys currently stored
+			size_t size = 0;
+		};
+
+		/**
+		 * A function parsing a DER encoded SubjectPublicKeyInfo
+		 */
+		using parser = std::unique_ptr<const publicKey> (*)(const byte* spki, size_t len);
+
+		/**
+		 * Create a key cache
+		 *
+		 * @param capacity the maximum number of keys to store. Zero disables the cache.
+		 * @param shards the number of shards to split the cache into
+		 * @param parse the function used to parse keys which are not cached yet
+		 */
+		explicit keyCache(size_t capacity, size_t shards = 16, parser parse = publicKey::fromSubjectPublicKeyInfo);
+
+		keyCache(const keyCache&) = delete;
+
+		keyCache& operator=(const keyCache&) = delete;
+
+		/**
+		 * Get a parsed public key, parsing and inserting it if it is not cached yet.
+		 * Throws std::invalid_argument if the key could not be parsed,
+		 * invalid keys are never cached.
+		 *
+		 * @param spki the DER encoded SubjectPublicKeyInfo
+		 * @param len the length of the encoded key
+		 * @return the parsed key
+		 */
+		std::shared_ptr<const publicKey> get(const byte* spki, size_t len);
+
+		/**
+		 * Get a parsed public key using its already computed SHA-256 fingerprint,
+		 * used by batches which hash all keys at once. Same as get otherwise.
+		 *
+		 * @param fingerprint the SHA-256 hash of the encoded key
+		 * @param spki the DER encoded SubjectPublicKeyInfo
+		 * @param len the length of the encoded key
+		 * @return the parsed key
+		 */
+		std::shared_ptr<const publicKey> get(const sha256::digest& fingerprint, const byte* spki, size_t len);
+
+		/**
+		 * Remove all keys from the cache. Does not reset the statistics.
+		 */
+		void clear();
+
+		/**
+		 * Get the current statistics
+		 *
+		 * @return the hit, miss and eviction counts summed over all shards
+		 */
+		NODEMSPASSPORT_NODISCARD statistics getStatistics() const;
+
+		/**
+		 * Get the process wide key cache, used by the native verification engine
+		 *
+		 * @return the shared key cache
+		 */
+		static keyCache& shared();
+
+	private:
+		struct digestHash {
+			size_t operator()(const sha256::digest& d) const noexcept;
+		};
+
+		using entry = std::pair<sha256::digest, std::shared_ptr<const publicKey>>;
+
+		struct shard {
+			mutable std::mutex mtx;
+			// The most recently used key is at the front
+			std::list<entry> lru;
+			std::unordered_map<sha256::digest, std::list<entry>::iterator, digestHash> index;
+			uint64_t hits = 0;
+			uint64_t misses = 0;
+			uint64_t evictions = 0;
+		};
+
+		parser parse;
+		size_t shardCapacity;
+		std::unique_ptr<shard[]> shards;
+		size_t numShards;
+	};
+}
+
+#endif //PASSPORT_KEYCACHE_HPP
\ No newline at end of file
@@ -0,0 +1,147 @@
+#include <atomic>
+#include <stdexcept>
+
+#include "NodeMsPassport.hpp"
+#include "VerificationEngine.hpp"
+#include "ChallengeIssuer.hpp"
+#include "ReplayFilter.hpp"
+#include "Sha256.hpp"
+#include "ThreadPool.hpp"
+
+using namespace nodeMsPassport;
+
+namespace {
+	std::atomic<bool> replayProtection(false);
+
+	// The number of signatures hashed by a single task of verifySignatures, a multiple of the SIMD lanes
+	constexpr size_t hashGroupSize = 64;
+
+	bool verifyWithKey(const secure_buffer& challenge, const secure_buffer& signature,
+		const secure_vector<byte>& publicKey, const passport::signatureOptions& options) {
+		try {
+			const auto key = crypto::verificationEngine::active().keys().get(publicKey.data(), publicKey.size());
+			return key->verify(challenge.data(), challenge.size(), signature.data(), signature.size(), options);
+		} catch (const std::invalid_argument& e) {
+			throw passport::passportException(e.what(), -1);
+		}
+	}
+
+	/**
+	 * Consume a challenge. Only the challenge is remembered, not the signature,
+	 * as another valid signature of the same challenge is a replay just as well.
+	 *
+	 * @return false if the challenge was already consumed or the filter is full
+	 */
+	bool consume(const secure_buffer& challenge) {
+		return crypto::replayFilter::shared().insert(challenge.data(), challenge.size()) ==
+			crypto::replayFilter::result::inserted;
+	}
+
+	/**
+	 * Consume a verified challenge if replay protection is enabled
+	 *
+	 * @return false if the challenge must be rejected as a replay
+	 */
+	bool consumeIfProtected(const secure_buffer& challenge) {
+		return !replayProtection.load(std::memory_order_relaxed) || consume(challenge);
+	}
+}
+
+passport::passportException::passportException(std::string err, int code) : error(std::move(err)) {
+	error.append("#").append(std::to_string(code));
+}
+
+const char* passport::passportException::what() const noexcept {
+	return error.c_str();
+}
+
+bool passport::verifySignature(const secure_buffer& challenge, const secure_buffer& signature,
+	const secure_vector<byte>& publicKey, const signatureOptions& options) {
+	return verifyWithKey(challenge, signature, publicKey, options) && consumeIfProtected(challenge);
+}
+
+void passport::setReplayProtection(bool enabled) {
+	replayProtection.store(enabled, std::memory_order_relaxed);
+}
+
+secure_buffer passport::issueChallenge(const std::string& accountId) {
+	return crypto::challengeIssuer::shared()->issue(accountId);
+}
+
+bool passport::verifyChallengeAndSignature(const std::string& accountId, const secure_buffer& challenge,
+	const secure_buffer& signature, const secure_vector<byte>& publicKey) {
+	// The MAC check is much cheaper than the signature verification and rejects forged challenges first
+	const auto issuer = crypto::challengeIssuer::shared();
+	const uint64_t now = crypto::challengeIssuer::now();
+	if (issuer->verify(challenge, accountId, now) != crypto::challengeIssuer::status::valid) return false;
+
+	// Reject challenges which would still be valid once the replay filter forgot them
+	const uint64_t validUntil = crypto::challengeIssuer::timestamp(challenge) + issuer->getMaxAge();
+	if (validUntil >= now + crypto::replayFilter::shared().ttl()) return false;
+
+	return verifyWithKey(challenge, signature, publicKey, signatureOptions()) && consume(challenge);
+}
+
+secure_buffer passport::fingerprint(const secure_vector<byte>& publicKey) {
+	const crypto::sha256::digest hash = crypto::sha256::hash(publicKey);
+	return secure_buffer(hash.data(), hash.size());
+}
+
+std::vector<bool> passport::verifySignatures(const std::vector<signatureData>& signatures) {
+	const size_t count = signatures.size();
+	util::threadPool& pool = util::threadPool::shared();
+
+	// Hash the keys and the SHA-256 challenges in groups, so the multi-buffer kernel
+	// can hash them side by side. Other challenges are hashed when they are verified.
+	std::vector<crypto::sha256::digest> keyHashes(count), challengeHashes(count);
+	pool.parallelFor((count + hashGroupSize - 1) / hashGroupSize, [&](size_t group) {
+		const size_t begin = group * hashGroupSize;
+		const size_t end = std::min(count, begin + hashGroupSize);
+
+		const byte* data[hashGroupSize] = {};
+		size_t lengths[hashGroupSize] = {};
+		for (size_t i = begin; i < end; i++) {
+			data[i - begin] = signatures[i].publicKey.data();
+			lengths[i - begin] = signatures[i].publicKey.size();
+		}
+		crypto::sha256::hashBatch(data, lengths, end - begin, keyHashes.data() + begin);
+
+		size_t n = 0;
+		size_t indices[hashGroupSize];
+		crypto::sha256::digest hashes[hashGroupSize];
+		for (size_t i = begin; i < end; i++) {
+			if (signatures[i].options.hash != hashAlgorithm::sha256) continue;
+			indices[n] = i;
+			data[n] = signatures[i].challenge.data();
+			lengths[n++] = signatures[i].challenge.size();
+		}
+
+		crypto::sha256::hashBatch(data, lengths, n, hashes);
+		for (size_t i = 0; i < n; i++) {
+			challengeHashes[indices[i]] = hashes[i];
+		}
+	});
+
+	// The whole batch uses the same engine, even if it is changed meanwhile
+	crypto::keyCache& keys = crypto::verificationEngine::active().keys();
+
+	// std::vector<bool> can't be written to from multiple threads
+	std::vector<byte> results(count, 0);
+	pool.parallelFor(count, [&](size_t i) {
+		const signatureData& data = signatures[i];
+		try {
+			const auto key = keys.get(keyHashes[i], data.publicKey.data(), data.publicKey.size());
+			const bool verified = data.options.hash == hashAlgorithm::sha256 ?
+				key->verifyDigest(challengeHashes[i].data(), challengeHashes[i].size(), data.signature.data(),
+					data.signature.size(), data.options) :
+				key->verify(data.challenge.data(), data.challenge.size(), data.signature.data(),
+					data.signature.size(), data.options);
+
+			results[i] = verified && consumeIfProtected(data.challenge) ? 1 : 0;
+		} catch (const std::invalid_argument&) {
+			results[i] = 0;
+		}
+	});
+
+	return std::vector<bool>(results.begin(), results.end());
+}
\ No newline at end of file
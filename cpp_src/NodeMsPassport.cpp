@@ -10,20 +10,13 @@
 #pragma comment(lib, "comsuppw.lib")
 
 #include "NodeMsPassport.hpp"
+#include "Backend.hpp"
 #include "CLITools.hpp"
 
 using namespace System;
 using namespace System::Reflection;
 using namespace nodeMsPassport;
 
-passport::passportException::passportException(std::string err, int code) : error(std::move(err)) {
-	error.append("#").append(std::to_string(code));
-}
-
-const char* passport::passportException::what() const noexcept {
-	return error.c_str();
-}
-
 /**
  * Convert a managed Exception to a passportException.
  * If the Exception is typeof TargetInvocationException,
@@ -54,158 +47,150 @@ void passport::setCSharpDllLocation(const std::string& location) {
 	CLITools::setDllLocation(location);
 }
 
-bool passport::passportAvailable() {
-	try {
-		return CLITools::callFunc<bool>("PassportAvailable");
-	} catch (Exception^ e) {
-		throw convertException(e);
+/**
+ * The windows hello backend, calling into the C# dll
+ */
+class clrBackend : public passport::backend {
+public:
+	const char* name() const noexcept override {
+		return "windows";
 	}
-}
 
-bool passport::passportAccountExists(const std::string& accountId) {
-	try {
-		return CLITools::callFunc<bool>("PassportAccountExists", accountId);
-	} catch (Exception^ e) {
-		throw convertException(e);
+	bool interactive() const noexcept override {
+		return true;
 	}
-}
 
-void passport::createPassportKey(const std::string& accountId) {
-	try {
-		CLITools::callFunc<void>("CreatePassportKey", accountId);
-	} catch (Exception^ e) {
-		throw convertException(e);
+	bool available() override {
+		try {
+			return CLITools::callFunc<bool>("PassportAvailable");
+		} catch (Exception^ e) {
+			throw convertException(e);
+		}
 	}
-}
 
-secure_vector<byte> passport::passportSign(const std::string& accountId, const secure_vector<byte>& challenge) {
-	try {
-		return CLITools::callFunc<secure_vector<byte>>("PassportSign", accountId, challenge);
-	} catch (Exception^ e) {
-		throw convertException(e);
+	void create(const std::string& accountId) override {
+		try {
+			CLITools::callFunc<void>("CreatePassportKey", accountId);
+		} catch (Exception^ e) {
+			throw convertException(e);
+		}
 	}
-}
 
-secure_vector<byte> passport::getPublicKey(const std::string& accountId) {
-	try {
-		return CLITools::callFunc<secure_vector<byte>>("GetPublicKey", accountId);
-	} catch (Exception^ e) {
-		throw convertException(e);
+	bool open(const std::string& accountId) override {
+		try {
+			return CLITools::callFunc<bool>("PassportAccountExists", accountId);
+		} catch (Exception^ e) {
+			throw convertException(e);
+		}
 	}
-}
 
-secure_vector<byte> passport::getPublicKeyHash(const std::string& accountId) {
-	try {
-		return CLITools::callFunc<secure_vector<byte>>("GetPublicKeyHash", accountId);
-	} catch (Exception^ e) {
-		throw convertException(e);
+	secure_buffer sign(const std::string& accountId, const secure_buffer& challenge) override {
+		try {
+			return CLITools::callFunc<secure_buffer>("PassportSign", accountId, challenge);
+		} catch (Exception^ e) {
+			throw convertException(e);
+		}
 	}
-}
 
-bool passport::verifySignature(const secure_vector<byte>& challenge, const secure_vector<byte>& signature,
-	const secure_vector<byte>& publicKey) {
-	try {
-		return CLITools::callFunc<bool>("VerifyChallenge", challenge, signature, publicKey);
-	} catch (Exception^ e) {
-		throw convertException(e);
+	secure_vector<passport::byte> getPublicKey(const std::string& accountId) override {
+		try {
+			return CLITools::callFunc<secure_vector<passport::byte>>("GetPublicKey", accountId);
+		} catch (Exception^ e) {
+			throw convertException(e);
+		}
 	}
-}
 
-void passport::deletePassportAccount(const std::string& accountId) {
-	try {
-		CLITools::callFunc<void>("DeletePassportAccount", accountId);
-	} catch (Exception^ e) {
-		throw convertException(e);
+	void remove(const std::string& accountId) override {
+		try {
+			CLITools::callFunc<void>("DeletePassportAccount", accountId);
+		} catch (Exception^ e) {
+			throw convertException(e);
+		}
 	}
-}
+};
 
-secure_vector<unsigned char> copyToChar(const secure_wstring& data, bool& ok) {
-	secure_vector<unsigned char> tmp;
-	tmp.resize(data.size() * sizeof(wchar_t));
+std::shared_ptr<passport::backend> passport::createDefaultBackend() {
+	return std::make_shared<clrBackend>();
+}
 
-	ok = memcpy_s(tmp.data(), tmp.size(), data.c_str(), data.size() * sizeof(wchar_t)) == 0;
+// Passwords are stored in secure_u16string, which is passed to the api as a wide string
+static_assert(sizeof(wchar_t) == sizeof(char16_t), "The windows api uses 16 bit wide strings");
 
-	return tmp;
+/**
+ * Get the characters of a string as they are passed to the windows api
+ */
+wchar_t* wideChars(secure_u16string& str) {
+	return reinterpret_cast<wchar_t*>(&str[0]);
 }
 
-secure_wstring copyToWChar(char* ptr, int sizeInBytes, bool& ok) {
-	secure_wstring out;
-	out.resize(sizeInBytes / sizeof(wchar_t));
+secure_u16string copyToU16String(char* ptr, int sizeInBytes, bool& ok) {
+	secure_u16string out;
+	out.resize(sizeInBytes / sizeof(char16_t));
 
-	ok = memcpy_s((wchar_t*)out.data(), out.size() * sizeof(wchar_t), ptr, sizeInBytes) == 0;
+	ok = memcpy_s(&out[0], out.size() * sizeof(char16_t), ptr, sizeInBytes) == 0;
 	return out;
 }
 
 // Source: https://github.com/microsoft/Windows-classic-samples/blob/master/Samples/CredentialProvider/cpp/helpers.cpp#L456
-bool unprotectCredential(secure_wstring& toUnprotect) {
+// The strings are passed to the api directly, as std::basic_string keeps its buffer null terminated.
+// The decrypted data replaces toUnprotect only if the operation was successful.
+bool unprotectCredential(secure_u16string& toUnprotect) {
 	CRED_PROTECTION_TYPE protectionType;
-	secure_vector<wchar_t> toUnprotect_cpy(toUnprotect.begin(), toUnprotect.end());
-	if (CredIsProtectedW(toUnprotect_cpy.data(), &protectionType)) {
-		if (protectionType != CredUnprotected) {
-			toUnprotect_cpy = secure_vector<wchar_t>(toUnprotect.begin(), toUnprotect.end());
-			DWORD unprotectedSize = 0;
-			if (!CredUnprotectW(false, toUnprotect_cpy.data(), (DWORD)toUnprotect_cpy.size(), nullptr,
-				&unprotectedSize)) {
-				DWORD dwErr = GetLastError();
-				if (dwErr == ERROR_INSUFFICIENT_BUFFER && unprotectedSize > 0) {
-					secure_vector<wchar_t> outData;
-					outData.resize(unprotectedSize);
-
-					if (CredUnprotectW(false, toUnprotect_cpy.data(), (DWORD)toUnprotect_cpy.size(), outData.data(),
-						&unprotectedSize)) {
-						toUnprotect = secure_wstring(outData.begin(), outData.end());
-						return true;
-					}
-				}
-			}
-		}
+	if (!CredIsProtectedW(wideChars(toUnprotect), &protectionType) || protectionType == CredUnprotected) {
+		return false;
 	}
 
-	return false;
+	DWORD unprotectedSize = 0;
+	if (CredUnprotectW(false, wideChars(toUnprotect), (DWORD)toUnprotect.size(), nullptr, &unprotectedSize) ||
+		GetLastError() != ERROR_INSUFFICIENT_BUFFER || unprotectedSize == 0) {
+		return false;
+	}
+
+	secure_u16string outData(unprotectedSize, u'\0');
+	if (!CredUnprotectW(false, wideChars(toUnprotect), (DWORD)toUnprotect.size(), wideChars(outData),
+		&unprotectedSize)) {
+		return false;
+	}
+
+	toUnprotect = std::move(outData);
+	return true;
 }
 
-bool protectCredential(secure_wstring& toProtect) {
+// The encrypted data replaces toProtect only if the operation was successful
+bool protectCredential(secure_u16string& toProtect) {
 	CRED_PROTECTION_TYPE protectionType;
-	secure_vector<wchar_t> toProtect_cpy(toProtect.begin(), toProtect.end());
-	if (CredIsProtectedW(toProtect_cpy.data(), &protectionType)) {
-		if (protectionType == CredUnprotected) {
-			toProtect_cpy = secure_vector<wchar_t>(toProtect.begin(), toProtect.end());
-			DWORD protectedSize = 0;
-			if (!CredProtectW(false, toProtect_cpy.data(), (DWORD)toProtect_cpy.size(), nullptr, &protectedSize,
-				nullptr)) {
-				DWORD dwErr = GetLastError();
-
-				if (dwErr == ERROR_INSUFFICIENT_BUFFER && protectedSize > 0) {
-					secure_vector<wchar_t> outData;
-					outData.resize(protectedSize);
-
-					if (CredProtectW(false, toProtect_cpy.data(), (DWORD)toProtect_cpy.size(), outData.data(),
-						&protectedSize, nullptr)) {
-						toProtect = secure_wstring(outData.begin(), outData.end());
-						return true;
-					}
-				}
-			}
-		}
+	if (!CredIsProtectedW(wideChars(toProtect), &protectionType) || protectionType != CredUnprotected) {
+		return false;
 	}
 
-	return false;
+	DWORD protectedSize = 0;
+	if (CredProtectW(false, wideChars(toProtect), (DWORD)toProtect.size(), nullptr, &protectedSize, nullptr) ||
+		GetLastError() != ERROR_INSUFFICIENT_BUFFER || protectedSize == 0) {
+		return false;
+	}
+
+	secure_u16string outData(protectedSize, u'\0');
+	if (!CredProtectW(false, wideChars(toProtect), (DWORD)toProtect.size(), wideChars(outData), &protectedSize,
+		nullptr)) {
+		return false;
+	}
+
+	toProtect = std::move(outData);
+	return true;
 }
 
 bool
-credentials::write(const std::wstring& target, const std::wstring& user, const secure_wstring& password,
+credentials::write(const std::wstring& target, const std::wstring& user, const secure_u16string& password,
+	bool encrypt) {
+	return write(target, user, secret_u16string(secure_u16string(password)), encrypt);
+}
+
+bool credentials::write(const std::wstring& target, const std::wstring& user, secret_u16string password,
 	bool encrypt) {
-	bool ok;
-	secure_wstring pass = password;
 	if (encrypt) {
-		if (!protectCredential(pass)) return false;
+		if (!protectCredential(*password)) return false;
 	}
 
-	secure_vector<unsigned char> passData = copyToChar(pass, ok);
-	if (!ok) return false;
-
-	DWORD cbCreds = (DWORD)passData.size();
-
 	CREDENTIALW cred = { 0 };
 	cred.Type = CRED_TYPE_GENERIC;
 
@@ -213,8 +198,9 @@ credentials::write(const std::wstring& target, const std::wstring& user, const s
 	std::wstring target_cpy = target;
 	cred.TargetName = (wchar_t*)target_cpy.data();
 
-	cred.CredentialBlobSize = cbCreds;
-	cred.CredentialBlob = passData.data();
+	// The blob points into the password, it is not copied again
+	cred.CredentialBlobSize = (DWORD)(password->size() * sizeof(char16_t));
+	cred.CredentialBlob = reinterpret_cast<LPBYTE>(&(*password)[0]);
 	cred.Persist = CRED_PERSIST_LOCAL_MACHINE;
 
 	// Copy user as a non-const qualified wchar array is required
@@ -224,13 +210,23 @@ credentials::write(const std::wstring& target, const std::wstring& user, const s
 	return ::CredWriteW(&cred, 0);
 }
 
-bool credentials::read(const std::wstring& target, std::wstring& username, secure_wstring& password, bool encrypt) {
+bool credentials::read(const std::wstring& target, std::wstring& username, secure_u16string& password,
+	bool encrypt) {
+	secret_u16string pass;
+	if (!read(target, username, pass, encrypt)) return false;
+
+	password = pass.release();
+	return true;
+}
+
+bool credentials::read(const std::wstring& target, std::wstring& username, secret_u16string& password,
+	bool encrypt) {
 	PCREDENTIALW pcred;
 
 	bool ok = ::CredReadW(target.c_str(), CRED_TYPE_GENERIC, 0, &pcred);
 	if (!ok) return false;
 
-	secure_wstring pass = copyToWChar((char*)pcred->CredentialBlob, pcred->CredentialBlobSize, ok);
+	secure_u16string pass = copyToU16String((char*)pcred->CredentialBlob, pcred->CredentialBlobSize, ok);
 	if (ok) {
 		if (encrypt) {
 			ok = unprotectCredential(pass);
@@ -238,10 +234,11 @@ bool credentials::read(const std::wstring& target, std::wstring& username, secur
 
 		if (ok) {
 			username = std::wstring(pcred->UserName);
-			password = secure_wstring(pass.begin(), pass.end());
+			password = secret_u16string(std::move(pass));
 		}
 	}
 
+	util::secureWipe(pcred->CredentialBlob, pcred->CredentialBlobSize);
 	::CredFree(pcred);
 	return ok;
 }
@@ -257,13 +254,13 @@ bool credentials::isEncrypted(const std::wstring& target) {
 	ok = ::CredReadW(target.c_str(), CRED_TYPE_GENERIC, 0, &pcred);
 	if (!ok) throw std::runtime_error("Could not check if data is encrypted");
 
-	secure_wstring pass = copyToWChar((char*)pcred->CredentialBlob, pcred->CredentialBlobSize, ok);
+	secure_u16string pass = copyToU16String((char*)pcred->CredentialBlob, pcred->CredentialBlobSize, ok);
+	util::secureWipe(pcred->CredentialBlob, pcred->CredentialBlobSize);
 	::CredFree(pcred);
 	if (!ok) throw std::runtime_error("Could not check if data is encrypted");
 
 	CRED_PROTECTION_TYPE protectionType;
-	secure_vector<wchar_t> pass_cpy(pass.begin(), pass.end());
-	ok = CredIsProtectedW(pass_cpy.data(), &protectionType);
+	ok = CredIsProtectedW(wideChars(pass), &protectionType);
 	if (ok) {
 		if (protectionType == CredUnprotected) {
 			return false;
@@ -275,32 +272,18 @@ bool credentials::isEncrypted(const std::wstring& target) {
 	}
 }
 
-bool passwords::encrypt(secure_wstring& data) {
-	secure_wstring copy = data;
-	bool ok = protectCredential(copy);
-	if (!ok) {
-		return false;
-	} else {
-		data = copy;
-		return true;
-	}
+bool passwords::encrypt(secure_u16string& data) {
+	return protectCredential(data);
 }
 
-bool passwords::decrypt(secure_wstring& data) {
-	secure_wstring copy = data;
-	bool ok = unprotectCredential(copy);
-	if (!ok) {
-		return false;
-	} else {
-		data = copy;
-		return true;
-	}
+bool passwords::decrypt(secure_u16string& data) {
+	return unprotectCredential(data);
 }
 
-bool passwords::isEncrypted(const secure_wstring& data) {
+bool passwords::isEncrypted(const secure_u16string& data) {
 	CRED_PROTECTION_TYPE protectionType;
-	secure_vector<wchar_t> pass_cpy(data.begin(), data.end());
-	bool ok = CredIsProtectedW(pass_cpy.data(), &protectionType);
+	// CredIsProtectedW does not modify the string, it just isn't declared const
+	bool ok = CredIsProtectedW(const_cast<wchar_t*>(reinterpret_cast<const wchar_t*>(data.c_str())), &protectionType);
 	if (ok) {
 		if (protectionType == CredUnprotected) {
 			return false;
@@ -3,6 +3,14 @@
 
 #include <vector>
 #include <string>
+#include <limits>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <new>
+#include <iterator>
+#include <algorithm>
+#include <utility>
 
 #if __cplusplus >= 201603L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201603L)
 #   define NODEMSPASSPORT_NODISCARD [[nodiscard]]
@@ -10,6 +18,8 @@
 #   define NODEMSPASSPORT_NODISCARD
 #endif
 
+#include "UtfCodec.hpp"
+
 #undef max
 
 /**
@@ -18,6 +28,42 @@
 namespace nodeMsPassport {
 	using byte = unsigned char;
 	namespace util {
+		/**
+		 * Zero memory. The write is never optimized away,
+		 * even if the memory is not read afterwards.
+		 *
+		 * @param ptr the memory to zero
+		 * @param size the number of bytes to zero
+		 */
+		void secureWipe(void* ptr, size_t size) noexcept;
+
+		/**
+		 * Allocate memory from the secure heap. Blocks of up to 16 KiB are taken from
+		 * size classed slabs with thread local free lists, larger blocks get their own pages.
+		 * The memory is locked into RAM where possible, excluded from core dumps
+		 * and surrounded by guard pages. Throws std::bad_alloc if no memory is available.
+		 *
+		 * @param size the number of bytes to allocate
+		 * @return the allocated memory
+		 */
+		void* secureAllocate(size_t size);
+
+		/**
+		 * Zero and free memory allocated by secureAllocate
+		 *
+		 * @param ptr the memory to free
+		 * @param size the size passed to secureAllocate
+		 */
+		void secureDeallocate(void* ptr, size_t size) noexcept;
+
+		/**
+		 * Get the number of secureAllocate calls made by the calling thread.
+		 * Used to check how often secrets are copied.
+		 *
+		 * @return the number of allocations
+		 */
+		size_t secureAllocationCount() noexcept;
+
 		/**
 		 * zallocator struct
 		 * Source: https://wiki.openssl.org/index.php/EVP_Symmetric_Encryption_and_Decryption
@@ -46,12 +92,11 @@ namespace nodeMsPassport {
 			pointer allocate(size_type n, const void* hint = 0) {
 				if (n > std::numeric_limits<size_type>::max() / sizeof(T))
 					throw std::bad_alloc();
-				return static_cast<pointer> (::operator new(n * sizeof(value_type)));
+				return static_cast<pointer> (secureAllocate(n * sizeof(value_type)));
 			}
 
 			void deallocate(pointer p, size_type n) {
-				std::fill_n((volatile char*)p, n * sizeof(T), 0);
-				::operator delete(p);
+				secureDeallocate(p, n * sizeof(T));
 			}
 
 			[[nodiscard]] size_type max_size() const {
@@ -97,6 +142,7 @@ namespace nodeMsPassport {
 		template<class T>
 		using basic_secure_vector = std::vector<T, zallocator<T>>;
 		using basic_secure_wstring = std::basic_string<wchar_t, std::char_traits<wchar_t>, zallocator<wchar_t>>;
+		using basic_secure_u16string = std::basic_string<char16_t, std::char_traits<char16_t>, zallocator<char16_t>>;
 	}
 
 	template<typename T>
@@ -121,18 +167,20 @@ namespace nodeMsPassport {
 
 		secure_wstring(const std::wstring& str) : util::basic_secure_wstring(str.begin(), str.end()) {}
 
-		secure_wstring(const std::string& str) : util::basic_secure_wstring(str.size() + 1, L' ') {
-			size_t outSize;
-
-			errno_t err = mbstowcs_s(&outSize, (wchar_t*)this->data(), this->size(), str.c_str(), str.size());
-			if (err) perror("Error creating wide string");
-			this->resize(outSize);
+		/**
+		 * Create a wide string from an UTF-8 string.
+		 * Throws an utf::utfException if the string is not valid UTF-8.
+		 *
+		 * @param str the string to convert
+		 */
+		secure_wstring(const std::string& str) : util::basic_secure_wstring(str.size(), L'\0') {
+			this->resize(utf::utf8ToWide(str.data(), str.size(), &(*this)[0]));
 		}
 
 		secure_wstring(const secure_vector<unsigned char>& data) : util::basic_secure_wstring(
 			data.size() / sizeof(wchar_t), L' ') {
-			bool ok = memcpy_s((wchar_t*)this->data(), this->size() * sizeof(wchar_t), data.data(), data.size()) == 0;
-			if (!ok) this->resize(0);
+			if (data.size() % sizeof(wchar_t) != 0) this->resize(0);
+			else memcpy((wchar_t*)this->data(), data.data(), data.size());
 		}
 
 		NODEMSPASSPORT_NODISCARD std::wstring to_wstring() const {
@@ -143,24 +191,329 @@ namespace nodeMsPassport {
 			secure_vector<unsigned char> tmp;
 			tmp.resize(this->size() * sizeof(wchar_t));
 
-			bool ok = memcpy_s(tmp.data(), tmp.size(), this->c_str(), this->size() * sizeof(wchar_t)) == 0;
-			if (!ok) tmp.resize(0);
+			memcpy(tmp.data(), this->c_str(), tmp.size());
 
 			return tmp;
 		}
 
+		/**
+		 * Convert this string to UTF-8.
+		 * Throws an utf::utfException if the string is not valid.
+		 *
+		 * @return the UTF-8 string
+		 */
 		NODEMSPASSPORT_NODISCARD inline std::string to_string() const {
-			std::string out(this->size() + 1, ' ');
-			size_t outSize;
+			std::string out(utf::maxUtf8Length(this->size()), '\0');
+			out.resize(utf::wideToUtf8(this->data(), this->size(), &out[0]));
 
-			errno_t err = wcstombs_s(&outSize, (char*)out.data(), out.size(), this->c_str(), this->size());
-			if (err) perror("Error creating string");
-			out.resize(outSize);
+			return out;
+		}
+	};
+
+	/**
+	 * A secure UTF-16 string. Maps 1:1 onto javascript strings and onto
+	 * the wide strings of the windows api, on every platform.
+	 * Used for passwords, which therefore never need to be transcoded.
+	 */
+	class secure_u16string : public util::basic_secure_u16string {
+	public:
+		using util::basic_secure_u16string::basic_secure_u16string;
+
+		secure_u16string() : util::basic_secure_u16string() {}
+
+		secure_u16string(const std::u16string& str) : util::basic_secure_u16string(str.begin(), str.end()) {}
+
+		/**
+		 * Create a string from an UTF-8 string.
+		 * Throws an utf::utfException if the string is not valid UTF-8.
+		 *
+		 * @param str the string to convert
+		 */
+		secure_u16string(const std::string& str) : util::basic_secure_u16string(str.size(), u'\0') {
+			this->resize(utf::utf8ToUtf16(str.data(), str.size(), &(*this)[0]));
+		}
+
+		/**
+		 * Create a string from its UTF-16 code units. The string
+		 * is empty if the number of bytes is not a multiple of two.
+		 *
+		 * @param data the bytes of the string
+		 */
+		secure_u16string(const secure_vector<unsigned char>& data) : util::basic_secure_u16string(
+			data.size() / sizeof(char16_t), u'\0') {
+			if (data.size() % sizeof(char16_t) != 0) this->resize(0);
+			else memcpy(&(*this)[0], data.data(), data.size());
+		}
+
+		NODEMSPASSPORT_NODISCARD std::u16string to_u16string() const {
+			return std::u16string(this->begin(), this->end());
+		}
+
+		NODEMSPASSPORT_NODISCARD secure_vector<unsigned char> getBytes() const {
+			secure_vector<unsigned char> tmp(this->size() * sizeof(char16_t));
+			memcpy(tmp.data(), this->data(), tmp.size());
+
+			return tmp;
+		}
+
+		/**
+		 * Convert this string to UTF-8.
+		 * Throws an utf::utfException if the string contains unpaired surrogates.
+		 *
+		 * @return the UTF-8 string
+		 */
+		NODEMSPASSPORT_NODISCARD std::string to_string() const {
+			std::string out(this->size() * 3, '\0');
+			out.resize(utf::utf16ToUtf8(this->data(), this->size(), &out[0]));
 
 			return out;
 		}
 	};
 
+	/**
+	 * A secure byte buffer storing up to N bytes inside of the object, so challenges,
+	 * hashes and signatures don't need a heap allocation. Larger buffers are stored
+	 * on the secure heap. The memory is zeroed when it is released.
+	 *
+	 * @tparam N the number of bytes stored inside of the object
+	 */
+	template<size_t N>
+	class basic_secure_buffer {
+	public:
+		using value_type = byte;
+		using size_type = size_t;
+		using iterator = byte*;
+		using const_iterator = const byte*;
+
+		basic_secure_buffer() noexcept : ptr(storage), length(0), cap(N) {}
+
+		explicit basic_secure_buffer(size_t size, byte value = 0) : basic_secure_buffer() {
+			resize(size, value);
+		}
+
+		basic_secure_buffer(const byte* data, size_t size) : basic_secure_buffer() {
+			assign(data, size);
+		}
+
+		template<class InputIt, class = typename std::iterator_traits<InputIt>::iterator_category>
+		basic_secure_buffer(InputIt first, InputIt last) : basic_secure_buffer() {
+			resize(static_cast<size_t>(std::distance(first, last)));
+			std::copy(first, last, ptr);
+		}
+
+		basic_secure_buffer(const secure_vector<byte>& vec) : basic_secure_buffer(vec.data(), vec.size()) {}
+
+		basic_secure_buffer(const basic_secure_buffer& other) : basic_secure_buffer(other.ptr, other.length) {}
+
+		basic_secure_buffer(basic_secure_buffer&& other) noexcept : basic_secure_buffer() {
+			take(other);
+		}
+
+		basic_secure_buffer& operator=(const basic_secure_buffer& other) {
+			if (this != &other) assign(other.ptr, other.length);
+			return *this;
+		}
+
+		basic_secure_buffer& operator=(basic_secure_buffer&& other) noexcept {
+			if (this != &other) {
+				release();
+				take(other);
+			}
+
+			return *this;
+		}
+
+		/**
+		 * Replace the contents of this buffer
+		 *
+		 * @param data the new contents
+		 * @param size the number of bytes
+		 */
+		void assign(const byte* data, size_t size) {
+			resize(size);
+			std::copy(data, data + size, ptr);
+		}
+
+		/**
+		 * Resize the buffer. Removed bytes are zeroed.
+		 *
+		 * @param size the new size
+		 * @param value the value of added bytes
+		 */
+		void resize(size_t size, byte value = 0) {
+			reserve(size);
+			if (size > length) {
+				std::fill(ptr + length, ptr + size, value);
+			} else {
+				util::secureWipe(ptr + size, length - size);
+			}
+
+			length = size;
+		}
+
+		/**
+		 * Make sure the buffer can hold a number of bytes without reallocating
+		 *
+		 * @param size the number of bytes
+		 */
+		void reserve(size_t size) {
+			if (size <= cap) return;
+
+			auto* mem = static_cast<byte*>(util::secureAllocate(size));
+			std::copy(ptr, ptr + length, mem);
+			const size_t len = length;
+			release();
+
+			ptr = mem;
+			cap = size;
+			length = len;
+		}
+
+		/**
+		 * Zero and remove all bytes
+		 */
+		void clear() noexcept {
+			util::secureWipe(ptr, length);
+			length = 0;
+		}
+
+		NODEMSPASSPORT_NODISCARD byte* data() noexcept { return ptr; }
+
+		NODEMSPASSPORT_NODISCARD const byte* data() const noexcept { return ptr; }
+
+		NODEMSPASSPORT_NODISCARD size_t size() const noexcept { return length; }
+
+		NODEMSPASSPORT_NODISCARD bool empty() const noexcept { return length == 0; }
+
+		NODEMSPASSPORT_NODISCARD size_t capacity() const noexcept { return cap; }
+
+		iterator begin() noexcept { return ptr; }
+
+		iterator end() noexcept { return ptr + length; }
+
+		NODEMSPASSPORT_NODISCARD const_iterator begin() const noexcept { return ptr; }
+
+		NODEMSPASSPORT_NODISCARD const_iterator end() const noexcept { return ptr + length; }
+
+		byte& operator[](size_t i) noexcept { return ptr[i]; }
+
+		const byte& operator[](size_t i) const noexcept { return ptr[i]; }
+
+		bool operator==(const basic_secure_buffer& other) const noexcept {
+			return length == other.length && std::equal(ptr, ptr + length, other.ptr);
+		}
+
+		bool operator!=(const basic_secure_buffer& other) const noexcept {
+			return !(*this == other);
+		}
+
+		NODEMSPASSPORT_NODISCARD secure_vector<byte> to_vector() const {
+			return secure_vector<byte>(ptr, ptr + length);
+		}
+
+		~basic_secure_buffer() {
+			release();
+		}
+
+	private:
+		/**
+		 * Take the contents of another buffer, leaving it empty
+		 */
+		void take(basic_secure_buffer& other) noexcept {
+			if (other.ptr == other.storage) {
+				std::copy(other.storage, other.storage + other.length, storage);
+				length = other.length;
+				other.clear();
+			} else {
+				ptr = other.ptr;
+				cap = other.cap;
+				length = other.length;
+
+				other.ptr = other.storage;
+				other.cap = N;
+				other.length = 0;
+			}
+		}
+
+		/**
+		 * Zero and free the memory, leaving the buffer empty
+		 */
+		void release() noexcept {
+			util::secureWipe(ptr, length);
+			if (ptr != storage) util::secureDeallocate(ptr, cap);
+
+			ptr = storage;
+			cap = N;
+			length = 0;
+		}
+
+		byte* ptr;
+		size_t length;
+		size_t cap;
+		// Left uninitialized, only the first length bytes are ever read
+		byte storage[N];
+	};
+
+	/**
+	 * A secure buffer large enough to hold RSA-4096 signatures without a heap allocation
+	 */
+	using secure_buffer = basic_secure_buffer<512>;
+
+	/**
+	 * A move-only owner of a secret, like a password. The secret can only be
+	 * copied using clone(), so every copy is visible in the code. Functions
+	 * taking a secret by value take over the memory and transform it in place.
+	 *
+	 * @tparam T the secure container storing the secret
+	 */
+	template<class T>
+	class secret {
+	public:
+		secret() = default;
+
+		explicit secret(T&& value) noexcept : value(std::move(value)) {}
+
+		secret(const secret&) = delete;
+
+		secret& operator=(const secret&) = delete;
+
+		secret(secret&&) noexcept = default;
+
+		secret& operator=(secret&&) noexcept = default;
+
+		/**
+		 * Create a copy of the secret
+		 *
+		 * @return the copy
+		 */
+		NODEMSPASSPORT_NODISCARD secret clone() const {
+			return secret(T(value));
+		}
+
+		/**
+		 * Take the secret out of this owner, leaving it empty
+		 *
+		 * @return the secret
+		 */
+		NODEMSPASSPORT_NODISCARD T release() noexcept {
+			return std::move(value);
+		}
+
+		T& operator*() noexcept { return value; }
+
+		const T& operator*() const noexcept { return value; }
+
+		T* operator->() noexcept { return &value; }
+
+		const T* operator->() const noexcept { return &value; }
+
+	private:
+		T value;
+	};
+
+	using secret_wstring = secret<secure_wstring>;
+	using secret_u16string = secret<secure_u16string>;
+
 	/**
 	 * A namespace for MS passport operations
 	 */
@@ -229,7 +582,7 @@ namespace nodeMsPassport {
 		 * @param challenge the challenge to sign
 		 * @return the result of the operation
 		 */
-		secure_vector<byte> passportSign(const std::string& accountId, const secure_vector<byte>& challenge);
+		secure_buffer passportSign(const std::string& accountId, const secure_buffer& challenge);
 
 		/**
 		 * Get the public key
@@ -245,18 +598,114 @@ namespace nodeMsPassport {
 		 * @param accountId the id of the account
 		 * @return the result of the operation
 		 */
-		secure_vector<byte> getPublicKeyHash(const std::string& accountId);
+		secure_buffer getPublicKeyHash(const std::string& accountId);
+
+		/**
+		 * Get the SHA-256 fingerprint of a public key.
+		 * This is the same value getPublicKeyHash returns for the key.
+		 *
+		 * @param publicKey the public key to hash
+		 * @return the fingerprint of the key
+		 */
+		secure_buffer fingerprint(const secure_vector<byte>& publicKey);
+
+		/**
+		 * The padding of RSA signatures
+		 */
+		enum class signaturePadding {
+			// RSASSA-PKCS1-v1_5, used by passport
+			pkcs1,
+			// RSASSA-PSS with MGF1 using the message hash
+			pss
+		};
+
+		/**
+		 * The hash function used to create a signature
+		 */
+		enum class hashAlgorithm {
+			sha256,
+			sha384,
+			sha512
+		};
 
 		/**
-		 * Verify a challenge signed by the passport application
+		 * How a signature was created. The padding only applies to RSA keys,
+		 * ECDSA keys only support the default padding.
+		 */
+		struct signatureOptions {
+			// Accept any salt length encoded in a PSS signature
+			static constexpr size_t saltLengthAuto = std::numeric_limits<size_t>::max();
+
+			signaturePadding padding = signaturePadding::pkcs1;
+			hashAlgorithm hash = hashAlgorithm::sha256;
+			// The length of the PSS salt in bytes
+			size_t saltLength = saltLengthAuto;
+		};
+
+		/**
+		 * Verify a challenge signed by the passport application.
+		 * If replay protection is enabled, the challenge is consumed
+		 * and every further verification of it fails.
 		 *
 		 * @param challenge the challenge used
 		 * @param the signature returned by passport
 		 * @param the public key of the user
+		 * @param options how the signature was created
 		 * @return true if the signature matched
 		 */
-		bool verifySignature(const secure_vector<byte>& challenge, const secure_vector<byte>& signature,
-			const secure_vector<byte>& publicKey);
+		bool verifySignature(const secure_buffer& challenge, const secure_buffer& signature,
+			const secure_vector<byte>& publicKey, const signatureOptions& options = signatureOptions());
+
+		/**
+		 * Enable or disable replay protection for verifySignature and
+		 * verifySignatures. Disabled by default. Challenges are remembered
+		 * in crypto::replayFilter::shared().
+		 *
+		 * @param enabled whether to consume verified challenges
+		 */
+		void setReplayProtection(bool enabled);
+
+		/**
+		 * Issue a stateless challenge bound to an account, see crypto::challengeIssuer
+		 *
+		 * @param accountId the id of the account that will sign the challenge
+		 * @return the challenge
+		 */
+		secure_buffer issueChallenge(const std::string& accountId);
+
+		/**
+		 * Verify a challenge issued by issueChallenge and its signature.
+		 * The signature is only verified if the challenge is authentic,
+		 * bound to the account and not expired. A verified challenge is
+		 * consumed, whether replay protection is enabled or not.
+		 *
+		 * @param accountId the id of the account that signed the challenge
+		 * @param challenge the challenge returned by issueChallenge
+		 * @param signature the signature returned by passport
+		 * @param publicKey the public key of the user
+		 * @return true if the challenge is valid and the signature matched
+		 */
+		bool verifyChallengeAndSignature(const std::string& accountId, const secure_buffer& challenge,
+			const secure_buffer& signature, const secure_vector<byte>& publicKey);
+
+		/**
+		 * A signed challenge to verify
+		 */
+		struct signatureData {
+			secure_buffer challenge;
+			secure_buffer signature;
+			secure_vector<byte> publicKey;
+			signatureOptions options;
+		};
+
+		/**
+		 * Verify multiple signatures on the native thread pool.
+		 * Entries with an invalid public key are reported as not matching.
+		 *
+		 * @param signatures the signatures to verify
+		 * @return whether each signature matched, in the order of the input
+		 */
+		std::vector<bool> verifySignatures(const std::vector<signatureData>& signatures);
 
 		/**
 		 * Delete a passport account
@@ -279,9 +728,21 @@ namespace nodeMsPassport {
 		 * @param encrypt whether to encrypt the password
 		 * @return if the operation was successful
 		 */
-		bool write(const std::wstring& target, const std::wstring& user, const secure_wstring& password,
+		bool write(const std::wstring& target, const std::wstring& user, const secure_u16string& password,
 			bool encrypt);
 
+		/**
+		 * Write data to the password storage. Takes over the password,
+		 * which is encrypted in place and stored without copying it.
+		 *
+		 * @param target the account id
+		 * @param user the user name to store
+		 * @param password the password to store
+		 * @param encrypt whether to encrypt the password
+		 * @return if the operation was successful
+		 */
+		bool write(const std::wstring& target, const std::wstring& user, secret_u16string password, bool encrypt);
+
 		/**
 		 * Read data from the password storage
 		 *
@@ -291,7 +752,19 @@ namespace nodeMsPassport {
 		 * @param whether the password is encrypted
 		 * @return if the operation was successful
 		 */
-		bool read(const std::wstring& target, std::wstring& user, secure_wstring& password, bool encrypt);
+		bool read(const std::wstring& target, std::wstring& user, secure_u16string& password, bool encrypt);
+
+		/**
+		 * Read data from the password storage. The password
+		 * is copied out of the storage once and decrypted in place.
+		 *
+		 * @param target the account id
+		 * @param user the user name
+		 * @param password the password
+		 * @param whether the password is encrypted
+		 * @return if the operation was successful
+		 */
+		bool read(const std::wstring& target, std::wstring& user, secret_u16string& password, bool encrypt);
 
 		/**
 		 * Remove a entry from the credential storage
@@ -321,7 +794,7 @@ namespace nodeMsPassport {
 		 * @param data the data to encrypt, will remain unchanged if the encryption failed
 		 * @return if the operation was successful
 		 */
-		bool encrypt(secure_wstring& data);
+		bool encrypt(secure_u16string& data);
 
 		/**
 		 * Decrypt data using CredUnprotectW function
@@ -329,7 +802,7 @@ namespace nodeMsPassport {
 		 * @param data the data to decrypt, will remain unchanged if the decryption failed
 		 * @return if the operation was successful
 		 */
-		bool decrypt(secure_wstring& data);
+		bool decrypt(secure_u16string& data);
 
 		/**
 		 * Check if data was protected using CredProtectW
@@ -337,7 +810,7 @@ namespace nodeMsPassport {
 		 * @param data the data to check
 		 * @return if the data is encrypted
 		 */
-		bool isEncrypted(const secure_wstring& data);
+		bool isEncrypted(const secure_u16string& data);
 	}
 }
 
@@ -0,0 +1,222 @@
+#include <vector>
+#include <cstring>
+#include <stdexcept>
+
+#include <openssl/evp.h>
+#include <openssl/ecdsa.h>
+#include <openssl/rsa.h>
+#include <openssl/x509.h>
+#include <openssl/err.h>
+#include <openssl/bn.h>
+#include <openssl/core_names.h>
+
+#include "OpenSslEngine.hpp"
+#include "Digest.hpp"
+#include "RsaPublicOperation.hpp"
+
+using namespace nodeMsPassport;
+using namespace nodeMsPassport::crypto;
+
+namespace {
+	// The size of a raw (r || s) P-256 signature
+	constexpr size_t rawSignatureSize = 64;
+
+	struct contextDeleter {
+		void operator()(EVP_PKEY_CTX* ctx) const noexcept {
+			EVP_PKEY_CTX_free(ctx);
+		}
+	};
+
+	struct numberDeleter {
+		void operator()(BIGNUM* n) const noexcept {
+			BN_free(n);
+		}
+	};
+
+	struct signatureDeleter {
+		void operator()(ECDSA_SIG* sig) const noexcept {
+			ECDSA_SIG_free(sig);
+		}
+	};
+
+	/**
+	 * Get a big number parameter of a key
+	 */
+	std::unique_ptr<BIGNUM, numberDeleter> getNumber(const EVP_PKEY* key, const char* name) {
+		BIGNUM* value = nullptr;
+		if (EVP_PKEY_get_bn_param(key, name, &value) != 1) {
+			ERR_clear_error();
+			throw std::invalid_argument("Invalid public key: the key could not be parsed");
+		}
+
+		return std::unique_ptr<BIGNUM, numberDeleter>(value);
+	}
+
+	/**
+	 * Reject the RSA keys the constructor of rsaPublicKey rejects.
+	 * With e = 1, the encoded message is a valid signature.
+	 */
+	void checkRsaKey(const EVP_PKEY* key) {
+		if (EVP_PKEY_bits(key) < 512) throw std::invalid_argument("Invalid public key: the modulus is too small");
+
+		if (!BN_is_odd(getNumber(key, OSSL_PKEY_PARAM_RSA_N).get())) {
+			throw std::invalid_argument("Invalid public key: the modulus must be odd");
+		}
+
+		// The exponent must be odd, at least three and at most 64 bits long
+		const auto e = getNumber(key, OSSL_PKEY_PARAM_RSA_E);
+		if (!BN_is_odd(e.get()) || BN_is_one(e.get())) {
+			throw std::invalid_argument("Invalid public key: invalid public exponent");
+		} else if ((size_t)BN_num_bits(e.get()) > rsaPublicOperation::maxExponentBits) {
+			throw std::invalid_argument("Invalid public key: the public exponent is too large");
+		}
+	}
+
+	const EVP_MD* messageDigest(hashAlgorithm alg) noexcept {
+		switch (alg) {
+			case hashAlgorithm::sha384:
+				return EVP_sha384();
+			case hashAlgorithm::sha512:
+				return EVP_sha512();
+			default:
+				return EVP_sha256();
+		}
+	}
+
+	/**
+	 * Convert a DER encoded or raw (r || s) ECDSA signature to DER,
+	 * with the same rules as ecPublicKey
+	 *
+	 * @return the DER encoded signature, empty if the signature could not be parsed
+	 */
+	std::vector<byte> encodeEcdsaSignature(const byte* data, size_t len) {
+		const byte* p = data;
+		std::unique_ptr<ECDSA_SIG, signatureDeleter> sig(d2i_ECDSA_SIG(nullptr, &p, (long)len));
+		if (sig && p == data + len) {
+			return std::vector<byte>(data, data + len);
+		}
+
+		if (len != rawSignatureSize) return {};
+		const size_t half = rawSignatureSize / 2;
+		sig.reset(ECDSA_SIG_new());
+		BIGNUM* r = BN_bin2bn(data, half, nullptr);
+		BIGNUM* s = BN_bin2bn(data + half, half, nullptr);
+		if (!sig || !r || !s || ECDSA_SIG_set0(sig.get(), r, s) != 1) {
+			BN_free(r);
+			BN_free(s);
+			return {};
+		}
+
+		const int size = i2d_ECDSA_SIG(sig.get(), nullptr);
+		if (size <= 0) return {};
+		std::vector<byte> res((size_t)size);
+		byte* out = res.data();
+		i2d_ECDSA_SIG(sig.get(), &out);
+
+		return res;
+	}
+}
+
+void openSslPublicKey::keyDeleter::operator()(evp_pkey_st* k) const noexcept {
+	EVP_PKEY_free(k);
+}
+
+std::unique_ptr<const publicKey> openSslPublicKey::fromSubjectPublicKeyInfo(const byte* data, size_t len) {
+	const byte* p = data;
+	EVP_PKEY* parsed = d2i_PUBKEY(nullptr, &p, (long)len);
+	if (!parsed) {
+		ERR_clear_error();
+		throw std::invalid_argument("Invalid public key: the key could not be parsed");
+	}
+
+	std::unique_ptr<evp_pkey_st, keyDeleter> k(parsed);
+	if (p != data + len) throw std::invalid_argument("Invalid public key: trailing data");
+
+	// Only accept the keys the native engine accepts
+	switch (EVP_PKEY_base_id(k.get())) {
+		case EVP_PKEY_RSA:
+			checkRsaKey(k.get());
+			return std::unique_ptr<const publicKey>(new openSslPublicKey(k.release(), true));
+		case EVP_PKEY_EC: {
+			char group[64];
+			if (EVP_PKEY_get_group_name(k.get(), group, sizeof(group), nullptr) != 1 ||
+				std::strcmp(group, "prime256v1") != 0) {
+				ERR_clear_error();
+				throw std::invalid_argument("Invalid public key: unsupported curve");
+			}
+
+			return std::unique_ptr<const publicKey>(new openSslPublicKey(k.release(), false));
+		}
+		default:
+			throw std::invalid_argument("Invalid public key: unsupported algorithm");
+	}
+}
+
+openSslPublicKey::openSslPublicKey(evp_pkey_st* key, bool rsa) : key(key), rsa(rsa) {}
+
+bool openSslPublicKey::verifyDigest(const byte* hash, size_t hashLength, const byte* signature,
+	size_t signatureLength, const passport::signatureOptions& options) const {
+	if (!rsa && options.padding == passport::signaturePadding::pss) {
+		throw std::invalid_argument("PSS signatures require an RSA key");
+	}
+
+	if (hashLength != digestSize(options.hash)) {
+		throw std::invalid_argument("The length of the hash does not match the hash algorithm");
+	}
+
+	std::vector<byte> encoded;
+	if (!rsa) {
+		encoded = encodeEcdsaSignature(signature, signatureLength);
+		if (encoded.empty()) {
+			ERR_clear_error();
+			return false;
+		}
+
+		signature = encoded.data();
+		signatureLength = encoded.size();
+	}
+
+	std::unique_ptr<EVP_PKEY_CTX, contextDeleter> ctx(EVP_PKEY_CTX_new(key.get(), nullptr));
+	const EVP_MD* md = messageDigest(options.hash);
+	bool ok = ctx && EVP_PKEY_verify_init(ctx.get()) == 1;
+	if (ok && rsa) {
+		if (options.padding == passport::signaturePadding::pss) {
+			// The salt can never be longer than the signature
+			if (options.saltLength != passport::signatureOptions::saltLengthAuto &&
+				options.saltLength > signatureLength) {
+				return false;
+			}
+
+			const int saltLength = options.saltLength == passport::signatureOptions::saltLengthAuto
+								   ? RSA_PSS_SALTLEN_AUTO : (int)options.saltLength;
+			ok = EVP_PKEY_CTX_set_rsa_padding(ctx.get(), RSA_PKCS1_PSS_PADDING) == 1 &&
+				 EVP_PKEY_CTX_set_rsa_pss_saltlen(ctx.get(), saltLength) == 1 &&
+				 EVP_PKEY_CTX_set_rsa_mgf1_md(ctx.get(), md) == 1;
+		} else {
+			ok = EVP_PKEY_CTX_set_rsa_padding(ctx.get(), RSA_PKCS1_PADDING) == 1;
+		}
+	}
+
+	// ECDSA truncates the hash to the size of the group order, like ecPublicKey
+	ok = ok && EVP_PKEY_CTX_set_signature_md(ctx.get(), md) == 1 &&
+		 EVP_PKEY_verify(ctx.get(), signature, signatureLength, hash, hashLength) == 1;
+
+	// Invalid signatures leave errors on the thread's error queue
+	if (!ok) ERR_clear_error();
+	return ok;
+}
+
+openSslEngine::openSslEngine() : cache(1024, 16, openSslPublicKey::fromSubjectPublicKeyInfo) {}
+
+const char* openSslEngine::name() const noexcept {
+	return "openssl";
+}
+
+keyCache& openSslEngine::keys() const noexcept {
+	return cache;
+}
+
+const openSslEngine& openSslEngine::instance() {
+	static const openSslEngine engine;
+	return engine;
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#ifndef PASSPORT_OPENSSLENGINE_HPP
+#define PASSPORT_OPENSSLENGINE_HPP
+
+#include <memory>
+
+#include "VerificationEngine.hpp"
+
+// Avoid including the OpenSSL headers everywhere
+struct evp_pkey_st;
+
+namespace nodeMsPassport::crypto {
+	/**
+	 * A public key verifying signatures using the OpenSSL EVP interface.
+	 * Accepts the same keys and signatures as rsaPublicKey and ecPublicKey.
+	 */
+	class openSslPublicKey : public publicKey {
+	public:
+		/**
+		 * Parse a DER encoded X.509 SubjectPublicKeyInfo holding an RSA or EC P-256 key.
+		 * Throws std::invalid_argument if the key could not be parsed.
+		 *
+		 * @param data the encoded key
+		 * @param len the length of the encoded key
+		 * @return the parsed key
+		 */
+		static std::unique_ptr<const publicKey> fromSubjectPublicKeyInfo(const byte* data, size_t len);
+
+		NODEMSPASSPORT_NODISCARD bool verifyDigest(const byte* hash, size_t hashLength, const byte* signature,
+			size_t signatureLength, const passport::signatureOptions& options) const override;
+
+	private:
+		struct keyDeleter {
+			void operator()(evp_pkey_st* key) const noexcept;
+		};
+
+		openSslPublicKey(evp_pkey_st* key, bool rsa);
+
+		std::unique_ptr<evp_pkey_st, keyDeleter> key;
+		bool rsa;
+	};
+
+	/**
+	 * The verification engine using OpenSSL. Only available
+	 * if the library was built with PASSPORT_WITH_OPENSSL.
+	 */
+	class openSslEngine : public verificationEngine {
+	public:
+		NODEMSPASSPORT_NODISCARD const char* name() const noexcept override;
+
+		NODEMSPASSPORT_NODISCARD keyCache& keys() const noexcept override;
+
+		/**
+		 * Get the OpenSSL engine
+		 *
+		 * @return the engine instance
+		 */
+		static const openSslEngine& instance();
+
+	private:
+		openSslEngine();
+
+		mutable keyCache cache;
+	};
+}
+
+#endif //PASSPORT_OPENSSLENGINE_HPP
\ No newline at end of file
@@ -0,0 +1,56 @@
+#include "NodeMsPassport.hpp"
+#include "SoftwareBackend.hpp"
+
+// The windows only parts of the library, for any other system.
+// Passport operations use the software authenticator, the credential
+// manager and password encryption are not available.
+
+using namespace nodeMsPassport;
+
+namespace {
+	[[noreturn]] void throwUnsupported() {
+		throw passport::passportException("This operation is only supported on windows", -1);
+	}
+}
+
+void passport::setCSharpDllLocation(const std::string&) {}
+
+std::shared_ptr<passport::backend> passport::createDefaultBackend() {
+	return std::make_shared<softwareBackend>(softwareBackend::defaultDirectory());
+}
+
+bool credentials::write(const std::wstring&, const std::wstring&, const secure_u16string&, bool) {
+	throwUnsupported();
+}
+
+bool credentials::write(const std::wstring&, const std::wstring&, secret_u16string, bool) {
+	throwUnsupported();
+}
+
+bool credentials::read(const std::wstring&, std::wstring&, secure_u16string&, bool) {
+	throwUnsupported();
+}
+
+bool credentials::read(const std::wstring&, std::wstring&, secret_u16string&, bool) {
+	throwUnsupported();
+}
+
+bool credentials::remove(const std::wstring&) {
+	throwUnsupported();
+}
+
+bool credentials::isEncrypted(const std::wstring&) {
+	throwUnsupported();
+}
+
+bool passwords::encrypt(secure_u16string&) {
+	throwUnsupported();
+}
+
+bool passwords::decrypt(secure_u16string&) {
+	throwUnsupported();
+}
+
+bool passwords::isEncrypted(const secure_u16string&) {
+	throwUnsupported();
+}
\ No newline at end of file
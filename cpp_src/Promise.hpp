@@ -0,0 +1,222 @@
+#ifndef PASSPORT_PROMISE_HPP
+#define PASSPORT_PROMISE_HPP
+
+#include <napi.h>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <utility>
+#include <optional>
+#include <type_traits>
+
+#include "Scheduler.hpp"
+
+/**
+ * Promises running their work on the shared scheduler.
+ * All results are handed back to the javascript thread of the calling
+ * environment through a thread-safe function per environment, created by init().
+ */
+namespace nodeMsPassport::promises {
+	namespace detail {
+		inline Napi::Value toNapiValue(const Napi::Env& env, bool value) {
+			return Napi::Boolean::New(env, value);
+		}
+
+		inline Napi::Value toNapiValue(const Napi::Env& env, const std::string& value) {
+			return Napi::String::New(env, value);
+		}
+
+		inline Napi::Value toNapiValue(const Napi::Env& env, const std::u16string& value) {
+			return Napi::String::New(env, value);
+		}
+
+		template<class T>
+		inline auto toNapiValue(const Napi::Env& env, const T& value) -> decltype(T::toNapiValue(env, value)) {
+			return T::toNapiValue(env, value);
+		}
+
+		/**
+		 * A call waiting to be settled on the javascript thread
+		 */
+		class completion {
+		public:
+			explicit completion(const Napi::Env& env) : deferred(Napi::Promise::Deferred::New(env)) {}
+
+			virtual ~completion() = default;
+
+			/**
+			 * Run the work. Called on a pool thread.
+			 */
+			virtual void run() noexcept = 0;
+
+			/**
+			 * Resolve or reject the promise. Called on the javascript thread.
+			 *
+			 * @param env the environment to work in
+			 */
+			virtual void settle(const Napi::Env& env) = 0;
+
+			Napi::Promise::Deferred deferred;
+		};
+
+		template<class T, class Fn>
+		class task : public completion {
+		public:
+			template<class F>
+			task(const Napi::Env& env, F&& fn) : completion(env), fn(std::forward<F>(fn)), result(), error() {}
+
+			void run() noexcept override {
+				try {
+					if constexpr (std::is_void_v<T>) {
+						fn();
+						result = true;
+					} else {
+						result = fn();
+					}
+				} catch (const std::exception& e) {
+					error = e.what();
+				} catch (...) {
+					error = "An unknown error occurred";
+				}
+			}
+
+			void settle(const Napi::Env& env) override {
+				if (!result) {
+					deferred.Reject(Napi::Error::New(env, error).Value());
+				} else if constexpr (std::is_void_v<T>) {
+					deferred.Resolve(env.Undefined());
+				} else {
+					deferred.Resolve(toNapiValue(env, *result));
+				}
+			}
+
+		private:
+			Fn fn;
+			std::optional<std::conditional_t<std::is_void_v<T>, bool, T>> result;
+			std::string error;
+		};
+
+		/**
+		 * The per environment state. Every environment loading the module
+		 * (worker threads, electron contexts) has its own dispatcher, so the
+		 * results are always settled on the thread which created the promise.
+		 */
+		struct instance {
+			/**
+			 * The thread-safe function delivering the completions of this environment
+			 */
+			Napi::ThreadSafeFunction dispatcher;
+
+			/**
+			 * Guards the dispatcher against the environment being torn down
+			 */
+			std::mutex mtx;
+
+			/**
+			 * Whether the dispatcher was finalized by node. Guarded by mtx.
+			 */
+			bool closed = false;
+
+			/**
+			 * The number of unsettled promises. Only used on the javascript thread.
+			 * The dispatcher only keeps the event loop alive while this is not zero.
+			 */
+			size_t inFlight = 0;
+		};
+
+		/**
+		 * The instance data of an environment. Pending tasks share the
+		 * ownership, as they may finish after the environment was torn down.
+		 */
+		using instanceData = std::shared_ptr<instance>;
+
+		inline void deliver(const std::shared_ptr<instance>& owner, completion* c) {
+			// Node frees the dispatcher when the environment is torn down, never call it after that
+			std::unique_lock lock(owner->mtx);
+			if (owner->closed) {
+				lock.unlock();
+				delete c;
+				return;
+			}
+
+			const napi_status status = owner->dispatcher.NonBlockingCall(c,
+				[owner](Napi::Env env, Napi::Function, completion* c) {
+					std::unique_ptr<completion> ptr(c);
+
+					// Called without an environment while the queue is drained on teardown
+					if (env == nullptr) return;
+
+					if (--owner->inFlight == 0) owner->dispatcher.Unref(env);
+					ptr->settle(env);
+				});
+			lock.unlock();
+
+			// The environment is shutting down, nobody is waiting for the result
+			if (status != napi_ok) delete c;
+		}
+	}
+
+	/**
+	 * Create the thread-safe function delivering the results of an environment.
+	 * Must be called once when the module is initialized in an environment.
+	 *
+	 * @param env the environment to work in
+	 */
+	inline void init(const Napi::Env& env) {
+		auto data = std::make_shared<detail::instance>();
+
+		// N-API versions before 5 require a function, the results are delivered by the call_js callbacks
+		const Napi::Function noop = Napi::Function::New(env, [](const Napi::CallbackInfo&) {});
+		data->dispatcher = Napi::ThreadSafeFunction::New(env, noop, "nodeMsPassport", 0, 1,
+			[data](Napi::Env) {
+				std::lock_guard lock(data->mtx);
+				data->closed = true;
+			});
+		data->dispatcher.Unref(env);
+
+		// Deleted by node when the environment is torn down
+		Napi::Env(env).SetInstanceData(new detail::instanceData(std::move(data)));
+	}
+
+	/**
+	 * Run a function on a lane of the shared scheduler and return a promise resolving to its result.
+	 * The promise is rejected with the message of any exception thrown by fn.
+	 *
+	 * @tparam T the return type of fn
+	 * @param env the environment to work in
+	 * @param l the lane to run fn on
+	 * @param fn the function to run
+	 * @return the promise
+	 */
+	template<class T, class Fn>
+	inline Napi::Promise promise(const Napi::Env& env, util::lane l, Fn&& fn) {
+		auto* c = new detail::task<T, std::decay_t<Fn>>(env, std::forward<Fn>(fn));
+		const Napi::Promise res = c->deferred.Promise();
+
+		// Settle the promise through the dispatcher of the calling environment
+		std::shared_ptr<detail::instance> owner = *Napi::Env(env).GetInstanceData<detail::instanceData>();
+		if (owner->inFlight++ == 0) owner->dispatcher.Ref(env);
+
+		util::scheduler::shared().submit(l, [c, owner = std::move(owner)] {
+			c->run();
+			detail::deliver(owner, c);
+		});
+
+		return res;
+	}
+
+	/**
+	 * Run a function on the compute lane and return a promise resolving to its result
+	 *
+	 * @tparam T the return type of fn
+	 * @param env the environment to work in
+	 * @param fn the function to run
+	 * @return the promise
+	 */
+	template<class T, class Fn>
+	inline Napi::Promise promise(const Napi::Env& env, Fn&& fn) {
+		return promise<T>(env, util::lane::compute, std::forward<Fn>(fn));
+	}
+}
+
+#endif //PASSPORT_PROMISE_HPP
\ No newline at end of file
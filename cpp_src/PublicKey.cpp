@@ -0,0 +1,36 @@
+#include <stdexcept>
+
+#include "PublicKey.hpp"
+#include "RsaVerifier.hpp"
+#include "EcdsaVerifier.hpp"
+#include "Der.hpp"
+#include "Digest.hpp"
+
+using namespace nodeMsPassport;
+using namespace nodeMsPassport::crypto;
+
+std::unique_ptr<const publicKey> publicKey::fromSubjectPublicKeyInfo(const byte* data, size_t len) {
+	const der::subjectPublicKeyInfo info = der::parseSubjectPublicKeyInfo(der::span{data, len});
+	if (der::isRsaKey(info)) {
+		const der::rsaPublicKeyView key = der::parseRsaPublicKey(info);
+		return std::make_unique<const rsaPublicKey>(key.modulus.data, key.modulus.size, key.exponent.data,
+			key.exponent.size);
+	} else if (der::isEcKey(info)) {
+		const der::ecPublicKeyView key = der::parseEcPublicKey(info);
+		return std::make_unique<const ecPublicKey>(key.point.data, key.point.size);
+	}
+
+	throw std::invalid_argument("Invalid public key: unsupported algorithm");
+}
+
+bool publicKey::verify(const byte* message, size_t messageLength, const byte* signature, size_t signatureLength,
+	const passport::signatureOptions& options) const {
+	byte hash[maxDigestSize];
+	const size_t hashLength = digest(options.hash, message, messageLength, hash);
+	return verifyDigest(hash, hashLength, signature, signatureLength, options);
+}
+
+bool publicKey::verifySha256(const byte* message, size_t messageLength, const byte* signature,
+	size_t signatureLength) const {
+	return verify(message, messageLength, signature, signatureLength, passport::signatureOptions());
+}
\ No newline at end of file
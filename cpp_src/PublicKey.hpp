@@ -0,0 +1,72 @@
+#ifndef PASSPORT_PUBLICKEY_HPP
+#define PASSPORT_PUBLICKEY_HPP
+
+#include <memory>
+
+#include "NodeMsPassport.hpp"
+
+namespace nodeMsPassport::crypto {
+	/**
+	 * A public key used to verify signatures.
+	 * Implemented by rsaPublicKey, ecPublicKey and openSslPublicKey.
+	 */
+	class publicKey {
+	public:
+		/**
+		 * Parse a DER encoded X.509 SubjectPublicKeyInfo. The key type is
+		 * selected by the algorithm identifier, RSA and EC P-256 keys are supported.
+		 * Throws std::invalid_argument if the key could not be parsed.
+		 *
+		 * @param data the encoded key
+		 * @param len the length of the encoded key
+		 * @return the parsed key
+		 */
+		static std::unique_ptr<const publicKey> fromSubjectPublicKeyInfo(const byte* data, size_t len);
+
+		/**
+		 * Verify a signature. RSA keys expect a RSASSA-PKCS1-v1_5 or RSASSA-PSS
+		 * signature, EC keys a DER encoded or raw (r || s) ECDSA signature.
+		 * Throws std::invalid_argument if the options are not supported by the key.
+		 *
+		 * @param message the signed message
+		 * @param messageLength the length of the message
+		 * @param signature the signature
+		 * @param signatureLength the length of the signature
+		 * @param options how the signature was created
+		 * @return true if the signature is valid
+		 */
+		NODEMSPASSPORT_NODISCARD bool verify(const byte* message, size_t messageLength, const byte* signature,
+			size_t signatureLength, const passport::signatureOptions& options) const;
+
+		/**
+		 * Verify a signature of an already hashed message, same as verify.
+		 * Throws std::invalid_argument if the options are not supported by the key
+		 * or the length of the hash does not match the hash algorithm.
+		 *
+		 * @param hash the hash of the message using options.hash
+		 * @param hashLength the length of the hash
+		 * @param signature the signature
+		 * @param signatureLength the length of the signature
+		 * @param options how the signature was created
+		 * @return true if the signature is valid
+		 */
+		NODEMSPASSPORT_NODISCARD virtual bool verifyDigest(const byte* hash, size_t hashLength,
+			const byte* signature, size_t signatureLength, const passport::signatureOptions& options) const = 0;
+
+		/**
+		 * Verify a signature using SHA-256 and the default padding
+		 *
+		 * @param message the signed message
+		 * @param messageLength the length of the message
+		 * @param signature the signature
+		 * @param signatureLength the length of the signature
+		 * @return true if the signature is valid
+		 */
+		NODEMSPASSPORT_NODISCARD bool verifySha256(const byte* message, size_t messageLength,
+			const byte* signature, size_t signatureLength) const;
+
+		virtual ~publicKey() = default;
+	};
+}
+
+#endif //PASSPORT_PUBLICKEY_HPP
\ No newline at end of file
@@ -0,0 +1,50 @@
+#include <stdexcept>
+#include <algorithm>
+
+#include "Random.hpp"
+
+#ifdef _WIN32
+#   define NOMINMAX
+#   include <windows.h>
+#   include <bcrypt.h>
+#   pragma comment(lib, "bcrypt.lib")
+#elif defined(__linux__)
+#   include <cerrno>
+#   include <sys/random.h>
+#else
+#   include <cstdio>
+#endif
+
+using namespace nodeMsPassport;
+
+void crypto::randomBytes(byte* out, size_t len) {
+#ifdef _WIN32
+	while (len > 0) {
+		const ULONG chunk = (ULONG)std::min<size_t>(len, 0x7fffffff);
+		if (!BCRYPT_SUCCESS(BCryptGenRandom(nullptr, out, chunk, BCRYPT_USE_SYSTEM_PREFERRED_RNG))) {
+			throw std::runtime_error("Could not generate random bytes");
+		}
+
+		out += chunk;
+		len -= chunk;
+	}
+#elif defined(__linux__)
+	while (len > 0) {
+		const ssize_t res = getrandom(out, len, 0);
+		if (res < 0) {
+			if (errno == EINTR) continue;
+			throw std::runtime_error("Could not generate random bytes");
+		}
+
+		out += res;
+		len -= (size_t)res;
+	}
+#else
+	FILE* urandom = fopen("/dev/urandom", "rb");
+	if (urandom == nullptr) throw std::runtime_error("Could not open /dev/urandom");
+
+	const size_t read = fread(out, 1, len, urandom);
+	fclose(urandom);
+	if (read != len) throw std::runtime_error("Could not generate random bytes");
+#endif
+}
\ No newline at end of file
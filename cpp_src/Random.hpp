@@ -0,0 +1,18 @@
+#ifndef PASSPORT_RANDOM_HPP
+#define PASSPORT_RANDOM_HPP
+
+#include "NodeMsPassport.hpp"
+
+namespace nodeMsPassport::crypto {
+	/**
+	 * Fill a buffer with cryptographically secure random bytes
+	 * provided by the operating system.
+	 * Throws std::runtime_error if no random bytes could be generated.
+	 *
+	 * @param out the buffer to fill
+	 * @param len the number of bytes to generate
+	 */
+	void randomBytes(byte* out, size_t len);
+}
+
+#endif //PASSPORT_RANDOM_HPP
\ No newline at end of file
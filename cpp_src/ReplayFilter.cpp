@@ -0,0 +1,179 @@
+#include <chrono>
+#include <stdexcept>
+#include <algorithm>
+
+#include "ReplayFilter.hpp"
+#include "Sha256.hpp"
+
+using namespace nodeMsPassport;
+using namespace nodeMsPassport::crypto;
+
+namespace {
+	constexpr size_t initialTableSize = 16;
+
+	std::mutex sharedMtx;
+	uint64_t sharedTtlValue = replayFilter::defaultTtl;
+	size_t sharedMaxEntriesValue = replayFilter::defaultMaxEntries;
+	bool sharedStarted = false;
+
+	inline size_t slotIndex(uint64_t fp, size_t mask) {
+		// The upper bits select the shard
+		return (size_t)fp & mask;
+	}
+}
+
+replayFilter::replayFilter(uint64_t ttl, size_t maxEntries, size_t shards) : bucketWidth(
+	std::max<uint64_t>(1, (ttl + bucketCount - 2) / (bucketCount - 1))), numShards(std::max<size_t>(1, shards)) {
+	shardCapacity = std::max<size_t>(1, maxEntries / numShards);
+	this->shards = std::make_unique<shard[]>(numShards);
+}
+
+replayFilter::result replayFilter::insert(const byte* challenge, size_t len) {
+	return insert(challenge, len, now());
+}
+
+replayFilter::result replayFilter::insert(const byte* challenge, size_t len, uint64_t now) {
+	return insertFingerprint(fingerprint(challenge, len), now);
+}
+
+replayFilter::result replayFilter::insertFingerprint(uint64_t fp, uint64_t now) {
+	if (fp == 0) fp = 1;
+	shard& s = shards[(fp >> 32u) % numShards];
+
+	std::unique_lock<std::mutex> lock(s.mtx);
+	s.epoch = std::max(s.epoch, now / bucketWidth);
+	const uint64_t epoch = s.epoch;
+
+	size_t live = 0;
+	for (bucket& b : s.buckets) {
+		if (b.epoch == noEpoch) continue;
+
+		// Expire the bucket and release its memory, so only live buckets take up space
+		if (b.epoch + bucketCount <= epoch) {
+			std::vector<uint64_t>().swap(b.table);
+			b.count = 0;
+			b.epoch = noEpoch;
+			continue;
+		}
+
+		if (contains(b, fp)) {
+			s.duplicates++;
+			return result::duplicate;
+		}
+
+		live += b.count;
+	}
+
+	// Every bucket in the slot of a different epoch has just been expired
+	bucket& target = s.buckets[epoch % bucketCount];
+	target.epoch = epoch;
+
+	if (live >= shardCapacity) {
+		s.rejected++;
+		return result::full;
+	}
+
+	add(target, fp);
+	s.inserted++;
+	return result::inserted;
+}
+
+uint64_t replayFilter::ttl() const noexcept {
+	return bucketWidth * (bucketCount - 1);
+}
+
+replayFilter::statistics replayFilter::getStatistics() const {
+	statistics res;
+	for (size_t i = 0; i < numShards; i++) {
+		const shard& s = shards[i];
+		std::unique_lock<std::mutex> lock(s.mtx);
+
+		res.inserted += s.inserted;
+		res.duplicates += s.duplicates;
+		res.rejected += s.rejected;
+		for (const bucket& b : s.buckets) {
+			if (b.epoch != noEpoch && b.epoch + bucketCount > s.epoch) res.size += b.count;
+			res.memory += b.table.capacity() * sizeof(uint64_t);
+		}
+	}
+
+	return res;
+}
+
+uint64_t replayFilter::fingerprint(const byte* challenge, size_t len) noexcept {
+	const sha256::digest hash = sha256::hash(challenge, len);
+
+	uint64_t res = 0;
+	for (size_t i = 0; i < sizeof(uint64_t); i++) {
+		res = (res << 8u) | hash[i];
+	}
+
+	return res;
+}
+
+uint64_t replayFilter::now() noexcept {
+	using namespace std::chrono;
+	return (uint64_t)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void replayFilter::setSharedConfiguration(uint64_t ttl, size_t maxEntries) {
+	if (ttl == 0 || maxEntries == 0) throw std::invalid_argument("The ttl and the size must be positive");
+
+	std::unique_lock<std::mutex> lock(sharedMtx);
+	if (sharedStarted) throw std::logic_error("The shared replay filter is already running");
+	sharedTtlValue = ttl;
+	sharedMaxEntriesValue = maxEntries;
+}
+
+uint64_t replayFilter::sharedTtl() {
+	std::unique_lock<std::mutex> lock(sharedMtx);
+	return sharedTtlValue;
+}
+
+size_t replayFilter::sharedMaxEntries() {
+	std::unique_lock<std::mutex> lock(sharedMtx);
+	return sharedMaxEntriesValue;
+}
+
+replayFilter& replayFilter::shared() {
+	static replayFilter filter = [] {
+		std::unique_lock<std::mutex> lock(sharedMtx);
+		sharedStarted = true;
+		return replayFilter(sharedTtlValue, sharedMaxEntriesValue);
+	}();
+
+	return filter;
+}
+
+bool replayFilter::contains(const bucket& b, uint64_t fp) noexcept {
+	if (b.count == 0) return false;
+
+	const size_t mask = b.table.size() - 1;
+	for (size_t i = slotIndex(fp, mask);; i = (i + 1) & mask) {
+		if (b.table[i] == fp) return true;
+		if (b.table[i] == 0) return false;
+	}
+}
+
+void replayFilter::add(bucket& b, uint64_t fp) {
+	// Keep the load factor at or below one half
+	if (b.table.empty() || (b.count + 1) * 2 > b.table.size()) {
+		std::vector<uint64_t> table(std::max(initialTableSize, b.table.size() * 2), 0);
+		const size_t mask = table.size() - 1;
+		for (uint64_t value : b.table) {
+			if (value == 0) continue;
+
+			size_t i = slotIndex(value, mask);
+			while (table[i] != 0) i = (i + 1) & mask;
+			table[i] = value;
+		}
+
+		b.table.swap(table);
+	}
+
+	const size_t mask = b.table.size() - 1;
+	size_t i = slotIndex(fp, mask);
+	while (b.table[i] != 0) i = (i + 1) & mask;
+	b.table[i] = fp;
+	b.count++;
+}
\ No newline at end of file
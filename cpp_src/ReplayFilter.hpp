@@ -0,0 +1,191 @@
+#ifndef PASSPORT_REPLAYFILTER_HPP
+#define PASSPORT_REPLAYFILTER_HPP
+
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+#include "NodeMsPassport.hpp"
+
+namespace nodeMsPassport::crypto {
+	/**
+	 * An in-process filter for consumed challenges. Stores a 64 bit fingerprint
+	 * of every challenge in a sharded hash set, split into time buckets per shard.
+	 * Whole buckets expire at once, so a challenge is remembered for at least ttl
+	 * and at most ttl plus the width of one bucket. The number of stored
+	 * fingerprints is bounded, inserts fail once a shard is full.
+	 */
+	class replayFilter {
+	public:
+		/**
+		 * The result of an insert
+		 */
+		enum class result {
+			// The challenge was not seen before and is now consumed
+			inserted,
+			// The challenge was already consumed
+			duplicate,
+			// The filter is full, the challenge can't be consumed
+			full
+		};
+
+		/**
+		 * The filter statistics
+		 */
+		struct statistics {
+			uint64_t inserted = 0;
+			uint64_t duplicates = 0;
+			// The number of inserts rejected because the filter was full
+			uint64_t rejected = 0;
+			// The number of fingerprints currently stored
+			size_t size = 0;
+			// The size of all hash tables in bytes
+			size_t memory = 0;
+		};
+
+		/**
+		 * The default time a challenge is remembered for in milliseconds
+		 */
+		static constexpr uint64_t defaultTtl = 10 * 60 * 1000;
+
+		/**
+		 * The default maximum number of stored fingerprints
+		 */
+		static constexpr size_t defaultMaxEntries = 1u << 22u;
+
+		/**
+		 * Create a replay filter
+		 *
+		 * @param ttl the minimum time a challenge is remembered for in milliseconds
+		 * @param maxEntries the maximum number of stored fingerprints
+		 * @param shards the number of shards to split the filter into
+		 */
+		explicit replayFilter(uint64_t ttl = defaultTtl, size_t maxEntries = defaultMaxEntries, size_t shards = 64);
+
+		replayFilter(const replayFilter&) = delete;
+
+		replayFilter& operator=(const replayFilter&) = delete;
+
+		/**
+		 * Consume a challenge. Checking and inserting is atomic,
+		 * concurrent inserts of the same challenge return inserted exactly once.
+		 *
+		 * @param challenge the challenge to consume
+		 * @param len the length of the challenge
+		 * @return the result of the insert
+		 */
+		result insert(const byte* challenge, size_t len);
+
+		/**
+		 * Consume a challenge at a fixed time
+		 *
+		 * @param challenge the challenge to consume
+		 * @param len the length of the challenge
+		 * @param now the current time in milliseconds, must not go backwards
+		 * @return the result of the insert
+		 */
+		result insert(const byte* challenge, size_t len, uint64_t now);
+
+		/**
+		 * Consume a challenge by its fingerprint
+		 *
+		 * @param fp the 64 bit fingerprint of the challenge
+		 * @param now the current time in milliseconds, must not go backwards
+		 * @return the result of the insert
+		 */
+		result insertFingerprint(uint64_t fp, uint64_t now);
+
+		/**
+		 * Get the minimum time a challenge is remembered for
+		 *
+		 * @return the ttl in milliseconds
+		 */
+		NODEMSPASSPORT_NODISCARD uint64_t ttl() const noexcept;
+
+		/**
+		 * Get the current statistics
+		 *
+		 * @return the statistics summed over all shards
+		 */
+		NODEMSPASSPORT_NODISCARD statistics getStatistics() const;
+
+		/**
+		 * Get the fingerprint of a challenge
+		 *
+		 * @param challenge the challenge
+		 * @param len the length of the challenge
+		 * @return the first 64 bits of the SHA-256 hash of the challenge
+		 */
+		static uint64_t fingerprint(const byte* challenge, size_t len) noexcept;
+
+		/**
+		 * Get the current time of the monotonic clock used by insert
+		 *
+		 * @return the current time in milliseconds
+		 */
+		static uint64_t now() noexcept;
+
+		/**
+		 * Set the ttl and size of the shared filter.
+		 * Throws std::logic_error if the shared filter is already running.
+		 *
+		 * @param ttl the minimum time a challenge is remembered for in milliseconds
+		 * @param maxEntries the maximum number of stored fingerprints
+		 */
+		static void setSharedConfiguration(uint64_t ttl, size_t maxEntries);
+
+		/**
+		 * Get the ttl the shared filter uses or will use once it is started
+		 *
+		 * @return the ttl in milliseconds
+		 */
+		static uint64_t sharedTtl();
+
+		/**
+		 * Get the maximum number of fingerprints the shared filter stores or will store once it is started
+		 *
+		 * @return the maximum number of stored fingerprints
+		 */
+		static size_t sharedMaxEntries();
+
+		/**
+		 * Get the process wide replay filter
+		 *
+		 * @return the shared filter
+		 */
+		static replayFilter& shared();
+
+	private:
+		static constexpr size_t bucketCount = 8;
+		static constexpr uint64_t noEpoch = UINT64_MAX;
+
+		struct bucket {
+			uint64_t epoch = noEpoch;
+			// Open addressing with linear probing, zero marks an empty slot
+			std::vector<uint64_t> table;
+			size_t count = 0;
+		};
+
+		struct shard {
+			mutable std::mutex mtx;
+			bucket buckets[bucketCount];
+			// The latest epoch seen, the time of concurrent inserts may differ slightly
+			uint64_t epoch = 0;
+			uint64_t inserted = 0;
+			uint64_t duplicates = 0;
+			uint64_t rejected = 0;
+		};
+
+		static bool contains(const bucket& b, uint64_t fp) noexcept;
+
+		void add(bucket& b, uint64_t fp);
+
+		uint64_t bucketWidth;
+		size_t shardCapacity;
+		std::unique_ptr<shard[]> shards;
+		size_t numShards;
+	};
+}
+
+#endif //PASSPORT_REPLAYFILTER_HPP
\ No newline at end of file
@@ -0,0 +1,443 @@
+#include <atomic>
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
+
+#include "RsaPublicOperation.hpp"
+#include "CpuFeatures.hpp"
+#include "BigInt.hpp"
+#include "Word64.hpp"
+
+#if defined(NODEMSPASSPORT_X86) && (defined(_M_X64) || defined(__x86_64__))
+#   define NODEMSPASSPORT_X64
+#   include <immintrin.h>
+#endif
+
+// Fully unroll loops with a trip count known at compile time
+#if defined(__GNUC__) || defined(__clang__)
+#   define NODEMSPASSPORT_UNROLL _Pragma("GCC unroll 64")
+#else
+#   define NODEMSPASSPORT_UNROLL
+#endif
+
+using namespace nodeMsPassport;
+using namespace nodeMsPassport::crypto;
+
+namespace {
+	using word = word64;
+
+	/**
+	 * Reduce the L + 1 word montgomery product t < 2n below n
+	 */
+	template<size_t L>
+	inline void finalSubtract(const word* t, const word* n, word* out) noexcept {
+		bool subtract = t[L] != 0;
+		if (!subtract) {
+			subtract = true;
+			for (size_t i = L; i-- > 0;) {
+				if (t[i] != n[i]) {
+					subtract = t[i] > n[i];
+					break;
+				}
+			}
+		}
+
+		if (subtract) {
+			word borrow = 0;
+			NODEMSPASSPORT_UNROLL
+			for (size_t i = 0; i < L; i++) {
+				const word diff = t[i] - n[i];
+				out[i] = diff - borrow;
+				borrow = (word)(t[i] < n[i]) | (word)(diff < borrow);
+			}
+		} else {
+			std::copy(t, t + L, out);
+		}
+	}
+
+	/**
+	 * Add x * y to t[0, L + 2)
+	 */
+	template<size_t L>
+	inline void addRowPortable(word* t, const word* x, word y) noexcept {
+		word carry = 0;
+		NODEMSPASSPORT_UNROLL
+		for (size_t j = 0; j < L; j++) {
+			t[j] = multiplyAdd(x[j], y, t[j], carry, carry);
+		}
+
+		t[L] += carry;
+		t[L + 1] += t[L] < carry;
+	}
+
+	/**
+	 * Montgomery multiplication out = a * b / R mod n (CIOS). Instead of shifting
+	 * the accumulator by one word after every reduction step, the window into
+	 * a twice as large accumulator is moved up by one word.
+	 */
+	template<size_t L>
+	void multiplyPortable(const word* a, const word* b, const word* n, word n0inv, word* out) noexcept {
+		word t[2 * L + 2] = {};
+		for (size_t i = 0; i < L; i++) {
+			word* window = t + i;
+			addRowPortable<L>(window, a, b[i]);
+			addRowPortable<L>(window, n, window[0] * n0inv);
+		}
+
+		finalSubtract<L>(t + L, n, out);
+	}
+
+#ifdef NODEMSPASSPORT_X64
+	/**
+	 * Add x * y to t[0, L + 2) using mulx, which leaves the flags untouched.
+	 * The low halves of the products are added in the carry chain of adcx and
+	 * the high halves in the overflow chain of adox. Compilers keep at most one
+	 * carry chain in the flags, so gcc and clang use inline assembly, looping
+	 * over blocks of four words with jrcxz which does not change the flags.
+	 */
+	template<size_t L>
+	NODEMSPASSPORT_TARGET("bmi2,adx") inline void addRowBmi2(word* t, const word* x, word y) noexcept {
+		static_assert(L % 4 == 0, "The number of words must be a multiple of four");
+#if defined(__GNUC__) || defined(__clang__)
+		size_t blocks = L / 4;
+		__asm__ volatile(
+			// Clears the carry and overflow flags and the previous high word
+			"xorl %%r8d, %%r8d\n\t"
+			"1:\n\t"
+			"mulxq 0(%[x]), %%rax, %%r9\n\t"
+			"adcxq 0(%[t]), %%rax\n\t"
+			"adoxq %%r8, %%rax\n\t"
+			"movq %%rax, 0(%[t])\n\t"
+			"mulxq 8(%[x]), %%rax, %%r8\n\t"
+			"adcxq 8(%[t]), %%rax\n\t"
+			"adoxq %%r9, %%rax\n\t"
+			"movq %%rax, 8(%[t])\n\t"
+			"mulxq 16(%[x]), %%rax, %%r9\n\t"
+			"adcxq 16(%[t]), %%rax\n\t"
+			"adoxq %%r8, %%rax\n\t"
+			"movq %%rax, 16(%[t])\n\t"
+			"mulxq 24(%[x]), %%rax, %%r8\n\t"
+			"adcxq 24(%[t]), %%rax\n\t"
+			"adoxq %%r9, %%rax\n\t"
+			"movq %%rax, 24(%[t])\n\t"
+			"leaq 32(%[x]), %[x]\n\t"
+			"leaq 32(%[t]), %[t]\n\t"
+			"leaq -1(%[blocks]), %[blocks]\n\t"
+			"jrcxz 2f\n\t"
+			"jmp 1b\n"
+			"2:\n\t"
+			// t[L] += high + carry + overflow, t[L + 1] += carry + overflow
+			"movl $0, %%eax\n\t"
+			"adcxq 0(%[t]), %%r8\n\t"
+			"adoxq %%rax, %%r8\n\t"
+			"movq %%r8, 0(%[t])\n\t"
+			"movq 8(%[t]), %%r9\n\t"
+			"adcxq %%rax, %%r9\n\t"
+			"adoxq %%rax, %%r9\n\t"
+			"movq %%r9, 8(%[t])\n\t"
+			: [t] "+r"(t), [x] "+r"(x), [blocks] "+c"(blocks)
+			: "d"(y)
+			: "rax", "r8", "r9", "cc", "memory");
+#else
+		unsigned char lowCarry = 0, highCarry = 0;
+		unsigned long long previousHigh = 0;
+		for (size_t j = 0; j < L; j++) {
+			unsigned long long high;
+			const unsigned long long low = _mulx_u64(x[j], y, &high);
+			lowCarry = _addcarryx_u64(lowCarry, t[j], low, &t[j]);
+			highCarry = _addcarryx_u64(highCarry, t[j], previousHigh, &t[j]);
+			previousHigh = high;
+		}
+
+		lowCarry = _addcarryx_u64(lowCarry, t[L], previousHigh, &t[L]);
+		highCarry = _addcarryx_u64(highCarry, t[L], 0, &t[L]);
+		t[L + 1] += (word)lowCarry + highCarry;
+#endif
+	}
+
+	template<size_t L>
+	NODEMSPASSPORT_TARGET("bmi2,adx") void multiplyBmi2(const word* a, const word* b, const word* n, word n0inv,
+		word* out) noexcept {
+		word t[2 * L + 2] = {};
+		for (size_t i = 0; i < L; i++) {
+			word* window = t + i;
+			addRowBmi2<L>(window, a, b[i]);
+			addRowBmi2<L>(window, n, window[0] * n0inv);
+		}
+
+		finalSubtract<L>(t + L, n, out);
+	}
+#endif
+
+	bool isSupported(rsaPublicOperation::implementation impl) {
+		switch (impl) {
+#ifdef NODEMSPASSPORT_X64
+			case rsaPublicOperation::implementation::bmi2Adx: {
+				const cpu::features& features = cpu::getFeatures();
+				return features.bmi2 && features.adx;
+			}
+#endif
+			case rsaPublicOperation::implementation::portable:
+				return true;
+			default:
+				return false;
+		}
+	}
+
+	rsaPublicOperation::implementation bestImplementation() {
+		return isSupported(rsaPublicOperation::implementation::bmi2Adx) ? rsaPublicOperation::implementation::bmi2Adx
+			: rsaPublicOperation::implementation::portable;
+	}
+
+	std::atomic<rsaPublicOperation::implementation> active(bestImplementation());
+
+	/**
+	 * The public operation for a modulus of exactly Bits bits
+	 */
+	template<size_t Bits>
+	class fixedOperation final : public rsaPublicOperation {
+	public:
+		static constexpr size_t words = Bits / 64;
+		static constexpr size_t bytes = Bits / 8;
+		static_assert(Bits % 64 == 0, "The modulus size must be a multiple of 64 bits");
+
+		/**
+		 * Create the operation, the modulus must have exactly Bits bits.
+		 * Leading zeros must be stripped from the exponent.
+		 */
+		fixedOperation(const byte* modulus, const byte* exponent, size_t exponentLength)
+			: n(), r2(), n0inv(0), exponent(exponent, exponent + exponentLength),
+			  f4(exponentLength == 3 && exponent[0] == 1 && exponent[1] == 0 && exponent[2] == 1) {
+			if ((modulus[bytes - 1] & 1u) == 0) {
+				throw std::invalid_argument("The modulus must be odd and greater than one");
+			}
+
+			fromBytes(modulus, n);
+
+			// Newton iteration for n[0]^-1 mod 2^64, each step doubles the number of correct bits
+			word inv = n[0];
+			for (int i = 0; i < 6; i++) {
+				inv *= 2 - n[0] * inv;
+			}
+			n0inv = (word)0 - inv;
+
+			// R mod n = 2^Bits - n, as the highest bit of n is set. Doubling it 64 times
+			// results in 2^64 in montgomery form, raising that to the number of words
+			// results in 2^Bits = R in montgomery form, which is R^2 mod n.
+			value x;
+			for (size_t i = 0; i < words; i++) {
+				x[i] = ~n[i];
+			}
+			x[0] += 1;
+
+			for (size_t bit = 0; bit < 64; bit++) {
+				const word carry = x[words - 1] >> 63u;
+				for (size_t i = words - 1; i > 0; i--) {
+					x[i] = (x[i] << 1u) | (x[i - 1] >> 63u);
+				}
+				x[0] <<= 1u;
+
+				if (carry || !less(x, n)) {
+					word borrow = 0;
+					for (size_t i = 0; i < words; i++) {
+						const word diff = x[i] - n[i];
+						const word res = diff - borrow;
+						borrow = (word)(x[i] < n[i]) | (word)(diff < borrow);
+						x[i] = res;
+					}
+				}
+			}
+
+			std::copy(std::begin(x), std::end(x), r2);
+			int bit = 0;
+			while ((words >> (bit + 1)) != 0) bit++;
+			while (bit-- > 0) {
+				multiplyPortable<words>(r2, r2, n, n0inv, r2);
+				if ((words >> bit) & 1u) {
+					multiplyPortable<words>(r2, x, n, n0inv, r2);
+				}
+			}
+		}
+
+		NODEMSPASSPORT_NODISCARD size_t bits() const noexcept override {
+			return Bits;
+		}
+
+		NODEMSPASSPORT_NODISCARD bool isFixedSize() const noexcept override {
+			return true;
+		}
+
+		NODEMSPASSPORT_NODISCARD bool apply(const byte* in, byte* out) const override {
+#ifdef NODEMSPASSPORT_X64
+			if (active.load(std::memory_order_relaxed) == implementation::bmi2Adx) {
+				return exponentiate<multiplyBmi2<words>>(in, out);
+			}
+#endif
+
+			return exponentiate<multiplyPortable<words>>(in, out);
+		}
+
+	private:
+		using value = word[words];
+		using multiplyFunc = void (*)(const word*, const word*, const word*, word, word*) noexcept;
+
+		static void fromBytes(const byte* in, value& out) noexcept {
+			for (size_t i = 0; i < words; i++) {
+				word w = 0;
+				for (size_t j = 0; j < 8; j++) {
+					w = (w << 8u) | in[bytes - 8 * (i + 1) + j];
+				}
+				out[i] = w;
+			}
+		}
+
+		static void toBytes(const value& in, byte* out) noexcept {
+			for (size_t i = 0; i < words; i++) {
+				for (size_t j = 0; j < 8; j++) {
+					out[bytes - 1 - 8 * i - j] = (byte)(in[i] >> (8u * j));
+				}
+			}
+		}
+
+		static bool less(const value& a, const value& b) noexcept {
+			for (size_t i = words; i-- > 0;) {
+				if (a[i] != b[i]) return a[i] < b[i];
+			}
+
+			return false;
+		}
+
+		template<multiplyFunc multiply>
+		bool exponentiate(const byte* in, byte* out) const noexcept {
+			value s;
+			fromBytes(in, s);
+			if (!less(s, n)) return false;
+
+			value x, acc;
+			multiply(s, r2, n, n0inv, x);
+			std::copy(std::begin(x), std::end(x), acc);
+
+			if (f4) {
+				// s^65537 = (s^(2^16)) * s, multiplying the montgomery form by the
+				// plain input also converts the result back out of montgomery form
+				for (int i = 0; i < 16; i++) {
+					multiply(acc, acc, n, n0inv, acc);
+				}
+				multiply(acc, s, n, n0inv, acc);
+			} else {
+				// Left to right square and multiply, starting below the most significant bit
+				int bit = 7;
+				while (((exponent[0] >> bit) & 1u) == 0) bit--;
+				bit--;
+
+				for (const byte e : exponent) {
+					for (; bit >= 0; bit--) {
+						multiply(acc, acc, n, n0inv, acc);
+						if ((e >> bit) & 1u) {
+							multiply(acc, x, n, n0inv, acc);
+						}
+					}
+
+					bit = 7;
+				}
+
+				value one = {1};
+				multiply(acc, one, n, n0inv, acc);
+			}
+
+			toBytes(acc, out);
+			return true;
+		}
+
+		value n, r2;
+		word n0inv;
+		std::vector<byte> exponent;
+		// The exponent is 65537
+		bool f4;
+	};
+
+	/**
+	 * The public operation for any other modulus size
+	 */
+	class genericOperation final : public rsaPublicOperation {
+	public:
+		genericOperation(const byte* modulus, size_t modulusLength, const byte* exponent, size_t exponentLength)
+			: context(modulus, modulusLength), exponent(exponent, exponent + exponentLength),
+			  modulusBits(bigintBits(context.modulus())) {}
+
+		NODEMSPASSPORT_NODISCARD size_t bits() const noexcept override {
+			return modulusBits;
+		}
+
+		NODEMSPASSPORT_NODISCARD bool isFixedSize() const noexcept override {
+			return false;
+		}
+
+		NODEMSPASSPORT_NODISCARD bool apply(const byte* in, byte* out) const override {
+			const size_t len = (modulusBits + 7) / 8;
+			const bigint s = bigintFromBytes(in, len, context.limbs());
+			if (bigintCompare(s, context.modulus()) >= 0) return false;
+
+			bigintToBytes(context.modExp(s, exponent.data(), exponent.size()), out, len);
+			return true;
+		}
+
+	private:
+		montgomeryContext context;
+		std::vector<byte> exponent;
+		size_t modulusBits;
+	};
+}
+
+rsaPublicOperation::implementation rsaPublicOperation::getImplementation() noexcept {
+	return active.load(std::memory_order_relaxed);
+}
+
+bool rsaPublicOperation::setImplementation(implementation impl) noexcept {
+	if (!isSupported(impl)) return false;
+
+	active.store(impl, std::memory_order_relaxed);
+	return true;
+}
+
+const char* rsaPublicOperation::implementationName(implementation impl) noexcept {
+	switch (impl) {
+		case implementation::bmi2Adx:
+			return "bmi2-adx";
+		default:
+			return "portable";
+	}
+}
+
+std::unique_ptr<const rsaPublicOperation> rsaPublicOperation::create(const byte* modulus, size_t modulusLength,
+	const byte* exponent, size_t exponentLength) {
+	// Skip leading zeros
+	while (modulusLength > 0 && *modulus == 0) {
+		modulus++;
+		modulusLength--;
+	}
+
+	while (exponentLength > 0 && *exponent == 0) {
+		exponent++;
+		exponentLength--;
+	}
+
+	if (exponentLength > maxExponentBits / 8) {
+		throw std::invalid_argument("Invalid public key: the public exponent is too large");
+	}
+
+	if (modulusLength > 0 && exponentLength > 0 && (modulus[0] & 0x80u) != 0) {
+		switch (modulusLength) {
+			case 256:
+				return std::make_unique<const fixedOperation<2048>>(modulus, exponent, exponentLength);
+			case 384:
+				return std::make_unique<const fixedOperation<3072>>(modulus, exponent, exponentLength);
+			case 512:
+				return std::make_unique<const fixedOperation<4096>>(modulus, exponent, exponentLength);
+			default:
+				break;
+		}
+	}
+
+	return std::make_unique<const genericOperation>(modulus, modulusLength, exponent, exponentLength);
+}
\ No newline at end of file
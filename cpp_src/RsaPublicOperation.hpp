@@ -0,0 +1,96 @@
+#ifndef PASSPORT_RSAPUBLICOPERATION_HPP
+#define PASSPORT_RSAPUBLICOPERATION_HPP
+
+#include <memory>
+
+#include "NodeMsPassport.hpp"
+
+namespace nodeMsPassport::crypto {
+	/**
+	 * The RSA public key operation m = s^e mod n.
+	 * Moduli of exactly 2048, 3072 or 4096 bits use montgomery arithmetic on 64 bit
+	 * words with the loops unrolled for the key size at compile time, using the BMI2
+	 * and ADX instructions if supported by the cpu. Other sizes use montgomeryContext.
+	 * Only public values are processed, the operation is not constant time.
+	 */
+	class rsaPublicOperation {
+	public:
+		/**
+		 * The available multiplication kernels of the fixed size implementations
+		 */
+		enum class implementation {
+			portable,
+			bmi2Adx
+		};
+
+		/**
+		 * Get the kernel currently in use
+		 *
+		 * @return the active implementation
+		 */
+		static implementation getImplementation() noexcept;
+
+		/**
+		 * Set the kernel to use. Mainly used by benchmarks.
+		 *
+		 * @param impl the implementation to use
+		 * @return false if the implementation is not supported by this cpu
+		 */
+		static bool setImplementation(implementation impl) noexcept;
+
+		/**
+		 * Get the name of an implementation
+		 *
+		 * @param impl the implementation
+		 * @return the name of the implementation
+		 */
+		static const char* implementationName(implementation impl) noexcept;
+
+		/**
+		 * The maximum size of the public exponent in bits, the same as OPENSSL_RSA_MAX_PUBEXP_BITS.
+		 * Larger exponents only make the operation more expensive.
+		 */
+		static constexpr size_t maxExponentBits = 64;
+
+		/**
+		 * Create the operation for a public key.
+		 * Throws std::invalid_argument if the modulus is even or too large
+		 * or if the exponent is longer than maxExponentBits.
+		 *
+		 * @param modulus the big endian modulus
+		 * @param modulusLength the length of the modulus in bytes
+		 * @param exponent the big endian public exponent
+		 * @param exponentLength the length of the exponent in bytes
+		 * @return the operation
+		 */
+		static std::unique_ptr<const rsaPublicOperation> create(const byte* modulus, size_t modulusLength,
+			const byte* exponent, size_t exponentLength);
+
+		/**
+		 * Get the number of significant bits of the modulus
+		 *
+		 * @return the size of the modulus in bits
+		 */
+		NODEMSPASSPORT_NODISCARD virtual size_t bits() const noexcept = 0;
+
+		/**
+		 * Check if this operation uses one of the fixed size implementations
+		 *
+		 * @return true if the modulus size has a fixed size implementation
+		 */
+		NODEMSPASSPORT_NODISCARD virtual bool isFixedSize() const noexcept = 0;
+
+		/**
+		 * Compute out = in^e mod n
+		 *
+		 * @param in the big endian input, exactly (bits() + 7) / 8 bytes long
+		 * @param out the big endian output, (bits() + 7) / 8 bytes
+		 * @return false if the input is not smaller than the modulus
+		 */
+		NODEMSPASSPORT_NODISCARD virtual bool apply(const byte* in, byte* out) const = 0;
+
+		virtual ~rsaPublicOperation() = default;
+	};
+}
+
+#endif //PASSPORT_RSAPUBLICOPERATION_HPP
\ No newline at end of file
@@ -0,0 +1,270 @@
+#include <stdexcept>
+
+#include "RsaSigner.hpp"
+#include "RsaVerifier.hpp"
+#include "Drbg.hpp"
+#include "Der.hpp"
+
+using namespace nodeMsPassport;
+using namespace nodeMsPassport::crypto;
+
+namespace {
+	constexpr unsigned limbBits = sizeof(limb) * 8;
+
+	/**
+	 * The odd primes below 2048, used to quickly reject prime candidates
+	 */
+	const std::vector<limb>& smallPrimes() {
+		static const std::vector<limb> primes = [] {
+			std::vector<limb> res;
+			for (limb candidate = 3; candidate < 2048; candidate += 2) {
+				bool prime = true;
+				for (limb p : res) {
+					if (p * p > candidate) break;
+					if (candidate % p == 0) {
+						prime = false;
+						break;
+					}
+				}
+
+				if (prime) res.push_back(candidate);
+			}
+
+			return res;
+		}();
+
+		return primes;
+	}
+
+	montgomeryContext contextFor(const bigint& modulus) {
+		const secure_vector<byte> bytes = bigintToBytes(modulus);
+		return montgomeryContext(bytes.data(), bytes.size());
+	}
+
+	bigint fromSpan(const der::span& value, size_t limbs) {
+		return bigintFromBytes(value.data, value.size, limbs);
+	}
+
+	bigint subtractLimb(const bigint& a, limb value) {
+		bigint res = a;
+		if (bigintSubtract(res, bigint{value})) throw std::invalid_argument("The value must not be negative");
+		return res;
+	}
+
+	/**
+	 * Generate a random value with the given number of limbs
+	 */
+	bigint randomBigint(size_t limbs) {
+		bigint res(limbs);
+		secureRandom(reinterpret_cast<byte*>(res.data()), limbs * sizeof(limb));
+		return res;
+	}
+
+	/**
+	 * Run the Miller-Rabin probabilistic primality test
+	 *
+	 * @param candidate the odd number to test
+	 * @param rounds the number of random bases to test
+	 * @return false if the candidate is composite
+	 */
+	bool millerRabin(const bigint& candidate, int rounds) {
+		const montgomeryContext context = contextFor(candidate);
+		const size_t s = candidate.size();
+
+		// candidate - 1 = d * 2^r
+		const bigint minusOne = subtractLimb(candidate, 1);
+		bigint d = minusOne;
+		size_t r = 0;
+		while ((d[0] & 1u) == 0) {
+			bigintDivideLimb(d, 2);
+			r++;
+		}
+
+		bigint one(s, 0);
+		one[0] = 1;
+
+		bigint oneMontgomery(s), minusOneMontgomery(s);
+		context.toMontgomery(one.data(), oneMontgomery.data());
+		context.toMontgomery(minusOne.data(), minusOneMontgomery.data());
+
+		const bigint minusThree = subtractLimb(candidate, 3);
+		for (int i = 0; i < rounds; i++) {
+			// A random base in [2, candidate - 2]
+			bigint base = bigintMod(randomBigint(s + 2), minusThree);
+			bigintAdd(base, bigint{2});
+
+			bigint x = context.modExpSecret(base, d);
+			context.toMontgomery(x.data(), x.data());
+			if (x == oneMontgomery || x == minusOneMontgomery) continue;
+
+			bool composite = true;
+			for (size_t j = 1; j < r && composite; j++) {
+				context.multiply(x.data(), x.data(), x.data());
+				if (x == minusOneMontgomery) composite = false;
+			}
+
+			if (composite) return false;
+		}
+
+		return true;
+	}
+
+	/**
+	 * Generate a random prime with the two highest bits set,
+	 * so the product of two primes has exactly twice the number of bits.
+	 * p - 1 is never a multiple of the public exponent.
+	 */
+	bigint generatePrime(size_t bits) {
+		const size_t limbs = bits / limbBits;
+		const int rounds = bits >= 1024 ? 5 : 7;
+
+		while (true) {
+			bigint candidate = randomBigint(limbs);
+			candidate[limbs - 1] |= (limb)3 << (limbBits - 2);
+			candidate[0] |= 1u;
+
+			bool composite = false;
+			for (limb p : smallPrimes()) {
+				if (bigintModLimb(candidate, p) == 0) {
+					composite = true;
+					break;
+				}
+			}
+
+			if (composite || bigintModLimb(candidate, rsaPrivateKey::publicExponent) == 1) continue;
+			if (millerRabin(candidate, rounds)) return candidate;
+		}
+	}
+
+	/**
+	 * Calculate a^-1 mod m for coprime a and m using the extended euclidean algorithm
+	 */
+	limb inverseModLimb(limb a, limb m) {
+		int64_t t = 0, newT = 1;
+		int64_t r = m, newR = a % m;
+		while (newR != 0) {
+			const int64_t quotient = r / newR;
+			t -= quotient * newT;
+			std::swap(t, newT);
+			r -= quotient * newR;
+			std::swap(r, newR);
+		}
+
+		if (r != 1) throw std::invalid_argument("The value is not invertible");
+		return (limb)(t < 0 ? t + m : t);
+	}
+}
+
+rsaPrivateKey rsaPrivateKey::generate(size_t bits) {
+	if (bits < 1024 || bits % 64 != 0) {
+		throw std::invalid_argument("The key size must be a multiple of 64 and at least 1024 bits");
+	}
+
+	bigint p, q;
+	do {
+		p = generatePrime(bits / 2);
+		q = generatePrime(bits / 2);
+	} while (p == q);
+
+	if (bigintCompare(p, q) < 0) std::swap(p, q);
+
+	const bigint n = bigintMultiply(p, q);
+	const bigint pMinusOne = subtractLimb(p, 1);
+	const bigint qMinusOne = subtractLimb(q, 1);
+	const bigint phi = bigintMultiply(pMinusOne, qMinusOne);
+
+	// d = e^-1 mod phi = (k * phi + 1) / e, with k = -phi^-1 mod e
+	const limb k = publicExponent - inverseModLimb(bigintModLimb(phi, publicExponent), publicExponent);
+	bigint d = phi;
+	d.push_back(0);
+	bigintMultiplyAddLimb(d, k, 1);
+	if (bigintDivideLimb(d, publicExponent) != 0) throw std::runtime_error("Could not calculate the private exponent");
+	d.resize(phi.size());
+
+	const bigint dp = bigintMod(d, pMinusOne);
+	const bigint dq = bigintMod(d, qMinusOne);
+
+	// q^-1 mod p = q^(p - 2) mod p, as p is prime
+	const bigint qInv = contextFor(p).modExpSecret(bigintMod(q, p), subtractLimb(p, 2));
+
+	return rsaPrivateKey(n, bigint{publicExponent}, d, p, q, dp, dq, qInv);
+}
+
+rsaPrivateKey rsaPrivateKey::fromDer(const byte* data, size_t len) {
+	const der::rsaPrivateKeyView key = der::parseRsaPrivateKey(der::span{data, len});
+
+	const size_t nLimbs = (key.modulus.size + sizeof(limb) - 1) / sizeof(limb);
+	const size_t pLimbs = (key.prime1.size + sizeof(limb) - 1) / sizeof(limb);
+	const size_t qLimbs = (key.prime2.size + sizeof(limb) - 1) / sizeof(limb);
+	if (nLimbs == 0 || pLimbs == 0 || qLimbs == 0) throw std::invalid_argument("Invalid private key");
+
+	return rsaPrivateKey(fromSpan(key.modulus, nLimbs), fromSpan(key.publicExponent, 1 + key.publicExponent.size / 4),
+		fromSpan(key.privateExponent, nLimbs), fromSpan(key.prime1, pLimbs), fromSpan(key.prime2, qLimbs),
+		fromSpan(key.exponent1, pLimbs), fromSpan(key.exponent2, qLimbs), fromSpan(key.coefficient, pLimbs));
+}
+
+rsaPrivateKey::rsaPrivateKey(const bigint& n, const bigint& e, const bigint& d, const bigint& p, const bigint& q,
+	const bigint& dp, const bigint& dq, const bigint& qInv)
+	: n(n), e(e), d(d), p(p), q(q), dp(dp), dq(dq), qInv(qInv), nContext(contextFor(n)), pContext(contextFor(p)),
+	  qContext(contextFor(q)), qInvMontgomery(p.size()), modulusLength((bigintBits(n) + 7) / 8) {
+	const bigint product = bigintMultiply(p, q);
+	for (size_t i = 0; i < product.size(); i++) {
+		if (product[i] != (i < n.size() ? n[i] : 0)) throw std::invalid_argument("Invalid private key: n != p * q");
+	}
+
+	if (bigintCompare(qInv, p) >= 0 || bigintCompare(dp, p) >= 0) {
+		throw std::invalid_argument("Invalid private key: invalid CRT values");
+	}
+	if (bigintCompare(dq, q) >= 0) throw std::invalid_argument("Invalid private key: invalid CRT values");
+
+	pContext.toMontgomery(qInv.data(), qInvMontgomery.data());
+}
+
+secure_vector<byte> rsaPrivateKey::toDer() const {
+	secure_vector<byte> content = der::encodeInteger({0});
+	for (const bigint* value : {&n, &e, &d, &p, &q, &dp, &dq, &qInv}) {
+		const secure_vector<byte> encoded = der::encodeInteger(bigintToBytes(*value));
+		content.insert(content.end(), encoded.begin(), encoded.end());
+	}
+
+	return der::encode(der::TAG_SEQUENCE, content);
+}
+
+secure_vector<byte> rsaPrivateKey::getPublicKey() const {
+	return der::encodeRsaPublicKey(bigintToBytes(n), bigintToBytes(e));
+}
+
+size_t rsaPrivateKey::size() const noexcept {
+	return modulusLength;
+}
+
+secure_buffer rsaPrivateKey::signPkcs1Sha256(const byte* message, size_t messageLength) const {
+	secure_buffer encoded(modulusLength);
+	encodePkcs1Sha256(sha256::hash(message, messageLength), encoded.data(), modulusLength);
+	const bigint m = bigintFromBytes(encoded.data(), encoded.size(), n.size());
+
+	// Chinese remainder theorem: m1 = m^dp mod p, m2 = m^dq mod q,
+	// h = qInv * (m1 - m2) mod p, s = m2 + h * q
+	const bigint m1 = pContext.modExpSecret(bigintMod(m, p), dp);
+	const bigint m2 = qContext.modExpSecret(bigintMod(m, q), dq);
+
+	bigint diff = m1;
+	if (bigintSubtract(diff, bigintMod(m2, p))) bigintAdd(diff, p);
+
+	bigint h(p.size());
+	pContext.multiply(qInvMontgomery.data(), diff.data(), h.data());
+
+	bigint s = bigintMultiply(h, q);
+	bigintAdd(s, m2);
+
+	secure_buffer signature(modulusLength);
+	bigintToBytes(s, signature.data(), modulusLength);
+
+	// Check the signature to never return a faulty one, which could leak the private key
+	const secure_vector<byte> exponent = bigintToBytes(e);
+	const bigint check = nContext.modExp(bigintFromBytes(signature.data(), signature.size(), n.size()),
+		exponent.data(), exponent.size());
+	if (check != m) throw std::runtime_error("Could not create a valid signature");
+
+	return signature;
+}
\ No newline at end of file
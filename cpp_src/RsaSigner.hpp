@@ -0,0 +1,76 @@
+#ifndef PASSPORT_RSASIGNER_HPP
+#define PASSPORT_RSASIGNER_HPP
+
+#include "BigInt.hpp"
+
+namespace nodeMsPassport::crypto {
+	/**
+	 * A RSA private key used by the software authenticator
+	 */
+	class rsaPrivateKey {
+	public:
+		// The public exponent of generated keys
+		static constexpr limb publicExponent = 65537;
+
+		/**
+		 * Generate a new key pair
+		 *
+		 * @param bits the size of the modulus in bits. Must be a multiple of 64 and at least 1024.
+		 * @return the generated key
+		 */
+		static rsaPrivateKey generate(size_t bits = 2048);
+
+		/**
+		 * Load a DER encoded PKCS#1 RSAPrivateKey.
+		 * Throws std::invalid_argument if the key could not be parsed.
+		 *
+		 * @param data the encoded key
+		 * @param len the length of the encoded key
+		 * @return the key
+		 */
+		static rsaPrivateKey fromDer(const byte* data, size_t len);
+
+		/**
+		 * Encode this key as a PKCS#1 RSAPrivateKey
+		 *
+		 * @return the DER encoded key
+		 */
+		NODEMSPASSPORT_NODISCARD secure_vector<byte> toDer() const;
+
+		/**
+		 * Get the public key as a SubjectPublicKeyInfo,
+		 * in the same format as the keys returned by windows hello
+		 *
+		 * @return the DER encoded public key
+		 */
+		NODEMSPASSPORT_NODISCARD secure_vector<byte> getPublicKey() const;
+
+		/**
+		 * Get the size of the modulus and of every signature in bytes
+		 *
+		 * @return the size of the key in bytes
+		 */
+		NODEMSPASSPORT_NODISCARD size_t size() const noexcept;
+
+		/**
+		 * Create a RSASSA-PKCS1-v1_5 signature using SHA-256
+		 *
+		 * @param message the message to sign
+		 * @param messageLength the length of the message
+		 * @return the signature
+		 */
+		NODEMSPASSPORT_NODISCARD secure_buffer signPkcs1Sha256(const byte* message, size_t messageLength) const;
+
+	private:
+		rsaPrivateKey(const bigint& n, const bigint& e, const bigint& d, const bigint& p, const bigint& q,
+			const bigint& dp, const bigint& dq, const bigint& qInv);
+
+		bigint n, e, d, p, q, dp, dq, qInv;
+		montgomeryContext nContext, pContext, qContext;
+		// qInv * R mod p
+		bigint qInvMontgomery;
+		size_t modulusLength;
+	};
+}
+
+#endif //PASSPORT_RSASIGNER_HPP
\ No newline at end of file
@@ -0,0 +1,225 @@
+#include <stdexcept>
+#include <algorithm>
+
+#include "RsaVerifier.hpp"
+#include "Der.hpp"
+
+using namespace nodeMsPassport;
+using namespace nodeMsPassport::crypto;
+
+namespace {
+	// The DER encoded DigestInfo prefixes, see RFC 8017 section 9.2
+	const byte sha256DigestInfo[] = {
+		0x30, 0x31, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x01, 0x05, 0x00, 0x04, 0x20
+	};
+
+	const byte sha384DigestInfo[] = {
+		0x30, 0x41, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x02, 0x05, 0x00, 0x04, 0x30
+	};
+
+	const byte sha512DigestInfo[] = {
+		0x30, 0x51, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x03, 0x05, 0x00, 0x04, 0x40
+	};
+
+	// All DigestInfo prefixes have the same length
+	constexpr size_t digestInfoLength = sizeof(sha256DigestInfo);
+
+	const byte* digestInfo(hashAlgorithm alg) noexcept {
+		switch (alg) {
+			case hashAlgorithm::sha384:
+				return sha384DigestInfo;
+			case hashAlgorithm::sha512:
+				return sha512DigestInfo;
+			default:
+				return sha256DigestInfo;
+		}
+	}
+
+	/**
+	 * XOR a MGF1 mask into data, see RFC 8017 appendix B.2.1
+	 *
+	 * @param alg the hash algorithm to use
+	 * @param seed the seed of the mask
+	 * @param seedLength the length of the seed, at most maxDigestSize
+	 * @param data the data to mask
+	 * @param len the length of the data
+	 */
+	void applyMgf1(hashAlgorithm alg, const byte* seed, size_t seedLength, byte* data, size_t len) {
+		byte input[maxDigestSize + 4];
+		std::copy_n(seed, seedLength, input);
+
+		byte mask[maxDigestSize];
+		for (uint32_t counter = 0; len > 0; counter++) {
+			for (int i = 0; i < 4; i++) {
+				input[seedLength + i] = (byte)(counter >> (24u - 8u * i));
+			}
+
+			const size_t maskLength = std::min(len, digest(alg, input, seedLength + 4, mask));
+			for (size_t i = 0; i < maskLength; i++) {
+				data[i] ^= mask[i];
+			}
+
+			data += maskLength;
+			len -= maskLength;
+		}
+	}
+}
+
+void crypto::encodePkcs1Sha256(const sha256::digest& hash, byte* out, size_t len) {
+	encodePkcs1(hashAlgorithm::sha256, hash.data(), out, len);
+}
+
+void crypto::encodePkcs1(hashAlgorithm alg, const byte* hash, byte* out, size_t len) {
+	// EM = 0x00 || 0x01 || PS || 0x00 || DigestInfo || H
+	const size_t hashLength = digestSize(alg);
+	const size_t tLength = digestInfoLength + hashLength;
+	if (len < tLength + 11) throw std::invalid_argument("The key is too small");
+
+	const size_t psLength = len - tLength - 3;
+	out[0] = 0x00;
+	out[1] = 0x01;
+	std::fill_n(out + 2, psLength, 0xff);
+	out[psLength + 2] = 0x00;
+	std::copy_n(digestInfo(alg), digestInfoLength, out + psLength + 3);
+	std::copy_n(hash, hashLength, out + len - hashLength);
+}
+
+rsaPublicKey rsaPublicKey::fromSubjectPublicKeyInfo(const byte* data, size_t len) {
+	const der::rsaPublicKeyView key = der::parseRsaPublicKey(der::parseSubjectPublicKeyInfo(der::span{data, len}));
+	return rsaPublicKey(key.modulus.data, key.modulus.size, key.exponent.data, key.exponent.size);
+}
+
+rsaPublicKey::rsaPublicKey(const byte* modulus, size_t modulusLength, const byte* exponent, size_t exponentLength)
+	: operation(rsaPublicOperation::create(modulus, modulusLength, exponent, exponentLength)), modulusLength(0) {
+	const size_t bits = operation->bits();
+	if (bits < 512) throw std::invalid_argument("Invalid public key: the modulus is too small");
+	this->modulusLength = (bits + 7) / 8;
+
+	while (exponentLength > 0 && *exponent == 0) {
+		exponent++;
+		exponentLength--;
+	}
+
+	// The exponent must be odd and at least three. Larger exponents than 64 bits
+	// are rejected like OpenSSL does, they only make verifying needlessly expensive.
+	if (exponentLength == 0 || (exponent[exponentLength - 1] & 1u) == 0 ||
+		(exponentLength == 1 && exponent[0] < 3)) {
+		throw std::invalid_argument("Invalid public key: invalid public exponent");
+	} else if (exponentLength > rsaPublicOperation::maxExponentBits / 8) {
+		throw std::invalid_argument("Invalid public key: the public exponent is too large");
+	}
+}
+
+size_t rsaPublicKey::size() const noexcept {
+	return modulusLength;
+}
+
+bool rsaPublicKey::verifyPkcs1Sha256(const byte* message, size_t messageLength, const byte* signature,
+	size_t signatureLength) const {
+	return verifyPkcs1(message, messageLength, signature, signatureLength, hashAlgorithm::sha256);
+}
+
+bool rsaPublicKey::verifyPkcs1(const byte* message, size_t messageLength, const byte* signature,
+	size_t signatureLength, hashAlgorithm alg) const {
+	byte hash[maxDigestSize];
+	digest(alg, message, messageLength, hash);
+	return checkPkcs1(hash, signature, signatureLength, alg);
+}
+
+bool rsaPublicKey::verifyPss(const byte* message, size_t messageLength, const byte* signature,
+	size_t signatureLength, hashAlgorithm alg, size_t saltLength) const {
+	byte hash[maxDigestSize];
+	digest(alg, message, messageLength, hash);
+	return checkPss(hash, signature, signatureLength, alg, saltLength);
+}
+
+bool rsaPublicKey::verifyDigest(const byte* hash, size_t hashLength, const byte* signature,
+	size_t signatureLength, const passport::signatureOptions& options) const {
+	if (hashLength != digestSize(options.hash)) {
+		throw std::invalid_argument("The length of the hash does not match the hash algorithm");
+	}
+
+	if (options.padding == passport::signaturePadding::pss) {
+		return checkPss(hash, signature, signatureLength, options.hash, options.saltLength);
+	}
+
+	return checkPkcs1(hash, signature, signatureLength, options.hash);
+}
+
+bool rsaPublicKey::checkPkcs1(const byte* hash, const byte* signature, size_t signatureLength,
+	hashAlgorithm alg) const {
+	const size_t k = modulusLength;
+	if (signatureLength != k) return false;
+
+	// Keys of up to 4096 bits fit into the buffers without a heap allocation
+	secure_buffer encoded(k), expected(k);
+	if (!operation->apply(signature, encoded.data())) return false;
+
+	try {
+		encodePkcs1(alg, hash, expected.data(), k);
+	} catch (const std::invalid_argument&) {
+		// A SHA-512 DigestInfo does not fit into a 512 bit key
+		return false;
+	}
+
+	byte diff = 0;
+	for (size_t i = 0; i < k; i++) {
+		diff |= encoded[i] ^ expected[i];
+	}
+
+	return diff == 0;
+}
+
+bool rsaPublicKey::checkPss(const byte* hash, const byte* signature, size_t signatureLength,
+	hashAlgorithm alg, size_t saltLength) const {
+	const size_t k = modulusLength;
+	if (signatureLength != k) return false;
+
+	secure_buffer em(k);
+	if (!operation->apply(signature, em.data())) return false;
+
+	// EM has emBits = modBits - 1 bits. If modBits - 1 is a multiple
+	// of eight, the result of the public operation has a leading zero byte.
+	const size_t emBits = operation->bits() - 1;
+	const size_t emLength = (emBits + 7) / 8;
+	if (emLength < k && em[0] != 0) return false;
+	const byte* encoded = em.data() + (k - emLength);
+
+	const size_t hashLength = digestSize(alg);
+	const size_t minSalt = saltLength == passport::signatureOptions::saltLengthAuto ? 0 : saltLength;
+	if (minSalt > emLength || emLength < hashLength + minSalt + 2) return false;
+	if (encoded[emLength - 1] != 0xbc) return false;
+
+	// EM = maskedDB || H || 0xbc, the unused top bits of maskedDB must be zero
+	const size_t dbLength = emLength - hashLength - 1;
+	const byte topMask = (byte)(0xffu >> (8 * emLength - emBits));
+	if ((encoded[0] & ~topMask) != 0) return false;
+
+	secure_buffer db(encoded, dbLength);
+	const byte* h = encoded + dbLength;
+	applyMgf1(alg, h, hashLength, db.data(), dbLength);
+	db[0] &= topMask;
+
+	// DB = PS || 0x01 || salt, with PS being all zeros
+	size_t separator = 0;
+	while (separator < dbLength && db[separator] == 0) separator++;
+	if (separator == dbLength || db[separator] != 0x01) return false;
+
+	const size_t actualSalt = dbLength - separator - 1;
+	if (saltLength != passport::signatureOptions::saltLengthAuto && actualSalt != saltLength) return false;
+
+	// M' = 0x00 * 8 || mHash || salt
+	secure_buffer prefixed(8 + hashLength + actualSalt);
+	std::copy_n(hash, hashLength, prefixed.data() + 8);
+	std::copy(db.begin() + separator + 1, db.end(), prefixed.data() + 8 + hashLength);
+
+	byte expected[maxDigestSize];
+	digest(alg, prefixed.data(), prefixed.size(), expected);
+
+	byte diff = 0;
+	for (size_t i = 0; i < hashLength; i++) {
+		diff |= h[i] ^ expected[i];
+	}
+
+	return diff == 0;
+}
\ No newline at end of file
@@ -0,0 +1,130 @@
+#ifndef PASSPORT_RSAVERIFIER_HPP
+#define PASSPORT_RSAVERIFIER_HPP
+
+#include <memory>
+
+#include "PublicKey.hpp"
+#include "RsaPublicOperation.hpp"
+#include "Digest.hpp"
+
+namespace nodeMsPassport::crypto {
+	/**
+	 * Encode a SHA-256 hash for a RSASSA-PKCS1-v1_5 signature
+	 * (EMSA-PKCS1-v1_5, see RFC 8017 section 9.2).
+	 * Throws std::invalid_argument if the key is too small.
+	 *
+	 * @param hash the hash of the message
+	 * @param out the output buffer
+	 * @param len the size of the modulus in bytes
+	 */
+	void encodePkcs1Sha256(const sha256::digest& hash, byte* out, size_t len);
+
+	/**
+	 * Encode a hash for a RSASSA-PKCS1-v1_5 signature
+	 * (EMSA-PKCS1-v1_5, see RFC 8017 section 9.2).
+	 * Throws std::invalid_argument if the key is too small.
+	 *
+	 * @param alg the hash algorithm used
+	 * @param hash the hash of the message, digestSize(alg) bytes
+	 * @param out the output buffer
+	 * @param len the size of the modulus in bytes
+	 */
+	void encodePkcs1(hashAlgorithm alg, const byte* hash, byte* out, size_t len);
+
+	/**
+	 * An RSA public key used to verify signatures
+	 */
+	class rsaPublicKey : public publicKey {
+	public:
+		/**
+		 * Parse a DER encoded X.509 SubjectPublicKeyInfo holding an RSA key,
+		 * as returned by KeyCredential::RetrievePublicKey.
+		 * Throws std::invalid_argument if the key could not be parsed.
+		 *
+		 * @param data the encoded key
+		 * @param len the length of the encoded key
+		 * @return the parsed key
+		 */
+		static rsaPublicKey fromSubjectPublicKeyInfo(const byte* data, size_t len);
+
+		/**
+		 * Create a public key from its components.
+		 * Throws std::invalid_argument if the values are not a valid RSA key,
+		 * this includes public exponents larger than 64 bits.
+		 *
+		 * @param modulus the big endian modulus
+		 * @param modulusLength the length of the modulus in bytes
+		 * @param exponent the big endian public exponent
+		 * @param exponentLength the length of the exponent in bytes
+		 */
+		rsaPublicKey(const byte* modulus, size_t modulusLength, const byte* exponent, size_t exponentLength);
+
+		/**
+		 * Get the size of the modulus and of every signature in bytes
+		 *
+		 * @return the size of the key in bytes
+		 */
+		NODEMSPASSPORT_NODISCARD size_t size() const noexcept;
+
+		/**
+		 * Verify a RSASSA-PKCS1-v1_5 signature using SHA-256
+		 *
+		 * @param message the signed message
+		 * @param messageLength the length of the message
+		 * @param signature the signature
+		 * @param signatureLength the length of the signature
+		 * @return true if the signature is valid
+		 */
+		NODEMSPASSPORT_NODISCARD bool verifyPkcs1Sha256(const byte* message, size_t messageLength,
+			const byte* signature, size_t signatureLength) const;
+
+		/**
+		 * Verify a RSASSA-PKCS1-v1_5 signature
+		 *
+		 * @param message the signed message
+		 * @param messageLength the length of the message
+		 * @param signature the signature
+		 * @param signatureLength the length of the signature
+		 * @param alg the hash algorithm used
+		 * @return true if the signature is valid
+		 */
+		NODEMSPASSPORT_NODISCARD bool verifyPkcs1(const byte* message, size_t messageLength,
+			const byte* signature, size_t signatureLength, hashAlgorithm alg) const;
+
+		/**
+		 * Verify a RSASSA-PSS signature using MGF1 with the message hash
+		 * (EMSA-PSS, see RFC 8017 section 9.1)
+		 *
+		 * @param message the signed message
+		 * @param messageLength the length of the message
+		 * @param signature the signature
+		 * @param signatureLength the length of the signature
+		 * @param alg the hash algorithm used
+		 * @param saltLength the length of the salt, saltLengthAuto to accept any length
+		 * @return true if the signature is valid
+		 */
+		NODEMSPASSPORT_NODISCARD bool verifyPss(const byte* message, size_t messageLength,
+			const byte* signature, size_t signatureLength, hashAlgorithm alg, size_t saltLength) const;
+
+		NODEMSPASSPORT_NODISCARD bool verifyDigest(const byte* hash, size_t hashLength, const byte* signature,
+			size_t signatureLength, const passport::signatureOptions& options) const override;
+
+	private:
+		/**
+		 * Check a RSASSA-PKCS1-v1_5 signature of a hash
+		 */
+		NODEMSPASSPORT_NODISCARD bool checkPkcs1(const byte* hash, const byte* signature, size_t signatureLength,
+			hashAlgorithm alg) const;
+
+		/**
+		 * Check a RSASSA-PSS signature of a hash
+		 */
+		NODEMSPASSPORT_NODISCARD bool checkPss(const byte* hash, const byte* signature, size_t signatureLength,
+			hashAlgorithm alg, size_t saltLength) const;
+
+		std::unique_ptr<const rsaPublicOperation> operation;
+		size_t modulusLength;
+	};
+}
+
+#endif //PASSPORT_RSAVERIFIER_HPP
\ No newline at end of file
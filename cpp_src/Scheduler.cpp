@@ -0,0 +1,62 @@
+#include "Scheduler.hpp"
+
+using namespace nodeMsPassport::util;
+
+scheduler::scheduler(threadPool& computePool) : computePool(computePool), interactiveRunning(false), stopping(false) {
+	interactiveThread = std::thread(&scheduler::interactiveLoop, this);
+}
+
+void scheduler::submit(lane l, std::function<void()> task) {
+	if (l == lane::compute) {
+		computePool.submit(std::move(task));
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(mtx);
+	interactiveTasks.push_back(std::move(task));
+	lock.unlock();
+	cv.notify_one();
+}
+
+size_t scheduler::pendingInteractive() {
+	std::unique_lock<std::mutex> lock(mtx);
+	return interactiveTasks.size() + (interactiveRunning ? 1 : 0);
+}
+
+scheduler& scheduler::shared() {
+	static scheduler s(threadPool::shared());
+	return s;
+}
+
+scheduler::~scheduler() {
+	std::unique_lock<std::mutex> lock(mtx);
+	stopping = true;
+	lock.unlock();
+	cv.notify_all();
+
+	if (interactiveThread.joinable()) interactiveThread.join();
+}
+
+void scheduler::interactiveLoop() {
+	std::unique_lock<std::mutex> lock(mtx);
+	while (true) {
+		cv.wait(lock, [this] {
+			return stopping || !interactiveTasks.empty();
+		});
+
+		// Queued tasks are still run when the scheduler is stopping
+		if (interactiveTasks.empty()) return;
+
+		std::function<void()> task = std::move(interactiveTasks.front());
+		interactiveTasks.pop_front();
+		interactiveRunning = true;
+		lock.unlock();
+
+		try {
+			task();
+		} catch (...) {}
+
+		lock.lock();
+		interactiveRunning = false;
+	}
+}
\ No newline at end of file
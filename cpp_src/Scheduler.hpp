@@ -0,0 +1,79 @@
+#ifndef PASSPORT_SCHEDULER_HPP
+#define PASSPORT_SCHEDULER_HPP
+
+#include <mutex>
+#include <deque>
+#include <thread>
+#include <functional>
+#include <condition_variable>
+
+#include "ThreadPool.hpp"
+
+namespace nodeMsPassport::util {
+	/**
+	 * The lanes tasks can be scheduled on
+	 */
+	enum class lane {
+		// Tasks waiting for the user, e.g. for a windows hello prompt.
+		// These are run one at a time on a dedicated thread.
+		interactive,
+		// Computational work, run on the thread pool
+		compute
+	};
+
+	/**
+	 * Schedules tasks on a serialized interactive lane and a compute lane,
+	 * so pending user prompts never block the threads of the compute lane
+	 */
+	class scheduler {
+	public:
+		/**
+		 * Create a scheduler
+		 *
+		 * @param computePool the thread pool running the compute lane
+		 */
+		explicit scheduler(threadPool& computePool);
+
+		scheduler(const scheduler&) = delete;
+
+		scheduler& operator=(const scheduler&) = delete;
+
+		/**
+		 * Run a task on a lane. The task must not throw,
+		 * exceptions thrown by it are caught and discarded.
+		 *
+		 * @param l the lane to run the task on
+		 * @param task the task to run
+		 */
+		void submit(lane l, std::function<void()> task);
+
+		/**
+		 * Get the number of interactive tasks waiting or running
+		 *
+		 * @return the number of unfinished interactive tasks
+		 */
+		NODEMSPASSPORT_NODISCARD size_t pendingInteractive();
+
+		/**
+		 * Get the process wide scheduler, using the shared thread pool
+		 *
+		 * @return the shared scheduler
+		 */
+		static scheduler& shared();
+
+		~scheduler();
+
+	private:
+		void interactiveLoop();
+
+		threadPool& computePool;
+		std::mutex mtx;
+		std::condition_variable cv;
+		std::deque<std::function<void()>> interactiveTasks;
+		bool interactiveRunning;
+		bool stopping;
+		std::thread interactiveThread;
+	};
+}
+
+#endif //PASSPORT_SCHEDULER_HPP
\ No newline at end of file
@@ -0,0 +1,291 @@
+#include <mutex>
+#include <algorithm>
+
+#include "NodeMsPassport.hpp"
+
+#ifdef _WIN32
+#   define NOMINMAX
+#   include <windows.h>
+#else
+#   include <unistd.h>
+#   include <sys/mman.h>
+#endif
+
+using namespace nodeMsPassport;
+
+namespace {
+	// Size classes from 16 bytes to 16 KiB
+	constexpr size_t minBlockSize = 16;
+	constexpr size_t numClasses = 11;
+	constexpr size_t maxBlockSize = minBlockSize << (numClasses - 1);
+	constexpr size_t slabSize = 64 * 1024;
+	// The number of free blocks a thread keeps per size class
+	constexpr size_t maxCached = 64;
+
+	/**
+	 * A free block, the link to the next free block is stored in the block itself
+	 */
+	struct freeBlock {
+		freeBlock* next;
+	};
+
+	size_t pageSize() {
+		static const size_t size = [] {
+#ifdef _WIN32
+			SYSTEM_INFO info;
+			GetSystemInfo(&info);
+			return (size_t)info.dwPageSize;
+#else
+			return (size_t)sysconf(_SC_PAGESIZE);
+#endif
+		}();
+
+		return size;
+	}
+
+	size_t roundToPages(size_t size) {
+		return (size + pageSize() - 1) / pageSize() * pageSize();
+	}
+
+	/**
+	 * Map pages surrounded by inaccessible guard pages. The pages are locked into
+	 * RAM if the limits allow it and are excluded from core dumps.
+	 *
+	 * @param size the number of bytes to map, must be a multiple of the page size
+	 * @return the usable pages
+	 */
+	byte* mapPages(size_t size) {
+		const size_t page = pageSize();
+#ifdef _WIN32
+		// The reserved but uncommitted pages around the block act as guard pages
+		auto* base = (byte*)VirtualAlloc(nullptr, size + 2 * page, MEM_RESERVE, PAGE_NOACCESS);
+		if (base == nullptr) throw std::bad_alloc();
+
+		byte* res = base + page;
+		if (VirtualAlloc(res, size, MEM_COMMIT, PAGE_READWRITE) == nullptr) {
+			VirtualFree(base, 0, MEM_RELEASE);
+			throw std::bad_alloc();
+		}
+
+		VirtualLock(res, size);
+#else
+		void* base = mmap(nullptr, size + 2 * page, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (base == MAP_FAILED) throw std::bad_alloc();
+
+		byte* res = (byte*)base + page;
+		if (mprotect(res, size, PROT_READ | PROT_WRITE) != 0) {
+			munmap(base, size + 2 * page);
+			throw std::bad_alloc();
+		}
+
+		// Locking fails if RLIMIT_MEMLOCK is exceeded, the memory is still usable
+		mlock(res, size);
+#   ifdef MADV_DONTDUMP
+		madvise(res, size, MADV_DONTDUMP);
+#   endif
+#endif
+		return res;
+	}
+
+	void unmapPages(byte* ptr, size_t size) {
+		const size_t page = pageSize();
+#ifdef _WIN32
+		VirtualUnlock(ptr, size);
+		VirtualFree(ptr - page, 0, MEM_RELEASE);
+#else
+		munlock(ptr, size);
+		munmap(ptr - page, size + 2 * page);
+#endif
+	}
+
+	size_t sizeClass(size_t size) {
+		size_t c = 0;
+		while ((minBlockSize << c) < size) c++;
+		return c;
+	}
+
+	/**
+	 * The free blocks shared by all threads
+	 */
+	struct globalHeap {
+		std::mutex mtx[numClasses];
+		freeBlock* free[numClasses] = {};
+	};
+
+	// Never destroyed, as secure memory may still be freed during static destruction
+	globalHeap& heap() {
+		static auto* h = new globalHeap();
+		return *h;
+	}
+
+	/**
+	 * Take up to count blocks of a size class from the global heap,
+	 * creating a new slab if it has no free blocks
+	 *
+	 * @param c the size class
+	 * @param count the maximum number of blocks to take, set to the number of blocks taken
+	 * @return the taken blocks as a list
+	 */
+	freeBlock* takeBlocks(size_t c, size_t& count) {
+		globalHeap& h = heap();
+		std::unique_lock<std::mutex> lock(h.mtx[c]);
+
+		if (h.free[c] == nullptr) {
+			const size_t blockSize = minBlockSize << c;
+			byte* slab = mapPages(slabSize);
+			for (size_t offset = slabSize; offset >= blockSize; offset -= blockSize) {
+				auto* block = (freeBlock*)(slab + offset - blockSize);
+				block->next = h.free[c];
+				h.free[c] = block;
+			}
+		}
+
+		freeBlock* head = h.free[c];
+		freeBlock* tail = head;
+		size_t taken = 1;
+		while (taken < count && tail->next != nullptr) {
+			tail = tail->next;
+			taken++;
+		}
+
+		h.free[c] = tail->next;
+		tail->next = nullptr;
+		count = taken;
+
+		return head;
+	}
+
+	/**
+	 * Return a list of blocks to the global heap
+	 */
+	void returnBlocks(size_t c, freeBlock* head, freeBlock* tail) {
+		globalHeap& h = heap();
+		std::unique_lock<std::mutex> lock(h.mtx[c]);
+		tail->next = h.free[c];
+		h.free[c] = head;
+	}
+
+	/**
+	 * The free blocks of a thread. Trivially destructible,
+	 * so it can still be used after the cacheGuard was destroyed.
+	 */
+	struct threadCache {
+		freeBlock* free[numClasses];
+		size_t count[numClasses];
+		// 0: not initialized, 1: in use, 2: the thread is exiting
+		int state;
+	};
+
+	thread_local threadCache cache = {};
+	// The number of secureAllocate calls made by this thread
+	thread_local size_t allocationCount = 0;
+
+	/**
+	 * Returns the cached blocks to the global heap when the thread exits
+	 */
+	struct cacheGuard {
+		cacheGuard() noexcept {
+			cache.state = 1;
+		}
+
+		~cacheGuard() {
+			for (size_t c = 0; c < numClasses; c++) {
+				freeBlock* head = cache.free[c];
+				if (head == nullptr) continue;
+
+				freeBlock* tail = head;
+				while (tail->next != nullptr) tail = tail->next;
+				returnBlocks(c, head, tail);
+
+				cache.free[c] = nullptr;
+				cache.count[c] = 0;
+			}
+
+			cache.state = 2;
+		}
+	};
+
+	thread_local cacheGuard guard;
+
+	/**
+	 * Get the cache of the current thread
+	 *
+	 * @return the cache or nullptr if the thread is exiting
+	 */
+	threadCache* localCache() {
+		if (cache.state == 0) {
+			// Initializes the guard, which marks the cache as in use
+			(void)&guard;
+		}
+
+		return cache.state == 1 ? &cache : nullptr;
+	}
+}
+
+void* util::secureAllocate(size_t size) {
+	allocationCount++;
+	if (size > maxBlockSize) {
+		return mapPages(roundToPages(size));
+	}
+
+	const size_t c = sizeClass(size);
+	freeBlock* block;
+
+	threadCache* tc = localCache();
+	if (tc == nullptr) {
+		size_t count = 1;
+		block = takeBlocks(c, count);
+	} else {
+		if (tc->free[c] == nullptr) {
+			size_t count = maxCached / 2;
+			tc->free[c] = takeBlocks(c, count);
+			tc->count[c] = count;
+		}
+
+		block = tc->free[c];
+		tc->free[c] = block->next;
+		tc->count[c]--;
+	}
+
+	// Free blocks are zeroed, except for the link to the next block
+	block->next = nullptr;
+	return block;
+}
+
+void util::secureDeallocate(void* ptr, size_t size) noexcept {
+	if (ptr == nullptr) return;
+	util::secureWipe(ptr, size);
+
+	if (size > maxBlockSize) {
+		unmapPages((byte*)ptr, roundToPages(size));
+		return;
+	}
+
+	const size_t c = sizeClass(size);
+	auto* block = (freeBlock*)ptr;
+
+	threadCache* tc = localCache();
+	if (tc == nullptr) {
+		returnBlocks(c, block, block);
+		return;
+	}
+
+	block->next = tc->free[c];
+	tc->free[c] = block;
+
+	// Hand half of the blocks to other threads if this thread frees more than it allocates
+	if (++tc->count[c] > maxCached) {
+		freeBlock* tail = block;
+		for (size_t i = 1; i < maxCached / 2; i++) {
+			tail = tail->next;
+		}
+
+		tc->free[c] = tail->next;
+		tc->count[c] -= maxCached / 2;
+		returnBlocks(c, block, tail);
+	}
+}
+
+size_t util::secureAllocationCount() noexcept {
+	return allocationCount;
+}
\ No newline at end of file
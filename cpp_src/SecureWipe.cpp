@@ -0,0 +1,36 @@
+// Required for memset_s, must be defined before any standard header is included
+#define __STDC_WANT_LIB_EXT1__ 1
+
+#include <cstring>
+
+#include "NodeMsPassport.hpp"
+
+#ifdef _WIN32
+#   define NOMINMAX
+#   include <windows.h>
+#endif
+
+using namespace nodeMsPassport;
+
+void util::secureWipe(void* ptr, size_t size) noexcept {
+	if (ptr == nullptr || size == 0) return;
+
+	// Use the platform primitives which are guaranteed to not be optimized away.
+	// All of them write whole words or vectors instead of single bytes.
+#if defined(_WIN32)
+	SecureZeroMemory(ptr, size);
+#elif (defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 25))) || \
+	defined(__OpenBSD__) || defined(__FreeBSD__)
+	explicit_bzero(ptr, size);
+#elif defined(__STDC_LIB_EXT1__) || defined(__APPLE__)
+	memset_s(ptr, size, 0, size);
+#elif defined(__GNUC__) || defined(__clang__)
+	memset(ptr, 0, size);
+	// The memory may be read by the asm statement, so the memset must be kept
+	__asm__ __volatile__("" : : "r"(ptr) : "memory");
+#else
+	// The compiler can't know which function the volatile pointer points to
+	static void* (* const volatile memsetPtr)(void*, int, size_t) = memset;
+	memsetPtr(ptr, 0, size);
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,526 @@
+#include <atomic>
+#include <algorithm>
+
+#include "Sha256.hpp"
+#include "CpuFeatures.hpp"
+
+#ifdef NODEMSPASSPORT_X86
+#   include <immintrin.h>
+#endif
+
+using namespace nodeMsPassport;
+using namespace nodeMsPassport::crypto;
+
+namespace {
+	const uint32_t roundConstants[64] = {
+		0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+		0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+		0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+		0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+		0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+		0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+		0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+		0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+	};
+
+	const uint32_t initialState[8] = {
+		0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+	};
+
+	inline uint32_t rotr(uint32_t x, unsigned n) {
+		return (x >> n) | (x << (32u - n));
+	}
+
+	inline uint32_t loadBigEndian(const byte* p) {
+		return ((uint32_t)p[0] << 24u) | ((uint32_t)p[1] << 16u) | ((uint32_t)p[2] << 8u) | (uint32_t)p[3];
+	}
+
+	inline void storeBigEndian(byte* p, uint32_t v) {
+		p[0] = (byte)(v >> 24u);
+		p[1] = (byte)(v >> 16u);
+		p[2] = (byte)(v >> 8u);
+		p[3] = (byte)v;
+	}
+
+	// The number of messages hashed at once by the multi-buffer kernel
+	constexpr size_t lanes = 8;
+
+	/**
+	 * Pad the last partial block of a message
+	 *
+	 * @param tail the bytes of the message after the last full block
+	 * @param tailLength the number of bytes after the last full block
+	 * @param length the length of the message
+	 * @param out the output buffer, must hold two blocks
+	 * @return the number of padded blocks, one or two
+	 */
+	size_t padTail(const byte* tail, size_t tailLength, uint64_t length, byte* out) {
+		const size_t blocks = tailLength + 9 > sha256::blockSize ? 2 : 1;
+		if (tailLength > 0) memcpy(out, tail, tailLength);
+		out[tailLength] = 0x80;
+		memset(out + tailLength + 1, 0, blocks * sha256::blockSize - tailLength - 1);
+
+		const uint64_t bitLength = length * 8;
+		for (int i = 0; i < 8; i++) {
+			out[blocks * sha256::blockSize - 1 - i] = (byte)(bitLength >> (8u * i));
+		}
+
+		return blocks;
+	}
+
+	/**
+	 * Process full 64 byte blocks
+	 *
+	 * @param state the hash state
+	 * @param data the blocks to process
+	 * @param blocks the number of blocks
+	 */
+	void compressScalar(uint32_t state[8], const byte* data, size_t blocks) {
+		uint32_t w[64];
+		while (blocks--) {
+			for (int i = 0; i < 16; i++) {
+				w[i] = loadBigEndian(data + i * 4);
+			}
+
+			for (int i = 16; i < 64; i++) {
+				const uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3u);
+				const uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10u);
+				w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+			}
+
+			uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+			uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+			for (int i = 0; i < 64; i++) {
+				const uint32_t s1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
+				const uint32_t ch = (e & f) ^ (~e & g);
+				const uint32_t t1 = h + s1 + ch + roundConstants[i] + w[i];
+				const uint32_t s0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
+				const uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+				const uint32_t t2 = s0 + maj;
+
+				h = g;
+				g = f;
+				f = e;
+				e = d + t1;
+				d = c;
+				c = b;
+				b = a;
+				a = t1 + t2;
+			}
+
+			state[0] += a;
+			state[1] += b;
+			state[2] += c;
+			state[3] += d;
+			state[4] += e;
+			state[5] += f;
+			state[6] += g;
+			state[7] += h;
+
+			data += sha256::blockSize;
+		}
+	}
+
+#ifdef NODEMSPASSPORT_X86
+	/**
+	 * Process full 64 byte blocks using the SHA extensions.
+	 * The sha256rnds2 instruction keeps the state as ABEF and CDGH.
+	 */
+	NODEMSPASSPORT_TARGET("sha,sse4.1,ssse3")
+	void compressShaNi(uint32_t state[8], const byte* data, size_t blocks) {
+		const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+		__m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0xB1); // CDAB
+		__m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4)), 0x1B); // EFGH
+		__m128i state0 = _mm_alignr_epi8(tmp, state1, 8); // ABEF
+		state1 = _mm_blend_epi16(state1, tmp, 0xF0); // CDGH
+
+		while (blocks--) {
+			const __m128i abefSave = state0;
+			const __m128i cdghSave = state1;
+
+			__m128i msg[4];
+			for (int i = 0; i < 4; i++) {
+				msg[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 16)), byteSwap);
+			}
+
+			// Four rounds per iteration, the message words of
+			// group i + 4 replace the ones of group i
+			for (int i = 0; i < 16; i++) {
+				__m128i w = _mm_add_epi32(msg[i % 4],
+					_mm_loadu_si128(reinterpret_cast<const __m128i*>(roundConstants + i * 4)));
+				state1 = _mm_sha256rnds2_epu32(state1, state0, w);
+				w = _mm_shuffle_epi32(w, 0x0E);
+				state0 = _mm_sha256rnds2_epu32(state0, state1, w);
+
+				if (i < 12) {
+					const __m128i& last = msg[(i + 3) % 4];
+					__m128i next = _mm_sha256msg1_epu32(msg[i % 4], msg[(i + 1) % 4]);
+					next = _mm_add_epi32(next, _mm_alignr_epi8(last, msg[(i + 2) % 4], 4));
+					msg[i % 4] = _mm_sha256msg2_epu32(next, last);
+				}
+			}
+
+			state0 = _mm_add_epi32(state0, abefSave);
+			state1 = _mm_add_epi32(state1, cdghSave);
+			data += sha256::blockSize;
+		}
+
+		tmp = _mm_shuffle_epi32(state0, 0x1B); // FEBA
+		state1 = _mm_shuffle_epi32(state1, 0xB1); // DCHG
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_blend_epi16(tmp, state1, 0xF0)); // DCBA
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), _mm_alignr_epi8(state1, tmp, 8)); // HGFE
+	}
+
+	NODEMSPASSPORT_TARGET("avx2")
+	inline __m256i rotrLanes(__m256i x, int n) {
+		return _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n));
+	}
+
+	/**
+	 * Transpose a matrix of 8x8 32 bit words
+	 */
+	NODEMSPASSPORT_TARGET("avx2")
+	inline void transpose8(__m256i r[8]) {
+		const __m256i t0 = _mm256_unpacklo_epi32(r[0], r[1]), t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+		const __m256i t2 = _mm256_unpacklo_epi32(r[2], r[3]), t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+		const __m256i t4 = _mm256_unpacklo_epi32(r[4], r[5]), t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+		const __m256i t6 = _mm256_unpacklo_epi32(r[6], r[7]), t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+
+		const __m256i u0 = _mm256_unpacklo_epi64(t0, t2), u1 = _mm256_unpackhi_epi64(t0, t2);
+		const __m256i u2 = _mm256_unpacklo_epi64(t1, t3), u3 = _mm256_unpackhi_epi64(t1, t3);
+		const __m256i u4 = _mm256_unpacklo_epi64(t4, t6), u5 = _mm256_unpackhi_epi64(t4, t6);
+		const __m256i u6 = _mm256_unpacklo_epi64(t5, t7), u7 = _mm256_unpackhi_epi64(t5, t7);
+
+		r[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+		r[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+		r[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+		r[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+		r[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+		r[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+		r[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+		r[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+	}
+
+	/**
+	 * Hash up to eight messages at once, every message in its own 32 bit lane.
+	 * Lanes of messages which are shorter than the longest one keep their
+	 * state once their last block was processed.
+	 *
+	 * @param data the messages
+	 * @param lengths the lengths of the messages
+	 * @param count the number of messages, at most eight
+	 * @param out the hashes of the messages
+	 */
+	NODEMSPASSPORT_TARGET("avx2")
+	void hashLanesAvx2(const byte* const* data, const size_t* lengths, size_t count, sha256::digest* out) {
+		static const byte unused[sha256::blockSize] = {};
+		const __m256i byteSwap = _mm256_set_epi64x(0x0c0d0e0f08090a0bLL, 0x0405060700010203LL,
+			0x0c0d0e0f08090a0bLL, 0x0405060700010203LL);
+
+		// The padded last one or two blocks of every message
+		byte tails[lanes][2 * sha256::blockSize];
+		size_t fullBlocks[lanes];
+		alignas(32) int32_t blocks[lanes];
+		size_t maxBlocks = 0;
+		for (size_t i = 0; i < lanes; i++) {
+			if (i < count) {
+				fullBlocks[i] = lengths[i] / sha256::blockSize;
+				blocks[i] = (int32_t)(fullBlocks[i] + padTail(data[i] + fullBlocks[i] * sha256::blockSize,
+					lengths[i] % sha256::blockSize, lengths[i], tails[i]));
+				maxBlocks = std::max(maxBlocks, (size_t)blocks[i]);
+			} else {
+				fullBlocks[i] = 0;
+				blocks[i] = 0;
+			}
+		}
+
+		__m256i state[8];
+		for (int i = 0; i < 8; i++) state[i] = _mm256_set1_epi32((int)initialState[i]);
+		const __m256i blockCounts = _mm256_load_si256(reinterpret_cast<const __m256i*>(blocks));
+
+		for (size_t block = 0; block < maxBlocks; block++) {
+			const byte* ptr[lanes];
+			for (size_t i = 0; i < lanes; i++) {
+				if ((int32_t)block >= blocks[i]) {
+					ptr[i] = unused;
+				} else if (block < fullBlocks[i]) {
+					ptr[i] = data[i] + block * sha256::blockSize;
+				} else {
+					ptr[i] = tails[i] + (block - fullBlocks[i]) * sha256::blockSize;
+				}
+			}
+
+			// Load the blocks as rows and transpose them, so every
+			// register holds the same message word of all lanes
+			__m256i w[16];
+			for (size_t half = 0; half < 2; half++) {
+				for (size_t i = 0; i < lanes; i++) {
+					w[half * 8 + i] = _mm256_shuffle_epi8(_mm256_loadu_si256(
+						reinterpret_cast<const __m256i*>(ptr[i] + half * 32)), byteSwap);
+				}
+				transpose8(w + half * 8);
+			}
+
+			__m256i a = state[0], b = state[1], c = state[2], d = state[3];
+			__m256i e = state[4], f = state[5], g = state[6], h = state[7];
+
+			for (int i = 0; i < 64; i++) {
+				if (i >= 16) {
+					const __m256i w15 = w[(i - 15) & 15], w2 = w[(i - 2) & 15];
+					const __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(rotrLanes(w15, 7), rotrLanes(w15, 18)),
+						_mm256_srli_epi32(w15, 3));
+					const __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(rotrLanes(w2, 17), rotrLanes(w2, 19)),
+						_mm256_srli_epi32(w2, 10));
+					w[i & 15] = _mm256_add_epi32(_mm256_add_epi32(w[i & 15], s0),
+						_mm256_add_epi32(w[(i - 7) & 15], s1));
+				}
+
+				const __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(rotrLanes(e, 6), rotrLanes(e, 11)), rotrLanes(e, 25));
+				const __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+				const __m256i t1 = _mm256_add_epi32(_mm256_add_epi32(h, s1), _mm256_add_epi32(ch,
+					_mm256_add_epi32(_mm256_set1_epi32((int)roundConstants[i]), w[i & 15])));
+				const __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(rotrLanes(a, 2), rotrLanes(a, 13)), rotrLanes(a, 22));
+				const __m256i maj = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+				const __m256i t2 = _mm256_add_epi32(s0, maj);
+
+				h = g;
+				g = f;
+				f = e;
+				e = _mm256_add_epi32(d, t1);
+				d = c;
+				c = b;
+				b = a;
+				a = _mm256_add_epi32(t1, t2);
+			}
+
+			// Only update the lanes which still had a block to process
+			const __m256i active = _mm256_cmpgt_epi32(blockCounts, _mm256_set1_epi32((int)block));
+			const __m256i res[8] = {a, b, c, d, e, f, g, h};
+			for (int i = 0; i < 8; i++) {
+				state[i] = _mm256_add_epi32(state[i], _mm256_and_si256(res[i], active));
+			}
+		}
+
+		transpose8(state);
+		for (size_t i = 0; i < count; i++) {
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out[i].data()), _mm256_shuffle_epi8(state[i], byteSwap));
+		}
+
+		util::secureWipe(tails, sizeof(tails));
+	}
+#endif
+
+	using compressFunc = void (*)(uint32_t*, const byte*, size_t);
+
+	struct kernel {
+		sha256::implementation impl;
+		compressFunc compress;
+	};
+
+	const kernel scalarKernel{sha256::implementation::scalar, compressScalar};
+#ifdef NODEMSPASSPORT_X86
+	const kernel shaNiKernel{sha256::implementation::shaNi, compressShaNi};
+#endif
+
+	const kernel* selectKernel(sha256::implementation impl) {
+		switch (impl) {
+#ifdef NODEMSPASSPORT_X86
+			case sha256::implementation::shaNi: {
+				const cpu::features& features = cpu::getFeatures();
+				return features.sha && features.sse41 && features.ssse3 ? &shaNiKernel : nullptr;
+			}
+#endif
+			case sha256::implementation::scalar:
+				return &scalarKernel;
+			default:
+				return nullptr;
+		}
+	}
+
+	const kernel* bestKernel() {
+		const kernel* k = selectKernel(sha256::implementation::shaNi);
+		return k ? k : &scalarKernel;
+	}
+
+	std::atomic<const kernel*> active(bestKernel());
+
+	void compress(uint32_t state[8], const byte* data, size_t blocks) {
+		if (blocks > 0) active.load(std::memory_order_relaxed)->compress(state, data, blocks);
+	}
+
+	using hashLanesFunc = void (*)(const byte* const*, const size_t*, size_t, sha256::digest*);
+
+	struct batchKernel {
+		sha256::batchImplementation impl;
+		// Hashes up to eight messages, nullptr to hash every message on its own
+		hashLanesFunc hashLanes;
+	};
+
+	const batchKernel sequentialBatchKernel{sha256::batchImplementation::sequential, nullptr};
+#ifdef NODEMSPASSPORT_X86
+	const batchKernel avx2BatchKernel{sha256::batchImplementation::avx2, hashLanesAvx2};
+#endif
+
+	const batchKernel* selectBatchKernel(sha256::batchImplementation impl) {
+		switch (impl) {
+#ifdef NODEMSPASSPORT_X86
+			case sha256::batchImplementation::avx2:
+				return cpu::getFeatures().avx2 ? &avx2BatchKernel : nullptr;
+#endif
+			case sha256::batchImplementation::sequential:
+				return &sequentialBatchKernel;
+			default:
+				return nullptr;
+		}
+	}
+
+	const batchKernel* bestBatchKernel() {
+		const batchKernel* k = selectBatchKernel(sha256::batchImplementation::avx2);
+		return k ? k : &sequentialBatchKernel;
+	}
+
+	std::atomic<const batchKernel*> activeBatch(bestBatchKernel());
+}
+
+sha256::implementation sha256::getImplementation() noexcept {
+	return active.load(std::memory_order_relaxed)->impl;
+}
+
+bool sha256::setImplementation(implementation impl) noexcept {
+	const kernel* k = selectKernel(impl);
+	if (!k) return false;
+
+	active.store(k, std::memory_order_relaxed);
+	return true;
+}
+
+const char* sha256::implementationName(implementation impl) noexcept {
+	switch (impl) {
+		case implementation::shaNi:
+			return "sha-ni";
+		default:
+			return "scalar";
+	}
+}
+
+sha256::batchImplementation sha256::getBatchImplementation() noexcept {
+	return activeBatch.load(std::memory_order_relaxed)->impl;
+}
+
+bool sha256::setBatchImplementation(batchImplementation impl) noexcept {
+	const batchKernel* k = selectBatchKernel(impl);
+	if (!k) return false;
+
+	activeBatch.store(k, std::memory_order_relaxed);
+	return true;
+}
+
+const char* sha256::batchImplementationName(batchImplementation impl) noexcept {
+	switch (impl) {
+		case batchImplementation::avx2:
+			return "avx2";
+		default:
+			return "sequential";
+	}
+}
+
+sha256::sha256() noexcept : state(), buffer(), bufferLength(0), length(0) {
+	reset();
+}
+
+void sha256::reset() noexcept {
+	for (int i = 0; i < 8; i++) state[i] = initialState[i];
+	bufferLength = 0;
+	length = 0;
+}
+
+void sha256::update(const byte* data, size_t len) noexcept {
+	if (len == 0) return;
+	length += len;
+
+	if (bufferLength > 0) {
+		const size_t toCopy = std::min(len, blockSize - bufferLength);
+		memcpy(buffer + bufferLength, data, toCopy);
+		bufferLength += toCopy;
+		data += toCopy;
+		len -= toCopy;
+
+		if (bufferLength < blockSize) return;
+		compress(state, buffer, 1);
+		bufferLength = 0;
+	}
+
+	const size_t blocks = len / blockSize;
+	compress(state, data, blocks);
+	data += blocks * blockSize;
+	len -= blocks * blockSize;
+
+	memcpy(buffer, data, len);
+	bufferLength = len;
+}
+
+sha256::digest sha256::finish() noexcept {
+	const uint64_t bitLength = length * 8;
+
+	buffer[bufferLength++] = 0x80;
+	if (bufferLength > blockSize - 8) {
+		memset(buffer + bufferLength, 0, blockSize - bufferLength);
+		compress(state, buffer, 1);
+		bufferLength = 0;
+	}
+
+	memset(buffer + bufferLength, 0, blockSize - 8 - bufferLength);
+	for (int i = 0; i < 8; i++) {
+		buffer[blockSize - 1 - i] = (byte)(bitLength >> (8u * i));
+	}
+	compress(state, buffer, 1);
+
+	digest out;
+	for (int i = 0; i < 8; i++) {
+		storeBigEndian(out.data() + i * 4, state[i]);
+	}
+
+	return out;
+}
+
+sha256::digest sha256::hash(const byte* data, size_t len) noexcept {
+	sha256 hasher;
+	hasher.update(data, len);
+	return hasher.finish();
+}
+
+sha256::digest sha256::hash(const secure_vector<byte>& data) noexcept {
+	return hash(data.data(), data.size());
+}
+
+void sha256::hashBatch(const byte* const* data, const size_t* lengths, size_t count, digest* out) noexcept {
+	const batchKernel* k = activeBatch.load(std::memory_order_relaxed);
+	if (!k->hashLanes) {
+		for (size_t i = 0; i < count; i++) {
+			out[i] = hash(data[i], lengths[i]);
+		}
+
+		return;
+	}
+
+	// The SHA extensions are faster than eight lanes for messages longer than
+	// one block, so only groups of short messages are hashed in parallel then
+	const bool shaNi = getImplementation() == implementation::shaNi;
+	for (size_t i = 0; i < count; i += lanes) {
+		const size_t n = std::min(lanes, count - i);
+		const size_t longest = *std::max_element(lengths + i, lengths + i + n);
+		if (!shaNi || longest + 9 <= blockSize) {
+			k->hashLanes(data + i, lengths + i, n, out + i);
+		} else {
+			for (size_t j = i; j < i + n; j++) {
+				out[j] = hash(data[j], lengths[j]);
+			}
+		}
+	}
+}
+
+sha256::~sha256() noexcept {
+	util::secureWipe(buffer, sizeof(buffer));
+}
\ No newline at end of file
@@ -0,0 +1,151 @@
+#ifndef PASSPORT_SHA256_HPP
+#define PASSPORT_SHA256_HPP
+
+#include <array>
+#include <cstdint>
+
+#include "NodeMsPassport.hpp"
+
+namespace nodeMsPassport::crypto {
+	/**
+	 * A SHA-256 hash function. Uses the SHA extensions
+	 * if supported by the cpu, a scalar implementation otherwise.
+	 */
+	class sha256 {
+	public:
+		static constexpr size_t digestSize = 32;
+		static constexpr size_t blockSize = 64;
+
+		using digest = std::array<byte, digestSize>;
+
+		/**
+		 * The available block function implementations
+		 */
+		enum class implementation {
+			scalar,
+			shaNi
+		};
+
+		/**
+		 * Get the implementation currently in use
+		 *
+		 * @return the active implementation
+		 */
+		static implementation getImplementation() noexcept;
+
+		/**
+		 * Set the implementation to use. Mainly used by benchmarks.
+		 *
+		 * @param impl the implementation to use
+		 * @return false if the implementation is not supported by this cpu
+		 */
+		static bool setImplementation(implementation impl) noexcept;
+
+		/**
+		 * Get the name of an implementation
+		 *
+		 * @param impl the implementation
+		 * @return the name of the implementation
+		 */
+		static const char* implementationName(implementation impl) noexcept;
+
+		/**
+		 * The available implementations of hashBatch
+		 */
+		enum class batchImplementation {
+			// Hash the messages one after another using the active block function
+			sequential,
+			// Hash eight messages at once, one in every lane of the AVX2 registers
+			avx2
+		};
+
+		/**
+		 * Get the implementation of hashBatch currently in use
+		 *
+		 * @return the active batch implementation
+		 */
+		static batchImplementation getBatchImplementation() noexcept;
+
+		/**
+		 * Set the implementation of hashBatch to use. Mainly used by benchmarks.
+		 *
+		 * @param impl the implementation to use
+		 * @return false if the implementation is not supported by this cpu
+		 */
+		static bool setBatchImplementation(batchImplementation impl) noexcept;
+
+		/**
+		 * Get the name of a batch implementation
+		 *
+		 * @param impl the implementation
+		 * @return the name of the implementation
+		 */
+		static const char* batchImplementationName(batchImplementation impl) noexcept;
+
+		/**
+		 * Create a new sha256 instance
+		 */
+		sha256() noexcept;
+
+		/**
+		 * Reset the state to hash a new message
+		 */
+		void reset() noexcept;
+
+		/**
+		 * Add data to the hash
+		 *
+		 * @param data the data to add
+		 * @param len the number of bytes to add
+		 */
+		void update(const byte* data, size_t len) noexcept;
+
+		/**
+		 * Finish the hash. The instance must be reset
+		 * before it can be used again.
+		 *
+		 * @return the hash of all data passed to update
+		 */
+		digest finish() noexcept;
+
+		/**
+		 * Hash data in one call
+		 *
+		 * @param data the data to hash
+		 * @param len the number of bytes to hash
+		 * @return the hash of the data
+		 */
+		static digest hash(const byte* data, size_t len) noexcept;
+
+		/**
+		 * Hash data in one call
+		 *
+		 * @param data the data to hash
+		 * @return the hash of the data
+		 */
+		static digest hash(const secure_vector<byte>& data) noexcept;
+
+		/**
+		 * Hash multiple independent messages. The messages are hashed in groups
+		 * of eight, which take as long as the longest message of the group.
+		 * If the SHA extensions are used, only groups of messages fitting
+		 * into a single block are hashed in parallel.
+		 *
+		 * @param data the messages
+		 * @param lengths the lengths of the messages
+		 * @param count the number of messages
+		 * @param out the hashes of the messages, must hold count digests
+		 */
+		static void hashBatch(const byte* const* data, const size_t* lengths, size_t count, digest* out) noexcept;
+
+		~sha256() noexcept;
+
+	private:
+		uint32_t state[8];
+		byte buffer[blockSize];
+		size_t bufferLength;
+		uint64_t length;
+	};
+}
+
+#endif //PASSPORT_SHA256_HPP
\ No newline at end of file
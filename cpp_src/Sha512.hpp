@@ -0,0 +1,126 @@
+#ifndef PASSPORT_SHA512_HPP
+#define PASSPORT_SHA512_HPP
+
+#include <array>
+#include <cstdint>
+
+#include "NodeMsPassport.hpp"
+
+namespace nodeMsPassport::crypto {
+	/**
+	 * A SHA-512 hash function, see FIPS 180-4.
+	 * Only used to verify signatures, so there is only a scalar implementation.
+	 */
+	class sha512 {
+	public:
+		static constexpr size_t digestSize = 64;
+		static constexpr size_t blockSize = 128;
+
+		using digest = std::array<byte, digestSize>;
+
+		/**
+		 * Create a new sha512 instance
+		 */
+		sha512() noexcept;
+
+		/**
+		 * Reset the state to hash a new message
+		 */
+		void reset() noexcept;
+
+		/**
+		 * Add data to the hash
+		 *
+		 * @param data the data to add
+		 * @param len the number of bytes to add
+		 */
+		void update(const byte* data, size_t len) noexcept;
+
+		/**
+		 * Finish the hash. The instance must be reset
+		 * before it can be used again.
+		 *
+		 * @return the hash of all data passed to update
+		 */
+		digest finish() noexcept;
+
+		/**
+		 * Hash data in one call
+		 *
+		 * @param data the data to hash
+		 * @param len the number of bytes to hash
+		 * @return the hash of the data
+		 */
+		static digest hash(const byte* data, size_t len) noexcept;
+
+		~sha512() noexcept;
+
+	private:
+		friend class sha384;
+
+		/**
+		 * Create an instance using another initial state
+		 *
+		 * @param initialState the initial hash value
+		 */
+		explicit sha512(const uint64_t* initialState) noexcept;
+
+		const uint64_t* initialState;
+		uint64_t state[8];
+		byte buffer[blockSize];
+		size_t bufferLength;
+		uint64_t length;
+	};
+
+	/**
+	 * A SHA-384 hash function, the truncated SHA-512
+	 * with a different initial state
+	 */
+	class sha384 {
+	public:
+		static constexpr size_t digestSize = 48;
+		static constexpr size_t blockSize = sha512::blockSize;
+
+		using digest = std::array<byte, digestSize>;
+
+		/**
+		 * Create a new sha384 instance
+		 */
+		sha384() noexcept;
+
+		/**
+		 * Reset the state to hash a new message
+		 */
+		void reset() noexcept;
+
+		/**
+		 * Add data to the hash
+		 *
+		 * @param data the data to add
+		 * @param len the number of bytes to add
+		 */
+		void update(const byte* data, size_t len) noexcept;
+
+		/**
+		 * Finish the hash. The instance must be reset
+		 * before it can be used again.
+		 *
+		 * @return the hash of all data passed to update
+		 */
+		digest finish() noexcept;
+
+		/**
+		 * Hash data in one call
+		 *
+		 * @param data the data to hash
+		 * @param len the number of bytes to hash
+		 * @return the hash of the data
+		 */
+		static digest hash(const byte* data, size_t len) noexcept;
+
+	private:
+		sha512 inner;
+	};
+}
+
+#endif //PASSPORT_SHA512_HPP
\ No newline at end of file
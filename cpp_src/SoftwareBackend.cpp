@@ -0,0 +1,290 @@
+#include <vector>
+#include <fstream>
+#include <cstdlib>
+#include <algorithm>
+#include <stdexcept>
+#include <filesystem>
+
+#include "SoftwareBackend.hpp"
+#include "RsaSigner.hpp"
+#include "HexCodec.hpp"
+#include "Sha256.hpp"
+#include "Random.hpp"
+
+#ifdef _WIN32
+#   define NOMINMAX
+#   include <windows.h>
+#   include <sddl.h>
+#   include <io.h>
+#   include <fcntl.h>
+#   pragma comment(lib, "advapi32.lib")
+#else
+#   include <cerrno>
+#   include <fcntl.h>
+#   include <unistd.h>
+#   include <sys/stat.h>
+#endif
+
+using namespace nodeMsPassport;
+using namespace nodeMsPassport::passport;
+
+namespace fs = std::filesystem;
+
+namespace {
+	// The size of the generated keys, the same as the keys created by windows hello
+	constexpr size_t keySize = 2048;
+
+#ifdef _WIN32
+	/**
+	 * Create a security descriptor with a protected DACL only granting access to the current user
+	 *
+	 * @return the descriptor, must be freed using LocalFree, or nullptr on error
+	 */
+	PSECURITY_DESCRIPTOR currentUserDescriptor() noexcept {
+		HANDLE token = nullptr;
+		if (!OpenProcessToken(GetCurrentProcess(), TOKEN_QUERY, &token)) return nullptr;
+
+		DWORD size = 0;
+		GetTokenInformation(token, TokenUser, nullptr, 0, &size);
+		std::vector<BYTE> buffer(size);
+		LPWSTR sid = nullptr;
+		const bool ok = size > 0 && GetTokenInformation(token, TokenUser, buffer.data(), size, &size) &&
+			ConvertSidToStringSidW(reinterpret_cast<const TOKEN_USER*>(buffer.data())->User.Sid, &sid);
+		CloseHandle(token);
+		if (!ok) return nullptr;
+
+		const std::wstring sddl = std::wstring(L"D:P(A;;FA;;;") + sid + L")";
+		LocalFree(sid);
+
+		PSECURITY_DESCRIPTOR descriptor = nullptr;
+		if (!ConvertStringSecurityDescriptorToSecurityDescriptorW(sddl.c_str(), SDDL_REVISION_1, &descriptor,
+			nullptr)) {
+			return nullptr;
+		}
+
+		return descriptor;
+	}
+#endif
+
+	/**
+	 * Create a new file only readable by the current user.
+	 * Fails if the file already exists. On windows, the file gets a protected
+	 * DACL only granting access to the current user instead of inheriting the ACL of the directory.
+	 *
+	 * @param path the file to create
+	 * @return the file descriptor or -1 if the file could not be created
+	 */
+	int createPrivateFile(const fs::path& path) noexcept {
+#ifdef _WIN32
+		const PSECURITY_DESCRIPTOR descriptor = currentUserDescriptor();
+		if (descriptor == nullptr) return -1;
+
+		SECURITY_ATTRIBUTES attributes{sizeof(SECURITY_ATTRIBUTES), descriptor, FALSE};
+		const HANDLE handle = CreateFileW(path.c_str(), GENERIC_WRITE, 0, &attributes, CREATE_NEW,
+			FILE_ATTRIBUTE_NORMAL, nullptr);
+		LocalFree(descriptor);
+		if (handle == INVALID_HANDLE_VALUE) return -1;
+
+		// The descriptor owns the handle from now on
+		const int fd = _open_osfhandle((intptr_t)handle, _O_WRONLY | _O_BINARY);
+		if (fd < 0) CloseHandle(handle);
+
+		return fd;
+#else
+		int fd;
+		do {
+			fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+		} while (fd < 0 && errno == EINTR);
+
+		return fd;
+#endif
+	}
+
+	/**
+	 * Write a buffer to a file descriptor and close it
+	 *
+	 * @return false if the data could not be written completely
+	 */
+	bool writeAndClose(int fd, const byte* data, size_t len) noexcept {
+		bool ok = true;
+		while (ok && len > 0) {
+#ifdef _WIN32
+			const int written = _write(fd, data, (unsigned int)std::min<size_t>(len, 0x7fffffff));
+#else
+			const ssize_t written = ::write(fd, data, len);
+			if (written < 0 && errno == EINTR) continue;
+#endif
+			if (written <= 0) {
+				ok = false;
+			} else {
+				data += written;
+				len -= (size_t)written;
+			}
+		}
+
+#ifdef _WIN32
+		return _close(fd) == 0 && ok;
+#else
+		return ::close(fd) == 0 && ok;
+#endif
+	}
+
+	/**
+	 * Write a file only readable by the current user. The data is written
+	 * to a temporary file first, so the key file is never left half written.
+	 * The temporary file is created with its final permissions under a
+	 * unique name, so no other user can open it and concurrent writers
+	 * never share it.
+	 */
+	void writePrivateFile(const fs::path& path, const secure_vector<byte>& data) {
+		byte suffix[8];
+		crypto::randomBytes(suffix, sizeof(suffix));
+		std::string name(sizeof(suffix) * 2, '\0');
+		hex::encode(suffix, sizeof(suffix), &name[0]);
+
+		const fs::path tmp = path.string() + "." + name + ".tmp";
+		const int fd = createPrivateFile(tmp);
+		if (fd < 0) throw passportException("Could not create the key file", 1);
+
+		std::error_code ec;
+		if (!writeAndClose(fd, data.data(), data.size())) {
+			fs::remove(tmp, ec);
+			throw passportException("Could not write the key file", 1);
+		}
+
+		fs::rename(tmp, path, ec);
+		if (ec) {
+			fs::remove(tmp, ec);
+			throw passportException("Could not write the key file", 1);
+		}
+	}
+}
+
+softwareBackend::softwareBackend(std::string directory) : directory(std::move(directory)) {
+	if (this->directory.empty()) throw std::invalid_argument("The key directory must not be empty");
+}
+
+std::string softwareBackend::defaultDirectory() {
+#ifdef _WIN32
+	const char* base = std::getenv("LOCALAPPDATA");
+	if (base != nullptr && base[0] != '\0') return (fs::path(base) / "node-ms-passport" / "keys").string();
+#else
+	const char* dataHome = std::getenv("XDG_DATA_HOME");
+	if (dataHome != nullptr && dataHome[0] != '\0') {
+		return (fs::path(dataHome) / "node-ms-passport" / "keys").string();
+	}
+
+	const char* home = std::getenv("HOME");
+	if (home != nullptr && home[0] != '\0') {
+		return (fs::path(home) / ".local" / "share" / "node-ms-passport" / "keys").string();
+	}
+#endif
+
+	// A shared directory like /tmp could be prepared by another user
+	throw passportException("No key directory is available, set HOME or pass a directory", 1);
+}
+
+const std::string& softwareBackend::getDirectory() const noexcept {
+	return directory;
+}
+
+const char* softwareBackend::name() const noexcept {
+	return "software";
+}
+
+bool softwareBackend::interactive() const noexcept {
+	return false;
+}
+
+bool softwareBackend::available() {
+	return true;
+}
+
+void softwareBackend::create(const std::string& accountId) {
+	// Generate the key without holding the lock, this takes a while
+	const secure_vector<byte> key = crypto::rsaPrivateKey::generate(keySize).toDer();
+
+	std::unique_lock<std::mutex> lock(mtx);
+	std::error_code ec;
+	if (fs::create_directories(directory, ec)) {
+		fs::permissions(directory, fs::perms::owner_all, fs::perm_options::replace, ec);
+	}
+	if (ec) throw passportException("Could not create the key directory", 1);
+	checkDirectory();
+
+	// Existing keys are replaced, like windows hello does
+	writePrivateFile(keyFile(accountId), key);
+}
+
+bool softwareBackend::open(const std::string& accountId) {
+	std::unique_lock<std::mutex> lock(mtx);
+	std::error_code ec;
+	return fs::is_regular_file(keyFile(accountId), ec);
+}
+
+secure_buffer softwareBackend::sign(const std::string& accountId, const secure_buffer& challenge) {
+	const secure_vector<byte> key = readKey(accountId);
+	try {
+		return crypto::rsaPrivateKey::fromDer(key.data(), key.size()).signPkcs1Sha256(challenge.data(),
+			challenge.size());
+	} catch (const std::exception&) {
+		throw passportException("The sign operation failed", 6);
+	}
+}
+
+secure_vector<byte> softwareBackend::getPublicKey(const std::string& accountId) {
+	const secure_vector<byte> key = readKey(accountId);
+	try {
+		return crypto::rsaPrivateKey::fromDer(key.data(), key.size()).getPublicKey();
+	} catch (const std::exception&) {
+		throw passportException("An unknown error occurred", 1);
+	}
+}
+
+void softwareBackend::remove(const std::string& accountId) {
+	std::unique_lock<std::mutex> lock(mtx);
+	std::error_code ec;
+	if (!fs::remove(keyFile(accountId), ec)) {
+		if (ec) throw passportException("The access was denied", 8);
+		throw passportException("The key is already deleted", 7);
+	}
+}
+
+std::string softwareBackend::keyFile(const std::string& accountId) const {
+	// The account id may contain any character, use its hash as the file name
+	const crypto::sha256::digest hash = crypto::sha256::hash(reinterpret_cast<const byte*>(accountId.data()),
+		accountId.size());
+	std::string name(hash.size() * 2, '\0');
+	hex::encode(hash.data(), hash.size(), &name[0]);
+
+	return (fs::path(directory) / (name + ".key")).string();
+}
+
+void softwareBackend::checkDirectory() const {
+#ifndef _WIN32
+	// Anyone able to write to the directory could replace the keys
+	struct stat info{};
+	if (lstat(directory.c_str(), &info) != 0 || !S_ISDIR(info.st_mode) || info.st_uid != geteuid() ||
+		(info.st_mode & (S_IRWXG | S_IRWXO)) != 0) {
+		throw passportException("The key directory must be a directory only accessible by the current user", 1);
+	}
+#endif
+}
+
+secure_vector<byte> softwareBackend::readKey(const std::string& accountId) {
+	std::unique_lock<std::mutex> lock(mtx);
+	std::error_code ec;
+	if (fs::exists(directory, ec)) checkDirectory();
+	std::ifstream in(keyFile(accountId), std::ios::binary | std::ios::ate);
+	if (!in) throw passportException("The specified account was not found", 5);
+
+	const std::streamsize size = in.tellg();
+	in.seekg(0);
+
+	secure_vector<byte> data((size_t)std::max<std::streamsize>(size, 0));
+	if (!in.read(reinterpret_cast<char*>(data.data()), size)) {
+		throw passportException("An unknown error occurred", 1);
+	}
+
+	return data;
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+#ifndef PASSPORT_SOFTWAREBACKEND_HPP
+#define PASSPORT_SOFTWAREBACKEND_HPP
+
+#include <mutex>
+
+#include "Backend.hpp"
+
+namespace nodeMsPassport::passport {
+	/**
+	 * A software authenticator. Keeps a RSA-2048 key for every account
+	 * in a directory and signs without any user interaction.
+	 * The keys are only protected by the file system permissions,
+	 * so this should only be used for testing, not as a replacement for windows hello.
+	 */
+	class softwareBackend : public backend {
+	public:
+		/**
+		 * Create a software authenticator
+		 *
+		 * @param directory the directory to store the keys in. Created if it does not exist,
+		 *                  must be owned by the current user and not accessible by anyone else.
+		 */
+		explicit softwareBackend(std::string directory);
+
+		/**
+		 * Get the default key directory. This is
+		 * %LOCALAPPDATA%/node-ms-passport/keys on windows,
+		 * $XDG_DATA_HOME/node-ms-passport/keys or ~/.local/share/node-ms-passport/keys otherwise.
+		 * Throws a passportException if none of these variables is set.
+		 *
+		 * @return the default key directory
+		 */
+		static std::string defaultDirectory();
+
+		/**
+		 * Get the key directory
+		 *
+		 * @return the directory the keys are stored in
+		 */
+		NODEMSPASSPORT_NODISCARD const std::string& getDirectory() const noexcept;
+
+		NODEMSPASSPORT_NODISCARD const char* name() const noexcept override;
+
+		NODEMSPASSPORT_NODISCARD bool interactive() const noexcept override;
+
+		bool available() override;
+
+		void create(const std::string& accountId) override;
+
+		bool open(const std::string& accountId) override;
+
+		secure_buffer sign(const std::string& accountId, const secure_buffer& challenge) override;
+
+		secure_vector<byte> getPublicKey(const std::string& accountId) override;
+
+		void remove(const std::string& accountId) override;
+
+	private:
+		/**
+		 * Get the file the key of an account is stored in
+		 */
+		NODEMSPASSPORT_NODISCARD std::string keyFile(const std::string& accountId) const;
+
+		/**
+		 * Check that the key directory is owned by the current user and not accessible
+		 * by anyone else. Throws a passportException otherwise. Windows relies on the
+		 * ACL of the directory, which is private for the default directory.
+		 */
+		void checkDirectory() const;
+
+		/**
+		 * Read the private key of an account
+		 */
+		secure_vector<byte> readKey(const std::string& accountId);
+
+		std::string directory;
+		std::mutex mtx;
+	};
+}
+
+#endif //PASSPORT_SOFTWAREBACKEND_HPP
\ No newline at end of file
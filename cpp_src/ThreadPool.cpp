@@ -0,0 +1,200 @@
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+
+#include "ThreadPool.hpp"
+
+using namespace nodeMsPassport::util;
+
+namespace {
+	// The pool and queue index of the current thread, if it is a pool thread
+	thread_local const threadPool* currentPool = nullptr;
+	thread_local size_t currentIndex = 0;
+
+	std::mutex sharedMtx;
+	size_t sharedThreads = 0;
+	bool sharedStarted = false;
+}
+
+/**
+ * A range of work items processed by the pool.
+ * Shared with the helper tasks, which may only start
+ * after all items have been processed.
+ */
+struct threadPool::job {
+	const std::function<void(size_t)>* fn = nullptr;
+	size_t count = 0;
+	std::atomic<size_t> next{0};
+
+	std::mutex mtx;
+	std::condition_variable cv;
+	size_t done = 0;
+	std::exception_ptr error;
+};
+
+threadPool::threadPool(size_t threads) : pending(0), stopping(false) {
+	if (threads == 0) {
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	// Create all queues before starting any thread, as threads steal from every queue
+	workers.reserve(threads);
+	for (size_t i = 0; i < threads; i++) {
+		workers.push_back(std::make_unique<worker>());
+	}
+
+	for (size_t i = 0; i < threads; i++) {
+		workers[i]->thread = std::thread(&threadPool::workerLoop, this, i);
+	}
+}
+
+void threadPool::submit(std::function<void()> task) {
+	if (currentPool == this) {
+		worker& w = *workers[currentIndex];
+		std::unique_lock<std::mutex> lock(w.mtx);
+		w.tasks.push_back(std::move(task));
+		pending.fetch_add(1);
+	} else {
+		std::unique_lock<std::mutex> lock(injectedMtx);
+		injected.push_back(std::move(task));
+		pending.fetch_add(1);
+	}
+
+	// Take the lock so a thread about to sleep can't miss the new task
+	std::unique_lock<std::mutex> sleepLock(sleepMtx);
+	sleepLock.unlock();
+	cv.notify_one();
+}
+
+void threadPool::parallelFor(size_t count, const std::function<void(size_t)>& fn) {
+	if (count == 0) return;
+
+	auto j = std::make_shared<job>();
+	j->fn = &fn;
+	j->count = count;
+
+	// The calling thread does one share of the work
+	const size_t helpers = std::min(count - 1, workers.size());
+	for (size_t i = 0; i < helpers; i++) {
+		submit([j] {
+			runJob(*j);
+		});
+	}
+
+	runJob(*j);
+
+	// Every item has been claimed, wait for the items still being processed.
+	// Helpers starting after this won't find any work and won't use fn.
+	std::unique_lock<std::mutex> lock(j->mtx);
+	j->cv.wait(lock, [&j] {
+		return j->done == j->count;
+	});
+
+	if (j->error) std::rethrow_exception(j->error);
+}
+
+size_t threadPool::size() const noexcept {
+	return workers.size();
+}
+
+void threadPool::setSharedSize(size_t threads) {
+	std::unique_lock<std::mutex> lock(sharedMtx);
+	if (sharedStarted) throw std::logic_error("The shared thread pool is already running");
+	sharedThreads = threads;
+}
+
+threadPool& threadPool::shared() {
+	static threadPool pool([] {
+		std::unique_lock<std::mutex> lock(sharedMtx);
+		sharedStarted = true;
+		return sharedThreads;
+	}());
+
+	return pool;
+}
+
+threadPool::~threadPool() {
+	std::unique_lock<std::mutex> lock(sleepMtx);
+	stopping = true;
+	lock.unlock();
+	cv.notify_all();
+
+	for (const std::unique_ptr<worker>& w : workers) {
+		if (w->thread.joinable()) w->thread.join();
+	}
+}
+
+void threadPool::workerLoop(size_t index) {
+	currentPool = this;
+	currentIndex = index;
+
+	while (true) {
+		if (tryRunTask(index)) continue;
+
+		// Queued tasks are still run when the pool is stopping
+		std::unique_lock<std::mutex> lock(sleepMtx);
+		cv.wait(lock, [this] {
+			return stopping || pending.load() > 0;
+		});
+		if (stopping && pending.load() == 0) return;
+	}
+}
+
+bool threadPool::tryRunTask(size_t index) {
+	std::function<void()> task;
+
+	// Take the newest own task, its data is most likely still in the cache
+	{
+		worker& w = *workers[index];
+		std::unique_lock<std::mutex> lock(w.mtx);
+		if (!w.tasks.empty()) {
+			task = std::move(w.tasks.back());
+			w.tasks.pop_back();
+			pending.fetch_sub(1);
+		}
+	}
+
+	// Then the oldest task submitted from outside the pool
+	if (!task) {
+		std::unique_lock<std::mutex> lock(injectedMtx);
+		if (!injected.empty()) {
+			task = std::move(injected.front());
+			injected.pop_front();
+			pending.fetch_sub(1);
+		}
+	}
+
+	// Steal the oldest task of another thread
+	for (size_t i = 1; !task && i < workers.size(); i++) {
+		worker& w = *workers[(index + i) % workers.size()];
+		std::unique_lock<std::mutex> lock(w.mtx);
+		if (!w.tasks.empty()) {
+			task = std::move(w.tasks.front());
+			w.tasks.pop_front();
+			pending.fetch_sub(1);
+		}
+	}
+
+	if (!task) return false;
+
+	try {
+		task();
+	} catch (...) {}
+
+	return true;
+}
+
+void threadPool::runJob(job& j) {
+	for (size_t i = j.next.fetch_add(1); i < j.count; i = j.next.fetch_add(1)) {
+		std::exception_ptr error;
+		try {
+			(*j.fn)(i);
+		} catch (...) {
+			error = std::current_exception();
+		}
+
+		std::unique_lock<std::mutex> lock(j.mtx);
+		if (error && !j.error) j.error = error;
+		if (++j.done == j.count) j.cv.notify_all();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#ifndef PASSPORT_THREADPOOL_HPP
+#define PASSPORT_THREADPOOL_HPP
+
+#include <mutex>
+#include <deque>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+
+#include "NodeMsPassport.hpp"
+
+namespace nodeMsPassport::util {
+	/**
+	 * A fixed size work-stealing thread pool.
+	 * Tasks submitted from outside the pool are run in FIFO order.
+	 * Every thread owns a task queue, tasks submitted by a pool thread
+	 * are pushed to its own queue and taken in LIFO order. Idle threads
+	 * steal the oldest tasks from the queues of the other threads.
+	 */
+	class threadPool {
+	public:
+		/**
+		 * Create a thread pool
+		 *
+		 * @param threads the number of threads to start. Zero uses one thread per core.
+		 */
+		explicit threadPool(size_t threads = 0);
+
+		threadPool(const threadPool&) = delete;
+
+		threadPool& operator=(const threadPool&) = delete;
+
+		/**
+		 * Run a task on the pool. The task must not throw,
+		 * exceptions thrown by it are caught and discarded.
+		 *
+		 * @param task the task to run
+		 */
+		void submit(std::function<void()> task);
+
+		/**
+		 * Call fn for every index in [0, count) and wait until all calls finished.
+		 * The calling thread takes part in the work. If any call throws,
+		 * the first exception is rethrown after all calls finished.
+		 *
+		 * @param count the number of work items
+		 * @param fn the function to call for every work item
+		 */
+		void parallelFor(size_t count, const std::function<void(size_t)>& fn);
+
+		/**
+		 * Get the number of threads in this pool
+		 *
+		 * @return the number of worker threads
+		 */
+		NODEMSPASSPORT_NODISCARD size_t size() const noexcept;
+
+		/**
+		 * Set the number of threads of the shared thread pool.
+		 * Throws std::logic_error if the shared pool is already running.
+		 *
+		 * @param threads the number of threads. Zero uses one thread per core.
+		 */
+		static void setSharedSize(size_t threads);
+
+		/**
+		 * Get the process wide thread pool
+		 *
+		 * @return the shared thread pool
+		 */
+		static threadPool& shared();
+
+		~threadPool();
+
+	private:
+		struct worker {
+			std::mutex mtx;
+			std::deque<std::function<void()>> tasks;
+			std::thread thread;
+		};
+
+		struct job;
+
+		void workerLoop(size_t index);
+
+		bool tryRunTask(size_t index);
+
+		static void runJob(job& j);
+
+		std::vector<std::unique_ptr<worker>> workers;
+		// The tasks submitted from outside the pool
+		std::mutex injectedMtx;
+		std::deque<std::function<void()>> injected;
+		// The number of tasks in all queues
+		std::atomic<size_t> pending;
+		std::mutex sleepMtx;
+		std::condition_variable cv;
+		bool stopping;
+	};
+}
+
+#endif //PASSPORT_THREADPOOL_HPP
\ No newline at end of file
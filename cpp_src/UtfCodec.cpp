@@ -0,0 +1,517 @@
+#include <atomic>
+#include <algorithm>
+
+#include "UtfCodec.hpp"
+#include "CpuFeatures.hpp"
+
+#ifdef NODEMSPASSPORT_X86
+#   include <immintrin.h>
+#endif
+
+using namespace nodeMsPassport;
+
+namespace {
+	// A kernel returns the number of code units it consumed
+	// and stops before the first invalid sequence
+	using toUtf16Func = size_t(*)(const char*, size_t, char16_t*, size_t&);
+	using toUtf8Func = size_t(*)(const char16_t*, size_t, char*, size_t&);
+
+	/**
+	 * Decode a single UTF-8 sequence, see the Unicode standard, table 3-7
+	 *
+	 * @param in the sequence to decode
+	 * @param len the number of bytes left in the input
+	 * @param cp the decoded code point
+	 * @return the length of the sequence, zero if it is invalid or truncated
+	 */
+	inline size_t decodeUtf8(const unsigned char* in, size_t len, char32_t& cp) noexcept {
+		const unsigned b0 = in[0];
+		if (b0 < 0x80) {
+			cp = b0;
+			return 1;
+		} else if (b0 < 0xC2) {
+			// A continuation byte or the start of an overlong two byte sequence
+			return 0;
+		} else if (b0 < 0xE0) {
+			if (len < 2 || (in[1] & 0xC0u) != 0x80) return 0;
+
+			cp = ((b0 & 0x1Fu) << 6u) | (in[1] & 0x3Fu);
+			return 2;
+		} else if (b0 < 0xF0) {
+			// E0 must not start an overlong sequence, ED must not encode a surrogate
+			const unsigned lo = b0 == 0xE0 ? 0xA0 : 0x80;
+			const unsigned hi = b0 == 0xED ? 0x9F : 0xBF;
+			if (len < 3 || in[1] < lo || in[1] > hi || (in[2] & 0xC0u) != 0x80) return 0;
+
+			cp = ((b0 & 0x0Fu) << 12u) | ((in[1] & 0x3Fu) << 6u) | (in[2] & 0x3Fu);
+			return 3;
+		} else if (b0 < 0xF5) {
+			// F0 must not start an overlong sequence, F4 must not exceed U+10FFFF
+			const unsigned lo = b0 == 0xF0 ? 0x90 : 0x80;
+			const unsigned hi = b0 == 0xF4 ? 0x8F : 0xBF;
+			if (len < 4 || in[1] < lo || in[1] > hi || (in[2] & 0xC0u) != 0x80 || (in[3] & 0xC0u) != 0x80) {
+				return 0;
+			}
+
+			cp = ((b0 & 0x07u) << 18u) | ((in[1] & 0x3Fu) << 12u) | ((in[2] & 0x3Fu) << 6u) | (in[3] & 0x3Fu);
+			return 4;
+		} else {
+			return 0;
+		}
+	}
+
+	/**
+	 * Decode a single UTF-16 code point
+	 *
+	 * @param in the code units to decode
+	 * @param len the number of code units left in the input
+	 * @param cp the decoded code point
+	 * @return the number of code units used, zero for an unpaired surrogate
+	 */
+	inline size_t decodeUtf16(const char16_t* in, size_t len, char32_t& cp) noexcept {
+		const char32_t c = in[0];
+		if (c < 0xD800 || c > 0xDFFF) {
+			cp = c;
+			return 1;
+		} else if (c > 0xDBFF || len < 2 || in[1] < 0xDC00 || in[1] > 0xDFFF) {
+			return 0;
+		}
+
+		cp = 0x10000 + ((c - 0xD800) << 10u) + (in[1] - 0xDC00);
+		return 2;
+	}
+
+	/**
+	 * Check if a value is a valid unicode scalar value
+	 */
+	inline bool isScalarValue(char32_t cp) noexcept {
+		return cp < 0xD800 || (cp > 0xDFFF && cp < 0x110000);
+	}
+
+	/**
+	 * Encode a unicode scalar value as UTF-16
+	 *
+	 * @return the number of code units written
+	 */
+	inline size_t encodeUtf16(char32_t cp, char16_t* out) noexcept {
+		if (cp < 0x10000) {
+			out[0] = (char16_t)cp;
+			return 1;
+		}
+
+		cp -= 0x10000;
+		out[0] = (char16_t)(0xD800 + (cp >> 10u));
+		out[1] = (char16_t)(0xDC00 + (cp & 0x3FFu));
+		return 2;
+	}
+
+	/**
+	 * Encode a unicode scalar value as UTF-8
+	 *
+	 * @return the number of bytes written
+	 */
+	inline size_t encodeUtf8(char32_t cp, char* out) noexcept {
+		if (cp < 0x80) {
+			out[0] = (char)cp;
+			return 1;
+		} else if (cp < 0x800) {
+			out[0] = (char)(0xC0 | (cp >> 6u));
+			out[1] = (char)(0x80 | (cp & 0x3Fu));
+			return 2;
+		} else if (cp < 0x10000) {
+			out[0] = (char)(0xE0 | (cp >> 12u));
+			out[1] = (char)(0x80 | ((cp >> 6u) & 0x3Fu));
+			out[2] = (char)(0x80 | (cp & 0x3Fu));
+			return 3;
+		} else {
+			out[0] = (char)(0xF0 | (cp >> 18u));
+			out[1] = (char)(0x80 | ((cp >> 12u) & 0x3Fu));
+			out[2] = (char)(0x80 | ((cp >> 6u) & 0x3Fu));
+			out[3] = (char)(0x80 | (cp & 0x3Fu));
+			return 4;
+		}
+	}
+
+	/**
+	 * Convert UTF-8 to UTF-16 one code point at a time, until at least
+	 * the position end is reached. The last sequence may exceed end.
+	 *
+	 * @return false if an invalid sequence was found at the position i
+	 */
+	inline bool toUtf16Until(const unsigned char* in, size_t len, size_t& i, size_t end, char16_t* out, size_t& o) {
+		while (i < end) {
+			if (in[i] < 0x80) {
+				out[o++] = in[i++];
+				continue;
+			}
+
+			char32_t cp;
+			const size_t n = decodeUtf8(in + i, len - i, cp);
+			if (n == 0) return false;
+
+			i += n;
+			o += encodeUtf16(cp, out + o);
+		}
+
+		return true;
+	}
+
+	/**
+	 * Convert UTF-16 to UTF-8 one code point at a time, until at least
+	 * the position end is reached. The last surrogate pair may exceed end.
+	 *
+	 * @return false if an unpaired surrogate was found at the position i
+	 */
+	inline bool toUtf8Until(const char16_t* in, size_t len, size_t& i, size_t end, char* out, size_t& o) {
+		while (i < end) {
+			if (in[i] < 0x80) {
+				out[o++] = (char)in[i++];
+				continue;
+			}
+
+			char32_t cp;
+			const size_t n = decodeUtf16(in + i, len - i, cp);
+			if (n == 0) return false;
+
+			i += n;
+			o += encodeUtf8(cp, out + o);
+		}
+
+		return true;
+	}
+
+	size_t toUtf16Scalar(const char* in, size_t len, char16_t* out, size_t& written) {
+		size_t i = 0;
+		written = 0;
+		toUtf16Until(reinterpret_cast<const unsigned char*>(in), len, i, len, out, written);
+
+		return i;
+	}
+
+	size_t toUtf8Scalar(const char16_t* in, size_t len, char* out, size_t& written) {
+		size_t i = 0;
+		written = 0;
+		toUtf8Until(in, len, i, len, out, written);
+
+		return i;
+	}
+
+#ifdef NODEMSPASSPORT_X86
+	// The vector kernels convert whole blocks of ASCII characters at once.
+	// Blocks containing other characters are converted one code point at a time.
+
+	NODEMSPASSPORT_TARGET("sse2")
+	size_t toUtf16Sse2(const char* in, size_t len, char16_t* out, size_t& written) {
+		const auto* src = reinterpret_cast<const unsigned char*>(in);
+		const __m128i zero = _mm_setzero_si128();
+		size_t i = 0, o = 0;
+
+		while (i + 16 <= len) {
+			const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+			if (_mm_movemask_epi8(v) == 0) {
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + o), _mm_unpacklo_epi8(v, zero));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + o + 8), _mm_unpackhi_epi8(v, zero));
+				i += 16;
+				o += 16;
+			} else if (!toUtf16Until(src, len, i, i + 16, out, o)) {
+				written = o;
+				return i;
+			}
+		}
+
+		toUtf16Until(src, len, i, len, out, o);
+		written = o;
+		return i;
+	}
+
+	NODEMSPASSPORT_TARGET("sse2")
+	size_t toUtf8Sse2(const char16_t* in, size_t len, char* out, size_t& written) {
+		const __m128i nonAscii = _mm_set1_epi16((short)0xFF80);
+		const __m128i zero = _mm_setzero_si128();
+		size_t i = 0, o = 0;
+
+		while (i + 16 <= len) {
+			const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+			const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 8));
+			const __m128i high = _mm_and_si128(_mm_or_si128(a, b), nonAscii);
+
+			if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, zero)) == 0xFFFF) {
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + o), _mm_packus_epi16(a, b));
+				i += 16;
+				o += 16;
+			} else if (!toUtf8Until(in, len, i, i + 16, out, o)) {
+				written = o;
+				return i;
+			}
+		}
+
+		toUtf8Until(in, len, i, len, out, o);
+		written = o;
+		return i;
+	}
+
+	NODEMSPASSPORT_TARGET("avx2")
+	size_t toUtf16Avx2(const char* in, size_t len, char16_t* out, size_t& written) {
+		const auto* src = reinterpret_cast<const unsigned char*>(in);
+		size_t i = 0, o = 0;
+
+		while (i + 32 <= len) {
+			const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+			if (_mm256_movemask_epi8(v) == 0) {
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + o),
+					_mm256_cvtepu8_epi16(_mm256_castsi256_si128(v)));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + o + 16),
+					_mm256_cvtepu8_epi16(_mm256_extracti128_si256(v, 1)));
+				i += 32;
+				o += 32;
+			} else if (!toUtf16Until(src, len, i, i + 32, out, o)) {
+				_mm256_zeroupper();
+				written = o;
+				return i;
+			}
+		}
+
+		// Avoid the penalty of mixing avx and legacy sse instructions
+		_mm256_zeroupper();
+		size_t tail;
+		i += toUtf16Sse2(in + i, len - i, out + o, tail);
+		written = o + tail;
+		return i;
+	}
+
+	NODEMSPASSPORT_TARGET("avx2")
+	size_t toUtf8Avx2(const char16_t* in, size_t len, char* out, size_t& written) {
+		const __m256i nonAscii = _mm256_set1_epi16((short)0xFF80);
+		size_t i = 0, o = 0;
+
+		while (i + 32 <= len) {
+			const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+			const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i + 16));
+
+			if (_mm256_testz_si256(_mm256_or_si256(a, b), nonAscii)) {
+				// packus operates on each lane separately, restore the order afterwards
+				const __m256i packed = _mm256_packus_epi16(a, b);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + o), _mm256_permute4x64_epi64(packed, 0xD8));
+				i += 32;
+				o += 32;
+			} else if (!toUtf8Until(in, len, i, i + 32, out, o)) {
+				_mm256_zeroupper();
+				written = o;
+				return i;
+			}
+		}
+
+		_mm256_zeroupper();
+		size_t tail;
+		i += toUtf8Sse2(in + i, len - i, out + o, tail);
+		written = o + tail;
+		return i;
+	}
+#endif
+
+	struct kernels {
+		utf::implementation impl;
+		toUtf16Func toUtf16;
+		toUtf8Func toUtf8;
+	};
+
+	const kernels scalarKernels{utf::implementation::scalar, toUtf16Scalar, toUtf8Scalar};
+#ifdef NODEMSPASSPORT_X86
+	const kernels sse2Kernels{utf::implementation::sse2, toUtf16Sse2, toUtf8Sse2};
+	const kernels avx2Kernels{utf::implementation::avx2, toUtf16Avx2, toUtf8Avx2};
+#endif
+
+	const kernels* selectKernels(utf::implementation impl) {
+		const cpu::features& features = cpu::getFeatures();
+		switch (impl) {
+#ifdef NODEMSPASSPORT_X86
+			case utf::implementation::avx2:
+				return features.avx2 ? &avx2Kernels : nullptr;
+			case utf::implementation::sse2:
+				return features.sse2 ? &sse2Kernels : nullptr;
+#endif
+			case utf::implementation::scalar:
+				return &scalarKernels;
+			default:
+				return nullptr;
+		}
+	}
+
+	const kernels* bestKernels() {
+		for (utf::implementation impl : {utf::implementation::avx2, utf::implementation::sse2}) {
+			const kernels* k = selectKernels(impl);
+			if (k) return k;
+		}
+
+		return &scalarKernels;
+	}
+
+	std::atomic<const kernels*> active(bestKernels());
+
+	[[noreturn]] void throwInvalidUtf8(size_t position) {
+		throw utf::utfException("Invalid UTF-8 sequence at position " + std::to_string(position), position);
+	}
+
+	[[noreturn]] void throwUnpairedSurrogate(size_t position) {
+		throw utf::utfException("Unpaired surrogate at position " + std::to_string(position), position);
+	}
+
+	[[noreturn]] void throwInvalidCharacter(size_t position) {
+		throw utf::utfException("Invalid character at position " + std::to_string(position), position);
+	}
+}
+
+utf::utfException::utfException(const std::string& err, size_t position) : std::invalid_argument(err), pos(position) {}
+
+size_t utf::utfException::position() const noexcept {
+	return pos;
+}
+
+utf::implementation utf::getImplementation() noexcept {
+	return active.load(std::memory_order_relaxed)->impl;
+}
+
+bool utf::setImplementation(implementation impl) noexcept {
+	const kernels* k = selectKernels(impl);
+	if (!k) return false;
+
+	active.store(k, std::memory_order_relaxed);
+	return true;
+}
+
+const char* utf::implementationName(implementation impl) noexcept {
+	switch (impl) {
+		case implementation::avx2:
+			return "avx2";
+		case implementation::sse2:
+			return "sse2";
+		default:
+			return "scalar";
+	}
+}
+
+size_t utf::utf8ToUtf16(const char* in, size_t len, char16_t* out) {
+	size_t written;
+	const size_t consumed = active.load(std::memory_order_relaxed)->toUtf16(in, len, out, written);
+	if (consumed != len) throwInvalidUtf8(consumed);
+
+	return written;
+}
+
+size_t utf::utf16ToUtf8(const char16_t* in, size_t len, char* out) {
+	size_t written;
+	const size_t consumed = active.load(std::memory_order_relaxed)->toUtf8(in, len, out, written);
+	if (consumed != len) throwUnpairedSurrogate(consumed);
+
+	return written;
+}
+
+// Wide strings are UTF-16 if wchar_t has 16 bits. The code units are passed
+// to the UTF-16 functions directly in that case, otherwise they are UTF-32.
+
+size_t utf::utf8ToWide(const char* in, size_t len, wchar_t* out) {
+	if constexpr (sizeof(wchar_t) == sizeof(char16_t)) {
+		return utf8ToUtf16(in, len, reinterpret_cast<char16_t*>(out));
+	} else {
+		const auto* src = reinterpret_cast<const unsigned char*>(in);
+		size_t o = 0;
+		for (size_t i = 0; i < len;) {
+			char32_t cp;
+			const size_t n = decodeUtf8(src + i, len - i, cp);
+			if (n == 0) throwInvalidUtf8(i);
+
+			out[o++] = (wchar_t)cp;
+			i += n;
+		}
+
+		return o;
+	}
+}
+
+size_t utf::wideToUtf8(const wchar_t* in, size_t len, char* out) {
+	if constexpr (sizeof(wchar_t) == sizeof(char16_t)) {
+		return utf16ToUtf8(reinterpret_cast<const char16_t*>(in), len, out);
+	} else {
+		size_t o = 0;
+		for (size_t i = 0; i < len; i++) {
+			const auto cp = (char32_t)in[i];
+			if (!isScalarValue(cp)) throwInvalidCharacter(i);
+
+			o += encodeUtf8(cp, out + o);
+		}
+
+		return o;
+	}
+}
+
+size_t utf::utf16ToWide(const char16_t* in, size_t len, wchar_t* out) {
+	if constexpr (sizeof(wchar_t) == sizeof(char16_t)) {
+		// Windows strings may contain unpaired surrogates, just like javascript strings
+		std::copy(in, in + len, out);
+		return len;
+	} else {
+		size_t o = 0;
+		for (size_t i = 0; i < len;) {
+			char32_t cp;
+			const size_t n = decodeUtf16(in + i, len - i, cp);
+			if (n == 0) throwUnpairedSurrogate(i);
+
+			out[o++] = (wchar_t)cp;
+			i += n;
+		}
+
+		return o;
+	}
+}
+
+size_t utf::wideToUtf16(const wchar_t* in, size_t len, char16_t* out) {
+	if constexpr (sizeof(wchar_t) == sizeof(char16_t)) {
+		std::copy(in, in + len, out);
+		return len;
+	} else {
+		size_t o = 0;
+		for (size_t i = 0; i < len; i++) {
+			const auto cp = (char32_t)in[i];
+			if (!isScalarValue(cp)) throwInvalidCharacter(i);
+
+			o += encodeUtf16(cp, out + o);
+		}
+
+		return o;
+	}
+}
+
+std::u16string utf::toUtf16(const std::string& str) {
+	std::u16string out(str.size(), u'\0');
+	out.resize(utf8ToUtf16(str.data(), str.size(), &out[0]));
+
+	return out;
+}
+
+std::string utf::toUtf8(const std::u16string& str) {
+	std::string out(str.size() * 3, '\0');
+	out.resize(utf16ToUtf8(str.data(), str.size(), &out[0]));
+
+	return out;
+}
+
+std::string utf::toUtf8(const std::wstring& str) {
+	std::string out(maxUtf8Length(str.size()), '\0');
+	out.resize(wideToUtf8(str.data(), str.size(), &out[0]));
+
+	return out;
+}
+
+std::wstring utf::toWide(const std::string& str) {
+	std::wstring out(str.size(), L'\0');
+	out.resize(utf8ToWide(str.data(), str.size(), &out[0]));
+
+	return out;
+}
+
+std::wstring utf::toWide(const std::u16string& str) {
+	std::wstring out(str.size(), L'\0');
+	out.resize(utf16ToWide(str.data(), str.size(), &out[0]));
+
+	return out;
+}
\ No newline at end of file
@@ -0,0 +1,188 @@
+#ifndef PASSPORT_UTFCODEC_HPP
+#define PASSPORT_UTFCODEC_HPP
+
+#include <string>
+#include <cstddef>
+#include <stdexcept>
+
+/**
+ * Validating UTF-8 and UTF-16 transcoding, independent of the current locale.
+ * Runs of ASCII characters are converted using SSE2 or AVX2
+ * if supported by the cpu, everything else is converted one code point at a time.
+ * wchar_t strings are treated as UTF-16 on windows and as UTF-32 on any other system.
+ */
+namespace nodeMsPassport::utf {
+	/**
+	 * The available transcoder implementations
+	 */
+	enum class implementation {
+		scalar,
+		sse2,
+		avx2
+	};
+
+	/**
+	 * An exception thrown if a string is not valid UTF-8 or UTF-16
+	 */
+	class utfException : public std::invalid_argument {
+	public:
+		/**
+		 * Create an utfException
+		 *
+		 * @param err the error message
+		 * @param position the offset of the offending code unit in the input
+		 */
+		utfException(const std::string& err, size_t position);
+
+		/**
+		 * Get the offset of the offending code unit
+		 *
+		 * @return the position of the invalid code unit
+		 */
+		size_t position() const noexcept;
+
+	private:
+		size_t pos;
+	};
+
+	/**
+	 * Get the implementation currently in use
+	 *
+	 * @return the active implementation
+	 */
+	implementation getImplementation() noexcept;
+
+	/**
+	 * Set the implementation to use. Mainly used by benchmarks.
+	 *
+	 * @param impl the implementation to use
+	 * @return false if the implementation is not supported by this cpu
+	 */
+	bool setImplementation(implementation impl) noexcept;
+
+	/**
+	 * Get the name of an implementation
+	 *
+	 * @param impl the implementation
+	 * @return the name of the implementation
+	 */
+	const char* implementationName(implementation impl) noexcept;
+
+	/**
+	 * Get the maximum number of UTF-8 bytes needed to encode a wide string
+	 *
+	 * @param len the number of wide characters
+	 * @return the maximum number of bytes
+	 */
+	constexpr size_t maxUtf8Length(size_t len) noexcept {
+		return len * (sizeof(wchar_t) == sizeof(char16_t) ? 3 : 4);
+	}
+
+	/**
+	 * Convert UTF-8 to UTF-16. The output buffer must hold at least len code units.
+	 * Throws an utfException if the input is not valid UTF-8.
+	 *
+	 * @param in the UTF-8 string
+	 * @param len the number of bytes to convert
+	 * @param out the output buffer
+	 * @return the number of code units written
+	 */
+	size_t utf8ToUtf16(const char* in, size_t len, char16_t* out);
+
+	/**
+	 * Convert UTF-16 to UTF-8. The output buffer must hold at least len * 3 bytes.
+	 * Throws an utfException if the input contains unpaired surrogates.
+	 *
+	 * @param in the UTF-16 string
+	 * @param len the number of code units to convert
+	 * @param out the output buffer
+	 * @return the number of bytes written
+	 */
+	size_t utf16ToUtf8(const char16_t* in, size_t len, char* out);
+
+	/**
+	 * Convert UTF-8 to a wide string. The output buffer must hold at least len characters.
+	 * Throws an utfException if the input is not valid UTF-8.
+	 *
+	 * @param in the UTF-8 string
+	 * @param len the number of bytes to convert
+	 * @param out the output buffer
+	 * @return the number of wide characters written
+	 */
+	size_t utf8ToWide(const char* in, size_t len, wchar_t* out);
+
+	/**
+	 * Convert a wide string to UTF-8. The output buffer must hold at least maxUtf8Length(len) bytes.
+	 * Throws an utfException if the input is not a valid wide string.
+	 *
+	 * @param in the wide string
+	 * @param len the number of wide characters to convert
+	 * @param out the output buffer
+	 * @return the number of bytes written
+	 */
+	size_t wideToUtf8(const wchar_t* in, size_t len, char* out);
+
+	/**
+	 * Convert UTF-16 to a wide string. The output buffer must hold at least len characters.
+	 * Throws an utfException if the input contains unpaired surrogates.
+	 *
+	 * @param in the UTF-16 string
+	 * @param len the number of code units to convert
+	 * @param out the output buffer
+	 * @return the number of wide characters written
+	 */
+	size_t utf16ToWide(const char16_t* in, size_t len, wchar_t* out);
+
+	/**
+	 * Convert a wide string to UTF-16. The output buffer must hold at least len * 2 code units.
+	 * Throws an utfException if the input is not a valid wide string.
+	 *
+	 * @param in the wide string
+	 * @param len the number of wide characters to convert
+	 * @param out the output buffer
+	 * @return the number of code units written
+	 */
+	size_t wideToUtf16(const wchar_t* in, size_t len, char16_t* out);
+
+	/**
+	 * Convert an UTF-8 string to UTF-16
+	 *
+	 * @param str the string to convert
+	 * @return the converted string
+	 */
+	std::u16string toUtf16(const std::string& str);
+
+	/**
+	 * Convert an UTF-16 string to UTF-8
+	 *
+	 * @param str the string to convert
+	 * @return the converted string
+	 */
+	std::string toUtf8(const std::u16string& str);
+
+	/**
+	 * Convert a wide string to UTF-8
+	 *
+	 * @param str the string to convert
+	 * @return the converted string
+	 */
+	std::string toUtf8(const std::wstring& str);
+
+	/**
+	 * Convert an UTF-8 string to a wide string
+	 *
+	 * @param str the string to convert
+	 * @return the converted string
+	 */
+	std::wstring toWide(const std::string& str);
+
+	/**
+	 * Convert an UTF-16 string to a wide string
+	 *
+	 * @param str the string to convert
+	 * @return the converted string
+	 */
+	std::wstring toWide(const std::u16string& str);
+}
+
+#endif //PASSPORT_UTFCODEC_HPP
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include <array>
+#include <atomic>
+
+#include "VerificationEngine.hpp"
+
+#ifdef NODEMSPASSPORT_WITH_OPENSSL
+#   include "OpenSslEngine.hpp"
+#endif
+
+#ifndef NODEMSPASSPORT_DEFAULT_ENGINE
+#   define NODEMSPASSPORT_DEFAULT_ENGINE "native"
+#endif
+
+using namespace nodeMsPassport;
+using namespace nodeMsPassport::crypto;
+
+namespace {
+	/**
+	 * The in-tree verifier, using rsaPublicKey and ecPublicKey
+	 */
+	class nativeEngine : public verificationEngine {
+	public:
+		NODEMSPASSPORT_NODISCARD const char* name() const noexcept override {
+			return "native";
+		}
+
+		NODEMSPASSPORT_NODISCARD keyCache& keys() const noexcept override {
+			return keyCache::shared();
+		}
+	};
+
+#ifdef NODEMSPASSPORT_WITH_OPENSSL
+	constexpr size_t engineCount = 2;
+#else
+	constexpr size_t engineCount = 1;
+#endif
+
+	/**
+	 * Get all engines of this build, the native engine first. A function local
+	 * static, so it can be used by the static initializers of other translation units.
+	 */
+	const std::array<const verificationEngine*, engineCount>& engines() {
+		static const nativeEngine native;
+		static const std::array<const verificationEngine*, engineCount> res = {
+			&native,
+#ifdef NODEMSPASSPORT_WITH_OPENSSL
+			&openSslEngine::instance(),
+#endif
+		};
+
+		return res;
+	}
+
+	const verificationEngine* find(const std::string& name) noexcept {
+		for (const verificationEngine* engine : engines()) {
+			if (name == engine->name()) return engine;
+		}
+
+		return nullptr;
+	}
+
+	const verificationEngine* defaultEngine() noexcept {
+		const verificationEngine* engine = find(NODEMSPASSPORT_DEFAULT_ENGINE);
+		return engine ? engine : engines().front();
+	}
+
+	// Constant initialized, the default engine is resolved by the first call to active().
+	// Published with release, so a reader skipping the engines() guard sees a constructed engine.
+	std::atomic<const verificationEngine*> activeEngine(nullptr);
+}
+
+const verificationEngine& verificationEngine::active() noexcept {
+	const verificationEngine* engine = activeEngine.load(std::memory_order_acquire);
+	if (engine) return *engine;
+
+	// Keep the engine of a concurrent setActive call
+	const verificationEngine* fallback = defaultEngine();
+	return activeEngine.compare_exchange_strong(engine, fallback, std::memory_order_acq_rel, std::memory_order_acquire) ? *fallback : *engine;
+}
+
+bool verificationEngine::setActive(const std::string& name) noexcept {
+	const verificationEngine* engine = find(name);
+	if (!engine) return false;
+
+	activeEngine.store(engine, std::memory_order_release);
+	return true;
+}
+
+std::vector<std::string> verificationEngine::available() {
+	std::vector<std::string> res;
+	for (const verificationEngine* engine : engines()) {
+		res.emplace_back(engine->name());
+	}
+
+	return res;
+}
\ No newline at end of file
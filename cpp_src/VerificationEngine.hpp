@@ -0,0 +1,60 @@
+#ifndef PASSPORT_VERIFICATIONENGINE_HPP
+#define PASSPORT_VERIFICATIONENGINE_HPP
+
+#include <string>
+#include <vector>
+
+#include "KeyCache.hpp"
+
+namespace nodeMsPassport::crypto {
+	/**
+	 * An implementation of signature verification used by passport::verifySignature
+	 * and passport::verifySignatures. Every engine parses keys into its own
+	 * publicKey implementation and caches them in its own key cache.
+	 * The native engine is always available, the OpenSSL engine
+	 * only if the library was built with PASSPORT_WITH_OPENSSL.
+	 */
+	class verificationEngine {
+	public:
+		/**
+		 * Get the name of this engine
+		 *
+		 * @return the name of the engine
+		 */
+		NODEMSPASSPORT_NODISCARD virtual const char* name() const noexcept = 0;
+
+		/**
+		 * Get the cache of the keys parsed by this engine
+		 *
+		 * @return the key cache of this engine
+		 */
+		NODEMSPASSPORT_NODISCARD virtual keyCache& keys() const noexcept = 0;
+
+		/**
+		 * Get the engine currently in use. Defaults to the engine
+		 * selected by PASSPORT_VERIFICATION_ENGINE at build time.
+		 *
+		 * @return the active engine
+		 */
+		static const verificationEngine& active() noexcept;
+
+		/**
+		 * Set the engine to use
+		 *
+		 * @param name the name of the engine, as returned by name()
+		 * @return false if no engine with the name is available
+		 */
+		static bool setActive(const std::string& name) noexcept;
+
+		/**
+		 * Get the names of all engines available in this build
+		 *
+		 * @return the names of the engines
+		 */
+		static std::vector<std::string> available();
+
+		virtual ~verificationEngine() = default;
+	};
+}
+
+#endif //PASSPORT_VERIFICATIONENGINE_HPP
\ No newline at end of file
@@ -0,0 +1,104 @@
+#ifndef PASSPORT_WORD64_HPP
+#define PASSPORT_WORD64_HPP
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#   include <intrin.h>
+#endif
+
+namespace nodeMsPassport::crypto {
+	/**
+	 * A 64 bit word of the fixed size big integers. This is unsigned long long,
+	 * not uint64_t, as the BMI2 and ADX intrinsics use it on every platform.
+	 */
+	using word64 = unsigned long long;
+	static_assert(sizeof(word64) == 8, "The fixed size big integers require 64 bit words");
+
+	/**
+	 * Compute a * b + t + c, which always fits into 128 bits
+	 *
+	 * @param hi receives the high word of the result
+	 * @return the low word of the result
+	 */
+	inline word64 multiplyAdd(word64 a, word64 b, word64 t, word64 c, word64& hi) noexcept {
+#if defined(__SIZEOF_INT128__)
+		__extension__ using uint128 = unsigned __int128;
+		const uint128 res = (uint128)a * b + t + c;
+		hi = (word64)(res >> 64u);
+		return (word64)res;
+#elif defined(_MSC_VER) && defined(_M_X64)
+		unsigned long long h;
+		unsigned long long lo = _umul128(a, b, &h);
+		h += _addcarry_u64(0, lo, t, &lo);
+		h += _addcarry_u64(0, lo, c, &lo);
+		hi = h;
+		return lo;
+#else
+		// Multiply the 32 bit halves
+		constexpr word64 mask = 0xffffffffu;
+		const word64 p0 = (a & mask) * (b & mask);
+		const word64 p1 = (a & mask) * (b >> 32u);
+		const word64 p2 = (a >> 32u) * (b & mask);
+		const word64 p3 = (a >> 32u) * (b >> 32u);
+		const word64 middle = (p0 >> 32u) + (p1 & mask) + (p2 & mask);
+
+		word64 lo = (p0 & mask) | (middle << 32u);
+		word64 h = p3 + (p1 >> 32u) + (p2 >> 32u) + (middle >> 32u);
+		lo += t;
+		h += lo < t;
+		lo += c;
+		h += lo < c;
+		hi = h;
+		return lo;
+#endif
+	}
+
+	/**
+	 * Compute a + b + carry
+	 *
+	 * @param carry the incoming carry, zero or one. Receives the outgoing carry.
+	 * @return the low word of the sum
+	 */
+	inline word64 addWithCarry(word64 a, word64 b, word64& carry) noexcept {
+#if defined(__SIZEOF_INT128__)
+		__extension__ using uint128 = unsigned __int128;
+		const uint128 res = (uint128)a + b + carry;
+		carry = (word64)(res >> 64u);
+		return (word64)res;
+#elif defined(_MSC_VER) && defined(_M_X64)
+		unsigned long long res;
+		carry = _addcarry_u64((unsigned char)carry, a, b, &res);
+		return res;
+#else
+		const word64 sum = a + carry;
+		const word64 res = sum + b;
+		carry = (word64)(sum < carry) + (word64)(res < b);
+		return res;
+#endif
+	}
+
+	/**
+	 * Compute a - b - borrow
+	 *
+	 * @param borrow the incoming borrow, zero or one. Receives the outgoing borrow.
+	 * @return the low word of the difference
+	 */
+	inline word64 subtractWithBorrow(word64 a, word64 b, word64& borrow) noexcept {
+#if defined(__SIZEOF_INT128__)
+		__extension__ using uint128 = unsigned __int128;
+		const uint128 res = (uint128)a - b - borrow;
+		borrow = (word64)(res >> 127u);
+		return (word64)res;
+#elif defined(_MSC_VER) && defined(_M_X64)
+		unsigned long long res;
+		borrow = _subborrow_u64((unsigned char)borrow, a, b, &res);
+		return res;
+#else
+		const word64 diff = a - b;
+		const word64 res = diff - borrow;
+		borrow = (word64)(a < b) | (word64)(diff < borrow);
+		return res;
+#endif
+	}
+}
+
+#endif //PASSPORT_WORD64_HPP
\ No newline at end of file
@@ -1,17 +1,26 @@
 #include <napi.h>
-#include <sstream>
-#include <random>
+#include <memory>
 #include <utility>
 #include <iostream>
 #include <napi_tools.hpp>
 
 #include "NodeMsPassport.hpp"
+#include "HexCodec.hpp"
+#include "Drbg.hpp"
+#include "ChallengePool.hpp"
+#include "ChallengeIssuer.hpp"
+#include "ReplayFilter.hpp"
+#include "VerificationEngine.hpp"
+#include "SoftwareBackend.hpp"
+#include "ThreadPool.hpp"
+#include "Backend.hpp"
+#include "Promise.hpp"
 
 using namespace nodeMsPassport;
 
 class exception : public std::exception {
 public:
-#ifdef __APPLE__
+#ifndef _MSC_VER
 	explicit exception(const char* msg) : std::exception(), msg(msg) {}
 
 	[[nodiscard]] const char* what() const noexcept override {
@@ -25,33 +34,355 @@ private:
 #endif
 };
 
-secure_vector<byte> string_to_binary(const std::string& source) {
-	static unsigned int nibbles[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 0, 0, 0, 0, 0, 0, 0, 10, 11, 12, 13, 14, 15 };
-	secure_vector<byte> retval;
-	for (std::string::const_iterator it = source.begin(); it < source.end(); it += 2) {
-		unsigned char v;
-		if (isxdigit(*it))
-			v = nibbles[toupper(*it) - '0'] << (unsigned)4;
-		else {
-			std::string err = "Invalid character: '";
-			err += (char)*it;
-			err.append("' is not a valid hex digit");
-			throw std::exception(err.c_str());
+/**
+ * Check the number of arguments passed to a function
+ *
+ * @param info the callback info
+ * @param count the expected number of arguments
+ */
+void checkArgCount(const Napi::CallbackInfo& info, size_t count) {
+	if (info.Length() != count) {
+		throw Napi::TypeError::New(info.Env(), "Expected " + std::to_string(count) + " arguments, got "
+			+ std::to_string(info.Length()));
+	}
+}
+
+/**
+ * Check that the replay filter remembers challenges for longer than they are valid.
+ * verifyChallengeAndSignature rejects every challenge which could still be valid once
+ * the filter forgot it, which includes challenges issued up to the clock skew in the future.
+ *
+ * @param maxAge the maximum age of a challenge in milliseconds
+ * @param ttl the ttl of the replay filter in milliseconds
+ */
+void checkReplayWindow(uint64_t maxAge, uint64_t ttl) {
+	if (maxAge + crypto::challengeIssuer::maxClockSkew >= ttl) {
+		throw exception("The maximum challenge age plus 30 seconds of clock skew must be less than the replay ttl");
+	}
+}
+
+/**
+ * Check if a value is a Buffer or an Uint8Array
+ *
+ * @param value the value to check
+ * @return true if the value holds binary data
+ */
+bool isBinary(const Napi::Value& value) {
+	return value.IsBuffer() ||
+		(value.IsTypedArray() && value.As<Napi::TypedArray>().TypedArrayType() == napi_uint8_array);
+}
+
+/**
+ * Get the bytes stored in a hex string, Buffer or Uint8Array.
+ * Binary values are copied directly out of their backing store.
+ *
+ * @param value the value to get the bytes from
+ * @param name the name of the parameter, used in error messages
+ * @return the bytes
+ */
+secure_vector<byte> getBytes(const Napi::Value& value, const std::string& name) {
+	if (isBinary(value)) {
+		Napi::Uint8Array arr = value.As<Napi::Uint8Array>();
+		return secure_vector<byte>(arr.Data(), arr.Data() + arr.ByteLength());
+	} else if (value.IsString()) {
+		return hex::decode(value.As<Napi::String>().Utf8Value());
+	} else {
+		throw Napi::TypeError::New(value.Env(), "Parameter '" + name + "' must be a hex string, Buffer or Uint8Array");
+	}
+}
+
+/**
+ * Get the bytes stored in a hex string, Buffer or Uint8Array as a secure buffer.
+ * Used for challenges and signatures, which usually fit into the inline storage.
+ *
+ * @param value the value to get the bytes from
+ * @param name the name of the parameter, used in error messages
+ * @return the bytes
+ */
+secure_buffer getBuffer(const Napi::Value& value, const std::string& name) {
+	if (isBinary(value)) {
+		Napi::Uint8Array arr = value.As<Napi::Uint8Array>();
+		return secure_buffer(arr.Data(), arr.ByteLength());
+	} else if (value.IsString()) {
+		return hex::decodeBuffer(value.As<Napi::String>().Utf8Value());
+	} else {
+		throw Napi::TypeError::New(value.Env(), "Parameter '" + name + "' must be a hex string, Buffer or Uint8Array");
+	}
+}
+
+/**
+ * Get the options of a signature to verify. Missing options use the defaults,
+ * which is a RSASSA-PKCS1-v1_5 or ECDSA signature using SHA-256.
+ *
+ * @param value the options object or undefined
+ * @return the signature options
+ */
+passport::signatureOptions getSignatureOptions(const Napi::Value& value) {
+	passport::signatureOptions options;
+	if (value.IsUndefined() || value.IsNull()) return options;
+	if (!value.IsObject()) throw Napi::TypeError::New(value.Env(), "Parameter 'options' must be an object");
+
+	const Napi::Object obj = value.As<Napi::Object>();
+	const Napi::Value padding = obj.Get("padding");
+	if (!padding.IsUndefined()) {
+		const std::string name = padding.IsString() ? padding.As<Napi::String>().Utf8Value() : std::string();
+		if (name == "pkcs1") {
+			options.padding = passport::signaturePadding::pkcs1;
+		} else if (name == "pss") {
+			options.padding = passport::signaturePadding::pss;
+		} else {
+			throw Napi::TypeError::New(value.Env(), "Option 'padding' must be either 'pkcs1' or 'pss'");
+		}
+	}
+
+	const Napi::Value hash = obj.Get("hash");
+	if (!hash.IsUndefined()) {
+		const std::string name = hash.IsString() ? hash.As<Napi::String>().Utf8Value() : std::string();
+		if (name == "sha256") {
+			options.hash = passport::hashAlgorithm::sha256;
+		} else if (name == "sha384") {
+			options.hash = passport::hashAlgorithm::sha384;
+		} else if (name == "sha512") {
+			options.hash = passport::hashAlgorithm::sha512;
+		} else {
+			throw Napi::TypeError::New(value.Env(), "Option 'hash' must be one of 'sha256', 'sha384' or 'sha512'");
+		}
+	}
+
+	const Napi::Value saltLength = obj.Get("saltLength");
+	if (!saltLength.IsUndefined()) {
+		const double length = saltLength.IsNumber() ? saltLength.As<Napi::Number>().DoubleValue() : -1;
+		// Salts are always smaller than the key, the upper bound also rejects NaN and infinity
+		if (!(length >= 0 && length <= 65536) || length != static_cast<double>(static_cast<int64_t>(length))) {
+			throw Napi::TypeError::New(value.Env(), "Option 'saltLength' must be a non-negative integer");
+		}
+
+		options.saltLength = static_cast<size_t>(length);
+	}
+
+	return options;
+}
+
+/**
+ * Get the number of UTF-16 code units of a javascript string
+ *
+ * @param value the string
+ * @return the length of the string
+ */
+size_t utf16Length(const Napi::Value& value) {
+	size_t length = 0;
+	if (napi_get_value_string_utf16(value.Env(), value, nullptr, 0, &length) != napi_ok) {
+		throw Napi::Error::New(value.Env());
+	}
+
+	return length;
+}
+
+/**
+ * Copy the UTF-16 code units of a javascript string. N-API always
+ * writes a null terminator, the output must hold length + 1 code units.
+ *
+ * @param value the string to copy
+ * @param out the output buffer
+ * @param length the length of the string
+ */
+void copyUtf16(const Napi::Value& value, char16_t* out, size_t length) {
+	if (napi_get_value_string_utf16(value.Env(), value, out, length + 1, &length) != napi_ok) {
+		throw Napi::Error::New(value.Env());
+	}
+}
+
+/**
+ * Convert a javascript string to UTF-8 using the validating transcoder.
+ * Throws a TypeError if the string contains unpaired surrogates.
+ *
+ * @param value the string to convert
+ * @return the UTF-8 string
+ */
+std::string getUtf8String(const Napi::Value& value) {
+	const size_t length = utf16Length(value);
+	std::u16string utf16(length, u'\0');
+	copyUtf16(value, &utf16[0], length);
+
+	try {
+		std::string out(length * 3, '\0');
+		out.resize(utf::utf16ToUtf8(utf16.data(), length, &out[0]));
+		return out;
+	} catch (const utf::utfException& e) {
+		throw Napi::TypeError::New(value.Env(), e.what());
+	}
+}
+
+/**
+ * Copy a javascript string into a wide string, without creating an intermediate
+ * std::u16string if wchar_t has 16 bits. Otherwise the string is transcoded to UTF-32,
+ * which throws a TypeError if the string contains unpaired surrogates.
+ *
+ * @tparam Str the type of the wide string to create
+ * @param value the string to copy
+ * @return the wide string
+ */
+template<class Str>
+Str getWideString(const Napi::Value& value) {
+	const size_t length = utf16Length(value);
+
+	// The null terminator written by N-API fits into the terminator of the string
+	if constexpr (sizeof(wchar_t) == sizeof(char16_t)) {
+		Str out(length, L'\0');
+		copyUtf16(value, reinterpret_cast<char16_t*>(&out[0]), length);
+		return out;
+	} else {
+		using allocator = typename std::allocator_traits<typename Str::allocator_type>::template rebind_alloc<char16_t>;
+		std::basic_string<char16_t, std::char_traits<char16_t>, allocator> utf16(length, u'\0');
+		copyUtf16(value, &utf16[0], length);
+
+		try {
+			Str out(length, L'\0');
+			out.resize(utf::utf16ToWide(utf16.data(), length, &out[0]));
+			return out;
+		} catch (const utf::utfException& e) {
+			throw Napi::TypeError::New(value.Env(), e.what());
 		}
-		if (it + 1 < source.end() && isxdigit(*(it + 1)))
-			v += nibbles[toupper(*(it + 1)) - '0'];
-		retval.push_back(v);
 	}
-	return retval;
 }
 
-std::string binary_to_string(const secure_vector<byte>& source) {
-	static char syms[] = "0123456789ABCDEF";
-	std::stringstream ss;
-	for (std::_Vector_const_iterator<std::_Vector_val<std::_Simple_types<char> > >::value_type it : source)
-		ss << syms[(((unsigned)it >> (unsigned)4) & (unsigned)0xf)] << syms[(unsigned)it & (unsigned)0xf];
+/**
+ * Copy a javascript string straight into secure memory. Javascript
+ * strings are UTF-16, so the string is copied with a single memcpy.
+ *
+ * @param value the string to copy
+ * @return the string as a secret
+ */
+secret_u16string getSecret(const Napi::Value& value) {
+	const size_t length = utf16Length(value);
+
+	// The null terminator written by N-API fits into the terminator of the string
+	secure_u16string out(length, u'\0');
+	copyUtf16(value, &out[0], length);
+	return secret_u16string(std::move(out));
+}
+
+/**
+ * Create a javascript string from a wide string without creating
+ * an intermediate std::u16string if wchar_t has 16 bits
+ *
+ * @tparam Str the type of the wide string
+ * @param env the environment to work in
+ * @param value the string to convert
+ * @return the javascript string
+ */
+template<class Str>
+Napi::String toNapiString(const Napi::Env& env, const Str& value) {
+	if constexpr (sizeof(wchar_t) == sizeof(char16_t)) {
+		return Napi::String::New(env, reinterpret_cast<const char16_t*>(value.data()), value.size());
+	} else {
+		using allocator = typename std::allocator_traits<typename Str::allocator_type>::template rebind_alloc<char16_t>;
+		std::basic_string<char16_t, std::char_traits<char16_t>, allocator> utf16(value.size() * 2, u'\0');
+		utf16.resize(utf::wideToUtf16(value.data(), value.size(), &utf16[0]));
+		return Napi::String::New(env, utf16.data(), utf16.size());
+	}
+}
+
+/**
+ * Create a javascript string from a secret, with a single memcpy
+ *
+ * @param env the environment to work in
+ * @param value the string to convert
+ * @return the javascript string
+ */
+Napi::String toNapiString(const Napi::Env& env, const secure_u16string& value) {
+	return Napi::String::New(env, value.data(), value.size());
+}
+
+/**
+ * Hand bytes over to javascript as an external Buffer without copying them.
+ * The data is zeroed and freed when the Buffer is garbage collected.
+ *
+ * @param env the environment to work in
+ * @param data the data to pass on
+ * @return the Buffer
+ */
+Napi::Buffer<byte> toBuffer(const Napi::Env& env, const std::shared_ptr<secure_vector<byte>>& data) {
+	if (!data || data->empty()) {
+		return Napi::Buffer<byte>::New(env, 0);
+	}
+
+	auto* hint = new std::shared_ptr<secure_vector<byte>>(data);
+	try {
+		return Napi::Buffer<byte>::New(env, data->data(), data->size(),
+			[](Napi::Env, byte*, std::shared_ptr<secure_vector<byte>>* ptr) {
+				delete ptr;
+			}, hint);
+	} catch (const Napi::Error&) {
+		// Some runtimes do not allow external buffers, copy the data in that case
+		delete hint;
+		return Napi::Buffer<byte>::Copy(env, data->data(), data->size());
+	}
+}
+
+/**
+ * A binary result of a promise, passed to javascript as a Buffer
+ */
+class binaryResult {
+public:
+	binaryResult() = default;
+
+	explicit binaryResult(secure_vector<byte>&& bytes) : data(
+		std::make_shared<secure_vector<byte>>(std::move(bytes))) {}
+
+	std::shared_ptr<secure_vector<byte>> data;
+
+	static Napi::Value toNapiValue(const Napi::Env& env, const binaryResult& res) {
+		return toBuffer(env, res.data);
+	}
+};
+
+/**
+ * A small binary result of a promise, copied into a Buffer.
+ * Signatures and hashes are too small to be worth an external Buffer.
+ */
+class bufferResult {
+public:
+	bufferResult() = default;
+
+	explicit bufferResult(secure_buffer&& bytes) : data(std::move(bytes)) {}
+
+	secure_buffer data;
+
+	static Napi::Value toNapiValue(const Napi::Env& env, const bufferResult& res) {
+		return Napi::Buffer<byte>::Copy(env, res.data.data(), res.data.size());
+	}
+};
 
-	return ss.str();
+/**
+ * The result of a batch verification, passed to javascript as an array of booleans
+ */
+class batchResult {
+public:
+	batchResult() = default;
+
+	explicit batchResult(std::vector<bool>&& results) : results(std::move(results)) {}
+
+	std::vector<bool> results;
+
+	static Napi::Value toNapiValue(const Napi::Env& env, const batchResult& res) {
+		Napi::Array arr = Napi::Array::New(env, res.results.size());
+		for (size_t i = 0; i < res.results.size(); i++) {
+			arr.Set(static_cast<uint32_t>(i), Napi::Boolean::New(env, res.results[i]));
+		}
+
+		return arr;
+	}
+};
+
+/**
+ * Get the lane for operations which may show a prompt to the user.
+ * Prompts are run one at a time, apart from the computational work.
+ *
+ * @return the lane to run create and sign operations on
+ */
+util::lane promptLane() {
+	return passport::getBackend()->interactive() ? util::lane::interactive : util::lane::compute;
 }
 
 Napi::Boolean passportAvailable(const Napi::CallbackInfo& info) {
@@ -62,30 +393,43 @@ Napi::Boolean passportAvailable(const Napi::CallbackInfo& info) {
 
 Napi::Promise createPassportKey(const Napi::CallbackInfo& info) {
 	CHECK_ARGS(napi_tools::string);
-	std::string account = info[0].ToString();
+	std::string account = getUtf8String(info[0]);
 
-	return napi_tools::promises::promise<void>(info.Env(), [account] {
+	return promises::promise<void>(info.Env(), promptLane(), [account] {
 		passport::createPassportKey(account);
 	});
 }
 
 Napi::Promise passportSign(const Napi::CallbackInfo& info) {
+	if (isBinary(info[1])) {
+		checkArgCount(info, 2);
+		if (!info[0].IsString()) throw Napi::TypeError::New(info.Env(), "Parameter 'accountId' must be a string");
+
+		std::string account = getUtf8String(info[0]);
+		secure_buffer challenge = getBuffer(info[1], "challenge");
+		return promises::promise<bufferResult>(info.Env(), promptLane(), [account, challenge = std::move(challenge)] {
+			return bufferResult(passport::passportSign(account, challenge));
+		});
+	}
+
 	CHECK_ARGS(napi_tools::string, napi_tools::string);
 
-	std::string account = info[0].ToString();
-	secure_vector<byte> challenge = string_to_binary(info[1].ToString().Utf8Value());
-	return napi_tools::promises::promise<std::string>(info.Env(), [account, challenge] {
-		secure_vector<byte> res = passport::passportSign(account, challenge);
+	TRY
+		std::string account = getUtf8String(info[0]);
+		secure_buffer challenge = hex::decodeBuffer(info[1].ToString().Utf8Value());
+		return promises::promise<std::string>(info.Env(), promptLane(), [account, challenge = std::move(challenge)] {
+			const secure_buffer res = passport::passportSign(account, challenge);
 
-		return binary_to_string(res);
-	});
+			return hex::encode(res);
+		});
+	CATCH_EXCEPTIONS
 }
 
 Napi::Promise deletePassportAccount(const Napi::CallbackInfo& info) {
 	CHECK_ARGS(napi_tools::string);
 
-	std::string account = info[0].ToString();
-	return napi_tools::promises::promise<void>(info.Env(), [account] {
+	std::string account = getUtf8String(info[0]);
+	return promises::promise<void>(info.Env(), [account] {
 		try {
 			passport::deletePassportAccount(account);
 		} catch (const std::exception& e) {
@@ -97,40 +441,183 @@ Napi::Promise deletePassportAccount(const Napi::CallbackInfo& info) {
 Napi::Promise getPublicKey(const Napi::CallbackInfo& info) {
 	CHECK_ARGS(napi_tools::string);
 
-	std::string account = info[0].ToString();
-	return napi_tools::promises::promise<std::string>(info.Env(), [account] {
+	std::string account = getUtf8String(info[0]);
+	return promises::promise<std::string>(info.Env(), [account] {
 		secure_vector<byte> res = passport::getPublicKey(account);
-		return binary_to_string(res);
+		return hex::encode(res);
+	});
+}
+
+Napi::Promise getPublicKeyBuffer(const Napi::CallbackInfo& info) {
+	CHECK_ARGS(napi_tools::string);
+
+	std::string account = getUtf8String(info[0]);
+	return promises::promise<binaryResult>(info.Env(), [account] {
+		return binaryResult(passport::getPublicKey(account));
 	});
 }
 
 Napi::Promise getPublicKeyHash(const Napi::CallbackInfo& info) {
 	CHECK_ARGS(napi_tools::string);
 
-	std::string account = info[0].ToString();
-	return napi_tools::promises::promise<std::string>(info.Env(), [account] {
-		secure_vector<byte> res = passport::getPublicKeyHash(account);
-		return binary_to_string(res);
+	std::string account = getUtf8String(info[0]);
+	return promises::promise<std::string>(info.Env(), [account] {
+		const secure_buffer res = passport::getPublicKeyHash(account);
+		return hex::encode(res);
+	});
+}
+
+Napi::Promise getPublicKeyHashBuffer(const Napi::CallbackInfo& info) {
+	CHECK_ARGS(napi_tools::string);
+
+	std::string account = getUtf8String(info[0]);
+	return promises::promise<bufferResult>(info.Env(), [account] {
+		return bufferResult(passport::getPublicKeyHash(account));
 	});
 }
 
 Napi::Promise verifySignature(const Napi::CallbackInfo& info) {
-	CHECK_ARGS(napi_tools::string, napi_tools::string, napi_tools::string);
+	checkArgCount(info, 4);
+
+	TRY
+		secure_buffer challenge = getBuffer(info[0], "challenge");
+		secure_buffer signature = getBuffer(info[1], "signature");
+		secure_vector<byte> publicKey = getBytes(info[2], "publicKey");
+		const passport::signatureOptions options = getSignatureOptions(info[3]);
+
+		return promises::promise<bool>(info.Env(), [challenge = std::move(challenge), signature = std::move(signature),
+			publicKey = std::move(publicKey), options] {
+			return passport::verifySignature(challenge, signature, publicKey, options);
+		});
+	CATCH_EXCEPTIONS
+}
 
-	secure_vector<byte> challenge = string_to_binary(info[0].ToString().Utf8Value());
-	secure_vector<byte> signature = string_to_binary(info[1].ToString().Utf8Value());
-	secure_vector<byte> publicKey = string_to_binary(info[2].ToString().Utf8Value());
+Napi::Value issueChallenge(const Napi::CallbackInfo& info) {
+	CHECK_ARGS(napi_tools::string, napi_tools::boolean);
 
-	return napi_tools::promises::promise<bool>(info.Env(), [challenge, signature, publicKey] {
-		return passport::verifySignature(challenge, signature, publicKey);
-	});
+	TRY
+		const secure_buffer challenge = passport::issueChallenge(getUtf8String(info[0]));
+
+		if (info[1].ToBoolean()) {
+			return Napi::Buffer<byte>::Copy(info.Env(), challenge.data(), challenge.size());
+		} else {
+			return Napi::String::New(info.Env(), hex::encode(challenge));
+		}
+	CATCH_EXCEPTIONS
+}
+
+Napi::Promise verifyChallengeAndSignature(const Napi::CallbackInfo& info) {
+	checkArgCount(info, 4);
+	if (!info[0].IsString()) throw Napi::TypeError::New(info.Env(), "Parameter 'accountId' must be a string");
+
+	TRY
+		std::string account = getUtf8String(info[0]);
+		secure_buffer challenge = getBuffer(info[1], "challenge");
+		secure_buffer signature = getBuffer(info[2], "signature");
+		secure_vector<byte> publicKey = getBytes(info[3], "publicKey");
+
+		return promises::promise<bool>(info.Env(), [account, challenge = std::move(challenge),
+			signature = std::move(signature), publicKey = std::move(publicKey)] {
+			return passport::verifyChallengeAndSignature(account, challenge, signature, publicKey);
+		});
+	CATCH_EXCEPTIONS
+}
+
+void setChallengeKey(const Napi::CallbackInfo& info) {
+	checkArgCount(info, 2);
+	if (!info[1].IsNumber()) throw Napi::TypeError::New(info.Env(), "Parameter 'maxAge' must be a number");
+
+	TRY
+		const secure_vector<byte> key = getBytes(info[0], "key");
+		const int64_t maxAge = info[1].As<Napi::Number>();
+		if (maxAge <= 0) throw exception("The maximum challenge age must be positive");
+		checkReplayWindow(static_cast<uint64_t>(maxAge), crypto::replayFilter::sharedTtl());
+
+		crypto::challengeIssuer::setShared(key, static_cast<uint64_t>(maxAge));
+	CATCH_EXCEPTIONS
+}
+
+Napi::Promise verifySignatures(const Napi::CallbackInfo& info) {
+	checkArgCount(info, 1);
+	if (!info[0].IsArray()) throw Napi::TypeError::New(info.Env(), "Parameter 'signatures' must be an array");
+
+	TRY
+		const Napi::Array arr = info[0].As<Napi::Array>();
+		auto signatures = std::make_shared<std::vector<passport::signatureData>>();
+		signatures->reserve(arr.Length());
+
+		for (uint32_t i = 0; i < arr.Length(); i++) {
+			const Napi::Value entry = arr.Get(i);
+			if (!entry.IsObject()) {
+				throw Napi::TypeError::New(info.Env(), "Element " + std::to_string(i) + " must be an object");
+			}
+
+			const Napi::Object obj = entry.As<Napi::Object>();
+			signatures->push_back({
+				getBuffer(obj.Get("challenge"), "challenge"),
+				getBuffer(obj.Get("signature"), "signature"),
+				getBytes(obj.Get("publicKey"), "publicKey"),
+				getSignatureOptions(obj.Get("options"))
+			});
+		}
+
+		return promises::promise<batchResult>(info.Env(), [signatures] {
+			return batchResult(passport::verifySignatures(*signatures));
+		});
+	CATCH_EXCEPTIONS
+}
+
+Napi::Object getKeyCacheStatistics(const Napi::CallbackInfo& info) {
+	const crypto::keyCache::statistics stats = crypto::verificationEngine::active().keys().getStatistics();
+
+	Napi::Object res = Napi::Object::New(info.Env());
+	res.Set("hits", Napi::Number::New(info.Env(), static_cast<double>(stats.hits)));
+	res.Set("misses", Napi::Number::New(info.Env(), static_cast<double>(stats.misses)));
+	res.Set("evictions", Napi::Number::New(info.Env(), static_cast<double>(stats.evictions)));
+	res.Set("size", Napi::Number::New(info.Env(), static_cast<double>(stats.size)));
+
+	return res;
+}
+
+void setReplayProtection(const Napi::CallbackInfo& info) {
+	CHECK_ARGS(napi_tools::boolean, napi_tools::number, napi_tools::number);
+
+	TRY
+		const int64_t ttl = info[1].As<Napi::Number>();
+		const int64_t maxEntries = info[2].As<Napi::Number>();
+		if (ttl < 0 || maxEntries < 0) throw exception("The ttl and the size must not be negative");
+
+		if (ttl > 0) checkReplayWindow(crypto::challengeIssuer::shared()->getMaxAge(), static_cast<uint64_t>(ttl));
+
+		// Zero keeps the current value
+		if (ttl > 0 || maxEntries > 0) {
+			crypto::replayFilter::setSharedConfiguration(
+				ttl > 0 ? static_cast<uint64_t>(ttl) : crypto::replayFilter::sharedTtl(),
+				maxEntries > 0 ? static_cast<size_t>(maxEntries) : crypto::replayFilter::sharedMaxEntries());
+		}
+
+		passport::setReplayProtection(info[0].ToBoolean());
+	CATCH_EXCEPTIONS
+}
+
+Napi::Object getReplayFilterStatistics(const Napi::CallbackInfo& info) {
+	const crypto::replayFilter::statistics stats = crypto::replayFilter::shared().getStatistics();
+
+	Napi::Object res = Napi::Object::New(info.Env());
+	res.Set("inserted", Napi::Number::New(info.Env(), static_cast<double>(stats.inserted)));
+	res.Set("duplicates", Napi::Number::New(info.Env(), static_cast<double>(stats.duplicates)));
+	res.Set("rejected", Napi::Number::New(info.Env(), static_cast<double>(stats.rejected)));
+	res.Set("size", Napi::Number::New(info.Env(), static_cast<double>(stats.size)));
+	res.Set("memory", Napi::Number::New(info.Env(), static_cast<double>(stats.memory)));
+
+	return res;
 }
 
 Napi::Boolean passportAccountExists(const Napi::CallbackInfo& info) {
 	CHECK_ARGS(napi_tools::string);
 
 	TRY
-		std::string account = info[0].ToString();
+		std::string account = getUtf8String(info[0]);
 	return Napi::Boolean::New(info.Env(), passport::passportAccountExists(account));
 	CATCH_EXCEPTIONS
 }
@@ -138,35 +625,28 @@ Napi::Boolean passportAccountExists(const Napi::CallbackInfo& info) {
 Napi::Promise writeCredential(const Napi::CallbackInfo& info) {
 	CHECK_ARGS(napi_tools::string, napi_tools::string, napi_tools::string, napi_tools::boolean);
 
-	std::u16string target_u16 = info[0].ToString();
-	std::u16string user_u16 = info[1].ToString();
-	std::u16string password_u16 = info[2].ToString();
-
-	std::wstring target(target_u16.begin(), target_u16.end());
-	std::wstring user(user_u16.begin(), user_u16.end());
-	secure_wstring password(password_u16.begin(), password_u16.end());
+	std::wstring target = getWideString<std::wstring>(info[0]);
+	std::wstring user = getWideString<std::wstring>(info[1]);
+	secret_u16string password = getSecret(info[2]);
 	bool encrypt = info[3].ToBoolean();
 
-	return napi_tools::promises::promise<bool>(info.Env(), [target, user, password, encrypt] {
-		return credentials::write(target, user, password, encrypt);
+	return promises::promise<bool>(info.Env(), [target, user, password = std::move(password), encrypt]() mutable {
+		return credentials::write(target, user, std::move(password), encrypt);
 	});
 }
 
 class credentialReadResult {
 public:
 	std::wstring user;
-	secure_wstring password;
+	secret_u16string password;
 	bool ok;
 
 	static Napi::Value toNapiValue(const Napi::Env& env, const credentialReadResult& res) {
 		if (res.ok) {
 			Napi::Object obj = Napi::Object::New(env);
 
-			std::u16string username(res.user.begin(), res.user.end());
-			std::u16string password(res.password.begin(), res.password.end());
-
-			obj.Set("username", Napi::String::New(env, username));
-			obj.Set("password", Napi::String::New(env, password));
+			obj.Set("username", toNapiString(env, res.user));
+			obj.Set("password", toNapiString(env, *res.password));
 
 			return obj;
 		} else {
@@ -179,11 +659,10 @@ Napi::Promise readCredential(const Napi::CallbackInfo& info) {
 	CHECK_ARGS(napi_tools::string, napi_tools::boolean);
 
 	Napi::Env env = info.Env();
-	std::u16string target_utf16 = info[0].As<Napi::String>().Utf16Value();
-	std::wstring target(target_utf16.begin(), target_utf16.end());
+	std::wstring target = getWideString<std::wstring>(info[0]);
 	bool encrypted = info[1].ToBoolean();
 
-	return napi_tools::promises::promise<credentialReadResult>(info.Env(), [target, encrypted] {
+	return promises::promise<credentialReadResult>(info.Env(), [target, encrypted] {
 		credentialReadResult res;
 		res.ok = credentials::read(target, res.user, res.password, encrypted);
 
@@ -194,10 +673,9 @@ Napi::Promise readCredential(const Napi::CallbackInfo& info) {
 Napi::Promise removeCredential(const Napi::CallbackInfo& info) {
 	CHECK_ARGS(napi_tools::string);
 
-	std::u16string target_u16 = info[0].ToString();
-	std::wstring target(target_u16.begin(), target_u16.end());
+	std::wstring target = getWideString<std::wstring>(info[0]);
 
-	return napi_tools::promises::promise<bool>(info.Env(), [target] {
+	return promises::promise<bool>(info.Env(), [target] {
 		return credentials::remove(target);
 	});
 }
@@ -205,77 +683,234 @@ Napi::Promise removeCredential(const Napi::CallbackInfo& info) {
 Napi::Promise credentialEncrypted(const Napi::CallbackInfo& info) {
 	CHECK_ARGS(napi_tools::string);
 
-	std::u16string target_u16 = info[0].ToString();
-	std::wstring target(target_u16.begin(), target_u16.end());
+	std::wstring target = getWideString<std::wstring>(info[0]);
 
-	return napi_tools::promises::promise<bool>(info.Env(), [target] {
+	return promises::promise<bool>(info.Env(), [target] {
 		return credentials::isEncrypted(target);
 	});
 }
 
+/**
+ * A decrypted password, passed to javascript as a string
+ */
+class passwordResult {
+public:
+	passwordResult() = default;
+
+	explicit passwordResult(secret_u16string&& password) : password(std::move(password)) {}
+
+	secret_u16string password;
+
+	static Napi::Value toNapiValue(const Napi::Env& env, const passwordResult& res) {
+		return toNapiString(env, *res.password);
+	}
+};
+
+/**
+ * Encrypt a password. The password is encrypted in place.
+ *
+ * @param data the password to encrypt
+ * @return the encrypted password bytes
+ */
+secure_vector<byte> encryptPasswordBytes(secret_u16string data) {
+	bool ok = passwords::encrypt(*data);
+	if (!ok) throw exception("Could not encrypt the data");
+	else return data->getBytes();
+}
+
+/**
+ * Decrypt a password
+ *
+ * @param bytes the encrypted password bytes
+ * @return the decrypted password
+ */
+passwordResult decryptPasswordBytes(const secure_vector<byte>& bytes) {
+	secret_u16string data(secure_u16string{bytes});
+	bool ok = passwords::decrypt(*data);
+
+	if (!ok) throw exception("Could not decrypt the data");
+	else return passwordResult(std::move(data));
+}
+
 Napi::Promise encryptPassword(const Napi::CallbackInfo& info) {
 	CHECK_ARGS(napi_tools::string);
 
-	std::u16string data_u16 = info[0].ToString();
-	secure_wstring data(data_u16.begin(), data_u16.end());
+	secret_u16string data = getSecret(info[0]);
 
-	return napi_tools::promises::promise<std::string>(info.Env(), [data] {
-		secure_wstring data_cpy(data);
-		bool ok = passwords::encrypt(data_cpy);
-		if (!ok) throw exception("Could not encrypt the data");
-		else return binary_to_string(data_cpy.getBytes());
+	return promises::promise<std::string>(info.Env(), [data = std::move(data)]() mutable {
+		return hex::encode(encryptPasswordBytes(std::move(data)));
 	});
+}
 
+Napi::Promise encryptPasswordBuffer(const Napi::CallbackInfo& info) {
+	CHECK_ARGS(napi_tools::string);
+
+	secret_u16string data = getSecret(info[0]);
+
+	return promises::promise<binaryResult>(info.Env(), [data = std::move(data)]() mutable {
+		return binaryResult(encryptPasswordBytes(std::move(data)));
+	});
 }
 
 Napi::Promise decryptPassword(const Napi::CallbackInfo& info) {
-	CHECK_ARGS(napi_tools::string);
+	if (isBinary(info[0])) {
+		checkArgCount(info, 1);
 
-	Napi::Env env = info.Env();
-	std::string data_str = info[0].ToString();
+		secure_vector<byte> data = getBytes(info[0], "data");
+		return promises::promise<passwordResult>(info.Env(), [data = std::move(data)] {
+			return decryptPasswordBytes(data);
+		});
+	}
 
-	return napi_tools::promises::promise<std::u16string>(info.Env(), [data_str] {
-		secure_wstring data_cpy(string_to_binary(data_str));
-		bool ok = passwords::decrypt(data_cpy);
+	CHECK_ARGS(napi_tools::string);
 
-		if (!ok) throw exception("Could not decrypt the data");
-		else return std::u16string(data_cpy.begin(), data_cpy.end());
+	std::string data_str = info[0].ToString();
+	return promises::promise<passwordResult>(info.Env(), [data_str] {
+		return decryptPasswordBytes(hex::decode(data_str));
 	});
 }
 
 Napi::Boolean passwordEncrypted(const Napi::CallbackInfo& info) {
-	CHECK_ARGS(napi_tools::string);
+	checkArgCount(info, 1);
 
 	TRY
-		Napi::Env env = info.Env();
-	std::string password = info[0].As<Napi::String>();
+		secure_u16string data(getBytes(info[0], "data"));
+		bool res = passwords::isEncrypted(data);
 
-	secure_vector<unsigned char> data_vec = string_to_binary(password);
-	secure_wstring data(data_vec);
+		return Napi::Boolean::New(info.Env(), res);
+	CATCH_EXCEPTIONS
+}
 
-	bool res = passwords::isEncrypted(data);
+Napi::Value fingerprint(const Napi::CallbackInfo& info) {
+	checkArgCount(info, 1);
 
-	return Napi::Boolean::New(env, res);
+	TRY
+		const bool binary = isBinary(info[0]);
+		const secure_buffer res = passport::fingerprint(getBytes(info[0], "publicKey"));
+
+		if (binary) {
+			return Napi::Buffer<byte>::Copy(info.Env(), res.data(), res.size());
+		} else {
+			return Napi::String::New(info.Env(), hex::encode(res));
+		}
 	CATCH_EXCEPTIONS
 }
 
-Napi::String generateRandom(const Napi::CallbackInfo& info) {
-	CHECK_ARGS(napi_tools::number);
+Napi::Value generateRandom(const Napi::CallbackInfo& info) {
+	if (info.Length() < 1 || info.Length() > 2) {
+		throw Napi::TypeError::New(info.Env(), "Expected 1 or 2 arguments, got " + std::to_string(info.Length()));
+	} else if (!info[0].IsNumber()) {
+		throw Napi::TypeError::New(info.Env(), "Parameter 'length' must be a number");
+	}
+
+	const int64_t length = info[0].As<Napi::Number>().Int64Value();
+	if (length < 0) throw Napi::RangeError::New(info.Env(), "Parameter 'length' must not be negative");
+	const bool binary = info.Length() == 2 && info[1].ToBoolean();
 
 	TRY
-		int numChars = info[0].As<Napi::Number>();
+		if (binary) {
+			Napi::Buffer<byte> res = Napi::Buffer<byte>::New(info.Env(), (size_t)length);
+			crypto::secureRandom(res.Data(), res.Length());
+			return res;
+		}
+
+		secure_vector<byte> buffer((size_t)length);
+		crypto::secureRandom(buffer.data(), buffer.size());
+		return Napi::String::New(info.Env(), hex::encode(buffer));
+	CATCH_EXCEPTIONS
+}
 
-	std::random_device dev;
-	std::mt19937 rng(dev());
-	std::uniform_int_distribution<> dist(0, UCHAR_MAX);
+Napi::Value takeChallenge(const Napi::CallbackInfo& info) {
+	CHECK_ARGS(napi_tools::number, napi_tools::boolean);
 
-	secure_vector<byte> buffer;
-	buffer.reserve(numChars);
-	for (int i = 0; i < numChars; i++) {
-		buffer.push_back((unsigned char)dist(rng));
+	const int64_t length = info[0].As<Napi::Number>().Int64Value();
+	if (length < 1 || length > (int64_t)crypto::challengePool::maxChallengeSize) {
+		throw Napi::RangeError::New(info.Env(), "Parameter 'length' must be between 1 and "
+			+ std::to_string(crypto::challengePool::maxChallengeSize));
 	}
 
-	return Napi::String::New(info.Env(), binary_to_string(buffer));
+	TRY
+		secure_buffer challenge((size_t)length);
+		crypto::challengePool::shared().take(challenge.data(), challenge.size());
+
+		if (info[1].ToBoolean()) {
+			return Napi::Buffer<byte>::Copy(info.Env(), challenge.data(), challenge.size());
+		} else {
+			return Napi::String::New(info.Env(), hex::encode(challenge));
+		}
+	CATCH_EXCEPTIONS
+}
+
+Napi::Object getChallengePoolStatistics(const Napi::CallbackInfo& info) {
+	const crypto::challengePool::statistics stats = crypto::challengePool::shared().getStatistics();
+
+	Napi::Object res = Napi::Object::New(info.Env());
+	res.Set("taken", Napi::Number::New(info.Env(), static_cast<double>(stats.taken)));
+	res.Set("exhausted", Napi::Number::New(info.Env(), static_cast<double>(stats.exhausted)));
+	res.Set("generated", Napi::Number::New(info.Env(), static_cast<double>(stats.generated)));
+	res.Set("available", Napi::Number::New(info.Env(), static_cast<double>(stats.available)));
+	res.Set("depth", Napi::Number::New(info.Env(), static_cast<double>(stats.depth)));
+
+	return res;
+}
+
+void setChallengePoolSize(const Napi::CallbackInfo& info) {
+	CHECK_ARGS(napi_tools::number, napi_tools::number);
+
+	TRY
+		const int64_t depth = info[0].As<Napi::Number>();
+		const int64_t lowWater = info[1].As<Napi::Number>();
+		if (depth < 1) throw exception("The pool depth must be positive");
+		if (lowWater < 0) throw exception("The low-water mark must not be negative");
+
+		crypto::challengePool::setSharedConfiguration(static_cast<size_t>(depth), static_cast<size_t>(lowWater));
+	CATCH_EXCEPTIONS
+}
+
+void setBackend(const Napi::CallbackInfo& info) {
+	if (info.Length() < 1 || info.Length() > 2) {
+		throw Napi::TypeError::New(info.Env(), "Expected 1 or 2 arguments, got " + std::to_string(info.Length()));
+	} else if (!info[0].IsString()) {
+		throw Napi::TypeError::New(info.Env(), "Parameter 'name' must be a string");
+	}
+
+	TRY
+		const std::string name = getUtf8String(info[0]);
+		if (name == "default") {
+			passport::setBackend(passport::createDefaultBackend());
+		} else if (name == "software") {
+			std::string directory;
+			if (info.Length() == 2 && !info[1].IsUndefined()) {
+				if (!info[1].IsString()) {
+					throw Napi::TypeError::New(info.Env(), "Parameter 'directory' must be a string");
+				}
+
+				directory = getUtf8String(info[1]);
+			} else {
+				directory = passport::softwareBackend::defaultDirectory();
+			}
+
+			passport::setBackend(std::make_shared<passport::softwareBackend>(directory));
+		} else {
+			throw Napi::TypeError::New(info.Env(), "Unknown backend: " + name);
+		}
+	CATCH_EXCEPTIONS
+}
+
+Napi::String getBackend(const Napi::CallbackInfo& info) {
+	TRY
+		return Napi::String::New(info.Env(), passport::getBackend()->name());
+	CATCH_EXCEPTIONS
+}
+
+void setThreadPoolSize(const Napi::CallbackInfo& info) {
+	CHECK_ARGS(napi_tools::number);
+
+	TRY
+		const int64_t threads = info[0].As<Napi::Number>();
+		if (threads < 0) throw exception("The number of threads must not be negative");
+
+		util::threadPool::setSharedSize(static_cast<size_t>(threads));
 	CATCH_EXCEPTIONS
 }
 
@@ -283,17 +918,29 @@ void setCSharpDllLocation(const Napi::CallbackInfo& info) {
 	CHECK_ARGS(napi_tools::string);
 
 	TRY
-		passport::setCSharpDllLocation(info[0].ToString().Utf8Value());
+		passport::setCSharpDllLocation(getUtf8String(info[0]));
 	CATCH_EXCEPTIONS
 }
 
 Napi::Object InitAll(Napi::Env env, Napi::Object exports) {
+	promises::init(env);
+
 	EXPORT_FUNCTION(exports, env, passportAvailable);
 	EXPORT_FUNCTION(exports, env, createPassportKey);
 	EXPORT_FUNCTION(exports, env, passportSign);
 	EXPORT_FUNCTION(exports, env, getPublicKey);
+	EXPORT_FUNCTION(exports, env, getPublicKeyBuffer);
+	EXPORT_FUNCTION(exports, env, getPublicKeyHash);
+	EXPORT_FUNCTION(exports, env, getPublicKeyHashBuffer);
 	EXPORT_FUNCTION(exports, env, deletePassportAccount);
 	EXPORT_FUNCTION(exports, env, verifySignature);
+	EXPORT_FUNCTION(exports, env, verifySignatures);
+	EXPORT_FUNCTION(exports, env, issueChallenge);
+	EXPORT_FUNCTION(exports, env, verifyChallengeAndSignature);
+	EXPORT_FUNCTION(exports, env, setChallengeKey);
+	EXPORT_FUNCTION(exports, env, getKeyCacheStatistics);
+	EXPORT_FUNCTION(exports, env, setReplayProtection);
+	EXPORT_FUNCTION(exports, env, getReplayFilterStatistics);
 	EXPORT_FUNCTION(exports, env, passportAccountExists);
 
 	EXPORT_FUNCTION(exports, env, writeCredential);
@@ -302,11 +949,19 @@ Napi::Object InitAll(Napi::Env env, Napi::Object exports) {
 	EXPORT_FUNCTION(exports, env, credentialEncrypted);
 
 	EXPORT_FUNCTION(exports, env, encryptPassword);
+	EXPORT_FUNCTION(exports, env, encryptPasswordBuffer);
 	EXPORT_FUNCTION(exports, env, decryptPassword);
 	EXPORT_FUNCTION(exports, env, passwordEncrypted);
 
 	EXPORT_FUNCTION(exports, env, generateRandom);
+	EXPORT_FUNCTION(exports, env, takeChallenge);
+	EXPORT_FUNCTION(exports, env, getChallengePoolStatistics);
+	EXPORT_FUNCTION(exports, env, setChallengePoolSize);
+	EXPORT_FUNCTION(exports, env, fingerprint);
+	EXPORT_FUNCTION(exports, env, setThreadPoolSize);
 	EXPORT_FUNCTION(exports, env, setCSharpDllLocation);
+	EXPORT_FUNCTION(exports, env, setBackend);
+	EXPORT_FUNCTION(exports, env, getBackend);
 
 	return exports;
 }
@@ -4,7 +4,6 @@ using System.Security.Cryptography;
 using System.Threading.Tasks;
 using Windows.Security.Credentials;
 using Windows.Security.Cryptography;
-using Windows.Security.Cryptography.Core;
 using Windows.Storage.Streams;
 
 /// <summary>
@@ -146,28 +145,6 @@ namespace CSNodeMsPassport {
             }
         }
 
-        /// <summary>
-        /// Get a hashed version of the public key
-        /// </summary>
-        /// <exception cref="UserCancelledException"></exception>
-        /// <exception cref="AccountNotFoundException"></exception>
-        /// <exception cref="UnknownException"></exception>
-        /// <exception cref="AggregateException"></exception>
-        /// <param name="accountId">The id of the account to use</param>
-        /// <returns>A passport result, storing the hashed public key in its buffer</returns>
-        public static byte[] GetPublicKeyHash(string accountId) {
-            byte[] res = GetPublicKey(accountId);
-            // Get a hash provider for the SHA256 algorithm and hash the public key
-            HashAlgorithmProvider hashProvider = HashAlgorithmProvider.OpenAlgorithm(HashAlgorithmNames.Sha256);
-            IBuffer publicKeyHash = hashProvider.HashData(CryptographicBuffer.CreateFromByteArray(res));
-
-            // Copy the hashed public key to the PassportResult's buffer
-            CryptographicBuffer.CopyToByteArray(publicKeyHash, out byte[] outBuffer);
-
-            // Return the PassportResult
-            return outBuffer;
-        }
-
         /// <summary>
         /// Delete the passport account async.
         /// Returns zero, if the operation was successful,
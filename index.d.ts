@@ -34,6 +34,78 @@ export type credentialReadResult = {
     password: string;
 };
 
+/**
+ * The statistics of the public key cache
+ */
+export type keyCacheStatistics = {
+    // The number of lookups of an already parsed key
+    hits: number;
+    // The number of keys that had to be parsed
+    misses: number;
+    // The number of keys removed to make room for new ones
+    evictions: number;
+    // The number of keys currently stored
+    size: number;
+};
+
+/**
+ * The statistics of the replay filter
+ */
+export type replayFilterStatistics = {
+    // The number of consumed challenges
+    inserted: number;
+    // The number of replayed challenges
+    duplicates: number;
+    // The number of challenges rejected because the filter was full
+    rejected: number;
+    // The number of challenges currently remembered
+    size: number;
+    // The memory used by the filter in bytes
+    memory: number;
+};
+
+/**
+ * The statistics of the challenge pool
+ */
+export type challengePoolStatistics = {
+    // The number of challenges taken from the pool
+    taken: number;
+    // The number of challenges generated by the caller because the pool was empty
+    exhausted: number;
+    // The number of challenges generated by the background thread
+    generated: number;
+    // The number of challenges currently stored
+    available: number;
+    // The maximum number of challenges stored
+    depth: number;
+};
+
+/**
+ * A signed challenge to verify using passport.verifySignatures
+ */
+export type signatureData = {
+    // The challenge used
+    challenge: string | Buffer | Uint8Array;
+    // The signature returned by passport
+    signature: string | Buffer | Uint8Array;
+    // The public key of the application
+    publicKey: string | Buffer | Uint8Array;
+    // How the signature was created, defaults to RSASSA-PKCS1-v1_5 or ECDSA using SHA-256
+    options?: signatureOptions;
+};
+
+/**
+ * How a signature was created
+ */
+export type signatureOptions = {
+    // The padding of RSA signatures. 'pss' is only supported by RSA keys. Defaults to 'pkcs1'.
+    padding?: 'pkcs1' | 'pss';
+    // The hash function used. Defaults to 'sha256'.
+    hash?: 'sha256' | 'sha384' | 'sha512';
+    // The length of the PSS salt in bytes. Any salt length is accepted if omitted.
+    saltLength?: number;
+};
+
 /**
  * The error codes that may be stored
  * by the PassportError class
@@ -115,6 +187,14 @@ export class passport {
      */
     async passportSign(challenge: string): Promise<string>;
 
+    /**
+     * Sign a challenge
+     *
+     * @param challenge the challenge to sign
+     * @return the signature
+     */
+    async passportSign(challenge: Buffer | Uint8Array): Promise<Buffer>;
+
     /**
      * Delete a passport account
      */
@@ -127,6 +207,13 @@ export class passport {
      */
     async getPublicKey(): Promise<string>;
 
+    /**
+     * Get the public key
+     *
+     * @return the public key
+     */
+    async getPublicKeyBuffer(): Promise<Buffer>;
+
     /**
      * Get a SHA-256 hash of the public key
      *
@@ -134,6 +221,13 @@ export class passport {
      */
     async getPublicKeyHash(): Promise<string>;
 
+    /**
+     * Get a SHA-256 hash of the public key
+     *
+     * @return the hashed public key
+     */
+    async getPublicKeyHashBuffer(): Promise<Buffer>;
+
     /**
      * Check if a passport account exists
      * 
@@ -150,14 +244,111 @@ export class passport {
     static passportAvailable(): boolean;
 
     /**
-     * Verify a challenge signed by passport
+     * Verify a challenge signed by passport.
+     * Every parameter may either be a hex string or binary data.
      *
      * @param challenge the challenge used
      * @param signature the signature returned
-     * @param publicKey the public key of the application
+     * @param publicKey the public key of the application, an RSA or ECDSA P-256 key
+     * @param options how the signature was created, defaults to RSASSA-PKCS1-v1_5 or ECDSA using SHA-256
      * @return true, if the signature matches
      */
-    static async verifySignature(challenge: string, signature: string, publicKey: string): Promise<boolean>;
+    static async verifySignature(challenge: string | Buffer | Uint8Array, signature: string | Buffer | Uint8Array,
+                                 publicKey: string | Buffer | Uint8Array, options?: signatureOptions): Promise<boolean>;
+
+    /**
+     * Issue a stateless challenge for an account. The challenge contains a nonce, the time
+     * of issue and a binding to the account, authenticated with HMAC-SHA256. It can be verified
+     * by every server using the same key (see setChallengeKey), without storing it.
+     *
+     * @param accountId the id of the account that will sign the challenge
+     * @param binary whether to return the challenge as a Buffer
+     * @return the challenge as hex string or as a Buffer if binary is true
+     */
+    static issueChallenge(accountId: string, binary?: false): string;
+    static issueChallenge(accountId: string, binary: true): Buffer;
+
+    /**
+     * Verify a challenge issued by issueChallenge and its signature.
+     * The signature is only verified if the challenge is authentic,
+     * bound to the account and not expired. The challenge can only be verified once.
+     *
+     * @param accountId the id of the account that signed the challenge
+     * @param challenge the challenge returned by issueChallenge
+     * @param signature the signature returned
+     * @param publicKey the public key of the application
+     * @return true, if the challenge is valid and the signature matches
+     */
+    static async verifyChallengeAndSignature(accountId: string, challenge: string | Buffer | Uint8Array,
+                                             signature: string | Buffer | Uint8Array,
+                                             publicKey: string | Buffer | Uint8Array): Promise<boolean>;
+
+    /**
+     * Set the key used to issue and verify challenges. All servers verifying each other's
+     * challenges must use the same key. If no key is set, a random key is used.
+     *
+     * @param key the key, at least 16 bytes, as hex string or binary data
+     * @param maxAge the maximum age of a challenge in milliseconds. Defaults to five minutes.
+     *               Plus 30 seconds of clock skew, it must be less than the replay protection ttl.
+     */
+    static setChallengeKey(key: string | Buffer | Uint8Array, maxAge?: number): void;
+
+    /**
+     * Verify multiple challenges signed by passport at once.
+     * The signatures are verified in parallel on a native thread pool.
+     * Entries with an invalid public key do not match.
+     *
+     * @param signatures the signatures to verify
+     * @return whether each signature matches, in the order of the input
+     */
+    static async verifySignatures(signatures: signatureData[]): Promise<boolean[]>;
+
+    /**
+     * Get the statistics of the cache of parsed public keys
+     * used by verifySignature and verifySignatures
+     *
+     * @return the cache statistics
+     */
+    static getKeyCacheStatistics(): keyCacheStatistics;
+
+    /**
+     * Enable or disable replay protection for verifySignature and verifySignatures.
+     * If enabled, every challenge can only be verified once. Challenges are
+     * remembered for ttl milliseconds in an in-process filter, which holds at
+     * most maxEntries challenges. Challenges verified while the filter is full
+     * are rejected. Challenges verified by verifyChallengeAndSignature are
+     * always consumed. The ttl and size can only be set before the first verification.
+     * The ttl must be greater than the maximum challenge age plus 30 seconds.
+     *
+     * @param enabled whether to consume verified challenges
+     * @param ttl the time a challenge is remembered for in milliseconds. Defaults to ten minutes.
+     * @param maxEntries the maximum number of remembered challenges. Defaults to 4194304.
+     */
+    static setReplayProtection(enabled: boolean, ttl?: number, maxEntries?: number): void;
+
+    /**
+     * Get the replay filter statistics
+     *
+     * @return the replay filter statistics
+     */
+    static getReplayFilterStatistics(): replayFilterStatistics;
+
+    /**
+     * Select the authenticator used by all passport instances.
+     * 'default' selects windows hello on windows and the software authenticator
+     * on all other platforms. 'software' stores the keys in files inside of directory.
+     *
+     * @param name the name of the backend, either 'default' or 'software'
+     * @param directory the key directory of the software authenticator
+     */
+    static setBackend(name: 'default' | 'software', directory?: string): void;
+
+    /**
+     * Get the name of the authenticator currently in use
+     *
+     * @return the name of the backend, either 'windows' or 'software'
+     */
+    static getBackend(): 'windows' | 'software';
 };
 
 /**
@@ -220,21 +411,29 @@ export namespace passwords {
      */
     async function encrypt(data: string): Promise<string>;
 
+    /**
+     * Encrypt a password using CredProtect. Throws on error
+     *
+     * @param data the data to encrypt
+     * @returns the encrypted data
+     */
+    async function encryptToBuffer(data: string): Promise<Buffer>;
+
     /**
      * Decrypt a password using CredUnprotect. Throws on error
      *
-     * @param data the data to decrypt as hex string
+     * @param data the data to decrypt as hex string or binary data
      * @returns the result as string or null if unsuccessful
      */
-    async function decrypt(data: string): Promise<string>;
+    async function decrypt(data: string | Buffer | Uint8Array): Promise<string>;
 
     /**
      * Check if data was encrypted using CredProtect. Throws an error on error
      *
-     * @param data the data as hex string
+     * @param data the data as hex string or binary data
      * @returns if the password is encrypted
      */
-    async function isEncrypted(data: string): Promise<boolean>;
+    async function isEncrypted(data: string | Buffer | Uint8Array): Promise<boolean>;
 };
 
 /**
@@ -242,12 +441,86 @@ export namespace passwords {
  */
 export namespace passport_utils {
     /**
-     * Generate random bytes
+     * Generate cryptographically secure random bytes
      *
      * @param length the length of the challenge in bytes
      * @return the random bytes as hex string
      */
     function generateRandom(length: number): string;
+
+    /**
+     * Generate cryptographically secure random bytes
+     *
+     * @param length the length of the challenge in bytes
+     * @param binary whether to return the bytes as a Buffer
+     * @return the random bytes as a Buffer if binary is true, as hex string otherwise
+     */
+    function generateRandom(length: number, binary: true): Buffer;
+    function generateRandom(length: number, binary: boolean): string | Buffer;
+
+    /**
+     * Take a pre-generated challenge from the native challenge pool.
+     * Much faster than generateRandom under load, as the challenges
+     * are generated by a background thread.
+     *
+     * @param length the length of the challenge in bytes, at most 64
+     * @return the challenge as hex string
+     */
+    function takeChallenge(length?: number): string;
+
+    /**
+     * Take a pre-generated challenge from the native challenge pool
+     *
+     * @param length the length of the challenge in bytes, at most 64
+     * @param binary whether to return the challenge as a Buffer
+     * @return the challenge as a Buffer if binary is true, as hex string otherwise
+     */
+    function takeChallenge(length: number, binary: true): Buffer;
+    function takeChallenge(length: number, binary: boolean): string | Buffer;
+
+    /**
+     * Get the challenge pool statistics
+     *
+     * @return the challenge pool statistics
+     */
+    function getChallengePoolStatistics(): challengePoolStatistics;
+
+    /**
+     * Set the size of the challenge pool.
+     * Must be called before the first call to takeChallenge.
+     *
+     * @param depth the number of challenges to keep
+     * @param lowWater refill the pool once it holds this many challenges or less
+     */
+    function setChallengePoolSize(depth: number, lowWater: number): void;
+
+    /**
+     * Get the SHA-256 fingerprint of a public key.
+     * This is the value getPublicKeyHash returns for the key,
+     * without having to call passport.
+     *
+     * @param publicKey the public key as hex string
+     * @return the fingerprint as hex string
+     */
+    function fingerprint(publicKey: string): string;
+
+    /**
+     * Get the SHA-256 fingerprint of a public key.
+     * This is the value getPublicKeyHash returns for the key,
+     * without having to call passport.
+     *
+     * @param publicKey the public key
+     * @return the fingerprint
+     */
+    function fingerprint(publicKey: Buffer | Uint8Array): Buffer;
+
+    /**
+     * Set the number of native threads running the asynchronous operations.
+     * Must be called before the first asynchronous operation.
+     *
+     * @param threads the number of threads, zero uses one thread per core
+     */
+    function setThreadPoolSize(threads: number): void;
 };
 
 /**
@@ -260,4 +533,6 @@ export namespace passport_lib {
     const library_dir: string;
     // The library name
     const library: string;
+    // The portable native library, must be linked together with library
+    const native_library: string;
 };
@@ -24,10 +24,8 @@
  * SOFTWARE.
  */
 
-// Check if this runs on windows and check if this is windows 10
-if (process.platform !== 'win32') {
-    throw new Error("OS is not supported. Only windows 10 is supported");
-} else {
+// Check if this is windows 10. Other platforms use the software authenticator.
+if (process.platform === 'win32') {
     let version = require('child_process').execSync('ver').toString().trim();
     version = version.split("[")[1].replace("Version ", "").split(".")[0];
     if (Number(version) !== 10) {
@@ -39,7 +37,9 @@ const path = require('path');
 const passport_native = require(path.join(__dirname, 'bin', 'passport.node'));
 
 // Set the location for the C# dll
-passport_native.setCSharpDllLocation(path.join(__dirname, 'bin/'));
+if (process.platform === 'win32') {
+    passport_native.setCSharpDllLocation(path.join(__dirname, 'bin/'));
+}
 
 class PassportError extends Error {
     #code = -1;
@@ -147,6 +147,16 @@ module.exports = {
             }
         }
 
+        async getPublicKeyBuffer() {
+            if (!this.accountExists)
+                throw new PassportError("The passport account does not exist", errorCodes.ERR_ACCOUNT_NOT_FOUND);
+            try {
+                return await passport_native.getPublicKeyBuffer(this.accountId);
+            } catch (e) {
+                rethrowError(e);
+            }
+        }
+
         async getPublicKeyHash() {
             if (!this.accountExists)
                 throw new PassportError("The passport account does not exist", errorCodes.ERR_ACCOUNT_NOT_FOUND);
@@ -157,6 +167,16 @@ module.exports = {
             }
         }
 
+        async getPublicKeyHashBuffer() {
+            if (!this.accountExists)
+                throw new PassportError("The passport account does not exist", errorCodes.ERR_ACCOUNT_NOT_FOUND);
+            try {
+                return await passport_native.getPublicKeyHashBuffer(this.accountId);
+            } catch (e) {
+                rethrowError(e);
+            }
+        }
+
         static passportAccountExists(accountId) {
             try {
                 return passport_native.passportAccountExists(accountId);
@@ -173,13 +193,107 @@ module.exports = {
             }
         }
 
-        static async verifySignature(challenge, signature, publicKey) {
+        static async verifySignature(challenge, signature, publicKey, options = undefined) {
+            try {
+                return await passport_native.verifySignature(challenge, signature, publicKey, options);
+            } catch (e) {
+                rethrowError(e);
+            }
+        }
+
+        static async verifySignatures(signatures) {
+            if (!Array.isArray(signatures)) {
+                throw new Error("Parameter 'signatures' must be an array");
+            }
+
+            try {
+                return await passport_native.verifySignatures(signatures);
+            } catch (e) {
+                rethrowError(e);
+            }
+        }
+
+        static issueChallenge(accountId, binary = false) {
+            if (typeof accountId !== 'string') {
+                throw new Error("Parameter 'accountId' must be typeof 'string'");
+            }
+
+            try {
+                return passport_native.issueChallenge(accountId, !!binary);
+            } catch (e) {
+                rethrowError(e);
+            }
+        }
+
+        static async verifyChallengeAndSignature(accountId, challenge, signature, publicKey) {
+            if (typeof accountId !== 'string') {
+                throw new Error("Parameter 'accountId' must be typeof 'string'");
+            }
+
+            try {
+                return await passport_native.verifyChallengeAndSignature(accountId, challenge, signature, publicKey);
+            } catch (e) {
+                rethrowError(e);
+            }
+        }
+
+        static setChallengeKey(key, maxAge = 5 * 60 * 1000) {
+            if (typeof maxAge !== 'number' || !Number.isInteger(maxAge) || maxAge <= 0) {
+                throw new Error("Parameter 'maxAge' must be a positive integer");
+            }
+
+            try {
+                passport_native.setChallengeKey(key, maxAge);
+            } catch (e) {
+                rethrowError(e);
+            }
+        }
+
+        static getKeyCacheStatistics() {
+            return passport_native.getKeyCacheStatistics();
+        }
+
+        static setReplayProtection(enabled, ttl = undefined, maxEntries = undefined) {
+            if (typeof enabled !== 'boolean') {
+                throw new Error("Parameter 'enabled' must be typeof 'boolean'");
+            } else if (ttl !== undefined && (!Number.isInteger(ttl) || ttl <= 0)) {
+                throw new Error("Parameter 'ttl' must be a positive integer");
+            } else if (maxEntries !== undefined && (!Number.isInteger(maxEntries) || maxEntries <= 0)) {
+                throw new Error("Parameter 'maxEntries' must be a positive integer");
+            }
+
+            try {
+                passport_native.setReplayProtection(enabled, ttl || 0, maxEntries || 0);
+            } catch (e) {
+                rethrowError(e);
+            }
+        }
+
+        static getReplayFilterStatistics() {
+            return passport_native.getReplayFilterStatistics();
+        }
+
+        static setBackend(name, directory = undefined) {
+            if (typeof name !== 'string') {
+                throw new Error("Parameter 'name' must be typeof 'string'");
+            } else if (directory !== undefined && typeof directory !== 'string') {
+                throw new Error("Parameter 'directory' must be typeof 'string'");
+            }
+
             try {
-                return await passport_native.verifySignature(challenge, signature, publicKey);
+                if (directory === undefined) {
+                    passport_native.setBackend(name);
+                } else {
+                    passport_native.setBackend(name, directory);
+                }
             } catch (e) {
                 rethrowError(e);
             }
         }
+
+        static getBackend() {
+            return passport_native.getBackend();
+        }
     },
     credentialStore: class {
         constructor(accountId, encryptPasswords = true) {
@@ -235,10 +349,19 @@ module.exports = {
         encrypt: async function (data) {
             return await passport_native.encryptPassword(data);
         },
+        /**
+         * Encrypt a password using CredProtect. Throws on error
+         *
+         * @param data {string} the data to encrypt
+         * @returns {Buffer} the encrypted data
+         */
+        encryptToBuffer: async function (data) {
+            return await passport_native.encryptPasswordBuffer(data);
+        },
         /**
          * Decrypt a password using CredUnprotect. Throws on error
          *
-         * @param data {string} the data to decrypt as hex string
+         * @param data {string | Buffer | Uint8Array} the data to decrypt as hex string or binary data
          * @returns {string} the result as string or null if unsuccessful
          */
         decrypt: async function (data) {
@@ -247,7 +370,7 @@ module.exports = {
         /**
          * Check if data was encrypted using CredProtect. Throws an error on error
          *
-         * @param data {string} the data as hex string
+         * @param data {string | Buffer | Uint8Array} the data as hex string or binary data
          * @returns {boolean} if the password is encrypted
          */
         isEncrypted: async function (data) {
@@ -259,13 +382,87 @@ module.exports = {
      */
     passport_utils: {
         /**
-         * Generate random bytes
+         * Generate cryptographically secure random bytes
          *
          * @param length {number} the length of the challenge in bytes
-         * @return {string} the random bytes as hex string
+         * @param binary {boolean} whether to return the bytes as a Buffer
+         * @return {string | Buffer} the random bytes as hex string or as a Buffer if binary is true
+         */
+        generateRandom: function (length, binary = false) {
+            return passport_native.generateRandom(length, binary);
+        },
+
+        /**
+         * Take a pre-generated challenge from the native challenge pool.
+         * Much faster than generateRandom under load, as the challenges
+         * are generated by a background thread.
+         *
+         * @param length {number} the length of the challenge in bytes, at most 64
+         * @param binary {boolean} whether to return the challenge as a Buffer
+         * @return {string | Buffer} the challenge as hex string or as a Buffer if binary is true
+         */
+        takeChallenge: function (length = 32, binary = false) {
+            if (typeof length !== 'number' || !Number.isInteger(length)) {
+                throw new Error("Parameter 'length' must be an integer");
+            }
+
+            return passport_native.takeChallenge(length, !!binary);
+        },
+
+        /**
+         * Get the challenge pool statistics
+         *
+         * @return {{taken: number, exhausted: number, generated: number, available: number, depth: number}}
+         * the number of challenges taken from the pool, generated by the caller because the pool
+         * was empty and generated by the background thread, the number of stored challenges and the pool depth
          */
-        generateRandom: function (length) {
-            return passport_native.generateRandom(length);
+        getChallengePoolStatistics: function () {
+            return passport_native.getChallengePoolStatistics();
+        },
+
+        /**
+         * Set the size of the challenge pool.
+         * Must be called before the first call to takeChallenge.
+         *
+         * @param depth {number} the number of challenges to keep
+         * @param lowWater {number} refill the pool once it holds this many challenges or less
+         */
+        setChallengePoolSize: function (depth, lowWater) {
+            if (typeof depth !== 'number' || !Number.isInteger(depth) || depth < 1) {
+                throw new Error("Parameter 'depth' must be a positive integer");
+            } else if (typeof lowWater !== 'number' || !Number.isInteger(lowWater) || lowWater < 0) {
+                throw new Error("Parameter 'lowWater' must be a non-negative integer");
+            }
+
+            passport_native.setChallengePoolSize(depth, lowWater);
+        },
+
+        /**
+         * Get the SHA-256 fingerprint of a public key
+         *
+         * @param publicKey {string | Buffer | Uint8Array} the public key
+         * @return {string | Buffer} the fingerprint, as a Buffer if publicKey is binary
+         */
+        fingerprint: function (publicKey) {
+            try {
+                return passport_native.fingerprint(publicKey);
+            } catch (e) {
+                rethrowError(e);
+            }
+        },
+
+        /**
+         * Set the number of native threads running the asynchronous operations.
+         * Must be called before the first asynchronous operation.
+         *
+         * @param threads {number} the number of threads, zero uses one thread per core
+         */
+        setThreadPoolSize: function (threads) {
+            if (typeof threads !== 'number' || !Number.isInteger(threads) || threads < 0) {
+                throw new Error("Parameter 'threads' must be a non-negative integer");
+            }
+
+            passport_native.setThreadPoolSize(threads);
         }
     },
     /**
@@ -274,6 +471,7 @@ module.exports = {
     passport_lib: {
         include_dir: path.join(__dirname, 'cpp_src'),
         library_dir: path.join(__dirname, 'lib'),
-        library: path.join(__dirname, 'lib', 'NodeMsPassport.lib')
+        library: path.join(__dirname, 'lib', 'NodeMsPassport.lib'),
+        native_library: path.join(__dirname, 'lib', process.platform === 'win32' ? 'PassportNative.lib' : 'libPassportNative.a')
     }
 }
\ No newline at end of file
@@ -5,9 +5,12 @@ const BINARY_NAME = "passport.node";
 const CS_BINARY_NAME = "CSNodeMsPassport.dll";
 const WINDOWS_WINMD = "Windows.winmd";
 const NODEMSPASSPORT_NAME = "NodeMsPassport.lib";
+const PASSPORTNATIVE_NAME = process.platform === 'win32' ? "PassportNative.lib" : "libPassportNative.a";
 const OUT_DIR = path.join(__dirname, 'bin');
 const LIB_DIR = path.join(__dirname, 'lib');
 const BUILD_DIR = path.join(__dirname, 'build');
+// Multi-config generators like visual studio put the binaries into a sub directory
+const RELEASE_DIR = fs.existsSync(path.join(BUILD_DIR, 'Release')) ? path.join(BUILD_DIR, 'Release') : BUILD_DIR;
 
 // Source: https://stackoverflow.com/a/32197381
 function deleteFolderRecursive(p) {
@@ -45,10 +48,15 @@ if (process.argv.length === 2) {
             deleteIfExists(LIB_DIR);
             fs.mkdirSync(OUT_DIR);
             fs.mkdirSync(LIB_DIR);
-            fs.copyFileSync(path.join(BUILD_DIR, 'Release', BINARY_NAME), path.join(OUT_DIR, BINARY_NAME));
-            fs.copyFileSync(path.join(BUILD_DIR, 'Release', CS_BINARY_NAME), path.join(OUT_DIR, CS_BINARY_NAME));
-            fs.copyFileSync(path.join(BUILD_DIR, 'Release', WINDOWS_WINMD), path.join(OUT_DIR, WINDOWS_WINMD));
-            fs.copyFileSync(path.join(BUILD_DIR, 'Release', NODEMSPASSPORT_NAME), path.join(LIB_DIR, NODEMSPASSPORT_NAME));
+            fs.copyFileSync(path.join(RELEASE_DIR, BINARY_NAME), path.join(OUT_DIR, BINARY_NAME));
+            fs.copyFileSync(path.join(RELEASE_DIR, PASSPORTNATIVE_NAME), path.join(LIB_DIR, PASSPORTNATIVE_NAME));
+
+            // The C# and C++/CLI parts are only built on windows
+            if (process.platform === 'win32') {
+                fs.copyFileSync(path.join(RELEASE_DIR, CS_BINARY_NAME), path.join(OUT_DIR, CS_BINARY_NAME));
+                fs.copyFileSync(path.join(RELEASE_DIR, WINDOWS_WINMD), path.join(OUT_DIR, WINDOWS_WINMD));
+                fs.copyFileSync(path.join(RELEASE_DIR, NODEMSPASSPORT_NAME), path.join(LIB_DIR, NODEMSPASSPORT_NAME));
+            }
             break;
         case "--clean":
             deleteIfExists(OUT_DIR);
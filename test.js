@@ -1,6 +1,17 @@
 const assert = require("assert");
+const crypto = require("crypto");
+const path = require("path");
+const fs = require("fs");
+const os = require("os");
 const { passport, passport_utils, passwords, credentialStore } = require('./index');
 
+// Windows hello is only available on windows, use the software authenticator everywhere else
+const windowsOnly = process.platform === 'win32' ? describe : describe.skip;
+const keyDirectory = fs.mkdtempSync(path.join(os.tmpdir(), 'node-ms-passport-'));
+if (process.platform !== 'win32') {
+    passport.setBackend('software', keyDirectory);
+}
+
 describe('Passport test', function () {
     let publicKey, challenge, signed;
     it('Checking if passport is available', () => {
@@ -23,6 +34,27 @@ describe('Passport test', function () {
         assert.strictEqual(challenge.length, 50);
     });
 
+    it('Generating a binary challenge', function () {
+        const first = passport_utils.generateRandom(32, true);
+        const second = passport_utils.generateRandom(32, true);
+        assert(Buffer.isBuffer(first));
+        assert.strictEqual(first.length, 32);
+        assert(!first.equals(second));
+    });
+
+    it('Taking challenges from the pool', function () {
+        const before = passport_utils.getChallengePoolStatistics();
+        const first = passport_utils.takeChallenge(32);
+        const second = passport_utils.takeChallenge(32, true);
+        assert.strictEqual(first.length, 64);
+        assert.strictEqual(second.length, 32);
+        assert.notStrictEqual(first, second.toString('hex'));
+
+        const after = passport_utils.getChallengePoolStatistics();
+        assert.strictEqual(after.taken + after.exhausted, before.taken + before.exhausted + 2);
+        assert.throws(() => passport_utils.takeChallenge(65));
+    });
+
     it('Signing challenge', async function () {
         this.timeout(0); // No timeout since this requires user interaction
         signed = await pass.passportSign(challenge);
@@ -34,13 +66,226 @@ describe('Passport test', function () {
         assert(signatureMatches);
     });
 
+    it('Checking public key as Buffer', async () => {
+        const publicKeyBuffer = await pass.getPublicKeyBuffer();
+        assert(Buffer.isBuffer(publicKeyBuffer));
+        assert.strictEqual(publicKeyBuffer.toString('hex').toUpperCase(), publicKey);
+    });
+
+    it('Signing and verifying Buffer challenge', async function () {
+        this.timeout(0); // No timeout since this requires user interaction
+        const challengeBuffer = Buffer.from(challenge, 'hex');
+        const signedBuffer = await pass.passportSign(challengeBuffer);
+        assert(Buffer.isBuffer(signedBuffer));
+
+        const publicKeyBuffer = await pass.getPublicKeyBuffer();
+        assert(await passport.verifySignature(challengeBuffer, signedBuffer, publicKeyBuffer));
+        assert(await passport.verifySignature(new Uint8Array(challengeBuffer), signedBuffer.toString('hex'), publicKey));
+    });
+
+    it('Verifying multiple signatures', async () => {
+        const results = await passport.verifySignatures([
+            {challenge: challenge, signature: signed, publicKey: publicKey},
+            {challenge: passport_utils.generateRandom(25), signature: signed, publicKey: publicKey},
+            {challenge: challenge, signature: signed, publicKey: "00"}
+        ]);
+        assert.deepStrictEqual(results, [true, false, false]);
+    });
+
+    it('Checking key cache statistics', async () => {
+        const before = passport.getKeyCacheStatistics();
+        assert(await passport.verifySignature(challenge, signed, publicKey));
+
+        const after = passport.getKeyCacheStatistics();
+        assert.strictEqual(after.hits, before.hits + 1);
+        assert.strictEqual(after.misses, before.misses);
+        assert(after.size >= 1);
+    });
+
+    it('Checking public key fingerprint', async () => {
+        const publicKeyHash = await pass.getPublicKeyHash();
+        assert.strictEqual(passport_utils.fingerprint(publicKey), publicKeyHash);
+
+        const fingerprint = passport_utils.fingerprint(Buffer.from(publicKey, 'hex'));
+        assert(Buffer.isBuffer(fingerprint));
+        assert.strictEqual(fingerprint.toString('hex').toUpperCase(), publicKeyHash);
+    });
+
+    it('Setting the thread pool size after it started', () => {
+        assert.throws(() => passport_utils.setThreadPoolSize(2));
+    });
+
     it('Deleting passport key', async () => {
         await pass.deletePassportAccount();
         assert.strictEqual(passport.passportAccountExists("test"), false);
     });
 });
 
-describe('Credential manager test', function () {
+describe('Software authenticator test', function () {
+    const pass = new passport("software-test");
+    it('Selecting the software authenticator', () => {
+        passport.setBackend('software', keyDirectory);
+        assert.strictEqual(passport.getBackend(), 'software');
+        assert(passport.passportAvailable());
+    });
+
+    it('Creating and using a software key', async () => {
+        await pass.createPassportKey();
+        assert(passport.passportAccountExists("software-test"));
+
+        const challenge = passport_utils.generateRandom(32);
+        const signature = await pass.passportSign(challenge);
+        const publicKey = await pass.getPublicKeyBuffer();
+        assert(crypto.verify('sha256', Buffer.from(challenge, 'hex'), {
+            key: publicKey,
+            format: 'der',
+            type: 'spki'
+        }, Buffer.from(signature, 'hex')));
+        assert(await passport.verifySignature(challenge, signature, publicKey));
+    });
+
+    it('Verifying an issued challenge', async () => {
+        const challenge = passport.issueChallenge("software-test");
+        const signature = await pass.passportSign(challenge);
+        const publicKey = await pass.getPublicKeyBuffer();
+        assert(await passport.verifyChallengeAndSignature("software-test", challenge, signature, publicKey));
+        assert(!await passport.verifyChallengeAndSignature("software-test", challenge, signature, publicKey));
+        assert(!await passport.verifyChallengeAndSignature("other-account", challenge, signature, publicKey));
+
+        const forged = Buffer.from(challenge, 'hex');
+        forged[1] ^= 1;
+        assert(!await passport.verifyChallengeAndSignature("software-test", forged, signature, publicKey));
+    });
+
+    it('Rejecting a challenge age the replay filter does not cover', () => {
+        // The default replay filter remembers challenges for ten minutes
+        const key = passport_utils.generateRandom(32);
+        assert.throws(() => passport.setChallengeKey(key, 15 * 60 * 1000));
+        assert.throws(() => passport.setChallengeKey(key, 10 * 60 * 1000 - 30 * 1000));
+    });
+
+    it('Rejecting replayed signatures', async () => {
+        const challenge = passport_utils.generateRandom(32);
+        const signature = await pass.passportSign(challenge);
+        const publicKey = await pass.getPublicKeyBuffer();
+
+        passport.setReplayProtection(true);
+        try {
+            assert(await passport.verifySignature(challenge, signature, publicKey));
+            assert(!await passport.verifySignature(challenge, signature, publicKey));
+            assert(passport.getReplayFilterStatistics().duplicates >= 1);
+        } finally {
+            passport.setReplayProtection(false);
+        }
+
+        assert(await passport.verifySignature(challenge, signature, publicKey));
+        assert.throws(() => passport.setReplayProtection(true, 1000));
+    });
+
+    it('Verifying an ECDSA P-256 signature', async () => {
+        const { publicKey, privateKey } = crypto.generateKeyPairSync('ec', { namedCurve: 'P-256' });
+        const spki = publicKey.export({ type: 'spki', format: 'der' });
+        const challenge = passport_utils.generateRandom(32, true);
+        const signature = crypto.sign('sha256', challenge, privateKey);
+
+        assert(await passport.verifySignature(challenge, signature, spki));
+        const raw = crypto.sign('sha256', challenge, { key: privateKey, dsaEncoding: 'ieee-p1363' });
+        assert(await passport.verifySignature(challenge, raw, spki));
+
+        raw[10] ^= 1;
+        assert(!await passport.verifySignature(challenge, raw, spki));
+    });
+
+    it('Verifying RSA-PSS signatures', async () => {
+        const { publicKey, privateKey } = crypto.generateKeyPairSync('rsa', { modulusLength: 2048 });
+        const spki = publicKey.export({ type: 'spki', format: 'der' });
+        const challenge = passport_utils.generateRandom(32, true);
+        const pss = { key: privateKey, padding: crypto.constants.RSA_PKCS1_PSS_PADDING, saltLength: 32 };
+
+        const signature = crypto.sign('sha256', challenge, pss);
+        assert(await passport.verifySignature(challenge, signature, spki, { padding: 'pss' }));
+        assert(await passport.verifySignature(challenge, signature, spki, { padding: 'pss', saltLength: 32 }));
+        assert(!await passport.verifySignature(challenge, signature, spki, { padding: 'pss', saltLength: 20 }));
+        assert(!await passport.verifySignature(challenge, signature, spki));
+
+        const sha512 = crypto.sign('sha512', challenge, pss);
+        const results = await passport.verifySignatures([
+            { challenge, signature: sha512, publicKey: spki, options: { padding: 'pss', hash: 'sha512' } },
+            { challenge, signature: sha512, publicKey: spki, options: { padding: 'pss', hash: 'sha384' } }
+        ]);
+        assert.deepStrictEqual(results, [true, false]);
+
+        await assert.rejects(passport.verifySignature(challenge, signature, spki, { padding: 'oaep' }));
+    });
+
+    it('Rejecting RSA keys with an invalid public exponent', async () => {
+        const { publicKey, privateKey } = crypto.generateKeyPairSync('rsa', { modulusLength: 2048 });
+        const jwk = publicKey.export({ format: 'jwk' });
+        const challenge = passport_utils.generateRandom(32, true);
+        const signature = crypto.sign('sha256', challenge, privateKey);
+
+        for (const e of ['01', '010000', '010000000000000001']) {
+            const key = crypto.createPublicKey({
+                key: { ...jwk, e: Buffer.from(e, 'hex').toString('base64url') },
+                format: 'jwk'
+            });
+            await assert.rejects(passport.verifySignature(challenge, signature,
+                key.export({ type: 'spki', format: 'der' })));
+        }
+    });
+
+    it('Terminating a worker with a verification in flight', async () => {
+        const { Worker } = require('worker_threads');
+        const { publicKey, privateKey } = crypto.generateKeyPairSync('rsa', { modulusLength: 2048 });
+        const spki = publicKey.export({ type: 'spki', format: 'der' });
+        const challenge = passport_utils.generateRandom(32, true);
+        const signature = crypto.sign('sha256', challenge, privateKey);
+
+        const worker = new Worker(`
+            const { parentPort, workerData } = require('worker_threads');
+            const { passport } = require(workerData.module);
+            for (let i = 0; i < 64; i++) {
+                passport.verifySignature(workerData.challenge, workerData.signature, workerData.spki);
+            }
+            parentPort.postMessage('submitted');
+        `, { eval: true, workerData: { module: path.join(__dirname, 'index.js'), challenge, signature, spki } });
+
+        await new Promise((resolve, reject) => {
+            worker.once('message', resolve);
+            worker.once('error', reject);
+        });
+        await worker.terminate();
+
+        // The results of the terminated worker must not be delivered to a freed dispatcher
+        await new Promise(resolve => setTimeout(resolve, 100));
+        assert(await passport.verifySignature(challenge, signature, spki));
+    });
+
+    it('Deleting a software key', async () => {
+        await pass.deletePassportAccount();
+        assert.strictEqual(passport.passportAccountExists("software-test"), false);
+        await assert.rejects(pass.deletePassportAccount(), (e) => e.getCode() === 7);
+    });
+
+    it('Using a non-ASCII account id', async () => {
+        const accountId = "software-tést-Женя-山田-\u{1F600}";
+        const unicode = new passport(accountId);
+        await unicode.createPassportKey();
+        assert(passport.passportAccountExists(accountId));
+        assert.strictEqual(passport.passportAccountExists("software-test-Женя-山田-\u{1F600}"), false);
+
+        await unicode.deletePassportAccount();
+        assert.strictEqual(passport.passportAccountExists(accountId), false);
+    });
+
+    after(() => {
+        if (process.platform === 'win32') {
+            passport.setBackend('default');
+        }
+    });
+});
+
+windowsOnly('Credential manager test', function () {
     describe('with encryption', () => {
         const cred = new credentialStore("test/test", true);
         it('Credential write', async function () {
@@ -88,7 +333,7 @@ describe('Credential manager test', function () {
     });
 });
 
-describe('Password encryption', function () {
+windowsOnly('Password encryption', function () {
     let data;
     it('Encrypt password', async () => {
         data = await passwords.encrypt("TestPassword");
@@ -110,4 +355,11 @@ describe('Password encryption', function () {
         data = await passwords.decrypt(data);
         assert.strictEqual(data, "TestPassword");
     });
+
+    it('Encrypt and decrypt password using Buffers', async () => {
+        const buffer = await passwords.encryptToBuffer("TestPassword");
+        assert(Buffer.isBuffer(buffer));
+        assert(await passwords.isEncrypted(buffer));
+        assert.strictEqual(await passwords.decrypt(buffer), "TestPassword");
+    });
 });
\ No newline at end of file